@@ -28,6 +28,12 @@ protected:
     /** @brief Creates a statistics object. */
     ELogStats* createStats() override { return new (std::nothrow) AsyncStats(); }
 
+    /**
+     * @brief Prints statistics specific to the asynchronous log target type (before printing
+     * statistics of the subordinate log target).
+     */
+    virtual void printTargetStats(ELogBuffer& buffer) {}
+
     struct AsyncStats : public ELogStats {
         AsyncStats() {}
         AsyncStats(const AsyncStats&) = delete;
@@ -38,6 +44,7 @@ protected:
         void toString(ELogBuffer& buffer, ELogTarget* logTarget, const char* msg = "") override {
             ELogStats::toString(buffer, logTarget, msg);
             ELogAsyncTarget* asyncTarget = (ELogAsyncTarget*)logTarget;
+            asyncTarget->printTargetStats(buffer);
             ELogTarget* subTarget = asyncTarget->getSubTarget();
             subTarget->getStats()->toString(buffer, subTarget, "sub-target statistics");
         }
@@ -1,12 +1,13 @@
 #ifndef __ELOG_DEFERRED_LOG_TARGET_H__
 #define __ELOG_DEFERRED_LOG_TARGET_H__
 
+#include <atomic>
 #include <condition_variable>
-#include <list>
 #include <mutex>
 #include <thread>
 
 #include "elog_async_target.h"
+#include "elog_msg_blob.h"
 
 namespace elog {
 
@@ -22,18 +23,43 @@ public:
      * @param logTarget The deferred log target.
      */
     ELogDeferredTarget(ELogTarget* logTarget)
-        : ELogAsyncTarget(logTarget), m_stop(false), m_writeCount(0), m_readCount(0) {}
+        : ELogAsyncTarget(logTarget),
+          m_queueHead(nullptr),
+          m_queueSize(0),
+          m_stop(false),
+          m_writeCount(0),
+          m_readCount(0) {}
     ELogDeferredTarget(const ELogDeferredTarget&) = delete;
     ELogDeferredTarget(ELogDeferredTarget&&) = delete;
     ELogDeferredTarget& operator=(const ELogDeferredTarget&) = delete;
 
     ELOG_DECLARE_LOG_TARGET_OVERRIDE(ELogDeferredTarget)
 
-protected:
-    typedef std::list<std::pair<ELogRecord, std::string>> LogQueue;
+    /** @brief Allocate thread local storage key for per-thread queue node cache. */
+    static bool createNodePoolKey();
+
+    /** @brief Free thread local storage key for per-thread queue node cache. */
+    static bool destroyNodePoolKey();
 
+protected:
+    /** @brief A queued log record (node of intrusive lock-free queue). */
+    struct LogNode {
+        LogNode(const ELogRecord& logRecord, ELogMsgRef&& msgRef)
+            : m_next(nullptr), m_logRecord(logRecord), m_msgRef(std::move(msgRef)) {}
+
+        std::atomic<LogNode*> m_next;
+        ELogRecord m_logRecord;
+        ELogMsgRef m_msgRef;
+    };
+
+    // NOTE: the queue is a multi-producer single-consumer intrusive list. producers push nodes to
+    // the list head with a single exchange (so there is no CAS retry loop), and the log thread
+    // detaches the entire list with a single exchange, and then reverses it to restore arrival
+    // order. queue nodes are allocated from a dedicated node pool with per-thread caches, so after
+    // warm-up queueing a log record does not require any allocation or lock
     std::thread m_logThread;
-    LogQueue m_logQueue;
+    std::atomic<LogNode*> m_queueHead;
+    std::atomic<uint64_t> m_queueSize;
     std::mutex m_lock;
     std::condition_variable m_cv;
     bool m_stop;
@@ -63,7 +89,19 @@ protected:
 
     virtual void waitQueue(std::unique_lock<std::mutex>& lock);
 
-    void logQueueMsgs(LogQueue& logQueue, bool disregardFlushRequests);
+    /**
+     * @brief Decides whether the log thread should be notified after a log record is queued. By
+     * default the log thread is notified only when the queue becomes non-empty.
+     * @param wasEmpty Specifies whether the queue was empty before the log record was queued.
+     * @param queueSize The queue size after the log record was queued.
+     */
+    virtual bool shouldNotify(bool wasEmpty, uint64_t queueSize);
+
+    bool pushLogNode(const ELogRecord& logRecord, ELogMsgRef&& msgRef);
+
+    LogNode* detachLogNodes(uint64_t& nodeCount);
+
+    void logQueueMsgs(LogNode* logNode, uint64_t nodeCount, bool disregardFlushRequests);
 
     void stopLogThread();
 };
@@ -4,6 +4,7 @@
 #include <atomic>
 #include <new>
 #include <thread>
+#include <vector>
 
 #include "elog_async_target.h"
 #include "elog_def.h"
@@ -116,6 +117,34 @@ public:
 
     ELOG_DECLARE_LOG_TARGET(ELogMultiQuantumTarget)
 
+    /**
+     * @brief Sets NUMA-aware mode. In this mode, thread ring buffers are partitioned among NUMA
+     * nodes, and each node has a single reader, pinned to the CPUs of the node (so the configured
+     * reader count is ignored). Ring buffers of each node are allocated with node-local memory, and
+     * logging threads obtain a ring buffer of the node on which they run (if any is vacant). Log
+     * records read by all node readers are merged by the sorting funnel as usual.
+     * @note This call has effect only if made before the log target is started.
+     */
+    inline void setNumaAware(bool numaAware) { m_numaAware = numaAware; }
+
+    /** @brief Queries whether NUMA-aware mode is set. */
+    inline bool isNumaAware() const { return m_numaAware; }
+
+    /**
+     * @brief Sets the CPUs to which reader threads are pinned. In NUMA-aware mode, the reader of
+     * each node is pinned to the CPUs in the list that belong to the node (or to all the CPUs of
+     * the node, if none of them belongs to the node). Otherwise, all readers are pinned to all the
+     * CPUs in the list.
+     * @note This call has effect only if made before the log target is started.
+     */
+    inline void setConsumerCpus(const std::vector<uint32_t>& cpus) { m_consumerCpus = cpus; }
+
+    /** @brief Retrieves the number of NUMA nodes served (one if not in NUMA-aware mode). */
+    inline uint32_t getNodeCount() const { return m_nodeCount; }
+
+    /** @brief Retrieves the number of log records read by the reader of a NUMA node. */
+    uint64_t getNodeMsgCount(uint32_t node) const;
+
 private:
     /** @brief Order the log target to start (required for threaded targets). */
     bool startLogTarget() final;
@@ -134,6 +163,9 @@ private:
     /** @brief Orders a buffered log target to flush it log messages. */
     bool flushLogTarget() final;
 
+    /** @brief Prints per-node throughput statistics. */
+    void printTargetStats(ELogBuffer& buffer) final;
+
 private:
     enum EntryState : uint64_t { ES_VACANT, ES_WRITING, ES_READY, ES_READING };
     struct ELogRecordData {
@@ -143,7 +175,7 @@ private:
         // buffer of the sorting funnel
         ELogBuffer* m_logBuffer;
         std::atomic<EntryState> m_entryState;
-        uint64_t m_padding[6];
+        uint64_t m_padding[5];
         // NOTE: each record data takes 2 cache lines
 
         ELogRecordData() : m_logBuffer(nullptr), m_entryState(ES_VACANT) {}
@@ -309,7 +341,19 @@ private:
         }
     };
 
+    // the range of thread slots served by a single reader
+    struct ELOG_CACHE_ALIGN ReaderRange {
+        uint64_t m_readerId;
+        uint64_t m_fromSlotId;
+        uint64_t m_toSlotId;
+        // number of log records read by the reader (statistics)
+        std::atomic<uint64_t> m_msgCount;
+
+        ReaderRange() : m_readerId(0), m_fromSlotId(0), m_toSlotId(0), m_msgCount(0) {}
+    };
+
     ELOG_CACHE_ALIGN RingBuffer* m_ringBuffers;
+    ELOG_CACHE_ALIGN ReaderRange* m_readers;
     ELOG_CACHE_ALIGN std::atomic<uint64_t>* m_activeThreads;
     ELOG_CACHE_ALIGN std::atomic<uint64_t>* m_activeRingBuffers;
     ELOG_CACHE_ALIGN std::atomic<uint64_t>* m_threadLogTime;
@@ -325,8 +369,17 @@ private:
     uint64_t m_maxBatchSize;
     uint64_t m_collectPeriodMicros;
     uint64_t m_sortingFunnelSize;
+    uint32_t m_nodeCount;
+    bool m_numaAware;
+    std::vector<uint32_t> m_consumerCpus;
     // CongestionPolicy m_congestionPolicy;
 
+    // start time and total run time of the readers, and per-node log record count of the last run
+    // (for throughput statistics)
+    uint64_t m_startTimeNanos;
+    uint64_t m_runTimeNanos;
+    std::vector<uint64_t> m_nodeMsgCounts;
+
     std::vector<std::thread> m_readerThreads;
     std::thread m_sortingThread;
 
@@ -336,21 +389,25 @@ private:
     std::atomic<uint64_t> m_sortCount;
     std::atomic<uint64_t> m_shipCount;
 
-    void readerThread(uint64_t readerId, uint64_t fromWordIndex, uint64_t toWordIndex);
+    // initialize ring buffers of a slot range
+    bool initRingBuffers(uint64_t fromSlotId, uint64_t toSlotId);
+
+    void readerThread(ReaderRange* reader);
 
-    bool visitActiveRingBuffers(uint64_t wordIndex);
+    // the word visitors visit only slots in the reader's range
+    bool visitActiveRingBuffers(ReaderRange* reader, uint64_t wordIndex);
 
-    bool revisitAllActiveThreads(uint64_t wordIndex);
+    bool revisitAllActiveThreads(ReaderRange* reader, uint64_t wordIndex);
 
-    bool revisitAllThreads(uint64_t wordIndex);
+    bool revisitAllThreads(ReaderRange* reader, uint64_t wordIndex);
 
-    bool readThreadRingBuffer(uint64_t slotId);
+    bool readThreadRingBuffer(ReaderRange* reader, uint64_t slotId);
 
     // move from ring buffer to funnel, return true if poison encountered
     // the max timestamp is valid only if at least one new message was extracted from the ring
     // buffer
     bool extractToSortingFunnel(RingBuffer* ringBuffer, uint64_t& maxTimeStamp, bool& isValid,
-                                bool& extractedAllRecords);
+                                bool& extractedAllRecords, uint64_t& msgCount);
 
     void sortingThread();
 
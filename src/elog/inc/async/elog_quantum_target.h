@@ -2,8 +2,10 @@
 #define __ELOG_QUANTUM_TARGET_H__
 
 #include <atomic>
+#include <mutex>
 #include <new>
 #include <thread>
+#include <vector>
 
 #include "elog_async_target.h"
 #include "elog_def.h"
@@ -77,6 +79,45 @@ public:
 
     ELOG_DECLARE_LOG_TARGET(ELogQuantumTarget)
 
+    /**
+     * @brief Sets NUMA-aware mode. In this mode, each NUMA node has its own ring buffer, allocated
+     * with node-local memory, and its own log thread, pinned to the CPUs of the node. Logging
+     * threads write to the ring buffer of the node on which they run, and all log threads deliver
+     * log records to the subordinate log target through a merge lock, so that the subordinate log
+     * target is still accessed by one thread at a time. Log records from different nodes are not
+     * ordered by time.
+     * @note This call has effect only if made before the log target is started.
+     */
+    inline void setNumaAware(bool numaAware) { m_numaAware = numaAware; }
+
+    /** @brief Queries whether NUMA-aware mode is set. */
+    inline bool isNumaAware() const { return m_numaAware; }
+
+    /**
+     * @brief Overrides the number of ring buffers used in NUMA-aware mode (by default one per NUMA
+     * node). With more ring buffers than NUMA nodes, ring buffers are assigned to nodes
+     * round-robin, and the logging threads of each node are spread round-robin among the ring
+     * buffers of the node. This is mostly useful for testing the multi-node setup on a single-node
+     * machine. Zero restores the default.
+     * @note This call has effect only if made before the log target is started.
+     */
+    inline void setNodeCount(uint32_t nodeCount) { m_nodeCountOverride = nodeCount; }
+
+    /**
+     * @brief Sets the CPUs to which log threads are pinned. In NUMA-aware mode, the log thread of
+     * each node is pinned to the CPUs in the list that belong to the node (or to all the CPUs of
+     * the node, if none of them belongs to the node). Otherwise, the single log thread is pinned to
+     * all the CPUs in the list.
+     * @note This call has effect only if made before the log target is started.
+     */
+    inline void setConsumerCpus(const std::vector<uint32_t>& cpus) { m_consumerCpus = cpus; }
+
+    /** @brief Retrieves the number of ring buffers (one per NUMA node in NUMA-aware mode). */
+    inline uint32_t getNodeCount() const { return m_nodeCount; }
+
+    /** @brief Retrieves the number of log records delivered by the log thread of a NUMA node. */
+    uint64_t getNodeMsgCount(uint32_t node) const;
+
 private:
     /** @brief Order the log target to start (required for threaded targets). */
     bool startLogTarget() final;
@@ -92,9 +133,15 @@ private:
      */
     bool writeLogRecord(const ELogRecord& logRecord, uint64_t& bytesWritten) final;
 
-    /** @brief Orders a buffered log target to flush it log messages. */
+    /**
+     * @brief Orders a buffered log target to flush it log messages. A flush request is posted to
+     * all ring buffers (there is no waiting for flush to complete).
+     */
     bool flushLogTarget() final;
 
+    /** @brief Prints per-node throughput statistics. */
+    void printTargetStats(ELogBuffer& buffer) final;
+
 private:
     enum EntryState : uint64_t { ES_VACANT, ES_WRITING, ES_READY, ES_READING };
     struct ELogRecordData {
@@ -102,7 +149,7 @@ private:
         ELogRecord m_logRecord;
         ELogBuffer* m_logBuffer;
         std::atomic<EntryState> m_entryState;
-        uint64_t m_padding[6];
+        uint64_t m_padding[5];
         // NOTE: each record data takes 2 cache lines
 
         ELogRecordData() : m_logBuffer(nullptr), m_entryState(ES_VACANT) {}
@@ -114,23 +161,64 @@ private:
         inline void setLogBuffer(ELogBuffer* logBuffer) { m_logBuffer = logBuffer; }
     };
 
-    ELOG_CACHE_ALIGN ELogRecordData* m_ringBuffer;
-    ELogBuffer* m_bufferArray;
+    // the ring buffer of a single NUMA node (or the single ring buffer if not NUMA-aware)
+    struct NodeRing {
+        ELogRecordData* m_ringBuffer;
+        ELogBuffer* m_bufferArray;
+        uint32_t m_node;
+        uint32_t m_numaNode;
+
+        // NOTE: write pos is usually very noisy, so we don't want it to affect read pos, which
+        // usually is much slower, therefore, we put read pos in a separate cache line
+        // in addition, ring buffer ptr, buffer array ptr and size are not changing, so they are
+        // good cache candidates, so we would like to keep them unaffected as well, so we put write
+        // pos also in it sown cache line
+        ELOG_CACHE_ALIGN std::atomic<uint64_t> m_writePos;
+        ELOG_CACHE_ALIGN std::atomic<uint64_t> m_readPos;
+
+        // number of log records delivered by the log thread (statistics)
+        ELOG_CACHE_ALIGN std::atomic<uint64_t> m_msgCount;
+
+        std::thread m_logThread;
+
+        NodeRing()
+            : m_ringBuffer(nullptr),
+              m_bufferArray(nullptr),
+              m_node(0),
+              m_numaNode(0),
+              m_writePos(0),
+              m_readPos(0),
+              m_msgCount(0) {}
+        NodeRing(const NodeRing&) = delete;
+        NodeRing(NodeRing&&) = delete;
+        NodeRing& operator=(const NodeRing&) = delete;
+        ~NodeRing() {}
+    };
+
+    NodeRing* m_nodeRings;
+    uint32_t m_nodeCount;
+    uint32_t m_nodeCountOverride;
+    uint32_t m_numaNodeCount;
     uint64_t m_ringBufferSize;
     uint64_t m_collectPeriodMicros;
-
-    // NOTE: write pos is usually very noisy, so we don't want it to affect read pos, which usually
-    // is much slower, therefore, we put read pos in a separate cache line
-    // in addition, ring buffer ptr, buffer array ptr and size are not changing, so they are good
-    // cache candidates, so we would like to keep them unaffected as well, so we put write pos also
-    // in it sown cache line
-    ELOG_CACHE_ALIGN std::atomic<uint64_t> m_writePos;
-    ELOG_CACHE_ALIGN std::atomic<uint64_t> m_readPos;
+    bool m_numaAware;
+    std::vector<uint32_t> m_consumerCpus;
     // CongestionPolicy m_congestionPolicy;
 
-    std::thread m_logThread;
+    // serializes access to the subordinate log target when there are several log threads
+    std::mutex m_mergeLock;
+
+    // start time and total run time of the log threads, and per-node log record count of the
+    // last run (for throughput statistics)
+    uint64_t m_startTimeNanos;
+    uint64_t m_runTimeNanos;
+    std::vector<uint64_t> m_nodeMsgCounts;
 
-    void logThread();
+    bool allocNodeRing(NodeRing& nodeRing);
+    void freeNodeRing(NodeRing& nodeRing);
+    void freeNodeRings();
+    void writeNodeRing(NodeRing& nodeRing, const ELogRecord& logRecord);
+    void logThread(NodeRing* nodeRing);
 };
 
 }  // namespace elog
@@ -36,6 +36,8 @@ public:
 protected:
     void waitQueue(std::unique_lock<std::mutex>& lock) final;
 
+    bool shouldNotify(bool wasEmpty, uint64_t queueSize) final;
+
 private:
     typedef std::chrono::time_point<std::chrono::steady_clock> Timestamp;
     typedef std::chrono::milliseconds Millis;
@@ -0,0 +1,160 @@
+#ifndef __ELOG_COLUMNAR_BATCH_H__
+#define __ELOG_COLUMNAR_BATCH_H__
+
+#include <string>
+#include <vector>
+
+#include "db/elog_db_formatter.h"
+#include "elog_field_selector.h"
+#include "elog_record.h"
+
+namespace elog {
+
+class ELogColumnReceptor;
+
+/**
+ * @brief A column-oriented batch of log records. Given a batch of log records and the field list
+ * of a parsed insert statement (see @ref ELogDbFormatter::prepareColumnarBatch()), the batch
+ * stores each field in a per-column array: integers and date-time values (as UNIX time
+ * nanoseconds) in 64 bit arrays, log levels in a log level array, and strings as offset/length
+ * pairs into one string heap shared by all columns of the batch.
+ *
+ * The batch is filled in a single pass over the records, each record filling all columns, so each
+ * record is brought into cache only once. Time, log level, thread id and record id columns are
+ * read directly from the log records, while all other columns go through the field selector.
+ *
+ * String offsets are 32 bit, so the string heap of a batch is limited to 4 GB. When a record does
+ * not fit, appending stops before that record (see @ref appendLogRecords()).
+ *
+ * Batched database inserts, columnar file formats and analytics exporters can consume the column
+ * arrays directly. The batch can be cleared and reused, so that after warm-up no memory allocation
+ * takes place.
+ *
+ * @note The batch refers to the field selectors of the formatter that prepared it, so it must not
+ * be used after that formatter is destroyed.
+ */
+class ELOG_API ELogColumnarBatch {
+public:
+    /** @brief A single column in the batch. */
+    class ELOG_API Column {
+    public:
+        Column(const std::string& name, ELogDbFormatter::ParamType paramType,
+               ELogFieldSelector* fieldSelector);
+
+        /** @brief Retrieves the column name (the field name as appears in the statement). */
+        inline const std::string& getName() const { return m_name; }
+
+        /** @brief Retrieves the column type. */
+        inline ELogDbFormatter::ParamType getParamType() const { return m_paramType; }
+
+        /**
+         * @brief Retrieves the integer values of the column (for integer columns), or UNIX time
+         * nanoseconds (for date-time columns).
+         */
+        inline const std::vector<uint64_t>& getIntValues() const { return m_intValues; }
+
+        /** @brief Retrieves the log level values of the column (for log level columns). */
+        inline const std::vector<ELogLevel>& getLogLevelValues() const { return m_levelValues; }
+
+        /** @brief Retrieves the offsets into the batch string heap (for text columns). */
+        inline const std::vector<uint32_t>& getTextOffsets() const { return m_textOffsets; }
+
+        /** @brief Retrieves the string lengths (for text columns). */
+        inline const std::vector<uint32_t>& getTextLengths() const { return m_textLengths; }
+
+    private:
+        /** @enum Specifies from where column values are taken. */
+        enum class ValueSource : uint32_t {
+            VS_SELECTOR,
+            VS_LOG_TIME,
+            VS_LOG_LEVEL,
+            VS_THREAD_ID,
+            VS_RECORD_ID
+        };
+
+        std::string m_name;
+        ELogDbFormatter::ParamType m_paramType;
+        ELogFieldSelector* m_fieldSelector;
+        ValueSource m_valueSource;
+
+        std::vector<uint64_t> m_intValues;
+        std::vector<ELogLevel> m_levelValues;
+        std::vector<uint32_t> m_textOffsets;
+        std::vector<uint32_t> m_textLengths;
+
+        void clear();
+        void truncate(size_t rowCount);
+        void reserve(size_t rowCount);
+
+        friend class ELogColumnarBatch;
+        friend class ELogColumnReceptor;
+    };
+
+    ELogColumnarBatch() : m_rowCount(0) {}
+    ELogColumnarBatch(const ELogColumnarBatch&) = delete;
+    ELogColumnarBatch(ELogColumnarBatch&&) = delete;
+    ELogColumnarBatch& operator=(const ELogColumnarBatch&) = delete;
+    ~ELogColumnarBatch() {}
+
+    /** @brief Adds a column to the batch. Normally called by the database formatter. */
+    void addColumn(const std::string& name, ELogDbFormatter::ParamType paramType,
+                   ELogFieldSelector* fieldSelector);
+
+    /** @brief Removes all columns from the batch. */
+    void reset();
+
+    /**
+     * @brief Reserves memory for a number of rows in all columns (not including the string heap).
+     * Should be called after the columns are added.
+     */
+    void reserve(size_t rowCount);
+
+    /** @brief Clears all rows, keeping columns and allocated memory for reuse. */
+    void clear();
+
+    /**
+     * @brief Appends log records to the batch.
+     * @param logRecords The log record array.
+     * @param count The number of log records in the array.
+     * @return The number of log records appended. This is less than the requested count only if
+     * the string heap is full, in which case the batch should be consumed and cleared before
+     * appending the rest of the log records.
+     */
+    size_t appendLogRecords(const ELogRecord* logRecords, size_t count);
+
+    /** @brief Retrieves the number of rows (log records) in the batch. */
+    inline size_t getRowCount() const { return m_rowCount; }
+
+    /** @brief Retrieves the number of columns in the batch. */
+    inline size_t getColumnCount() const { return m_columns.size(); }
+
+    /** @brief Retrieves a column by index. */
+    inline const Column& getColumn(size_t columnId) const { return m_columns[columnId]; }
+
+    /** @brief Retrieves the string heap shared by all text columns. */
+    inline const std::string& getStringHeap() const { return m_stringHeap; }
+
+    /**
+     * @brief Retrieves a string value from a text column.
+     * @param columnId The column index.
+     * @param rowId The row index.
+     * @param[out] length The string length.
+     * @return The string value (not null-terminated).
+     */
+    inline const char* getString(size_t columnId, size_t rowId, size_t& length) const {
+        const Column& column = m_columns[columnId];
+        length = column.m_textLengths[rowId];
+        return m_stringHeap.data() + column.m_textOffsets[rowId];
+    }
+
+private:
+    std::vector<Column> m_columns;
+    std::string m_stringHeap;
+    size_t m_rowCount;
+
+    void appendValue(Column& column, const ELogRecord& logRecord, ELogColumnReceptor& receptor);
+};
+
+}  // namespace elog
+
+#endif  // __ELOG_COLUMNAR_BATCH_H__
@@ -5,6 +5,9 @@
 
 namespace elog {
 
+// forward declaration
+class ELOG_API ELogColumnarBatch;
+
 class ELOG_API ELogDbFormatter : public ELogFormatter {
 public:
     /** @enum Prepared statement processing style. */
@@ -63,6 +66,24 @@ public:
 
     void getParamTypes(std::vector<ParamType>& paramTypes) const;
 
+    /**
+     * @brief Prepares a columnar batch with one column per insert statement field (static text
+     * and format fields do not generate columns). Any previous columns of the batch are removed.
+     */
+    void prepareColumnarBatch(ELogColumnarBatch& batch) const;
+
+    /**
+     * @brief Fills a columnar batch with log records, in a single pass over the log records. If
+     * the batch has no columns, it is first prepared with the insert statement field list.
+     * @param logRecords The log record array.
+     * @param count The number of log records in the array.
+     * @param batch The batch to fill. Log records are appended to any existing rows.
+     * @return The number of log records appended. This is less than the requested count only if
+     * the batch string heap is full (see @ref ELogColumnarBatch::appendLogRecords()).
+     */
+    size_t fillColumnarBatch(const ELogRecord* logRecords, size_t count,
+                             ELogColumnarBatch& batch) const;
+
 protected:
     bool handleText(const std::string& text) override;
 
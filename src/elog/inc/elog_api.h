@@ -258,6 +258,22 @@ extern ELOG_API void disableLazyTimeSource();
  */
 extern ELOG_API void configureLazyTimeSource(uint64_t resolution, ELogTimeUnits resolutionUnits);
 
+/**
+ * @brief Sets the time capture mode of log records, which applies when the lazy time source is
+ * disabled. When switching to TSC mode, the TSC clock is calibrated first (which takes several
+ * milliseconds).
+ */
+extern ELOG_API void setTimeCaptureMode(ELogTimeCaptureMode timeCaptureMode);
+
+/** @brief Retrieves the time capture mode of log records. */
+extern ELOG_API ELogTimeCaptureMode getTimeCaptureMode();
+
+/**
+ * @brief Retrieves the current time, exactly as it is captured in log records (i.e. according to
+ * the lazy time source and the time capture mode).
+ */
+extern ELOG_API void getCurrentLogTime(ELogTime& logTime);
+
 /**************************************************************************************
  *
  *                              Life-Sign Interface
@@ -1210,6 +1226,31 @@ extern ELOG_API bool configureRateLimit(const char* rateLimitCfg, bool replaceGl
 extern ELOG_API bool setRateLimit(uint64_t maxMsg, uint64_t timeout, ELogTimeUnits timeoutUnits,
                                   bool replaceGlobalFilter = true);
 
+/** @brief Configures call site rate limit form configuration string (max-msg:timeout:units). */
+extern ELOG_API bool configureCallSiteRateLimit(const char* rateLimitCfg);
+
+/**
+ * @brief Sets a rate limit applied separately to each log call site (file and line). This is
+ * useful for stopping log storms coming from call sites that were not anticipated (as opposed to
+ * @ref ELOG_MODERATE_EX() which is placed by the developer). Call site message counts are
+ * estimated with a fixed-size count-min sketch, and each thread reserves messages of a call site in
+ * small chunks, so the limit may occasionally be applied early to some call sites, but never late.
+ * Suppression takes place before message formatting, and a
+ * summary of suppressed messages per call site is reported through ELog's internal reporting
+ * channel (see @ref setReportHandler()) when each time window ends.
+ * @param maxMsg The maximum number of messages a single call site may issue in a time window.
+ * @param timeout The time window size.
+ * @param timeoutUnits The time window size units.
+ * @return True if the operation succeeded, otherwise false.
+ * @note Messages logged with fmtlib formatting style are formatted before the call site rate
+ * limit is checked, and multi-part messages (see @ref ELogLogger::startLog()) are not limited.
+ */
+extern ELOG_API bool setCallSiteRateLimit(uint64_t maxMsg, uint64_t timeout,
+                                          ELogTimeUnits timeoutUnits);
+
+/** @brief Clears call site rate limit, reporting any pending suppression summary. */
+extern ELOG_API void clearCallSiteRateLimit();
+
 /**
  * @brief Filters a log record.
  * @param logRecord The log record to filter.
@@ -1318,6 +1359,44 @@ extern ELOG_API void getThreadLogStatistics(ELogStatistics& stats);
 /** @brief Retrieves the per-level message count statistics (current thread scope). */
 extern ELOG_API void resetThreadLogStatistics();
 
+/**
+ * @brief Sets the sampling rate of log target latency histograms (write latency, flush latency
+ * and queue residence). Each thread records latency for one in every @ref sampleRate log records
+ * (or flush requests), so that statistics may be left enabled in production. By default the
+ * sampling rate is zero, which disables latency histograms (all other log target statistics are
+ * still collected).
+ * @param sampleRate The sampling rate. Pass 1 to sample all log records, or zero to disable.
+ */
+extern ELOG_API void setStatsLatencySampleRate(uint32_t sampleRate);
+
+/** @brief Retrieves the sampling rate of log target latency histograms. */
+extern ELOG_API uint32_t getStatsLatencySampleRate();
+
+/**************************************************************************************
+ *                          Self Profiling
+ **************************************************************************************/
+
+/**
+ * @brief Queries whether self-profiling is available. Self-profiling is enabled at compile time
+ * with the ELOG_ENABLE_SELF_PROFILE build option. When enabled, the time spent in each log
+ * pipeline stage is measured with the CPU time-stamp counter (on platforms other than x86, the
+ * steady clock is used, and ticks are nanoseconds), and accumulated in per-thread counters.
+ */
+extern ELOG_API bool isSelfProfileEnabled();
+
+/** @brief Retrieves the self-profiling statistics, aggregated over all threads. */
+extern ELOG_API void getSelfProfileStats(ELogProfileStats& stats);
+
+/** @brief Resets the self-profiling statistics of all threads. */
+extern ELOG_API void resetSelfProfileStats();
+
+/**
+ * @brief Prints the self-profiling statistics to ELog's internal log message reporting channel
+ * (see @ref setReportHandler()).
+ * @param reportLevel The log level used for reporting.
+ */
+extern ELOG_API void reportSelfProfileStats(ELogLevel reportLevel = ELEVEL_INFO);
+
 }  // namespace elog
 
 /**************************************************************************************
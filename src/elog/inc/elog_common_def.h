@@ -89,6 +89,40 @@ struct ELOG_API ELogStatistics {
     uint64_t m_msgCount[ELEVEL_COUNT];
 };
 
+/** @enum Log pipeline stages measured by self-profiling (see @ref getSelfProfileStats()). */
+enum class ELogProfileStage : uint32_t {
+    /** @brief Entire log record processing (record finalization, filtering and dispatch). */
+    PS_FINISH_LOG,
+
+    /** @brief Global log filter evaluation. */
+    PS_FILTER,
+
+    /** @brief Log target write (including formatting and flush policy evaluation). */
+    PS_TARGET_LOG,
+
+    /** @brief Log target flush. */
+    PS_TARGET_FLUSH,
+
+    /** @brief Log record formatting by a log target. */
+    PS_FORMAT,
+
+    /** @brief Garbage collector recycling of retired objects. */
+    PS_GC_RECYCLE
+};
+
+/** @def The number of self-profiling stages. */
+#define ELOG_PROFILE_STAGE_COUNT 6
+
+/**
+ * @brief Self-profiling statistics. Contains the accumulated clock ticks and the number of calls
+ * for each log pipeline stage. Stages are nested (e.g. target write includes formatting), so tick
+ * counts are inclusive.
+ */
+struct ELOG_API ELogProfileStats {
+    uint64_t m_ticks[ELOG_PROFILE_STAGE_COUNT];
+    uint64_t m_callCount[ELOG_PROFILE_STAGE_COUNT];
+};
+
 /** @def Invalid cache entry id value. */
 #define ELOG_INVALID_CACHE_ENTRY_ID ((ELogCacheEntryId)0xFFFFFFFF)
 
@@ -163,6 +197,12 @@ private:
 /** @def By default do not enable log statistics. */
 #define ELOG_DEFAULT_ENABLE_LOG_STATISTICS false
 
+/**
+ * @def By default log target latency histograms are disabled, since each sampled log record
+ * requires two clock reads.
+ */
+#define ELOG_DEFAULT_STATS_LATENCY_SAMPLE_RATE 0
+
 /** @def By default do not enable time source. */
 #define ELOG_DEFAULT_ENABLE_TIME_SOURCE false
 
@@ -172,6 +212,30 @@ private:
 /** @brief By default use 100 milli seconds resolution for the time source. */
 #define ELOG_DEFAULT_TIME_SOURCE_UNITS ELogTimeUnits::TU_MILLI_SECONDS
 
+/** @enum Log record time capture mode (applies only when the lazy time source is disabled). */
+enum class ELogTimeCaptureMode : uint32_t {
+    /** @brief Take time from the real-time clock. */
+    TCM_REALTIME,
+
+    /**
+     * @brief Take time from the coarse real-time clock (Linux only, otherwise same as
+     * TCM_REALTIME). This is cheaper, but the resolution is that of the system timer tick
+     * (typically 1-4 milliseconds).
+     */
+    TCM_REALTIME_COARSE,
+
+    /**
+     * @brief Take time from the CPU time-stamp counter, converted to wall-clock time by a
+     * calibrated ratio, which is refreshed periodically against the real-time clock by a
+     * background thread (x86 only, otherwise same as TCM_REALTIME). This provides high resolution
+     * with very low cost, but timestamps may deviate slightly from the real-time clock.
+     */
+    TCM_TSC
+};
+
+/** @def By default take time from the real-time clock. */
+#define ELOG_DEFAULT_TIME_CAPTURE_MODE ELogTimeCaptureMode::TCM_REALTIME
+
 /** @def Default value of life-sign usage. */
 #define ELOG_DEFAULT_ENABLE_LIFE_SIGN true
 
@@ -274,6 +338,24 @@ struct ELogFrequencySpec {
 #define ELOG_DEFAULT_ETCD_EXPIRY_RENEW_SECONDS 2
 #endif
 
+/** @enum Garbage collector reclamation mode. */
+enum class ELogGCMode : uint32_t {
+    /**
+     * @brief Each read-side critical section increments a shared epoch counter, and registers its
+     * end in a shared rolling bit-set. Objects are recycled when all preceding critical sections
+     * have ended.
+     */
+    GM_EPOCH_SET,
+
+    /**
+     * @brief Quiescent-state based reclamation: each read-side critical section only publishes
+     * the current epoch in a cache-line padded per-thread slot, so no shared memory is modified on
+     * the read side. Objects are recycled by scanning the slots of all threads for the minimum
+     * active epoch. This scales much better with many logging threads.
+     */
+    GM_THREAD_EPOCH
+};
+
 #ifdef ELOG_ENABLE_DYNAMIC_CONFIG
 /**
  * @brief Default value for maximum number of log targets, when dynamic log target configuration is
@@ -286,6 +368,9 @@ struct ELogFrequencySpec {
 
 /** @def Default number of log target GC tasks. */
 #define ELOG_DEFAULT_LOG_TARGET_GC_TASK_COUNT 1
+
+/** @def Default log target GC reclamation mode. */
+#define ELOG_DEFAULT_LOG_TARGET_GC_MODE ELogGCMode::GM_THREAD_EPOCH
 #endif
 
 }  // namespace elog
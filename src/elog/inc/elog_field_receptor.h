@@ -59,6 +59,24 @@ public:
         return receiveIntField(typeId, timeEpochMicros, fieldSpec);
     }
 
+    /** @brief Receives the time in nanoseconds elapsed since process start. */
+    virtual void receiveRelativeTime(uint32_t typeId, uint64_t relativeTimeNanos,
+                                     const ELogFieldSpec& fieldSpec) {
+        return receiveIntField(typeId, relativeTimeNanos, fieldSpec);
+    }
+
+    /** @brief Receives the time in nanoseconds elapsed since the log source was created. */
+    virtual void receiveSourceRelativeTime(uint32_t typeId, uint64_t relativeTimeNanos,
+                                           const ELogFieldSpec& fieldSpec) {
+        return receiveIntField(typeId, relativeTimeNanos, fieldSpec);
+    }
+
+    /** @brief Receives the time in nanoseconds elapsed since the previous record of the thread. */
+    virtual void receiveThreadDelta(uint32_t typeId, uint64_t deltaNanos,
+                                    const ELogFieldSpec& fieldSpec) {
+        return receiveIntField(typeId, deltaNanos, fieldSpec);
+    }
+
     /** @brief Receives the log record id. */
     virtual void receiveRecordId(uint32_t typeId, uint64_t recordId,
                                  const ELogFieldSpec& fieldSpec) {
@@ -1,6 +1,7 @@
 #ifndef __ELOG_FIELD_SELECTOR_H___
 #define __ELOG_FIELD_SELECTOR_H___
 
+#include <atomic>
 #include <vector>
 
 #include "elog_field_receptor.h"
@@ -236,6 +237,87 @@ private:
     ELOG_DECLARE_FIELD_SELECTOR(ELogTimeEpochSelector, time_epoch, ELOG_API)
 };
 
+/** @brief Selects the time elapsed since process start, in nanoseconds. */
+class ELOG_API ELogRelativeTimeSelector final : public ELogFieldSelector {
+public:
+    ELogRelativeTimeSelector(const ELogFieldSpec& fieldSpec)
+        : ELogFieldSelector(ELogFieldType::FT_INT, fieldSpec) {}
+    ELogRelativeTimeSelector(const ELogRelativeTimeSelector&) = delete;
+    ELogRelativeTimeSelector(ELogRelativeTimeSelector&&) = delete;
+    ELogRelativeTimeSelector& operator=(const ELogRelativeTimeSelector&) = delete;
+
+    void selectField(const ELogRecord& record, ELogFieldReceptor* receptor) final;
+
+    /** @brief Computes the time in nanoseconds elapsed since process start till record time. */
+    static uint64_t getRelativeTimeNanos(const ELogRecord& record);
+
+private:
+    ELOG_DECLARE_FIELD_SELECTOR(ELogRelativeTimeSelector, rel_time, ELOG_API)
+};
+
+/** @brief Selects the time elapsed since the log source of the record was created. */
+class ELOG_API ELogSourceRelativeTimeSelector final : public ELogFieldSelector {
+public:
+    ELogSourceRelativeTimeSelector(const ELogFieldSpec& fieldSpec)
+        : ELogFieldSelector(ELogFieldType::FT_INT, fieldSpec) {}
+    ELogSourceRelativeTimeSelector(const ELogSourceRelativeTimeSelector&) = delete;
+    ELogSourceRelativeTimeSelector(ELogSourceRelativeTimeSelector&&) = delete;
+    ELogSourceRelativeTimeSelector& operator=(const ELogSourceRelativeTimeSelector&) = delete;
+
+    void selectField(const ELogRecord& record, ELogFieldReceptor* receptor) final;
+
+    /**
+     * @brief Computes the time in nanoseconds elapsed since the log source of the record was
+     * created till record time.
+     */
+    static uint64_t getSourceRelativeTimeNanos(const ELogRecord& record);
+
+private:
+    ELOG_DECLARE_FIELD_SELECTOR(ELogSourceRelativeTimeSelector, src_rel_time, ELOG_API)
+};
+
+/**
+ * @brief Selects the time elapsed since the previous record of the same thread, in nanoseconds.
+ * The delta is computed by the logging thread when the record is captured, and is stored in the
+ * record, so it is correct regardless of which thread formats the record (e.g. consumer thread of
+ * an asynchronous log target, or a thread formatting on behalf of others). Capturing starts when
+ * the first thread delta selector is created, so the first record of each thread after that has
+ * zero delta.
+ */
+class ELOG_API ELogThreadDeltaSelector final : public ELogFieldSelector {
+public:
+    ELogThreadDeltaSelector(const ELogFieldSpec& fieldSpec)
+        : ELogFieldSelector(ELogFieldType::FT_INT, fieldSpec) {
+        sCaptureEnabled.store(true, std::memory_order_relaxed);
+    }
+    ELogThreadDeltaSelector(const ELogThreadDeltaSelector&) = delete;
+    ELogThreadDeltaSelector(ELogThreadDeltaSelector&&) = delete;
+    ELogThreadDeltaSelector& operator=(const ELogThreadDeltaSelector&) = delete;
+
+    void selectField(const ELogRecord& record, ELogFieldReceptor* receptor) final;
+
+    /** @brief Retrieves the time in nanoseconds since the previous record of the same thread. */
+    inline static uint64_t getThreadDeltaNanos(const ELogRecord& record) {
+        return record.m_threadDeltaNanos;
+    }
+
+    /** @brief Queries whether thread delta should be captured by logging threads. */
+    inline static bool isCaptureEnabled() {
+        return sCaptureEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Computes the thread delta of a record being captured (called by the logging thread,
+     * after the record time was captured).
+     */
+    static void captureThreadDelta(ELogRecord& record);
+
+private:
+    static std::atomic<bool> sCaptureEnabled;
+
+    ELOG_DECLARE_FIELD_SELECTOR(ELogThreadDeltaSelector, thread_delta, ELOG_API)
+};
+
 class ELOG_API ELogHostNameSelector final : public ELogFieldSelector {
 public:
     ELogHostNameSelector(const ELogFieldSpec& fieldSpec)
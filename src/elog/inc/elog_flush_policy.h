@@ -24,8 +24,9 @@ namespace elog {
 /** @def Default group flush timeout (microseconds). */
 #define ELOG_DEFAULT_GROUP_FLUSH_TIME_MICROS 200
 
-// forward declaration
+// forward declarations
 class ELOG_API ELogTarget;
+class ELogTimerTask;
 
 /**
  * @brief Flush policy. As some log targets are buffered, a flush policy should be defined to govern
@@ -465,14 +466,12 @@ private:
 
     uint64_t m_logTimeLimitMillis;
     std::atomic<ELogTime> m_prevFlushTime;
-    std::mutex m_lock;
-    std::condition_variable m_cv;
-    bool m_stopTimer;
-    std::thread m_timerThread;
+    ELogTimerTask* m_flushTimer;
 
-    void onTimer();
+    /** @brief Flushes the log target if required (called by the shared flush thread). */
+    void execTimedFlush();
 
-    bool shouldStop();
+    friend class ELogFlushExecutor;
 
     ELOG_DECLARE_FLUSH_POLICY(ELogTimedFlushPolicy, time, ELOG_API)
 };
@@ -552,6 +551,18 @@ private:
     ELOG_DECLARE_FLUSH_POLICY(ELogChainedFlushPolicy, CHAIN, ELOG_API)
 };
 
+/**
+ * @class A moderating flush policy that groups concurrent flush requests, so that a single flush
+ * serves a group of threads. The first thread to request flush becomes the group leader, and waits
+ * until either the group is full, or the group timeout expires, and then executes flush on behalf
+ * of all group members.
+ *
+ * @note Group timeouts of at least one timer tick (1 millisecond) are waited for on the shared
+ * timer service, which rounds the timeout up to whole ticks and adds one more tick, so a timeout
+ * of N milliseconds expires after N to N+1 milliseconds. Shorter timeouts (including the default
+ * timeout) are waited for with a timed condition variable wait, at the resolution of the system
+ * clock.
+ */
 class ELOG_API ELogGroupFlushPolicy final : public ELogFlushPolicy {
 public:
     ELogGroupFlushPolicy(uint32_t groupSize = ELOG_DEFAULT_GROUP_FLUSH_SIZE,
@@ -559,6 +570,7 @@ public:
         : ELogFlushPolicy(ELogGroupFlushPolicy::TYPE_NAME),
           m_groupSize(groupSize),
           m_groupTimeoutMicros(groupTimeoutMicros),
+          m_deadlineTimer(nullptr),
           m_currentGroup(nullptr),
           m_epoch(0) {}
     ELogGroupFlushPolicy(const ELogGroupFlushPolicy&) = delete;
@@ -602,9 +614,14 @@ private:
     uint64_t m_groupSize;
     Micros m_groupTimeoutMicros;
 
+    // deadline timer task, shared by all groups of the policy (defined in source file)
+    class DeadlineTimer;
+    DeadlineTimer* m_deadlineTimer;
+
     class Group : public ELogManagedObject {
     public:
-        Group(ELogTarget* logTarget, uint64_t groupSize, Micros groupTimeoutMicros);
+        Group(ELogTarget* logTarget, uint64_t groupSize, Micros groupTimeoutMicros,
+              DeadlineTimer* deadlineTimer);
         Group(const Group&) = delete;
         Group(Group&&) = delete;
         Group& operator=(const Group&) = delete;
@@ -614,6 +631,9 @@ private:
         bool execLeader();
         void execFollower();
 
+        /** @brief Notifies the group leader that the group timeout expired. */
+        void onDeadline();
+
     private:
         ELogTarget* m_logTarget;
         uint64_t m_groupSize;
@@ -623,6 +643,12 @@ private:
         std::mutex m_lock;
         std::condition_variable m_cv;
         uint32_t m_leaderThreadId;
+
+        // policy deadline timer (null if the group timeout is shorter than one timer tick)
+        DeadlineTimer* m_deadlineTimer;
+        bool m_deadlineExpired;
+
+        void waitGroupDeadline();
     };
 
     ELogGC m_gc;
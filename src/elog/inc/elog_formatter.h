@@ -21,7 +21,8 @@ namespace elog {
 /** @class Utility class for formatting log messages. */
 class ELOG_API ELogFormatter : public ELogManagedObject {
 public:
-    ELogFormatter(const char* typeName = ELOG_DEFAULT_FORMATTER_TYPE_NAME) : m_typeName(typeName) {}
+    ELogFormatter(const char* typeName = ELOG_DEFAULT_FORMATTER_TYPE_NAME)
+        : m_compiledMode(true), m_compiledSelectorCount(0), m_typeName(typeName) {}
     ELogFormatter(const ELogFormatter&) = delete;
     ELogFormatter(ELogFormatter&&) = delete;
     ELogFormatter& operator=(const ELogFormatter&) = delete;
@@ -71,6 +72,20 @@ public:
     /** @brief Retrieves the type name of the formatter. */
     inline const char* getTypeName() const { return m_typeName.c_str(); }
 
+    /**
+     * @brief Enables or disables compiled formatting mode (enabled by default). In compiled mode
+     * the field selectors are transformed after parsing into a flat instruction list, in which
+     * process-constant fields (host, user, OS name/version, program name, process id) are
+     * pre-rendered into static text. The instruction list is then executed by a single loop that
+     * writes directly into the output string/buffer, avoiding the virtual selector/receptor calls
+     * per field. Selectors that cannot be compiled (e.g. conditional or custom selectors) are
+     * still called through a receptor, so the result is identical in both modes.
+     */
+    inline void setCompiledMode(bool compiledMode) { m_compiledMode = compiledMode; }
+
+    /** @brief Queries whether compiled formatting mode is enabled. */
+    inline bool isCompiledMode() const { return m_compiledMode; }
+
 protected:
     ~ELogFormatter() override;
 
@@ -131,8 +146,58 @@ private:
     ELogFieldSelector* loadSelector(const std::string& selectorSpecStr);
     ELogFieldSelector* loadConstSelector(const std::string& fieldSpecStr);
 
+    /** @enum Compiled formatting instruction codes. */
+    enum class OpCode : uint32_t {
+        OP_STATIC_TEXT,
+        OP_RECORD_ID,
+        OP_TIME,
+        OP_TIME_EPOCH,
+        OP_REL_TIME,
+        OP_SOURCE_REL_TIME,
+        OP_THREAD_DELTA,
+        OP_APP_NAME,
+        OP_THREAD_ID,
+        OP_THREAD_NAME,
+        OP_SOURCE,
+        OP_MODULE,
+        OP_FILE,
+        OP_LINE,
+        OP_FUNCTION,
+        OP_LEVEL,
+        OP_MSG,
+        OP_SELECTOR
+    };
+
+    /** @struct A single compiled formatting instruction. */
+    struct Instruction {
+        OpCode m_opCode;
+
+        /** @var Specifies whether the field spec has no justification and no text formatting. */
+        bool m_isPlain;
+
+        /** @var Pre-rendered text (static text instruction only). */
+        std::string m_text;
+
+        /** @var The originating field selector (not used by static text instruction). */
+        ELogFieldSelector* m_selector;
+    };
+
+    bool m_compiledMode;
+    std::vector<Instruction> m_instructions;
+    size_t m_compiledSelectorCount;
     std::string m_typeName;
 
+    void compileFieldSelectors();
+    void compileFieldSelector(ELogFieldSelector* fieldSelector);
+    void addStaticText(const std::string& text);
+
+    inline bool canUseInstructions() const {
+        return m_compiledMode && m_compiledSelectorCount == m_fieldSelectors.size();
+    }
+
+    template <typename T>
+    void executeInstructions(const ELogRecord& logRecord, T& output);
+
     friend ELOG_API void destroyLogFormatter(ELogFormatter* formatter);
 };
 
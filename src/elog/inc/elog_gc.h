@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "elog_atomic.h"
+#include "elog_common_def.h"
 #include "elog_def.h"
 #include "elog_managed_object.h"
 #include "elog_rolling_bitset.h"
@@ -25,12 +26,17 @@ public:
     ELogGC()
         : m_name("elog-gc"),
           m_id(0),
+          m_generation(0),
           m_gcFrequency(0),
           m_gcPeriodMillis(0),
           m_gcThreadCount(0),
           m_maxThreads(0),
+          m_mode(ELogGCMode::GM_EPOCH_SET),
           m_retireCount(0),
           m_done(false),
+          m_readerSlots(nullptr),
+          m_threadEpoch(0),
+          m_overflowReaders(0),
           m_traceLogger(nullptr),
           m_tlsKey(ELOG_INVALID_TLS_KEY) {}
     ELogGC(const ELogGC&) = delete;
@@ -65,6 +71,9 @@ public:
      * transaction span exceeds this limit (i.e. when some long running transaction fails to end in
      * time), then new transaction will be blocked when calling @ref endEpoch(), until the long
      * running transaction finishes.
+     * @param mode Optionally specifies the reclamation mode. In thread epoch mode, the epoch
+     * counter passed to @ref enterEpoch() is not used (the GC maintains its own epoch counter), and
+     * the epoch passed to @ref retire() is ignored.
      *
      * @note Either one or both of cooperative and background garbage collection can be configured.
      * In case background garbage collection is used, a matching call to @ref start() and @ref
@@ -72,7 +81,7 @@ public:
      */
     bool initialize(const char* name, uint32_t maxThreads, uint32_t gcFrequency,
                     uint32_t gcPeriodMillis = 0, uint32_t gcThreadCount = 0,
-                    uint32_t maxTxnSpan = 0);
+                    uint32_t maxTxnSpan = 0, ELogGCMode mode = ELogGCMode::GM_EPOCH_SET);
 
     /** @brief Starts all background garbage collection threads. */
     void start();
@@ -89,6 +98,18 @@ public:
     /** @brief Let GC know that a transaction with the given epoch just ended. */
     void endEpoch(uint64_t epoch);
 
+    /**
+     * @brief Enters a read-side critical section (may be nested). In epoch set mode, this
+     * increments the given epoch counter and calls @ref beginEpoch(). In thread epoch mode, this
+     * only publishes the current epoch in the calling thread's slot.
+     * @param epoch The epoch counter associated with this garbage collector.
+     * @return The epoch of the critical section, to be passed to @ref leaveEpoch().
+     */
+    uint64_t enterEpoch(std::atomic<uint64_t>& epoch);
+
+    /** @brief Leaves a read-side critical section previously entered with @ref enterEpoch(). */
+    void leaveEpoch(uint64_t epoch);
+
     /**
      * @brief Retires an object to the garbage collector, to be recycled on a safe point in the
      * future.
@@ -105,6 +126,15 @@ public:
     void recycleRetiredObjects();
 
 private:
+    // per-thread read-side epoch (thread epoch mode), padded to avoid false sharing
+    struct ELOG_CACHE_ALIGN ReaderSlot {
+        std::atomic<uint64_t> m_epoch;
+        std::atomic<uint64_t> m_inUse;
+        uint64_t m_nestLevel;
+        uint64_t m_leaveCount;
+        ReaderSlot() : m_epoch((uint64_t)-1), m_inUse(0), m_nestLevel(0), m_leaveCount(0) {}
+    };
+
     // linked list of retired objects
     struct ManagedObjectList {
         ELogAtomic<uint64_t> m_ownerThreadId;
@@ -115,11 +145,13 @@ private:
 
     // the private garbage collector's name
     std::string m_name;
-    uint32_t m_id;  // global GC id, unique among all GCs
+    uint32_t m_id;  // global GC id, unique among all live GCs (reused after destroy)
+    uint64_t m_generation;  // unique per GC instance, tags per-thread cached slot ids
     uint32_t m_gcFrequency;
     uint32_t m_gcPeriodMillis;
     uint32_t m_gcThreadCount;
     uint32_t m_maxThreads;
+    ELogGCMode m_mode;
     std::atomic<uint64_t> m_retireCount;
     std::vector<std::thread> m_gcThreads;
     std::mutex m_lock;
@@ -138,6 +170,12 @@ private:
     // remember the maximum word used
     std::atomic<uint64_t> m_maxActiveWord;
 
+    // thread epoch mode: per-thread reader slots, GC-owned epoch counter, and number of readers
+    // that could not obtain a slot (while non-zero, recycling is postponed)
+    ReaderSlot* m_readerSlots;
+    ELOG_CACHE_ALIGN std::atomic<uint64_t> m_threadEpoch;
+    ELOG_CACHE_ALIGN std::atomic<uint64_t> m_overflowReaders;
+
     // optional trace logger
     ELogLogger* m_traceLogger;
 
@@ -153,6 +191,13 @@ private:
     // obtains a GC slot for the current thread
     uint64_t obtainSlot();
 
+    // obtains a reader slot for the current thread (thread epoch mode)
+    ReaderSlot* getReaderSlot();
+    void releaseReaderSlot();
+
+    // computes the minimum active epoch
+    uint64_t getMinActiveEpoch();
+
     void setListActive(uint64_t slotId);
     void setListInactive(uint64_t slotId);
     bool isListActive(uint64_t slotId);
@@ -164,24 +209,21 @@ private:
 /** @brief Helper class for managing GC epoch. */
 class ELOG_API ELogScopedEpoch {
 public:
-    ELogScopedEpoch(ELogGC& gc, std::atomic<uint64_t>& epoch) : m_gc(gc), m_epoch(epoch) {
-        m_currentEpoch = m_epoch.fetch_add(1, std::memory_order_relaxed);
-        m_gc.beginEpoch(epoch);
+    ELogScopedEpoch(ELogGC& gc, std::atomic<uint64_t>& epoch) : m_gc(gc) {
+        m_currentEpoch = m_gc.enterEpoch(epoch);
     }
-    ELogScopedEpoch(ELogGC* gc, std::atomic<uint64_t>& epoch) : m_gc(*gc), m_epoch(epoch) {
-        m_currentEpoch = m_epoch.fetch_add(1, std::memory_order_relaxed);
-        m_gc.beginEpoch(epoch);
+    ELogScopedEpoch(ELogGC* gc, std::atomic<uint64_t>& epoch) : m_gc(*gc) {
+        m_currentEpoch = m_gc.enterEpoch(epoch);
     }
     ELogScopedEpoch(const ELogScopedEpoch&) = delete;
     ELogScopedEpoch(ELogScopedEpoch&&) = delete;
     ELogScopedEpoch& operator=(const ELogScopedEpoch&) = delete;
-    ~ELogScopedEpoch() { m_gc.endEpoch(m_currentEpoch); }
+    ~ELogScopedEpoch() { m_gc.leaveEpoch(m_currentEpoch); }
 
     inline uint64_t getCurrentEpoch() const { return m_currentEpoch; }
 
 private:
     ELogGC& m_gc;
-    std::atomic<uint64_t>& m_epoch;
     uint64_t m_currentEpoch;
 };
 
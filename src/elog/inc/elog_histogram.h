@@ -0,0 +1,168 @@
+#ifndef __ELOG_HISTOGRAM_H__
+#define __ELOG_HISTOGRAM_H__
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "elog_def.h"
+
+#ifdef ELOG_MSVC
+#include <intrin.h>
+#endif
+
+namespace elog {
+
+/**
+ * @def The number of sub-bucket bits in a histogram. Each power of two range is divided into
+ * 2^ELOG_HISTOGRAM_SUB_BUCKET_BITS linear sub-buckets, so the relative error of any recorded value
+ * is at most 1/2^ELOG_HISTOGRAM_SUB_BUCKET_BITS (12.5%).
+ */
+#define ELOG_HISTOGRAM_SUB_BUCKET_BITS 3
+
+/** @def The number of sub-buckets in each power of two range. */
+#define ELOG_HISTOGRAM_SUB_BUCKET_COUNT (1u << ELOG_HISTOGRAM_SUB_BUCKET_BITS)
+
+/**
+ * @def The number of magnitude bits covered by a histogram. Larger values are recorded in the last
+ * bucket (with nanosecond units, this amounts to about 18 minutes).
+ */
+#define ELOG_HISTOGRAM_MAGNITUDE_BITS 40
+
+/** @def The total number of buckets in a histogram. */
+#define ELOG_HISTOGRAM_BUCKET_COUNT                                        \
+    ((ELOG_HISTOGRAM_MAGNITUDE_BITS - ELOG_HISTOGRAM_SUB_BUCKET_BITS + 1) * \
+     ELOG_HISTOGRAM_SUB_BUCKET_COUNT)
+
+/** @brief A point-in-time copy of a histogram, possibly merged from several histograms. */
+struct ELOG_API ELogHistogramSnapshot {
+    ELogHistogramSnapshot() : m_count(0), m_sum(0), m_min(0), m_max(0) {}
+
+    /** @brief The number of recorded values. */
+    uint64_t m_count;
+
+    /** @brief The sum of all recorded values. */
+    uint64_t m_sum;
+
+    /** @brief The minimum recorded value. */
+    uint64_t m_min;
+
+    /** @brief The maximum recorded value. */
+    uint64_t m_max;
+
+    /** @brief The bucket counts (empty if no value was recorded). */
+    std::vector<uint64_t> m_buckets;
+
+    /** @brief Merges another snapshot into this snapshot. */
+    void merge(const ELogHistogramSnapshot& snapshot);
+
+    /** @brief Retrieves the average value (zero if empty). */
+    inline uint64_t getMean() const { return m_count > 0 ? m_sum / m_count : 0; }
+
+    /**
+     * @brief Retrieves an approximation of the value at the given percentile (the upper bound of
+     * the bucket containing the percentile, limited by the maximum recorded value).
+     * @param percentile The percentile, in the range [0, 100].
+     */
+    uint64_t getPercentile(double percentile) const;
+};
+
+/**
+ * @brief A log-linear (HDR-style) histogram, designed for one writer thread per slot and many
+ * reader threads. Each thread records values into its own bucket array (allocated on first use),
+ * so recording involves no atomic operations and no shared cache lines. Per-thread arrays are
+ * merged only when a snapshot is taken.
+ */
+class ELOG_API ELogHistogram {
+public:
+    ELogHistogram() : m_threadData(nullptr), m_maxThreads(0) {}
+    ELogHistogram(const ELogHistogram&) = delete;
+    ELogHistogram(ELogHistogram&&) = delete;
+    ELogHistogram& operator=(const ELogHistogram&) = delete;
+    ~ELogHistogram() { terminate(); }
+
+    /** @brief Initializes the histogram. */
+    bool initialize(uint32_t maxThreads);
+
+    /** @brief Terminates the histogram. */
+    void terminate();
+
+    /**
+     * @brief Records a value.
+     * @param slotId The allocated statistics slot for the current thread.
+     * @param value The value to record.
+     */
+    inline void record(uint64_t slotId, uint64_t value) {
+        ThreadData* threadData = m_threadData[slotId].load(std::memory_order_acquire);
+        if (threadData == nullptr) {
+            threadData = allocThreadData(slotId);
+            if (threadData == nullptr) {
+                return;
+            }
+        }
+        threadData->record(value);
+    }
+
+    /** @brief Resets the histogram of a specific thread. */
+    void reset(uint64_t slotId);
+
+    /** @brief Merges all thread histograms into a snapshot. */
+    void getSnapshot(ELogHistogramSnapshot& snapshot) const;
+
+    /** @brief Retrieves the bucket index of a value. */
+    static inline uint32_t getBucketIndex(uint64_t value) {
+        if (value < ELOG_HISTOGRAM_SUB_BUCKET_COUNT) {
+            return (uint32_t)value;
+        }
+#ifdef ELOG_MSVC
+        unsigned long msb = 0;
+        _BitScanReverse64(&msb, value);
+        uint32_t magnitude = (uint32_t)msb;
+#else
+        uint32_t magnitude = 63 - (uint32_t)__builtin_clzll(value);
+#endif
+        if (magnitude >= ELOG_HISTOGRAM_MAGNITUDE_BITS) {
+            return ELOG_HISTOGRAM_BUCKET_COUNT - 1;
+        }
+        uint32_t shift = magnitude - ELOG_HISTOGRAM_SUB_BUCKET_BITS;
+        return (shift + 1) * ELOG_HISTOGRAM_SUB_BUCKET_COUNT +
+               (uint32_t)((value >> shift) & (ELOG_HISTOGRAM_SUB_BUCKET_COUNT - 1));
+    }
+
+    /** @brief Retrieves the upper bound (inclusive) of the values recorded in a bucket. */
+    static uint64_t getBucketUpperBound(uint32_t bucketIndex);
+
+private:
+    struct ELOG_CACHE_ALIGN ThreadData {
+        volatile uint64_t m_count;
+        volatile uint64_t m_sum;
+        volatile uint64_t m_min;
+        volatile uint64_t m_max;
+        volatile uint64_t m_buckets[ELOG_HISTOGRAM_BUCKET_COUNT];
+
+        ThreadData() { reset(); }
+        void reset();
+        inline void record(uint64_t value) {
+            // NOTE: single writer, so plain read-modify-write is enough
+            uint32_t bucketIndex = getBucketIndex(value);
+            m_buckets[bucketIndex] = m_buckets[bucketIndex] + 1;
+            m_count = m_count + 1;
+            m_sum = m_sum + value;
+            if (value < m_min) {
+                m_min = value;
+            }
+            if (value > m_max) {
+                m_max = value;
+            }
+        }
+    };
+
+    std::atomic<ThreadData*>* m_threadData;
+    uint32_t m_maxThreads;
+
+    ThreadData* allocThreadData(uint64_t slotId);
+};
+
+}  // namespace elog
+
+#endif  // __ELOG_HISTOGRAM_H__
@@ -20,6 +20,9 @@
 
 namespace elog {
 
+class ELogSpillFile;
+class ELogTimerTask;
+
 /** @brief An assistant to carry out HTTP client operations. */
 class ELOG_API ELogHttpClientAssistant {
 public:
@@ -66,6 +69,9 @@ public:
           m_assistant(nullptr),
           m_disableResend(false),
           m_backlogSizeBytes(0),
+          m_spillFile(nullptr),
+          m_resendTimer(nullptr),
+          m_resendDue(false),
           m_stopResend(false) {}
 
     ELogHttpClient(const ELogHttpClient&) = delete;
@@ -195,29 +201,51 @@ private:
                     size_t len, const char* contentType);
 
     struct HttpMessage {
+        HttpMessage() {}
         HttpMessage(const char* endpoint, const httplib::Headers& headers, const char* body,
                     size_t len, const char* contentType);
         std::string m_endpoint;
         httplib::Headers m_headers;
         std::vector<char> m_body;
         std::string m_contentType;
+
+        /** @brief Serializes the message into a buffer (for spilling to disk). */
+        void serialize(std::string& buffer) const;
+
+        /** @brief Deserializes the message from a buffer (when replaying spilled messages). */
+        bool deserialize(const std::vector<char>& buffer);
     };
 
     std::list<HttpMessage> m_pendingBackLog;
     std::list<HttpMessage> m_shippingBackLog;
     uint64_t m_backlogSizeBytes;
+
+    // optional disk spill for messages exceeding the backlog size limit (accessed only by the
+    // resend thread)
+    ELogSpillFile* m_spillFile;
     std::mutex m_lock;
     std::condition_variable m_cv;
 
+    // the resend period is kept by a timer task on the timer service, which only wakes up the
+    // resend thread (network I/O takes place only on the resend thread)
+    ELogTimerTask* m_resendTimer;
+    bool m_resendDue;
+
     std::thread m_resendThread;
     bool m_stopResend;
 
+    void onResendTimer();
     void resendThread();
     bool shouldStopResend();
     void stopResendThread();
     void copyPendingBacklog();
     void dropExcessBacklog();
     bool resendShippingBacklog(bool duringShutdown = false);
+    bool resendSpilledBacklog(bool duringShutdown);
+    bool resendMessage(const HttpMessage& msg);
+    bool spillMessage(const HttpMessage& msg);
+
+    friend class ELogHttpResendTimerTask;
 };
 
 }  // namespace elog
@@ -2,6 +2,7 @@
 #define __ELOG_HTTP_CONFIG_H__
 
 #include <cstdint>
+#include <string>
 
 #include "elog_def.h"
 
@@ -26,6 +27,12 @@
  */
 #define ELOG_HTTP_DEFAULT_SHUTDOWN_TIMEOUT_MILLIS 5000
 
+/** @def By default allow for a total 64 MB of backlog payload to be spilled to disk. */
+#define ELOG_HTTP_DEFAULT_SPILL_LIMIT_BYTES (64ull * 1024ull * 1024ull)
+
+/** @def By default use spill file segments of 4 MB. */
+#define ELOG_HTTP_DEFAULT_SPILL_SEGMENT_SIZE_BYTES (4ull * 1024ull * 1024ull)
+
 namespace elog {
 
 /** @brief Pack all HTTP configuration in one place. */
@@ -48,13 +55,27 @@ struct ELOG_API ELogHttpConfig {
     /** @brief The timeout used for final attempt to resend all unsent HTTP messages. */
     uint64_t m_shutdownTimeoutMillis;
 
+    /**
+     * @brief The directory used for spilling the backlog to disk when the backlog size limit is
+     * reached. Empty value disables backlog spilling (excess backlog messages are dropped).
+     */
+    std::string m_spillDir;
+
+    /** @brief The size limit of all backlog spill file segments. */
+    uint64_t m_spillLimitBytes;
+
+    /** @brief The size of each backlog spill file segment. */
+    uint64_t m_spillSegmentSizeBytes;
+
     ELogHttpConfig()
         : m_connectTimeoutMillis(ELOG_HTTP_DEFAULT_CONNECT_TIMEOUT_MILLIS),
           m_writeTimeoutMillis(ELOG_HTTP_DEFAULT_WRITE_TIMEOUT_MILLIS),
           m_readTimeoutMillis(ELOG_HTTP_DEFAULT_READ_TIMEOUT_MILLIS),
           m_resendPeriodMillis(ELOG_HTTP_DEFAULT_RESEND_TIMEOUT_MILLIS),
           m_backlogLimitBytes(ELOG_HTTP_DEFAULT_BACKLOG_LIMIT_BYTES),
-          m_shutdownTimeoutMillis(ELOG_HTTP_DEFAULT_SHUTDOWN_TIMEOUT_MILLIS) {}
+          m_shutdownTimeoutMillis(ELOG_HTTP_DEFAULT_SHUTDOWN_TIMEOUT_MILLIS),
+          m_spillLimitBytes(ELOG_HTTP_DEFAULT_SPILL_LIMIT_BYTES),
+          m_spillSegmentSizeBytes(ELOG_HTTP_DEFAULT_SPILL_SEGMENT_SIZE_BYTES) {}
 };
 
 }  // namespace elog
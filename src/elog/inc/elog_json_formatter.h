@@ -12,7 +12,12 @@ namespace elog {
 
 /**
  * @class A JSON formatter, which takes input as json map, and parses property names and values as
- * field selectors.
+ * field selectors. Log records are formatted as JSON directly into the output string/buffer,
+ * through a streaming JSON writer. If the formatter was initialized with @ref parseJson(), then
+ * each log record is formatted as a JSON object, mapping property names to field values. Otherwise
+ * the log line format specification is regarded as a JSON template, in which static text is
+ * copied as is, and field values are escaped as required for JSON string literals (e.g.
+ * {"msg": "${msg}"}).
  */
 class ELOG_API ELogJsonFormatter final : public ELogFormatter {
 public:
@@ -23,6 +28,20 @@ public:
 
     bool parseJson(const std::string& jsonStr);
 
+    /**
+     * @brief Formats a log record as JSON into a string.
+     * @param logRecord The log record used for formatting.
+     * @param[out] logMsg The resulting formatted log message.
+     */
+    void formatLogMsg(const ELogRecord& logRecord, std::string& logMsg) final;
+
+    /**
+     * @brief Formats a log record as JSON into a log buffer.
+     * @param logRecord The log record used for formatting.
+     * @param[out] logBuffer The resulting formatted log buffer.
+     */
+    void formatLogBuffer(const ELogRecord& logRecord, ELogBuffer& logBuffer) final;
+
     inline void fillInProps(const ELogRecord& logRecord, elog::ELogFieldReceptor* receptor) {
         applyFieldSelectors(logRecord, receptor);
     }
@@ -37,6 +56,9 @@ private:
     nlohmann::json m_jsonField;
     std::vector<std::string> m_propNames;
 
+    template <typename T>
+    void formatJson(const ELogRecord& logRecord, T& output);
+
     ELOG_DECLARE_LOG_FORMATTER(ELogJsonFormatter, json, ELOG_API)
 };
 
@@ -8,6 +8,7 @@
 
 #include "elog_def.h"
 #include "elog_field_receptor.h"
+#include "elog_json_writer.h"
 
 namespace elog {
 
@@ -64,6 +65,17 @@ public:
      */
     bool prepareJsonMap(nlohmann::json& logAttributes, const std::vector<std::string>& propNames);
 
+    /**
+     * @brief Writes the received property values as members of the JSON object currently being
+     * written by a streaming JSON writer.
+     * @param writer The JSON writer.
+     * @param propNames The property names used to compose the map. These normally come from the
+     * JSON formatter.
+     * @return The operation result.
+     */
+    bool writeJsonMap(ELogJsonWriter<std::string>& writer,
+                      const std::vector<std::string>& propNames);
+
     /** @brief Retrieves the received property values. */
     inline const std::vector<std::string>& getPropValues() const { return m_propValues; }
 
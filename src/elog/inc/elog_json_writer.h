@@ -0,0 +1,185 @@
+#ifndef __ELOG_JSON_WRITER_H__
+#define __ELOG_JSON_WRITER_H__
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "elog_buffer.h"
+#include "elog_def.h"
+
+/** @def The maximum nesting depth of objects/arrays supported by the JSON writer. */
+#define ELOG_JSON_WRITER_MAX_DEPTH 64
+
+namespace elog {
+
+/**
+ * @brief Searches for the first character in a string that requires escaping in a JSON string
+ * literal (i.e. double quote, backslash, or a control character). On x86-64 the search uses
+ * SSE2, or AVX2 if supported by the CPU (checked once at run-time).
+ * @param str The string to search.
+ * @param len The string length.
+ * @return The index of the first character that requires escaping, or the string length if none
+ * was found.
+ */
+extern ELOG_API size_t elogJsonFindEscape(const char* str, size_t len);
+
+/** @brief Retrieves the escape sequence of a character requiring escaping in JSON. */
+extern ELOG_API const char* elogJsonGetEscapeSeq(char c, size_t& len);
+
+/** @brief Appends raw data to a string. */
+inline void elogJsonAppend(std::string& output, const char* data, size_t len) {
+    output.append(data, len);
+}
+
+/** @brief Appends raw data to a log buffer (without terminating null). */
+inline void elogJsonAppend(ELogBuffer& output, const char* data, size_t len) {
+    output.appendRaw(data, len);
+}
+
+/**
+ * @brief Appends a string to the output, escaped as required for a JSON string literal (without
+ * the enclosing double quotes). Runs of characters not requiring escaping are copied in bulk.
+ */
+template <typename T>
+inline void elogJsonAppendEscaped(T& output, const char* str, size_t len) {
+    while (len > 0) {
+        size_t pos = elogJsonFindEscape(str, len);
+        if (pos > 0) {
+            elogJsonAppend(output, str, pos);
+        }
+        if (pos == len) {
+            break;
+        }
+        size_t escapeLen = 0;
+        const char* escapeSeq = elogJsonGetEscapeSeq(str[pos], escapeLen);
+        elogJsonAppend(output, escapeSeq, escapeLen);
+        str += pos + 1;
+        len -= pos + 1;
+    }
+}
+
+/**
+ * @brief A streaming JSON writer, which writes directly into a string or a log buffer, without
+ * building any intermediate document object. The writer only takes care of punctuation and
+ * escaping, and does not validate the document structure (e.g. that an object member has a key).
+ * @tparam T The output type, either std::string or @ref ELogBuffer. Pay attention that when
+ * writing into a log buffer, the terminating null is not appended (see @ref finish()).
+ */
+template <typename T>
+class ELogJsonWriter {
+public:
+    explicit ELogJsonWriter(T& output)
+        : m_output(output), m_depth(0), m_afterKey(false), m_hasItems(0) {}
+    ELogJsonWriter(const ELogJsonWriter&) = delete;
+    ELogJsonWriter(ELogJsonWriter&&) = delete;
+    ELogJsonWriter& operator=(const ELogJsonWriter&) = delete;
+    ~ELogJsonWriter() {}
+
+    /** @brief Begins a JSON object. */
+    inline void beginObject() { beginScope('{'); }
+
+    /** @brief Ends a JSON object. */
+    inline void endObject() { endScope('}'); }
+
+    /** @brief Begins a JSON array. */
+    inline void beginArray() { beginScope('['); }
+
+    /** @brief Ends a JSON array. */
+    inline void endArray() { endScope(']'); }
+
+    /** @brief Writes an object member key. Must be followed by a value. */
+    inline void writeKey(const char* key, size_t len = 0) {
+        writeString(key, len);
+        elogJsonAppend(m_output, ":", 1);
+        m_afterKey = true;
+    }
+
+    /** @brief Writes an escaped string value. */
+    inline void writeString(const char* value, size_t len = 0) {
+        prepareValue();
+        if (len == 0) {
+            len = strlen(value);
+        }
+        elogJsonAppend(m_output, "\"", 1);
+        elogJsonAppendEscaped(m_output, value, len);
+        elogJsonAppend(m_output, "\"", 1);
+    }
+
+    /** @brief Writes an integer value. */
+    inline void writeInt(uint64_t value) {
+        prepareValue();
+        char buf[32];
+        std::to_chars_result res = std::to_chars(buf, buf + sizeof(buf), value);
+        elogJsonAppend(m_output, buf, res.ptr - buf);
+    }
+
+    /** @brief Writes a value that is already serialized as JSON. */
+    inline void writeRawValue(const char* json, size_t len) {
+        prepareValue();
+        elogJsonAppend(m_output, json, len);
+    }
+
+    /** @brief Writes an object member with string value. */
+    inline void writeStringMember(const char* key, const char* value, size_t len = 0) {
+        writeKey(key);
+        writeString(value, len);
+    }
+
+    /** @brief Writes an object member with integer value. */
+    inline void writeIntMember(const char* key, uint64_t value) {
+        writeKey(key);
+        writeInt(value);
+    }
+
+    /** @brief Retrieves the current nesting depth. */
+    inline uint32_t getDepth() const { return m_depth; }
+
+    /** @brief Finishes writing into a log buffer by appending the terminating null. */
+    inline void finish() {
+        if constexpr (std::is_same_v<T, ELogBuffer>) {
+            m_output.append("", 0);
+        }
+    }
+
+private:
+    T& m_output;
+    uint32_t m_depth;
+    bool m_afterKey;
+
+    // one bit per nesting level, denoting whether a comma is required before the next value
+    uint64_t m_hasItems;
+
+    inline void prepareValue() {
+        if (m_afterKey) {
+            m_afterKey = false;
+        } else if (m_depth > 0) {
+            uint64_t bit = 1ull << ((m_depth - 1) % ELOG_JSON_WRITER_MAX_DEPTH);
+            if (m_hasItems & bit) {
+                elogJsonAppend(m_output, ",", 1);
+            } else {
+                m_hasItems |= bit;
+            }
+        }
+    }
+
+    inline void beginScope(char c) {
+        prepareValue();
+        elogJsonAppend(m_output, &c, 1);
+        ++m_depth;
+        m_hasItems &= ~(1ull << ((m_depth - 1) % ELOG_JSON_WRITER_MAX_DEPTH));
+    }
+
+    inline void endScope(char c) {
+        elogJsonAppend(m_output, &c, 1);
+        if (m_depth > 0) {
+            --m_depth;
+        }
+    }
+};
+
+}  // namespace elog
+
+#endif  // __ELOG_JSON_WRITER_H__
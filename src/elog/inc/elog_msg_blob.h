@@ -0,0 +1,141 @@
+#ifndef __ELOG_MSG_BLOB_H__
+#define __ELOG_MSG_BLOB_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "elog_def.h"
+#include "elog_record.h"
+
+namespace elog {
+
+/**
+ * @brief An immutable, reference-counted copy of a log record message. When a log record is queued
+ * for later processing (e.g. by a deferred log target, or in a log target's backlog), its message
+ * must outlive the logging thread's buffer, and so it is copied once into a message blob, which is
+ * then shared by all queues holding the record, instead of each queue keeping its own copy.
+ *
+ * Message blobs are allocated from a size-class pool with per-thread caches, so that in steady
+ * state no heap allocation takes place, even when blobs are allocated by logging threads and
+ * released by a background thread.
+ */
+class ELOG_API ELogMsgBlob {
+public:
+    ELogMsgBlob(const ELogMsgBlob&) = delete;
+    ELogMsgBlob(ELogMsgBlob&&) = delete;
+    ELogMsgBlob& operator=(const ELogMsgBlob&) = delete;
+
+    /**
+     * @brief Creates a message blob holding a copy of the given message.
+     * @param msg The message to copy. It may contain null characters (binary log records).
+     * @param length The message length.
+     * @return The message blob (with a reference count of 1), or null if out of memory.
+     */
+    static ELogMsgBlob* create(const char* msg, uint32_t length);
+
+    /** @brief Allocate thread local storage key for per-thread message blob cache. */
+    static bool createPoolKey();
+
+    /** @brief Free thread local storage key for per-thread message blob cache. */
+    static bool destroyPoolKey();
+
+    /** @brief Retrieves the null-terminated message data. */
+    inline const char* getData() const { return (const char*)(this + 1); }
+
+    /** @brief Retrieves the message length (not including terminating null). */
+    inline uint32_t getLength() const { return m_length; }
+
+    /** @brief Adds a reference to the message blob. */
+    inline void addRef() { m_refCount.fetch_add(1, std::memory_order_relaxed); }
+
+    /** @brief Releases a reference, returning the blob to the pool when no longer referenced. */
+    inline void release() {
+        if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            destroy(this);
+        }
+    }
+
+private:
+    ELogMsgBlob(uint32_t length, uint32_t sizeClass)
+        : m_refCount(1), m_length(length), m_sizeClass(sizeClass) {}
+    ~ELogMsgBlob() {}
+
+    static void destroy(ELogMsgBlob* msgBlob);
+
+    // NOTE: message data follows immediately after the header
+    std::atomic<uint32_t> m_refCount;
+    uint32_t m_length;
+    uint32_t m_sizeClass;
+    uint32_t m_padding;
+};
+
+/** @brief A smart reference to a message blob, suitable for keeping in queues. */
+class ELogMsgRef {
+public:
+    ELogMsgRef() : m_msgBlob(nullptr) {}
+
+    /** @brief Adopts a message blob reference (no reference is added). */
+    explicit ELogMsgRef(ELogMsgBlob* msgBlob) : m_msgBlob(msgBlob) {}
+
+    ELogMsgRef(const ELogMsgRef& msgRef) : m_msgBlob(msgRef.m_msgBlob) {
+        if (m_msgBlob != nullptr) {
+            m_msgBlob->addRef();
+        }
+    }
+
+    ELogMsgRef(ELogMsgRef&& msgRef) noexcept : m_msgBlob(msgRef.m_msgBlob) {
+        msgRef.m_msgBlob = nullptr;
+    }
+
+    ~ELogMsgRef() {
+        if (m_msgBlob != nullptr) {
+            m_msgBlob->release();
+        }
+    }
+
+    inline ELogMsgRef& operator=(const ELogMsgRef& msgRef) {
+        ELogMsgRef tmp(msgRef);
+        std::swap(m_msgBlob, tmp.m_msgBlob);
+        return *this;
+    }
+
+    inline ELogMsgRef& operator=(ELogMsgRef&& msgRef) noexcept {
+        std::swap(m_msgBlob, msgRef.m_msgBlob);
+        return *this;
+    }
+
+    /** @brief Retrieves the referenced message data (empty string if there is none). */
+    inline const char* getData() const { return m_msgBlob != nullptr ? m_msgBlob->getData() : ""; }
+
+    /** @brief Retrieves the referenced message length. */
+    inline uint32_t getLength() const { return m_msgBlob != nullptr ? m_msgBlob->getLength() : 0; }
+
+    /** @brief Retrieves the referenced message blob. */
+    inline ELogMsgBlob* getMsgBlob() const { return m_msgBlob; }
+
+private:
+    ELogMsgBlob* m_msgBlob;
+};
+
+/**
+ * @brief Creates a message blob holding a copy of the message of a log record.
+ * @param logRecord The log record.
+ * @return The message blob (with a reference count of 1), or null if out of memory.
+ */
+extern ELOG_API ELogMsgBlob* createLogRecordMsgBlob(const ELogRecord& logRecord);
+
+/**
+ * @brief Retrieves a shared copy of the message of a log record that needs to be queued. If the
+ * log record is currently being dispatched to several log targets, then the message is copied only
+ * once (by the first log target that needs it), and shared by all other log targets. Similarly, a
+ * log record that is dispatched from a queue to another queue shares the same message blob.
+ * @param logRecord The log record.
+ * @return The message reference. On allocation failure the reference is empty.
+ */
+extern ELOG_API ELogMsgRef acquireLogRecordMsg(const ELogRecord& logRecord);
+
+}  // namespace elog
+
+#endif  // __ELOG_MSG_BLOB_H__
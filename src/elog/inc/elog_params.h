@@ -80,11 +80,23 @@ struct ELOG_API ELogParams {
      * @brief The number of log target background garbage collection tasks.
      */
     uint32_t m_logTargetGCTaskCount;
+
+    /**
+     * @brief The reclamation mode of the log target garbage collector. The default thread epoch
+     * mode does not modify any shared memory on the logging hot path.
+     */
+    ELogGCMode m_logTargetGCMode;
 #endif
 
     /** @brief Specifies whether log statistics are enabled (per-level counters). */
     ELogAtomic<bool> m_enableLogStatistics;
 
+    /**
+     * @brief The sampling rate of log target latency histograms (one in every N log records per
+     * thread). Zero disables latency histograms.
+     */
+    ELogAtomic<uint32_t> m_statsLatencySampleRate;
+
     /** @brief Specifies whether a time source is used (better performance, less accuracy). */
     ELogAtomic<bool> m_enableTimeSource;
 
@@ -94,6 +106,9 @@ struct ELOG_API ELogParams {
     /** @brief The time source resolution units. */
     ELogTimeUnits m_timeSourceUnits;
 
+    /** @brief Specifies how time is captured when the time source is disabled. */
+    ELogAtomic<ELogTimeCaptureMode> m_timeCaptureMode;
+
 #ifdef ELOG_ENABLE_LIFE_SIGN
     ELogLifeSignParams m_lifeSignParams;
 #endif
@@ -115,11 +130,14 @@ struct ELOG_API ELogParams {
           m_maxLogTargets(ELOG_DEFAULT_MAX_TARGET_COUNT),
           m_logTargetGCPeriodMillis(ELOG_DEFAULT_LOG_TARGET_GC_PERIOD_MILLIS),
           m_logTargetGCTaskCount(ELOG_DEFAULT_LOG_TARGET_GC_TASK_COUNT),
+          m_logTargetGCMode(ELOG_DEFAULT_LOG_TARGET_GC_MODE),
 #endif
           m_enableLogStatistics(ELOG_DEFAULT_ENABLE_LOG_STATISTICS),
+          m_statsLatencySampleRate(ELOG_DEFAULT_STATS_LATENCY_SAMPLE_RATE),
           m_enableTimeSource(ELOG_DEFAULT_ENABLE_TIME_SOURCE),
           m_timeSourceResolution(ELOG_DEFAULT_TIME_SOURCE_RESOLUTION),
-          m_timeSourceUnits(ELOG_DEFAULT_TIME_SOURCE_UNITS) {
+          m_timeSourceUnits(ELOG_DEFAULT_TIME_SOURCE_UNITS),
+          m_timeCaptureMode(ELOG_DEFAULT_TIME_CAPTURE_MODE) {
     }
     ELogParams(const ELogParams&) = default;
     ELogParams(ELogParams&&) = default;
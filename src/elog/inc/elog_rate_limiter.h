@@ -13,9 +13,18 @@
 // strictly accurate, but we are ok with that.
 // the implementation relies on incoming log messages, instead of independent timer to count each
 // passing second.
+// under heavy multi-threaded logging the shared interval counters become a contention point, so a
+// sharded mode is also provided, in which each thread draws chunks of tokens from the shared
+// sliding window, and consumes them locally.
 
 namespace elog {
 
+/**
+ * @def The default allowed deviation of a sharded rate limiter, in percents of the maximum message
+ * count. This is also the size of the token chunk each thread draws from the shared sliding window.
+ */
+#define ELOG_DEFAULT_RATE_LIMIT_SHARD_ERROR 1
+
 /** @brief Rate limit parameters. */
 struct ELOG_API ELogRateLimitParams {
     /**
@@ -30,9 +39,30 @@ struct ELOG_API ELogRateLimitParams {
     /** @brief The timeout units. */
     ELogTimeUnits m_units;
 
+    /**
+     * @brief Specifies whether the rate limiter is sharded. In sharded mode each thread draws
+     * chunks of tokens from the shared sliding window, and consumes them locally. This reduces
+     * contention on the shared counters, in the expense of some inaccuracy (see @ref
+     * m_shardErrorPercent).
+     */
+    bool m_sharded;
+
+    /**
+     * @brief The token chunk size in sharded mode, in percents of the maximum message count (at
+     * least one message). Tokens held by a thread are counted in the sliding window but may be left
+     * unused, so each logging thread may cause the rate limiter to fall short of the configured
+     * rate by at most this portion.
+     */
+    uint32_t m_shardErrorPercent;
+
     ELogRateLimitParams(uint64_t maxMsg = 0, uint64_t timeout = 0,
-                        ELogTimeUnits units = ELogTimeUnits::TU_NONE)
-        : m_maxMsgs(maxMsg), m_timeout(timeout), m_units(units) {}
+                        ELogTimeUnits units = ELogTimeUnits::TU_NONE, bool sharded = false,
+                        uint32_t shardErrorPercent = ELOG_DEFAULT_RATE_LIMIT_SHARD_ERROR)
+        : m_maxMsgs(maxMsg),
+          m_timeout(timeout),
+          m_units(units),
+          m_sharded(sharded),
+          m_shardErrorPercent(shardErrorPercent) {}
     ELogRateLimitParams(const ELogRateLimitParams&) = default;
     ELogRateLimitParams(ELogRateLimitParams&&) = default;
     ELogRateLimitParams& operator=(const ELogRateLimitParams&) = default;
@@ -43,7 +73,8 @@ struct ELOG_API ELogRateLimitParams {
 class ELOG_API ELogRateLimitFilter final : public ELogCmpFilter {
 public:
     ELogRateLimitFilter(uint64_t maxMsg = 0, uint64_t timeout = 0,
-                        ELogTimeUnits timeoutUnits = ELogTimeUnits::TU_NONE);
+                        ELogTimeUnits timeoutUnits = ELogTimeUnits::TU_NONE, bool sharded = false,
+                        uint32_t shardErrorPercent = ELOG_DEFAULT_RATE_LIMIT_SHARD_ERROR);
     ELogRateLimitFilter(const ELogRateLimitParams& params);
     ELogRateLimitFilter(const ELogRateLimitFilter&) = delete;
     ELogRateLimitFilter(ELogRateLimitFilter&&) = delete;
@@ -63,10 +94,17 @@ public:
      */
     bool filterLogRecord(const ELogRecord& logRecord) final;
 
+    /** @brief Queries whether the rate limiter is sharded. */
+    inline bool isSharded() const { return m_sharded; }
+
 protected:
     uint64_t m_maxMsg;
     uint64_t m_timeout;
     ELogTimeUnits m_timeoutUnits;
+    bool m_sharded;
+    uint32_t m_shardErrorPercent;
+    uint64_t m_shardChunk;
+    uint64_t m_instanceId;
     uint64_t m_intervalMillis;
     std::atomic<uint64_t> m_currIntervalId;
     std::atomic<uint64_t> m_currIntervalCount;
@@ -76,6 +114,18 @@ protected:
 
 private:
     bool prepareInterval();
+    void prepareShards();
+
+    /**
+     * @brief Acquires tokens from the shared sliding window.
+     * @param tstamp The current steady clock time stamp in milliseconds.
+     * @param maxCount The maximum number of tokens to acquire.
+     * @return The number of acquired tokens, or zero if the rate limit was exceeded.
+     */
+    uint64_t acquireTokens(uint64_t tstamp, uint64_t maxCount);
+
+    /** @brief Filters a log record in sharded mode. */
+    bool filterLogRecordSharded();
 };
 
 /** Rate limiter utility class, without ELogFilter's stuff. */
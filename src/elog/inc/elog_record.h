@@ -62,6 +62,13 @@ struct ELOG_API ELogRecord {
     /** @var Reserved for internal use. */
     uint8_t m_reserved;
 
+    /**
+     * @var Time in nanoseconds since the previous record of the issuing thread (word offset: 8).
+     * Captured by the logging thread only if some log target uses the thread_delta field, otherwise
+     * zero.
+     */
+    uint64_t m_threadDeltaNanos;
+
     /** @brief Default constructor. */
     ELogRecord()
         : m_logRecordId(0),
@@ -77,7 +84,8 @@ struct ELOG_API ELogRecord {
           m_logMsgLen(0),
           m_line(0),
           m_flags(0),
-          m_reserved(0) {
+          m_reserved(0),
+          m_threadDeltaNanos(0) {
     }
 
     /** @brief Default copy constructor. */
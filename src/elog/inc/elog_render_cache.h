@@ -0,0 +1,155 @@
+#ifndef __ELOG_RENDER_CACHE_H__
+#define __ELOG_RENDER_CACHE_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "elog_buffer.h"
+#include "elog_def.h"
+#include "elog_field_spec.h"
+#include "elog_msg_blob.h"
+#include "elog_record.h"
+#include "elog_time.h"
+
+/** @def The maximum number of distinct time formats that can be cached per log record. */
+#define ELOG_RENDER_CACHE_TIME_SLOTS 4
+
+namespace elog {
+
+/**
+ * @brief A per-record cache of rendered fields, used when a single log record is dispatched to
+ * several log targets. The cache is filled lazily: the first formatter that renders a field stores
+ * the result, and formatters of all subsequent log targets reuse it.
+ *
+ * The cache is installed by the log target dispatch loop for the duration of the dispatch (see
+ * @ref ELogScopedRenderCache), and formatters retrieve it through @ref getRenderCache(). Since the
+ * cache lives on the dispatching thread's stack, log targets that format records asynchronously
+ * in another thread (or format a copy of the record) simply do not see it, and render as usual.
+ *
+ * The cache also holds the shared message copy of the record (see @ref acquireLogRecordMsg()),
+ * so that log targets that queue the record share a single copy of the message.
+ *
+ * @note Only fields that are relatively expensive to render are cached (i.e. time strings and
+ * resolved binary messages). Level names are constant strings, and padded thread/source/module
+ * names are already cached per thread (across records).
+ */
+class ELOG_API ELogRenderCache {
+public:
+    explicit ELogRenderCache(const ELogRecord& logRecord)
+        : m_logRecord(logRecord),
+          m_timeSlotCount(0),
+          m_msgState(MsgState::MS_NONE),
+          m_msgBlob(nullptr) {}
+    ELogRenderCache(const ELogRenderCache&) = delete;
+    ELogRenderCache(ELogRenderCache&&) = delete;
+    ELogRenderCache& operator=(const ELogRenderCache&) = delete;
+    ~ELogRenderCache() {
+        if (m_msgBlob != nullptr) {
+            m_msgBlob->release();
+        }
+    }
+
+    /** @brief Retrieves the log record associated with this cache. */
+    inline const ELogRecord& getLogRecord() const { return m_logRecord; }
+
+    /**
+     * @brief Retrieves the log record time rendered according to the given time specification,
+     * rendering and caching it on first use.
+     * @param timeSpec The time specification, or null for the default time format.
+     * @param[out] length The length of the returned time string.
+     * @return The null-terminated time string. The pointer is valid as long as the cache exists.
+     */
+    const char* getTimeString(const ELogTimeSpec* timeSpec, size_t& length);
+
+    /**
+     * @brief Retrieves the resolved message of a binary log record, resolving and caching it on
+     * first use.
+     * @param[out] length The length of the returned message.
+     * @return The null-terminated resolved message, or null if resolving the message failed (or
+     * binary logging is not supported).
+     */
+    const char* getResolvedMsg(size_t& length);
+
+    /**
+     * @brief Retrieves the shared message copy of the log record, creating it on first use.
+     * @return The message blob (owned by the cache, callers should add a reference in order to
+     * keep it), or null if out of memory.
+     */
+    inline ELogMsgBlob* getMsgBlob() {
+        if (m_msgBlob == nullptr) {
+            m_msgBlob = createLogRecordMsgBlob(m_logRecord);
+        }
+        return m_msgBlob;
+    }
+
+    /**
+     * @brief Sets the shared message copy of the log record, in case the record message is already
+     * held by a message blob (i.e. when dispatching a queued log record).
+     */
+    inline void setMsgBlob(ELogMsgBlob* msgBlob) {
+        if (msgBlob != nullptr) {
+            msgBlob->addRef();
+        }
+        if (m_msgBlob != nullptr) {
+            m_msgBlob->release();
+        }
+        m_msgBlob = msgBlob;
+    }
+
+private:
+    /** @brief A single cached time string. */
+    struct TimeSlot {
+        const ELogTimeSpec* m_timeSpec;
+        uint32_t m_length;
+        ELogTimeBuffer m_timeBuffer;
+    };
+
+    const ELogRecord& m_logRecord;
+    uint32_t m_timeSlotCount;
+    TimeSlot m_timeSlots[ELOG_RENDER_CACHE_TIME_SLOTS];
+
+    // NOTE: the layout does not depend on ELOG_ENABLE_FMT_LIB, since this header is public
+    enum class MsgState : uint32_t { MS_NONE, MS_RESOLVED, MS_FAILED };
+    MsgState m_msgState;
+    ELogBuffer m_resolvedMsg;
+    ELogMsgBlob* m_msgBlob;
+};
+
+/**
+ * @brief Retrieves the render cache of a log record, if the record is currently being dispatched
+ * to log targets by the calling thread.
+ * @param logRecord The log record being formatted.
+ * @return The render cache, or null if none is installed for the given record.
+ */
+extern ELOG_API ELogRenderCache* getRenderCache(const ELogRecord& logRecord);
+
+/**
+ * @brief Renders the time of a log record according to a time specification, using the record's
+ * render cache if there is any.
+ * @param logRecord The log record.
+ * @param timeSpec The time specification, or null for the default time format.
+ * @param timeBuffer A buffer to use in case there is no render cache.
+ * @param[out] length The length of the returned time string.
+ * @return The null-terminated time string, either from the render cache or from the given buffer.
+ */
+extern ELOG_API const char* renderLogRecordTime(const ELogRecord& logRecord,
+                                                const ELogTimeSpec* timeSpec,
+                                                ELogTimeBuffer& timeBuffer, size_t& length);
+
+/** @brief Installs a render cache for the current scope in the calling thread. */
+class ELOG_API ELogScopedRenderCache {
+public:
+    explicit ELogScopedRenderCache(ELogRenderCache* renderCache);
+    ELogScopedRenderCache(const ELogScopedRenderCache&) = delete;
+    ELogScopedRenderCache(ELogScopedRenderCache&&) = delete;
+    ELogScopedRenderCache& operator=(const ELogScopedRenderCache&) = delete;
+    ~ELogScopedRenderCache();
+
+private:
+    // saved for nested dispatching (e.g. error reported by a log target while logging)
+    ELogRenderCache* m_prevRenderCache;
+};
+
+}  // namespace elog
+
+#endif  // __ELOG_RENDER_CACHE_H__
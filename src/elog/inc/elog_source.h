@@ -9,6 +9,7 @@
 
 #include "elog_common_def.h"
 #include "elog_level.h"
+#include "elog_time.h"
 
 #ifdef ELOG_ENABLE_LIFE_SIGN
 #include "elog_life_sign_filter.h"
@@ -59,7 +60,7 @@ public:
      * @brief Sets a semantic module name that is associated with the log source (used for logging,
      * and is accessible by the ${module} log line format specifier).
      */
-    inline void setModuleName(const char* moduleName) { m_moduleName = moduleName; }
+    void setModuleName(const char* moduleName);
 
     /** @brief Retrieves the module name associated with the log source. */
     inline const char* getModuleName() const { return m_moduleName.c_str(); }
@@ -67,6 +68,9 @@ public:
     /** @brief Retrieves the length of the module name associated with the log source. */
     inline size_t getModuleNameLength() const { return m_moduleName.length(); }
 
+    /** @brief Retrieves the time at which the log source was created. */
+    inline const ELogTime& getCreationTime() const { return m_creationTime; }
+
     /**
      * @brief Retrieves the parent log source of this log source. The root log source has no
      * parent.
@@ -189,6 +193,7 @@ private:
     std::string m_qname;
     std::string m_moduleName;
     ELogSource* m_parent;
+    ELogTime m_creationTime;
 #ifdef ELOG_SOURCE_ATOMIC
     std::atomic<ELogLevel> m_logLevel;
 #else
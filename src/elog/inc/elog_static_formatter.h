@@ -0,0 +1,463 @@
+#ifndef __ELOG_STATIC_FORMATTER_H__
+#define __ELOG_STATIC_FORMATTER_H__
+
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "elog_buffer_receptor.h"
+#include "elog_formatter.h"
+#include "elog_render_cache.h"
+#include "elog_string_receptor.h"
+
+namespace elog {
+
+// forward declaration (see elog_api.h)
+extern ELOG_API const char* getAppName();
+
+/**
+ * @brief A string literal wrapper that can be used as a non-type template parameter, so that log
+ * line format specifications can be parsed at compile time (see @ref ELogStaticFormatter).
+ */
+template <size_t N>
+struct ELogFormatString {
+    constexpr ELogFormatString(const char (&str)[N]) {
+        for (size_t i = 0; i < N; ++i) {
+            m_str[i] = str[i];
+        }
+    }
+
+    /** @brief Retrieves the string length (not including terminating null). */
+    constexpr size_t length() const { return N - 1; }
+
+    char m_str[N];
+};
+
+/** @enum Field identifiers of statically parsed log line format specification segments. */
+enum class ELogStaticFieldId : uint32_t {
+    /** @var Static text. */
+    SF_TEXT,
+
+    /**
+     * @var Field whose value is constant during the lifetime of the process (host, user, os_name,
+     * os_ver, prog, pid), or which has no run-time value (env, fmt, text). Such fields are rendered
+     * once (including justification and text formatting) when the formatter is constructed.
+     */
+    SF_CONST,
+
+    /** @var Run-time fields with at most integer justification specification. */
+    SF_RECORD_ID,
+    SF_TIME,
+    SF_TIME_EPOCH,
+    SF_APP_NAME,
+    SF_THREAD_ID,
+    SF_SOURCE,
+    SF_MODULE,
+    SF_FILE,
+    SF_LINE,
+    SF_FUNCTION,
+    SF_LEVEL,
+    SF_MSG,
+
+    /**
+     * @var Any other field, or a run-time field with extended specification (text formatting,
+     * time format, conditional formatting, custom field selectors, etc.). Such fields are
+     * selected at run-time through a field selector.
+     */
+    SF_SELECTOR
+};
+
+/** @struct A single segment of a statically parsed log line format specification. */
+struct ELogStaticSegment {
+    ELogStaticFieldId m_fieldId;
+    ELogJustifyMode m_justifyMode;
+    uint32_t m_justify;
+
+    /** @var Offset/length of the text in the text pool (static text only). */
+    uint32_t m_textOffset;
+    uint32_t m_textLength;
+};
+
+/**
+ * @brief The result of parsing a log line format specification at compile time.
+ * @tparam N The format specification string size (including terminating null).
+ * @tparam SegmentCount The number of segments in the format specification.
+ */
+template <size_t N, size_t SegmentCount>
+struct ELogStaticFormat {
+    std::array<ELogStaticSegment, SegmentCount> m_segments;
+
+    /** @var All static text segments, each followed by a terminating null. */
+    std::array<char, N + SegmentCount> m_textPool;
+};
+
+/**
+ * @brief Compile-time log line format specification parser. Splits the format specification into
+ * segments exactly like @ref ELogFormatter::parseFormatSpec() does at run-time, so that each
+ * segment corresponds to a single field selector.
+ */
+struct ELogStaticFormatParser {
+    /** @def Segment count value denoting invalid format specification. */
+    static constexpr size_t INVALID_COUNT = (size_t)-1;
+
+    static constexpr size_t find(const char* str, size_t len, size_t from) {
+        for (size_t i = from; i + 1 < len; ++i) {
+            if (str[i] == '$' && str[i + 1] == '{') {
+                return i;
+            }
+        }
+        return INVALID_COUNT;
+    }
+
+    // same as ELogFormatter::getFieldCloseBrace()
+    static constexpr size_t findCloseBrace(const char* str, size_t len, size_t from) {
+        int count = 0;
+        bool countChanged = false;
+        for (size_t i = from; i < len; ++i) {
+            if (str[i] == '{') {
+                ++count;
+                countChanged = true;
+            } else if (str[i] == '}') {
+                --count;
+                countChanged = true;
+            }
+            if (count < 0) {
+                return INVALID_COUNT;
+            }
+            if (count == 0 && countChanged) {
+                return i;
+            }
+        }
+        return INVALID_COUNT;
+    }
+
+    static constexpr bool equals(const char* str, size_t len, const char* name) {
+        size_t i = 0;
+        for (; i < len && name[i] != 0; ++i) {
+            if (str[i] != name[i]) {
+                return false;
+            }
+        }
+        return i == len && name[i] == 0;
+    }
+
+    /** @brief Counts the segments in a format specification. */
+    static constexpr size_t countSegments(const char* str, size_t len) {
+        size_t count = 0;
+        size_t prevPos = 0;
+        size_t pos = find(str, len, 0);
+        while (pos != INVALID_COUNT) {
+            if (pos > prevPos) {
+                ++count;
+            }
+            size_t closePos = findCloseBrace(str, len, pos);
+            if (closePos == INVALID_COUNT) {
+                return INVALID_COUNT;
+            }
+            ++count;
+            prevPos = closePos + 1;
+            pos = find(str, len, prevPos);
+        }
+        if (prevPos < len) {
+            ++count;
+        }
+        return count;
+    }
+
+    /** @brief Classifies a field reference (contents of "${...}"). */
+    static constexpr ELogStaticSegment parseField(const char* spec, size_t len) {
+        ELogStaticSegment segment = {ELogStaticFieldId::SF_SELECTOR, ELogJustifyMode::JM_NONE, 0,
+                                     0, 0};
+        size_t nameLen = 0;
+        while (nameLen < len && spec[nameLen] != ':') {
+            ++nameLen;
+        }
+
+        // fields rendered once, regardless of specification
+        const char* constNames[] = {"host", "user", "os_name", "os_ver", "prog",
+                                    "pid",  "env",  "fmt",     "text"};
+        for (const char* name : constNames) {
+            if (equals(spec, nameLen, name)) {
+                segment.m_fieldId = ELogStaticFieldId::SF_CONST;
+                return segment;
+            }
+        }
+
+        // run-time fields, with optional integer justification only (same semantics as in
+        // ELogFieldSpec::parse(): positive value is left justification, negative is right)
+        if (nameLen < len) {
+            size_t i = nameLen + 1;
+            bool negative = (i < len && spec[i] == '-');
+            if (negative) {
+                ++i;
+            }
+            if (i == len) {
+                return segment;
+            }
+            uint32_t justify = 0;
+            for (; i < len; ++i) {
+                if (spec[i] < '0' || spec[i] > '9') {
+                    return segment;
+                }
+                justify = justify * 10 + (uint32_t)(spec[i] - '0');
+            }
+            if (justify > 0) {
+                segment.m_justify = justify;
+                segment.m_justifyMode = negative ? ELogJustifyMode::JM_RIGHT
+                                                 : ELogJustifyMode::JM_LEFT;
+            }
+        }
+        struct NameId {
+            const char* m_name;
+            ELogStaticFieldId m_fieldId;
+        };
+        const NameId runTimeNames[] = {{"rid", ELogStaticFieldId::SF_RECORD_ID},
+                                       {"time", ELogStaticFieldId::SF_TIME},
+                                       {"time_epoch", ELogStaticFieldId::SF_TIME_EPOCH},
+                                       {"app", ELogStaticFieldId::SF_APP_NAME},
+                                       {"tid", ELogStaticFieldId::SF_THREAD_ID},
+                                       {"src", ELogStaticFieldId::SF_SOURCE},
+                                       {"mod", ELogStaticFieldId::SF_MODULE},
+                                       {"file", ELogStaticFieldId::SF_FILE},
+                                       {"line", ELogStaticFieldId::SF_LINE},
+                                       {"func", ELogStaticFieldId::SF_FUNCTION},
+                                       {"level", ELogStaticFieldId::SF_LEVEL},
+                                       {"msg", ELogStaticFieldId::SF_MSG}};
+        for (const NameId& nameId : runTimeNames) {
+            if (equals(spec, nameLen, nameId.m_name)) {
+                segment.m_fieldId = nameId.m_fieldId;
+                return segment;
+            }
+        }
+        segment.m_justifyMode = ELogJustifyMode::JM_NONE;
+        segment.m_justify = 0;
+        return segment;
+    }
+
+    /** @brief Parses a format specification into segments. */
+    template <size_t N, size_t SegmentCount>
+    static constexpr ELogStaticFormat<N, SegmentCount> parse(const char* str) {
+        ELogStaticFormat<N, SegmentCount> result = {};
+        const size_t len = N - 1;
+        size_t segmentId = 0;
+        uint32_t poolOffset = 0;
+        auto addText = [&](size_t from, size_t to) {
+            ELogStaticSegment& segment = result.m_segments[segmentId++];
+            segment = {ELogStaticFieldId::SF_TEXT, ELogJustifyMode::JM_NONE, 0, poolOffset,
+                       (uint32_t)(to - from)};
+            for (size_t i = from; i < to; ++i) {
+                result.m_textPool[poolOffset++] = str[i];
+            }
+            result.m_textPool[poolOffset++] = 0;
+        };
+
+        size_t prevPos = 0;
+        size_t pos = find(str, len, 0);
+        while (pos != INVALID_COUNT) {
+            if (pos > prevPos) {
+                addText(prevPos, pos);
+            }
+            size_t closePos = findCloseBrace(str, len, pos);
+            result.m_segments[segmentId++] = parseField(str + pos + 2, closePos - pos - 2);
+            prevPos = closePos + 1;
+            pos = find(str, len, prevPos);
+        }
+        if (prevPos < len) {
+            addText(prevPos, len);
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief A log formatter whose log line format specification is parsed at compile time. Each
+ * segment of the format specification is formatted by code specialized for its field type and
+ * justification, so that no run-time dispatch takes place. Process-constant fields (host, user,
+ * etc.) are rendered once during construction. Fields with extended specification (e.g. text
+ * formatting, time format or conditional formatting) are still selected at run-time through a
+ * field selector, so all fields supported by @ref ELogFieldSelector may be used.
+ *
+ * Static formatters should be defined with @ref ELOG_DECLARE_STATIC_LOG_FORMATTER() and
+ * @ref ELOG_IMPLEMENT_LOG_FORMATTER(), so they can be created by type name, both from code and from
+ * configuration (e.g. "log_format=my_fmt:", note the colon, and the empty format specification
+ * which is ignored anyway).
+ *
+ * @note Like any other log formatter, static formatters should be constructed after ELog has been
+ * initialized.
+ * @tparam FormatSpec The log line format specification.
+ */
+template <ELogFormatString FormatSpec>
+class ELogStaticFormatter : public ELogFormatter {
+public:
+    /** @brief The number of segments in the format specification. */
+    static constexpr size_t SEGMENT_COUNT =
+        ELogStaticFormatParser::countSegments(FormatSpec.m_str, FormatSpec.length());
+    static_assert(SEGMENT_COUNT != ELogStaticFormatParser::INVALID_COUNT,
+                  "Invalid static log format specification, unbalanced curly braces");
+
+    /** @brief The parsed format specification. */
+    static constexpr ELogStaticFormat<sizeof(FormatSpec.m_str), SEGMENT_COUNT> FORMAT =
+        ELogStaticFormatParser::parse<sizeof(FormatSpec.m_str), SEGMENT_COUNT>(FormatSpec.m_str);
+
+    void formatLogMsg(const ELogRecord& logRecord, std::string& logMsg) final {
+        formatSegments(logRecord, logMsg, std::make_index_sequence<SEGMENT_COUNT>{});
+    }
+
+    void formatLogBuffer(const ELogRecord& logRecord, ELogBuffer& logBuffer) final {
+        formatSegments(logRecord, logBuffer, std::make_index_sequence<SEGMENT_COUNT>{});
+    }
+
+protected:
+    ELogStaticFormatter(const char* typeName) : ELogFormatter(typeName), m_isValid(false) {
+        // the format is also parsed at run-time, so that field selectors are available for
+        // receptor-based formatting (see applyFieldSelectors()), for selecting fields with
+        // extended specification, and for rendering constant fields
+        if (!parseFormatSpec(FormatSpec.m_str) || m_fieldSelectors.size() != SEGMENT_COUNT) {
+            // error already reported, formatting proceeds without selector-based fields
+            return;
+        }
+        m_isValid = true;
+        ELogRecord dummyRecord;
+        for (size_t i = 0; i < SEGMENT_COUNT; ++i) {
+            if (FORMAT.m_segments[i].m_fieldId == ELogStaticFieldId::SF_CONST) {
+                ELogStringReceptor receptor(m_constText[i]);
+                m_fieldSelectors[i]->selectField(dummyRecord, &receptor);
+            }
+        }
+    }
+    ELogStaticFormatter(const ELogStaticFormatter&) = delete;
+    ELogStaticFormatter(ELogStaticFormatter&&) = delete;
+    ELogStaticFormatter& operator=(const ELogStaticFormatter&) = delete;
+    ~ELogStaticFormatter() override {}
+
+private:
+    bool m_isValid;
+    std::array<std::string, SEGMENT_COUNT> m_constText;
+
+    template <typename T, size_t... Indices>
+    inline void formatSegments(const ELogRecord& logRecord, T& output,
+                               std::index_sequence<Indices...>) {
+        (formatSegment<Indices>(logRecord, output), ...);
+    }
+
+    template <ELogJustifyMode Mode, uint32_t Justify, typename T>
+    static inline void appendField(T& output, const char* field, size_t fieldLen) {
+        if constexpr (Mode == ELogJustifyMode::JM_RIGHT) {
+            if (fieldLen < Justify) {
+                output.append((uint64_t)(Justify - fieldLen), ' ');
+            }
+        }
+        output.append(field, fieldLen);
+        if constexpr (Mode == ELogJustifyMode::JM_LEFT) {
+            if (fieldLen < Justify) {
+                output.append((uint64_t)(Justify - fieldLen), ' ');
+            }
+        }
+    }
+
+    template <ELogJustifyMode Mode, uint32_t Justify, typename T>
+    static inline void appendIntField(T& output, uint64_t field) {
+        // NOTE: ELogBuffer::append() also copies the terminating null
+        char strField[32];
+        std::to_chars_result res = std::to_chars(strField, strField + sizeof(strField) - 1, field);
+        *res.ptr = 0;
+        appendField<Mode, Justify>(output, strField, res.ptr - strField);
+    }
+
+    static inline void selectField(ELogFieldSelector* selector, const ELogRecord& logRecord,
+                                   std::string& logMsg) {
+        ELogStringReceptor receptor(logMsg);
+        selector->selectField(logRecord, &receptor);
+    }
+
+    static inline void selectField(ELogFieldSelector* selector, const ELogRecord& logRecord,
+                                   ELogBuffer& logBuffer) {
+        ELogBufferReceptor receptor(logBuffer);
+        selector->selectField(logRecord, &receptor);
+    }
+
+    template <size_t I, typename T>
+    inline void formatSegment(const ELogRecord& logRecord, T& output) {
+        constexpr ELogStaticSegment segment = FORMAT.m_segments[I];
+        constexpr ELogJustifyMode mode = segment.m_justifyMode;
+        constexpr uint32_t justify = segment.m_justify;
+        if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_TEXT) {
+            output.append(FORMAT.m_textPool.data() + segment.m_textOffset, segment.m_textLength);
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_CONST) {
+            output.append(m_constText[I].c_str(), m_constText[I].length());
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_RECORD_ID) {
+            appendIntField<mode, justify>(output, logRecord.m_logRecordId);
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_TIME) {
+            ELogTimeBuffer timeBuffer;
+            size_t len = 0;
+            const char* timeStr = renderLogRecordTime(logRecord, nullptr, timeBuffer, len);
+            appendField<mode, justify>(output, timeStr, len);
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_TIME_EPOCH) {
+            appendIntField<mode, justify>(output,
+                                          elogTimeToUnixTimeNanos(logRecord.m_logTime) / 1000ull);
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_APP_NAME) {
+            const char* appName = getAppName();
+            appendField<mode, justify>(output, appName, strlen(appName));
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_THREAD_ID) {
+            appendIntField<mode, justify>(output, logRecord.m_threadId);
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_SOURCE) {
+            size_t len = 0;
+            const char* logSourceName = getLogSourceName(logRecord, len);
+            appendField<mode, justify>(output, logSourceName, len);
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_MODULE) {
+            size_t len = 0;
+            const char* moduleName = getLogModuleName(logRecord, len);
+            appendField<mode, justify>(output, moduleName, len);
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_FILE) {
+            appendField<mode, justify>(output, logRecord.m_file, strlen(logRecord.m_file));
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_LINE) {
+            appendIntField<mode, justify>(output, logRecord.m_line);
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_FUNCTION) {
+            appendField<mode, justify>(output, logRecord.m_function,
+                                       strlen(logRecord.m_function));
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_LEVEL) {
+            const char* logLevelStr = elogLevelToStr(logRecord.m_logLevel);
+            appendField<mode, justify>(output, logLevelStr, strlen(logLevelStr));
+        } else if constexpr (segment.m_fieldId == ELogStaticFieldId::SF_MSG) {
+            // binary log records must be resolved first, so let the selector handle that
+            if ((logRecord.m_flags & ELOG_RECORD_BINARY) == 0) {
+                appendField<mode, justify>(output, logRecord.m_logMsg, logRecord.m_logMsgLen);
+            } else if (m_isValid) {
+                selectField(m_fieldSelectors[I], logRecord, output);
+            }
+        } else {
+            if (m_isValid) {
+                selectField(m_fieldSelectors[I], logRecord, output);
+            }
+        }
+    }
+};
+
+/**
+ * @def Utility macro for defining a static log formatter class, which is also registered by type
+ * name (the class still needs to be implemented with @ref ELOG_IMPLEMENT_LOG_FORMATTER()).
+ * @param FormatterType Type name of log formatter.
+ * @param TypeName Configuration type name of log formatter (for dynamic loading from
+ * configuration).
+ * @param FormatSpec The log line format specification string literal.
+ * @param ImportExportSpec Window import/export specification. If exporting from a library then
+ * specify a macro that will expand correctly within the library and from outside as well. If not
+ * relevant then pass ELOG_NO_EXPORT.
+ */
+#define ELOG_DECLARE_STATIC_LOG_FORMATTER(FormatterType, TypeName, FormatSpec, ImportExportSpec) \
+    class ImportExportSpec FormatterType final                                                   \
+        : public elog::ELogStaticFormatter<FormatSpec> {                                         \
+    public:                                                                                      \
+        FormatterType() : elog::ELogStaticFormatter<FormatSpec>(TYPE_NAME) {}                    \
+        FormatterType(const FormatterType&) = delete;                                            \
+        FormatterType(FormatterType&&) = delete;                                                 \
+        FormatterType& operator=(const FormatterType&) = delete;                                 \
+                                                                                                 \
+        ELOG_DECLARE_LOG_FORMATTER(FormatterType, TypeName, ImportExportSpec)                    \
+    };
+
+}  // namespace elog
+
+#endif  // __ELOG_STATIC_FORMATTER_H__
@@ -5,6 +5,7 @@
 
 #include "elog_buffer.h"
 #include "elog_def.h"
+#include "elog_histogram.h"
 
 namespace elog {
 
@@ -29,17 +30,30 @@ struct ELOG_API ELogCounter {
     ~ELogCounter() {}
 };
 
-/** @brief A single statistics variable. */
+/**
+ * @brief A single statistics variable. The variable holds one counter per thread. The counters are
+ * either allocated by the variable itself (see @ref initialize()), or they reside in the per-thread
+ * counter blocks of an @ref ELogStats object (see @ref ELogStats::bindStatVar()), in which case all
+ * counters of a single thread are contiguous and isolated in their own cache lines.
+ */
 struct ELOG_API ELogStatVar {
-    ELogStatVar() : m_threadCounters(nullptr), m_maxThreads(0) {}
+    ELogStatVar() : m_counters(nullptr), m_stride(0), m_maxThreads(0), m_ownsCounters(false) {}
     ELogStatVar(const ELogStatVar&) = delete;
     ELogStatVar(ELogStatVar&&) = delete;
     ELogStatVar& operator=(const ELogStatVar&) = delete;
     ~ELogStatVar() { terminate(); }
 
-    /** @brief Initializes the statistics variable. */
+    /** @brief Initializes the statistics variable with its own counter array. */
     bool initialize(uint32_t maxThreads);
 
+    /**
+     * @brief Initializes the statistics variable with externally owned counters.
+     * @param firstCounter The counter of the first thread.
+     * @param stride The distance in bytes between the counters of consecutive threads.
+     * @param maxThreads The number of threads.
+     */
+    void bind(ELogCounter* firstCounter, uint32_t stride, uint32_t maxThreads);
+
     /** @brief Terminates the statistics variable. */
     void terminate();
 
@@ -48,12 +62,10 @@ struct ELOG_API ELogStatVar {
      * @param slotId The allocated slot for the current thread.
      * @param amount The amount to add to the counter.
      */
-    inline void add(uint64_t slotId, uint64_t amount) {
-        m_threadCounters[slotId].m_counter += amount;
-    }
+    inline void add(uint64_t slotId, uint64_t amount) { getCounter(slotId).m_counter += amount; }
 
     /** @brief Resets the counter value for a specific thread. */
-    inline void reset(uint64_t slotId) { m_threadCounters[slotId].m_counter = 0; }
+    inline void reset(uint64_t slotId) { getCounter(slotId).m_counter = 0; }
 
     /**
      * @brief Adds the threads counters of another statistics variable.
@@ -61,33 +73,63 @@ struct ELOG_API ELogStatVar {
      */
     inline void addVar(const ELogStatVar& statVar) {
         for (uint32_t i = 0; i < m_maxThreads; ++i) {
-            m_threadCounters[i].m_counter += statVar.m_threadCounters[i].m_counter;
+            getCounter(i).m_counter += statVar.getCounter(i).m_counter;
         }
     }
 
+    /** @brief Retrieves the counter value of a specific thread. */
+    inline uint64_t getValue(uint64_t slotId) const { return getCounter(slotId).m_counter; }
+
     /** @brief Retrieves the sum of all thread counters. */
     inline uint64_t getSum() const {
         uint64_t sum = 0;
         for (uint32_t i = 0; i < m_maxThreads; ++i) {
-            sum += m_threadCounters[i].m_counter;
+            sum += getCounter(i).m_counter;
         }
         return sum;
     }
 
 private:
-    ELogCounter* m_threadCounters;
+    char* m_counters;
+    uint32_t m_stride;
     uint32_t m_maxThreads;
+    bool m_ownsCounters;
+
+    inline ELogCounter& getCounter(uint64_t slotId) const {
+        return *(ELogCounter*)(m_counters + slotId * m_stride);
+    }
 };
 
+/** @def The number of statistics variables in @ref ELogStats. */
+#define ELOG_STATS_VAR_COUNT 11
+
 /** @brief Parent class for log target statistics. */
 struct ELOG_API ELogStats {
-    ELogStats() {}
+    /**
+     * @brief Construct a new ELogStats object.
+     * @param extraVarCount The number of statistics variables that a derived class binds to the
+     * per-thread counter blocks (see @ref bindStatVar()).
+     */
+    explicit ELogStats(uint32_t extraVarCount = 0)
+        : m_threadBlocks(nullptr),
+          m_blockSize(0),
+          m_maxThreads(0),
+          m_varCount(ELOG_STATS_VAR_COUNT + extraVarCount),
+          m_boundVarCount(0) {}
     ELogStats(const ELogStats&) = delete;
     ELogStats(ELogStats&&) = delete;
     ELogStats& operator=(const ELogStats&) = delete;
-    virtual ~ELogStats() {}
+    virtual ~ELogStats() { freeThreadBlocks(); }
 
-    /** @brief Initializes the statistics variable. */
+    /**
+     * @brief Initializes the statistics variable. The counters of all statistics variables of a
+     * single thread are kept in a contiguous block padded to cache line size, so that logging
+     * threads never share cache lines, and updating several counters for a single log record
+     * touches as few cache lines as possible. Counters are aggregated across threads only when
+     * read.
+     * @note Derived classes should first call this method, and then call @ref bindStatVar() for
+     * each of their own statistics variables.
+     */
     virtual bool initialize(uint32_t maxThreads);
 
     /** @brief Terminates the statistics variable. */
@@ -115,6 +157,10 @@ struct ELOG_API ELogStats {
     inline void incrementMsgSubmitted(uint64_t slotId) { m_msgSubmitted.add(slotId, 1); }
     inline void incrementMsgWritten(uint64_t slotId) { m_msgWritten.add(slotId, 1); }
     inline void incrementMsgFailWrite(uint64_t slotId) { m_msgFailWrite.add(slotId, 1); }
+    inline void addMsgDiscarded(uint64_t slotId, uint64_t count) {
+        m_msgDiscarded.add(slotId, count);
+    }
+    inline void addMsgWritten(uint64_t slotId, uint64_t count) { m_msgWritten.add(slotId, count); }
 
     // byte count statistics (user provides lot id)
     inline void addBytesSubmitted(uint64_t slotId, uint64_t bytes) {
@@ -133,6 +179,20 @@ struct ELOG_API ELogStats {
     inline void incrementFlushFailed(uint64_t slotId) { m_flushFailed.add(slotId, 1); }
     inline void incrementFlushDiscarded(uint64_t slotId) { m_flushDiscarded.add(slotId, 1); }
 
+    // latency and batch size statistics (user provides slot id)
+    inline void recordWriteLatency(uint64_t slotId, uint64_t nanos) {
+        m_writeLatency.record(slotId, nanos);
+    }
+    inline void recordFlushLatency(uint64_t slotId, uint64_t nanos) {
+        m_flushLatency.record(slotId, nanos);
+    }
+    inline void recordQueueResidence(uint64_t slotId, uint64_t nanos) {
+        m_queueResidence.record(slotId, nanos);
+    }
+    inline void recordBatchSize(uint64_t slotId, uint64_t recordCount) {
+        m_batchSize.record(slotId, recordCount);
+    }
+
     /**
      * @brief Prints statistics to an output string buffer.
      * @param buffer The output string buffer.
@@ -146,6 +206,38 @@ struct ELOG_API ELogStats {
     inline uint64_t getMsgSubmitted() const { return m_msgSubmitted.getSum(); }
     inline uint64_t getMsgWritten() const { return m_msgWritten.getSum(); }
     inline uint64_t getMsgFailWrite() const { return m_msgFailWrite.getSum(); }
+    inline uint64_t getMsgDiscarded() const { return m_msgDiscarded.getSum(); }
+
+    /** @brief Retrieves the number of log messages submitted by a specific thread. */
+    inline uint64_t getMsgSubmitted(uint64_t slotId) const {
+        return m_msgSubmitted.getValue(slotId);
+    }
+
+    /** @brief Retrieves a snapshot of the log record write latency histogram (nanoseconds). */
+    inline void getWriteLatency(ELogHistogramSnapshot& snapshot) const {
+        m_writeLatency.getSnapshot(snapshot);
+    }
+
+    /** @brief Retrieves a snapshot of the flush latency histogram (nanoseconds). */
+    inline void getFlushLatency(ELogHistogramSnapshot& snapshot) const {
+        m_flushLatency.getSnapshot(snapshot);
+    }
+
+    /**
+     * @brief Retrieves a snapshot of the queue residence histogram (nanoseconds), that is the time
+     * elapsed since a log record was issued until it was written by the log target.
+     */
+    inline void getQueueResidence(ELogHistogramSnapshot& snapshot) const {
+        m_queueResidence.getSnapshot(snapshot);
+    }
+
+    /**
+     * @brief Retrieves a snapshot of the batch size histogram (number of log records processed at
+     * once by an asynchronous log target).
+     */
+    inline void getBatchSize(ELogHistogramSnapshot& snapshot) const {
+        m_batchSize.getSnapshot(snapshot);
+    }
 
     /**
      * @brief Retrieves the slot id for the current thread. The slot id is used to access the
@@ -158,7 +250,28 @@ struct ELOG_API ELogStats {
     /** @brief Releases the statistics slot for the current thread. */
     virtual void resetThreadCounters(uint64_t slotId);
 
+protected:
+    /**
+     * @brief Binds a statistics variable of a derived class to the next vacant counter in the
+     * per-thread counter blocks. The number of such variables must be declared in the constructor.
+     * @param statVar The statistics variable to bind.
+     * @return True if succeeded, or false if all counters are already bound.
+     */
+    bool bindStatVar(ELogStatVar& statVar);
+
 private:
+    /** @brief Per-thread counter blocks. */
+    char* m_threadBlocks;
+
+    /** @brief The size in bytes of each thread's counter block (multiple of cache line size). */
+    uint32_t m_blockSize;
+
+    uint32_t m_maxThreads;
+    uint32_t m_varCount;
+    uint32_t m_boundVarCount;
+
+    void freeThreadBlocks();
+
     /** @brief Number of log messages discarded by the log target due to log level or filter. */
     ELogStatVar m_msgDiscarded;
 
@@ -239,6 +352,25 @@ private:
      * as a successful flush request execution).
      */
     ELogStatVar m_flushDiscarded;
+
+    /** @brief Time in nanoseconds spent in writing a single log record. */
+    ELogHistogram m_writeLatency;
+
+    /** @brief Time in nanoseconds spent in executing a flush request. */
+    ELogHistogram m_flushLatency;
+
+    /**
+     * @brief Time in nanoseconds elapsed since a log record was issued until it was written. In
+     * the context of synchronous log targets, this is mostly the formatting and dispatch time. In
+     * the context of asynchronous log targets, this also includes the time spent in the queue.
+     */
+    ELogHistogram m_queueResidence;
+
+    /**
+     * @brief Number of log records processed at once by an asynchronous log target (not updated by
+     * synchronous log targets).
+     */
+    ELogHistogram m_batchSize;
 };
 
 }  // namespace elog
@@ -9,6 +9,7 @@
 #include "elog_buffer.h"
 #include "elog_common_def.h"
 #include "elog_flush_policy.h"
+#include "elog_msg_blob.h"
 #include "elog_record.h"
 #include "elog_stats.h"
 
@@ -84,6 +85,19 @@ public:
     /** @brief Sends a log record to a log target. */
     void log(const ELogRecord& logRecord);
 
+    /**
+     * @brief Sets flat-combining mode for log targets that require a lock. In this mode, threads
+     * that fail to acquire the log target lock publish their log record in a per-thread slot and
+     * wait, while the lock holder writes all published log records in a single pass. This avoids
+     * message copying into the backlog queue, and keeps its size bounded. By default, threads that
+     * fail to acquire the log target lock push a copy of the log record into the backlog queue.
+     * @note This call has effect only if made before the log target is started.
+     */
+    inline void setFlatCombining(bool flatCombining) { m_flatCombining = flatCombining; }
+
+    /** @brief Queries whether flat-combining mode is set for the log target. */
+    inline bool isFlatCombining() const { return m_flatCombining; }
+
     /**
      * @brief Orders a buffered log target to flush it log messages.
      * @param allowModeration Optionally specify whether the log target can moderate flush calls, in
@@ -257,11 +271,17 @@ protected:
           m_isNativelyThreadSafe(false),
           m_isExternallyThreadSafe(false),
           m_isSystemTarget(false),
+          m_deferredWriteStats(false),
           m_addNewLine(0),
           m_requiresLock(1),
           m_logFilter(nullptr),
           m_logFormatter(nullptr),
           m_flushPolicy(flushPolicy),
+          m_backlogSize(0),
+          m_flatCombining(false),
+          m_combineSlots(nullptr),
+          m_combineSlotCount(0),
+          m_combineSlotHigh(0),
           m_enableStats(enableStats),
           m_stats(nullptr) {}
 
@@ -277,6 +297,24 @@ protected:
         onThreadSafe();
     }
 
+    /**
+     * @brief Sets deferred write statistics. Log targets that only buffer log records in @ref
+     * writeLogRecord(), and send them later in batches, should call this, so that buffered log
+     * records are not counted as written before they are sent. Instead, the outcome of sending
+     * each batch should be reported by calling @ref reportBatchWrite().
+     */
+    inline void setDeferredWriteStats() { m_deferredWriteStats = true; }
+
+    /**
+     * @brief Reports the outcome of sending a batch of buffered log records (see @ref
+     * setDeferredWriteStats()). On success, the log records are counted as written, otherwise they
+     * are counted as discarded.
+     * @param success Specifies whether the batch was sent successfully.
+     * @param msgCount The number of log records in the batch.
+     * @param bytes The number of bytes of the log records in the batch.
+     */
+    void reportBatchWrite(bool success, uint64_t msgCount, uint64_t bytes);
+
     /** @brief Queries whether the log target is exected in a thread safe environment. */
     inline bool isExternallyThreadSafe() const { return m_isExternallyThreadSafe; }
 
@@ -332,6 +370,7 @@ private:
     bool m_isNativelyThreadSafe;
     bool m_isExternallyThreadSafe;
     bool m_isSystemTarget;
+    bool m_deferredWriteStats;
     alignas(8) uint64_t m_addNewLine;
     // this member is pretty hot, so we avoid using 1 byte boolean, and use instead aligned uint64
     alignas(8) uint64_t m_requiresLock;
@@ -348,7 +387,12 @@ private:
 
     bool startNoLock();
     bool stopNoLock();
-    void logNoLock(const ELogRecord& logRecord);
+    inline void logNoLock(const ELogRecord& logRecord) {
+        logNoLock(logRecord, m_enableStats ? m_stats->getSlotId() : ELOG_INVALID_STAT_SLOT_ID);
+    }
+
+    // writes a log record, charging statistics to the given slot (that of the logging thread)
+    void logNoLock(const ELogRecord& logRecord, uint64_t slotId);
     bool flushNoLock(bool allowModeration);
 
     /** @brief Helper method for querying whether the log target should be flushed. */
@@ -360,16 +404,43 @@ private:
     ELogPassKey generatePassKey();
 
     // backlog for messages that could not be delivered due to possible deadlock
-    std::vector<std::pair<ELogRecord, std::string>> m_backlog;
+    std::vector<std::pair<ELogRecord, ELogMsgRef>> m_backlog;
     std::mutex m_backlogLock;
     std::atomic<uint64_t> m_backlogSize;
 
+    // flat-combining publication slot (one per thread, indexed by statistics slot id)
+    struct ELOG_CACHE_ALIGN CombineSlot {
+        std::atomic<const ELogRecord*> m_logRecord;
+        CombineSlot() : m_logRecord(nullptr) {}
+    };
+
+    bool m_flatCombining;
+    CombineSlot* m_combineSlots;
+    uint64_t m_combineSlotCount;
+    // one past the highest slot used so far, limits the combining scan
+    std::atomic<uint64_t> m_combineSlotHigh;
+
+    bool allocCombineSlots();
+    void freeCombineSlots();
+    bool logCombining(const ELogRecord& logRecord);
+    uint64_t combineLogRecords();
+
 protected:
     bool m_enableStats;
     ELogStats* m_stats;
 
     void pushBacklog(const ELogRecord& logRecord);
     void drainBacklog();
+
+    /** @brief Records the number of log records processed at once by an asynchronous target. */
+    inline void recordBatchSize(uint64_t recordCount) {
+        if (m_enableStats) {
+            uint64_t slotId = m_stats->getSlotId();
+            if (slotId != ELOG_INVALID_STAT_SLOT_ID) {
+                m_stats->recordBatchSize(slotId, recordCount);
+            }
+        }
+    }
 };
 
 /**
@@ -83,6 +83,68 @@ inline void elogGetCurrentTime(ELogTime& logTime) {
 #endif
 }
 
+/**
+ * @brief Retrieves the current time from the coarse real-time clock. This is cheaper than
+ * @ref elogGetCurrentTime(), but the resolution is that of the system timer tick (typically 1-4
+ * milliseconds). On platforms without a coarse clock, this is the same as
+ * @ref elogGetCurrentTime().
+ */
+inline void elogGetCurrentTimeCoarse(ELogTime& logTime) {
+#if !defined(ELOG_TIME_USE_CHRONO) && !defined(ELOG_MSVC) && defined(CLOCK_REALTIME_COARSE)
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    logTime.m_seconds = ts.tv_sec - sUnixTimeRef;
+    logTime.m_100nanos = (uint32_t)(ts.tv_nsec / 100);
+#else
+    elogGetCurrentTime(logTime);
+#endif
+}
+
+/**
+ * @brief Retrieves the current steady (monotonic) clock time in milliseconds, from the coarse
+ * monotonic clock where available. The resolution is that of the system timer tick (typically 1-4
+ * milliseconds). This is useful for cheap interval bookkeeping on the logging hot path.
+ */
+inline uint64_t elogGetSteadyMillisCoarse() {
+#if !defined(ELOG_MSVC) && defined(CLOCK_MONOTONIC_COARSE)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return ((uint64_t)ts.tv_sec) * 1000ull + ((uint64_t)ts.tv_nsec) / 1000000ull;
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+/**
+ * @brief Converts UNIX time nanoseconds (epoch since 1/1/1970 00:00:00 UTC) to ELog time.
+ * @param unixTimeNanos The UNIX time in nanoseconds.
+ * @param[out] logTime The resulting ELog time.
+ */
+inline void elogTimeFromUnixTimeNanos(uint64_t unixTimeNanos, ELogTime& logTime) {
+#ifdef ELOG_TIME_USE_CHRONO
+    logTime = ELogTime(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::nanoseconds(unixTimeNanos)));
+#else
+#ifdef ELOG_MSVC
+    // file time counts 100-nanos intervals since 1/1/1601
+    ULARGE_INTEGER fileTime;
+    fileTime.QuadPart = unixTimeNanos / 100 + 116444736000000000ull;
+#ifdef ELOG_TIME_USE_SYSTEMTIME
+    FILETIME ft = {fileTime.LowPart, fileTime.HighPart};
+    FileTimeToSystemTime(&ft, &logTime);
+#else
+    logTime.dwLowDateTime = fileTime.LowPart;
+    logTime.dwHighDateTime = fileTime.HighPart;
+#endif
+#else
+    logTime.m_seconds = (uint32_t)(unixTimeNanos / 1000000000ull - sUnixTimeRef);
+    logTime.m_100nanos = (uint32_t)((unixTimeNanos % 1000000000ull) / 100);
+#endif
+#endif
+}
+
 /**
  * @brief Checks whether to log time objects are equal
  */
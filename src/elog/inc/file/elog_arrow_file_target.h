@@ -0,0 +1,101 @@
+#ifndef __ELOG_ARROW_FILE_TARGET_H__
+#define __ELOG_ARROW_FILE_TARGET_H__
+
+#include <cstdio>
+#include <string>
+
+#include "elog_target.h"
+
+namespace elog {
+
+/** @def The default number of log records in each Arrow record batch. */
+#define ELOG_DEFAULT_ARROW_BATCH_SIZE (64ul * 1024ul)
+
+/** @def Maximum value allowed for the Arrow record batch size. */
+#define ELOG_MAX_ARROW_BATCH_SIZE (16ul * 1024ul * 1024ul)
+
+/**
+ * @brief A file log target that writes log records in columnar form, as an Apache Arrow IPC
+ * stream (readable by standard tools such as pyarrow, polars or DuckDB, without any network
+ * access). Log records are accumulated in memory into columns (see @ref ELogColumnarBatch), and
+ * are written to file as a single record batch when the batch is full, or when the log target is
+ * flushed. Thread name, log source, module, file and function columns are dictionary encoded when
+ * the batch is written, and log level is encoded with a fixed dictionary. Process-constant fields (host name, user name, OS name and version, application and
+ * program name, process id) are stored once in the schema metadata.
+ *
+ * The log file can be broken into segments by a configured segment size limit (each segment is a
+ * complete stream), and segments can be optionally rotated. In order to write large record batches
+ * from a background thread, this target should be combined with an asynchronous log target (e.g.
+ * "async://deferred"), and used with no flush policy, or with a flush policy that triggers rarely,
+ * since each flush ends the current record batch.
+ *
+ * @note The log formatter of this target is not used. The columns are: record_id, time (UTC
+ * nanoseconds), level, thread_id, thread_name, log_source, module, file, line, function and msg.
+ */
+class ELOG_API ELogArrowFileTarget : public ELogTarget {
+public:
+    /**
+     * @brief Construct a new ELogArrowFileTarget object.
+     * @param logPath The path to the directory in which log file segments are to be put.
+     * @param logName The base name of the log file segments. This should not include ".arrows"
+     * extension, as it is being automatically added.
+     * @param batchSize The maximum number of log records in each record batch.
+     * @param segmentLimitBytes Optionally specify the maximum segment size in bytes. The limit is
+     * checked after each record batch is written. By default the log file is not segmented.
+     * @param segmentCount Optionally specify the maximum number of segments to use. This will cause
+     * log segments to rotate. By default no log rotation takes place.
+     * @param flushPolicy Optional flush policy to be used in conjunction with this log target.
+     * @param enableStats Specifies whether log target statistics should be collected.
+     */
+    ELogArrowFileTarget(const char* logPath, const char* logName,
+                        uint32_t batchSize = ELOG_DEFAULT_ARROW_BATCH_SIZE,
+                        uint64_t segmentLimitBytes = 0, uint32_t segmentCount = 0,
+                        ELogFlushPolicy* flushPolicy = nullptr, bool enableStats = true);
+    ELogArrowFileTarget(const ELogArrowFileTarget&) = delete;
+    ELogArrowFileTarget(ELogArrowFileTarget&&) = delete;
+    ELogArrowFileTarget& operator=(const ELogArrowFileTarget&) = delete;
+
+    /** @brief Retrieves the path of the current segment file. */
+    inline const std::string& getSegmentPath() const { return m_segmentPath; }
+
+    ELOG_DECLARE_LOG_TARGET(ELogArrowFileTarget)
+
+protected:
+    /** @brief Order the log target to start (required for threaded targets). */
+    bool startLogTarget() final;
+
+    /** @brief Order the log target to stop (required for threaded targets). */
+    bool stopLogTarget() final;
+
+    /** @brief Appends the log record to the current record batch. */
+    bool writeLogRecord(const ELogRecord& logRecord, uint64_t& bytesWritten) final;
+
+    /** @brief Writes the current record batch and flushes the log file. */
+    bool flushLogTarget() final;
+
+private:
+    // column data of the current record batch (defined in source file)
+    struct RecordBatch;
+
+    std::string m_logPath;
+    std::string m_logName;
+    uint32_t m_batchSize;
+    uint64_t m_segmentLimitBytes;
+    uint32_t m_segmentCount;
+    uint32_t m_segmentId;
+    uint64_t m_segmentBytes;
+    std::string m_segmentPath;
+    FILE* m_segmentFile;
+    RecordBatch* m_recordBatch;
+
+    void formatSegmentPath(std::string& segmentPath, uint32_t segmentId);
+    bool selectFirstSegment();
+    bool openSegment();
+    bool closeSegment();
+    bool writeDictionaries();
+    bool writeRecordBatch();
+};
+
+}  // namespace elog
+
+#endif  // __ELOG_ARROW_FILE_TARGET_H__
@@ -18,8 +18,11 @@ namespace elog {
 /** @def Default buffers size. */
 #define ELOG_DEFAULT_FILE_BUFFER_SIZE_BYTES (1024 * 1024)
 
+/** @def The number of statistics variables in @ref ELogBufferedStats. */
+#define ELOG_BUFFERED_STATS_VAR_COUNT 4
+
 struct ELOG_API ELogBufferedStats : public ELogStats {
-    ELogBufferedStats() {}
+    ELogBufferedStats() : ELogStats(ELOG_BUFFERED_STATS_VAR_COUNT) {}
     ELogBufferedStats(const ELogBufferedStats&) = delete;
     ELogBufferedStats(ELogBufferedStats&&) = delete;
     ELogBufferedStats& operator=(const ELogBufferedStats&) = delete;
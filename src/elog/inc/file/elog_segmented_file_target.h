@@ -24,6 +24,9 @@ namespace elog {
 /** @def The default ring buffer size used for pending messages during segment switch. */
 #define ELOG_DEFAULT_SEGMENT_RING_SIZE (1024ul * 1024ul)
 
+/** @def The number of statistics variables of the segmented log file target. */
+#define ELOG_SEGMENTED_STATS_VAR_COUNT 5
+
 /**
  * @brief A lock-free segmented log file target, that breaks log file into segments by a configured
  * segment size limit. The segmented log file target can be combined with a user specified flush
@@ -112,7 +115,7 @@ private:
     };
 
     struct SegmentedStats : public ELogStats {
-        SegmentedStats() {}
+        SegmentedStats() : ELogStats(ELOG_SEGMENTED_STATS_VAR_COUNT) {}
         SegmentedStats(const SegmentedStats&) = delete;
         SegmentedStats(SegmentedStats&&) = delete;
         SegmentedStats& operator=(const SegmentedStats&) = delete;
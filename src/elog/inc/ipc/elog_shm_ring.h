@@ -0,0 +1,278 @@
+#ifndef __ELOG_SHM_RING_H__
+#define __ELOG_SHM_RING_H__
+
+#include "elog_def.h"
+
+#if defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** @def Magic word identifying ELog shared memory ring segments ("ELOGRING"). */
+#define ELOG_SHM_RING_MAGIC 0x474E4952474F4C45ull
+
+/** @def Version of the shared memory ring layout. */
+#define ELOG_SHM_RING_VERSION 2
+
+/**
+ * @def Name prefix of all ELog shared memory ring segments. The full POSIX shared memory object
+ * name is "/elog_ring.<name>", so that rings can be easily listed (e.g. by elog_pm).
+ */
+#define ELOG_SHM_RING_PREFIX "elog_ring."
+
+/** @brief Min/Max/Default shared memory ring data area size (rounded up to a power of 2). */
+#define ELOG_SHM_RING_MIN_SIZE (64ull * 1024ull)
+#define ELOG_SHM_RING_MAX_SIZE (1024ull * 1024ull * 1024ull)
+#define ELOG_SHM_RING_DEFAULT_SIZE (4ull * 1024ull * 1024ull)
+
+/** @def Alignment of each record in the shared memory ring. */
+#define ELOG_SHM_RING_RECORD_ALIGN 8
+
+/**
+ * @def The minimum time (in milliseconds) the consumer waits on a record that was reserved but not
+ * yet committed, before checking whether the writer process is still alive.
+ */
+#define ELOG_SHM_RING_LIVENESS_CHECK_MILLIS 100
+
+namespace elog {
+
+/** @brief Record state values, stored in the commit word of each record header. */
+enum ELogShmRecordState : uint32_t {
+    /** @var Record area is free, or record is still being written by a producer. */
+    ELOG_SHM_RECORD_EMPTY = 0,
+
+    /** @var Record is fully written and may be consumed. */
+    ELOG_SHM_RECORD_COMMITTED = 1,
+
+    /** @var Padding record at the end of the data area, should be skipped by the consumer. */
+    ELOG_SHM_RECORD_PADDING = 2,
+
+    /**
+     * @var Record space is reserved and its size is set, but the record is still being written by a
+     * producer. If the writer process dies in this state, the consumer can skip the record.
+     */
+    ELOG_SHM_RECORD_RESERVED = 3
+};
+
+/** @brief Header of a single record in the shared memory ring. */
+struct ELogShmRecordHeader {
+    /** @var The record state (see @ref ELogShmRecordState). Written last by the producer. */
+    std::atomic<uint32_t> m_commitWord;
+
+    /** @var The record payload size in bytes (not including this header and alignment). */
+    uint32_t m_payloadSize;
+};
+
+/**
+ * @brief Header of the shared memory ring segment. Positions are monotonically increasing byte
+ * offsets, which are mapped to the data area by masking with the (power of 2) capacity. Producers
+ * reserve space by advancing the reserve position with CAS, and the single consumer releases space
+ * by advancing the read position after zeroing consumed records.
+ */
+struct ELogShmRingHeader {
+    uint64_t m_magic;
+    uint32_t m_version;
+    uint32_t m_dataOffset;
+    uint64_t m_capacity;
+    uint64_t m_writerPid;
+    int64_t m_createTimeEpochMillis;
+
+    /** @var Next position to be reserved by producers. */
+    ELOG_CACHE_ALIGN std::atomic<uint64_t> m_reservePos;
+
+    /** @var Next position to be consumed by the reader. */
+    ELOG_CACHE_ALIGN std::atomic<uint64_t> m_readPos;
+
+    /** @var Futex word used for consumer wake-ups (incremented by producers on wake-up). */
+    ELOG_CACHE_ALIGN std::atomic<uint32_t> m_futexWord;
+
+    /** @var The number of consumers currently waiting on the futex word. */
+    std::atomic<uint32_t> m_waiterCount;
+
+    /** @var Total number of records written to the ring. */
+    ELOG_CACHE_ALIGN std::atomic<uint64_t> m_recordCount;
+
+    /** @var Total number of records dropped due to full ring. */
+    std::atomic<uint64_t> m_dropCount;
+
+    /**
+     * @var Total number of records reserved but never committed (due to writer crash), which were
+     * skipped by the consumer.
+     */
+    std::atomic<uint64_t> m_abandonCount;
+
+    /**
+     * @var The reserve position at the time the current writer attached. All space below this
+     * position was reserved by a previous writer process, so uncommitted records there are
+     * abandoned, and may be skipped by the consumer immediately.
+     */
+    std::atomic<uint64_t> m_reclaimPos;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared memory ring requires lock-free 64 bit atomics");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "Shared memory ring requires lock-free 32 bit atomics");
+
+/** @typedef List of shared memory ring names and total segment sizes. */
+typedef std::vector<std::pair<std::string, uint64_t>> ELogShmRingList;
+
+/**
+ * @brief A POSIX shared memory ring buffer for passing formatted log records to a collector
+ * process on the same host. Multiple producer threads (within the writing process) may write
+ * concurrently without locks, while a single consumer (usually in another process) reads records
+ * in place, without copying. When the ring is empty the consumer may block on a futex, and
+ * producers wake it up only if it is actually waiting.
+ *
+ * A producer that crashes after reserving a record but before committing it would otherwise block
+ * the consumer forever. The writer holds a shared file lock on the segment while it is attached, so
+ * the consumer can detect that the writer is gone, and skip such abandoned records. Abandoned records
+ * left by a previous writer are also skipped immediately after a new writer re-attaches.
+ */
+class ELOG_API ELogShmRing {
+public:
+    ELogShmRing()
+        : m_header(nullptr),
+          m_data(nullptr),
+          m_capacity(0),
+          m_mask(0),
+          m_mapSize(0),
+          m_fd(-1),
+          m_isOwner(false),
+          m_peekSize(0),
+          m_stallPos(UINT64_MAX),
+          m_stallTimeMillis(0) {}
+    ELogShmRing(const ELogShmRing&) = delete;
+    ELogShmRing(ELogShmRing&&) = delete;
+    ELogShmRing& operator=(const ELogShmRing&) = delete;
+    ~ELogShmRing() { (void)close(); }
+
+    /**
+     * @brief Creates (or re-attaches to) a shared memory ring (writer side).
+     * @param name The ring name (without the "elog_ring." prefix).
+     * @param capacity The requested data area size in bytes (rounded up to a power of 2).
+     * @return The operation result.
+     */
+    bool create(const char* name, uint64_t capacity);
+
+    /**
+     * @brief Opens an existing shared memory ring (reader side).
+     * @param name The ring name (without the "elog_ring." prefix).
+     * @return The operation result.
+     */
+    bool open(const char* name);
+
+    /**
+     * @brief Closes the shared memory ring.
+     * @param unlink Specifies whether to also remove the shared memory object.
+     */
+    bool close(bool unlink = false);
+
+    /** @brief Queries whether the ring is open. */
+    inline bool isOpen() const { return m_header != nullptr; }
+
+    /**
+     * @brief Writes a record into the ring (thread-safe, lock-free). If the ring is full the
+     * record is dropped, and the drop counter is incremented.
+     * @param data The record data.
+     * @param length The record length in bytes.
+     * @return True if the record was written, or false if the record was dropped.
+     */
+    bool write(const char* data, uint32_t length);
+
+    /**
+     * @brief Wakes up the consumer, if it is waiting. This is done automatically after each write,
+     * but may also be called explicitly (e.g. during flush).
+     */
+    void notify();
+
+    /**
+     * @brief Retrieves the next record in the ring, without consuming it (single consumer only).
+     * The returned pointer points directly into the shared memory segment, and remains valid until
+     * @ref consume() is called. Abandoned records (reserved by a writer that is no longer alive) are
+     * skipped and counted in the ring header.
+     * @param[out] data The record data.
+     * @param[out] length The record length.
+     * @return True if a record is available, otherwise false.
+     */
+    bool peek(const char*& data, uint32_t& length);
+
+    /** @brief Consumes the record last returned by @ref peek(), releasing its space. */
+    void consume();
+
+    /**
+     * @brief Waits until a record is available or the timeout expires (single consumer only).
+     * @param timeoutMillis The timeout in milliseconds.
+     * @return True if a record is available, otherwise false.
+     */
+    bool wait(uint64_t timeoutMillis);
+
+    /**
+     * @brief Iterates over pending records without consuming them (for inspection only, may be
+     * called concurrently with a consumer, in which case results may be inaccurate).
+     * @param[in,out] pos The position to inspect. Should be initialized with @ref getReadPos().
+     * On return points to the next record.
+     * @param[out] data The record data.
+     * @param[out] length The record length.
+     * @return True if a committed record was found at the given position, otherwise false.
+     */
+    bool inspect(uint64_t& pos, const char*& data, uint32_t& length) const;
+
+    /** @brief Retrieves the ring header (for inspection and statistics). */
+    inline const ELogShmRingHeader* getHeader() const { return m_header; }
+
+    /** @brief Retrieves the current read position. */
+    inline uint64_t getReadPos() const {
+        return m_header->m_readPos.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Lists all ELog shared memory rings on the local host.
+     * @param[out] ringList The resulting ring list (name without prefix and segment size).
+     * @return The operation result.
+     */
+    static bool listRings(ELogShmRingList& ringList);
+
+    /**
+     * @brief Deletes a shared memory ring.
+     * @param name The ring name (without the "elog_ring." prefix).
+     * @return The operation result.
+     */
+    static bool unlinkRing(const char* name);
+
+private:
+    ELogShmRingHeader* m_header;
+    char* m_data;
+    uint64_t m_capacity;
+    uint64_t m_mask;
+    uint64_t m_mapSize;
+    int m_fd;
+    bool m_isOwner;
+    uint64_t m_peekSize;
+    uint64_t m_stallPos;
+    uint64_t m_stallTimeMillis;
+    std::string m_shmName;
+
+    inline ELogShmRecordHeader* getRecordHeader(uint64_t pos) const {
+        return (ELogShmRecordHeader*)(m_data + (pos & m_mask));
+    }
+
+    inline static uint64_t alignRecordSize(uint64_t size) {
+        const uint64_t align = ELOG_SHM_RING_RECORD_ALIGN;
+        return (size + align - 1) & ~(align - 1);
+    }
+
+    bool mapSegment(uint64_t mapSize, bool readOnly);
+    void releaseSpace(uint64_t pos, uint64_t size);
+    bool recoverStalledRecord(uint64_t pos);
+    void skipAbandonedRecord(uint64_t pos, uint64_t endPos);
+};
+
+}  // namespace elog
+
+#endif  // defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
+
+#endif  // __ELOG_SHM_RING_H__
@@ -0,0 +1,77 @@
+#ifndef __ELOG_SHM_TARGET_H__
+#define __ELOG_SHM_TARGET_H__
+
+#include "elog_def.h"
+
+#if defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
+
+#include <string>
+
+#include "elog_target.h"
+#include "ipc/elog_shm_ring.h"
+
+namespace elog {
+
+/**
+ * @brief Log target writing formatted log records into a POSIX shared memory ring, for consumption
+ * by a collector process on the same host (see @ref ELogShmRing for the reader API). Writing is
+ * lock-free, and records are dropped (and counted) when the ring is full, so that logging threads
+ * never block on a slow collector.
+ */
+class ELOG_API ELogShmTarget : public ELogTarget {
+public:
+    /**
+     * @brief Construct a new ELogShmTarget object.
+     * @param ringName The shared memory ring name.
+     * @param ringSize The shared memory ring data area size in bytes (rounded up to power of 2).
+     * @param unlinkOnStop Specifies whether the shared memory object should be removed when the
+     * log target stops.
+     * @param flushPolicy Optional flush policy to use.
+     * @param enableStats Specifies whether log target statistics should be collected.
+     */
+    ELogShmTarget(const char* ringName, uint64_t ringSize = ELOG_SHM_RING_DEFAULT_SIZE,
+                  bool unlinkOnStop = false, ELogFlushPolicy* flushPolicy = nullptr,
+                  bool enableStats = true)
+        : ELogTarget("shm", flushPolicy, enableStats),
+          m_ringName(ringName),
+          m_ringSize(ringSize),
+          m_unlinkOnStop(unlinkOnStop) {
+        setNativelyThreadSafe();
+    }
+    ELogShmTarget(const ELogShmTarget&) = delete;
+    ELogShmTarget(ELogShmTarget&&) = delete;
+    ELogShmTarget& operator=(const ELogShmTarget&) = delete;
+
+    ELOG_DECLARE_LOG_TARGET(ELogShmTarget)
+
+    /** @brief Retrieves the number of log records dropped due to full ring. */
+    inline uint64_t getDropCount() const {
+        return m_ring.isOpen() ? m_ring.getHeader()->m_dropCount.load(std::memory_order_relaxed)
+                               : 0;
+    }
+
+protected:
+    /** @brief Log a formatted message. */
+    bool logFormattedMsg(const char* formattedLogMsg, size_t length) final;
+
+    /** @brief Order the log target to start (required for threaded targets). */
+    bool startLogTarget() final;
+
+    /** @brief Order the log target to stop (required for threaded targets). */
+    bool stopLogTarget() final;
+
+    /** @brief Orders a buffered log target to flush it log messages. */
+    bool flushLogTarget() final;
+
+private:
+    std::string m_ringName;
+    uint64_t m_ringSize;
+    bool m_unlinkOnStop;
+    ELogShmRing m_ring;
+};
+
+}  // namespace elog
+
+#endif  // defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
+
+#endif  // __ELOG_SHM_TARGET_H__
@@ -21,8 +21,6 @@
 #endif
 #endif
 
-#include <nlohmann/json.hpp>
-
 #include "elog_http_client.h"
 #include "elog_mon_target.h"
 #include "elog_props_formatter.h"
@@ -82,9 +80,16 @@ private:
     bool m_compress;
 
     ELogHttpClient m_client;
-    nlohmann::json m_logItemArray;
     ELogPropsFormatter* m_tagsFormatter;
 
+    /** @var Pending log items, written directly as a JSON array (without closing bracket). */
+    std::string m_logItems;
+    uint32_t m_logItemCount;
+
+    // reused between log records to avoid allocations
+    std::string m_logMsg;
+    std::string m_tagsStr;
+
     inline bool parseTags(const std::string& tags) { return m_tagsFormatter->parseProps(tags); }
 
     inline const std::vector<std::string>& getTagNames() const {
@@ -97,6 +102,11 @@ private:
 
     bool prepareTagsString(const std::vector<std::string>& propNames,
                            const std::vector<std::string>& propValues, std::string& tags);
+
+    inline void resetLogItems() {
+        m_logItems.assign(1, '[');
+        m_logItemCount = 0;
+    }
 };
 
 }  // namespace elog
@@ -21,8 +21,6 @@
 #endif
 #endif
 
-#include <nlohmann/json.hpp>
-
 #include "elog_grafana_target.h"
 #include "elog_props_formatter.h"
 
@@ -35,6 +33,7 @@ public:
         : ELogGrafanaTarget(lokiAddress, config),
           m_labels(labels),
           m_logLineMetadata(logLineMetadata),
+          m_logLineCount(0),
           m_labelFormatter(nullptr),
           m_metadataFormatter(nullptr) {}
 
@@ -65,7 +64,16 @@ protected:
 private:
     std::string m_labels;
     std::string m_logLineMetadata;
-    nlohmann::json m_logEntry;
+
+    /**
+     * @var The pending request body, written directly as JSON up to the last log line (closing
+     * brackets are added during flush).
+     */
+    std::string m_logEntry;
+    uint32_t m_logLineCount;
+
+    // reused between log records to avoid allocations
+    std::string m_logMsg;
     ELogPropsFormatter* m_labelFormatter;
     ELogPropsFormatter* m_metadataFormatter;
 
@@ -28,6 +28,9 @@ namespace elog {
 /**
  * @brief Abstract class for implementing server-side of ELog log record reporting protocol.
  * Sub-classes should implement the message handling pure virtual method @ref handleLogRecordMsg().
+ * @note A single client log target may open several connections to the server (see 'connections'
+ * property of message-based log targets). Each such connection is handled as a separate session,
+ * with its own duplicate detection state, since request ids are generated per connection.
  */
 class ELOG_API ELogMsgServer : public commutil::MsgFrameListener {
 public:
@@ -53,7 +56,8 @@ public:
      * @param maxConnections The maximum number of connections the server can handle concurrently.
      * This holds true also for datagram server, in which case there is a limit to the number of
      * different servers sending datagrams to the server, along with some expiry control. @see
-     * UdpServer for more information.
+     * UdpServer for more information. Note that clients using several connections (shards)
+     * occupy one connection slot per shard.
      * @param concurrency The level of concurrency to enforce. Determines the number of worker
      * threads.
      * @param bufferSize The buffer size used for each server connection I/O. Specify a buffer size
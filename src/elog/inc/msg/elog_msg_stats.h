@@ -5,8 +5,45 @@
 
 namespace elog {
 
+/** @def The number of statistics variables in @ref ELogMsgStats. */
+#define ELOG_MSG_STATS_VAR_COUNT 8
+
+/**
+ * @brief Statistics of a single connection (shard) of a message-based log target. Comparing the
+ * number of records queued on each shard with the number of records acknowledged by the server
+ * helps to determine whether the client or the server side is the bottleneck.
+ */
+struct ELOG_CACHE_ALIGN ELogMsgShardStats {
+    /** @brief The number of log records queued on the shard. */
+    std::atomic<uint64_t> m_recordCount;
+
+    /** @brief The number of message batches sent through the shard. */
+    std::atomic<uint64_t> m_sendCount;
+
+    /** @brief The number of failed send attempts through the shard. */
+    std::atomic<uint64_t> m_sendFailCount;
+
+    /** @brief The total number of bytes sent through the shard. */
+    std::atomic<uint64_t> m_sendByteCount;
+
+    /** @brief The number of log records acknowledged by the server on the shard. */
+    std::atomic<uint64_t> m_processedMsgCount;
+
+    ELogMsgShardStats()
+        : m_recordCount(0),
+          m_sendCount(0),
+          m_sendFailCount(0),
+          m_sendByteCount(0),
+          m_processedMsgCount(0) {}
+    ELogMsgShardStats(const ELogMsgShardStats&) = delete;
+    ELogMsgShardStats(ELogMsgShardStats&&) = delete;
+    ELogMsgShardStats& operator=(const ELogMsgShardStats&) = delete;
+    ~ELogMsgShardStats() {}
+};
+
 struct ELOG_API ELogMsgStats : public ELogStats {
-    ELogMsgStats() {}
+    ELogMsgStats(uint32_t shardCount = 1)
+        : ELogStats(ELOG_MSG_STATS_VAR_COUNT), m_shardCount(shardCount), m_shardStats(nullptr) {}
     ELogMsgStats(const ELogMsgStats&) = delete;
     ELogMsgStats(ELogMsgStats&&) = delete;
     ELogMsgStats& operator=(const ELogMsgStats&) = delete;
@@ -26,8 +63,18 @@ struct ELOG_API ELogMsgStats : public ELogStats {
         m_compressedSendByteCount.add(getSlotId(), bytes);
     }
 
-    void updateSendStats(uint64_t sendBytes, uint64_t compressedBytes, int status);
-    void updateRecvStats(uint64_t recvBytes, uint64_t msgProcessed);
+    void updateSendStats(uint64_t sendBytes, uint64_t compressedBytes, int status,
+                         uint32_t shardId = 0);
+    void updateRecvStats(uint64_t recvBytes, uint64_t msgProcessed, uint32_t shardId = 0);
+
+    // per-shard statistics
+    inline void incrementShardRecordCount(uint32_t shardId) {
+        m_shardStats[shardId].m_recordCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    inline uint32_t getShardCount() const { return m_shardCount; }
+    inline const ELogMsgShardStats& getShardStats(uint32_t shardId) const {
+        return m_shardStats[shardId];
+    }
 
     // recv statistics
     inline void incrementRecvCount() { m_recvCount.add(getSlotId(), 1); }
@@ -84,6 +131,12 @@ private:
 
     /** @brief The number of log messages processed and acknowledged by the server. */
     ELogStatVar m_processedMsgCount;
+
+    /** @brief The number of connections (shards) used by the log target. */
+    uint32_t m_shardCount;
+
+    /** @brief Per-shard statistics. */
+    ELogMsgShardStats* m_shardStats;
 };
 
 }  // namespace elog
@@ -9,6 +9,10 @@
 #include <msg/msg_sender.h>
 #include <transport/data_client.h>
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 #include "elog_target.h"
 #include "msg/elog_binary_format_provider.h"
 #include "msg/elog_msg.h"
@@ -18,74 +22,35 @@
 namespace elog {
 
 /** @brief Abstract parent class for messaging log targets. */
-class ELOG_API ELogMsgTarget : public ELogTarget,
-                               public commutil::MsgFrameListener,
-                               public commutil::MsgStatListener {
+class ELOG_API ELogMsgTarget : public ELogTarget {
 public:
+    /**
+     * @brief Constructs a messaging log target using a single connection.
+     * @param name The log target name.
+     * @param msgConfig The common messaging configuration.
+     * @param dataClient The transport layer client. The log target takes ownership.
+     */
     ELogMsgTarget(const char* name, const ELogMsgConfig& msgConfig,
                   commutil::DataClient* dataClient)
-        : ELogTarget(name),
-          m_msgConfig(msgConfig.m_commConfig),
-          m_dataClient(dataClient),
-          m_binaryFormatProvider(msgConfig.m_binaryFormatProvider),
-          m_msgStats(nullptr),
-          m_syncMode(msgConfig.m_syncMode),
-          m_compress(msgConfig.m_compress),
-          m_maxConcurrentRequests(msgConfig.m_maxConcurrentRequests) {}
+        : ELogMsgTarget(name, msgConfig, std::vector<commutil::DataClient*>(1, dataClient)) {}
+
+    /**
+     * @brief Constructs a messaging log target using several connections (shards). Each shard
+     * has its own message client, sender and pending message buffer array, so that log records
+     * may be sent concurrently over several connections.
+     * @param name The log target name.
+     * @param msgConfig The common messaging configuration.
+     * @param dataClients The transport layer clients, one per shard. The log target takes
+     * ownership.
+     */
+    ELogMsgTarget(const char* name, const ELogMsgConfig& msgConfig,
+                  const std::vector<commutil::DataClient*>& dataClients);
     ELogMsgTarget(const ELogMsgTarget&) = delete;
     ELogMsgTarget(ELogMsgTarget&&) = delete;
     ELogMsgTarget& operator=(const ELogMsgTarget&) = delete;
 
     ELOG_DECLARE_LOG_TARGET(ELogMsgTarget)
 
-    /**
-     * @brief Notifies on sent message statistics.
-     * @param msgSizeBytes The payload size (not including framing protocol header).
-     * @param compressedMsgSizeBytes The compressed pay load size, in case compression is used,
-     * otherwise zero.
-     * @param status Denotes send result status. Zero means success.
-     */
-    void onSendMsgStats(uint32_t msgSizeBytes, uint32_t compressedMsgSizeBytes,
-                        int status) override;
-
-    /**
-     * @brief Notifies on received message statistics.
-     * @param msgSizeBytes The payload size (not including framing protocol header).
-     * @param compressedMsgSizeBytes The compressed pay load size, in case compression is used,
-     * otherwise zero.
-     */
-    void onRecvMsgStats(uint32_t msgSizeBytes, uint32_t compressedMsgSizeBytes) override;
-
-    /**
-     * @brief Handles incoming message buffer. Subclasses are responsible for actual
-     * deserialization. The messaging layer provides only framing services.
-     * @param connectionDetails The client's connection details.
-     * @param msgHeader The header of the incoming meta-message frame.
-     * @param msgBuffer The message buffer.
-     * @param bufferSize The buffer length.
-     * @param lastInBatch Designates whether this is the last message within a message batch. In
-     * case of a single message this is always true.
-     * @param batchSize The number of messages in the message batch. In case of a single message
-     * this is always 1.
-     * @return Message handling result. If message handling within a batch should continue then
-     * return @ref E_OK, otherwise deriving sub-classes should return error code (e.g. irrecoverable
-     * deserialization error), in which case @ref handleMsgError() is NOT called, and if some error
-     * status needs to be sent to the client, then deriving sub-classes are responsible for that.
-     */
-    commutil::ErrorCode handleMsg(const commutil::ConnectionDetails& connectionDetails,
-                                  const commutil::MsgHeader& msgHeader, const char* msgBuffer,
-                                  uint32_t bufferSize, bool lastInBatch,
-                                  uint32_t batchSize) override;
-
-    /**
-     * @brief Handle errors during message unpacking.
-     * @param connectionDetails The client's connection details.
-     * @param msgHeader The header of the incoming meta-message.
-     * @param status Deserialization error status.
-     */
-    void handleMsgError(const commutil::ConnectionDetails& connectionDetails,
-                        const commutil::MsgHeader& msgHeader, int status) override;
-
     /**
      * @brief Retrieves the number of messages that were fully processed by the log target. This
      * includes failed log messages. In case of a compound log target, the request is delegated to
@@ -95,6 +60,9 @@ public:
      */
     uint64_t getProcessedMsgCount() override;
 
+    /** @brief Retrieves the number of connections (shards) used by the log target. */
+    inline uint32_t getShardCount() const { return (uint32_t)m_shards.size(); }
+
 protected:
     /**
      * @brief Order the log target to start. In the case of a network target this means starting all
@@ -123,13 +91,100 @@ protected:
     /** @brief Creates a statistics object. */
     ELogStats* createStats() final;
 
+    /**
+     * @brief A single connection of the log target. Each shard has its own transport client,
+     * message client/sender and pending message buffer array, and is protected by its own lock
+     * when the log target uses more than one shard.
+     */
+    class ELogMsgShard : public commutil::MsgFrameListener, public commutil::MsgStatListener {
+    public:
+        ELogMsgShard(ELogMsgTarget* target, uint32_t shardId, commutil::DataClient* dataClient)
+            : m_target(target), m_shardId(shardId), m_dataClient(dataClient) {}
+        ELogMsgShard(const ELogMsgShard&) = delete;
+        ELogMsgShard(ELogMsgShard&&) = delete;
+        ELogMsgShard& operator=(const ELogMsgShard&) = delete;
+        ~ELogMsgShard() override {}
+
+        /**
+         * @brief Notifies on sent message statistics.
+         * @param msgSizeBytes The payload size (not including framing protocol header).
+         * @param compressedMsgSizeBytes The compressed pay load size, in case compression is used,
+         * otherwise zero.
+         * @param status Denotes send result status. Zero means success.
+         */
+        void onSendMsgStats(uint32_t msgSizeBytes, uint32_t compressedMsgSizeBytes,
+                            int status) override;
+
+        /**
+         * @brief Notifies on received message statistics.
+         * @param msgSizeBytes The payload size (not including framing protocol header).
+         * @param compressedMsgSizeBytes The compressed pay load size, in case compression is used,
+         * otherwise zero.
+         */
+        void onRecvMsgStats(uint32_t msgSizeBytes, uint32_t compressedMsgSizeBytes) override;
+
+        /**
+         * @brief Handles incoming status response message buffer.
+         * @param connectionDetails The server's connection details.
+         * @param msgHeader The header of the incoming meta-message frame.
+         * @param msgBuffer The message buffer.
+         * @param bufferSize The buffer length.
+         * @param lastInBatch Designates whether this is the last message within a message batch.
+         * @param batchSize The number of messages in the message batch.
+         * @return Message handling result.
+         */
+        commutil::ErrorCode handleMsg(const commutil::ConnectionDetails& connectionDetails,
+                                      const commutil::MsgHeader& msgHeader, const char* msgBuffer,
+                                      uint32_t bufferSize, bool lastInBatch,
+                                      uint32_t batchSize) override;
+
+        /**
+         * @brief Handle errors during message unpacking.
+         * @param connectionDetails The server's connection details.
+         * @param msgHeader The header of the incoming meta-message.
+         * @param status Deserialization error status.
+         */
+        void handleMsgError(const commutil::ConnectionDetails& connectionDetails,
+                            const commutil::MsgHeader& msgHeader, int status) override;
+
+        /** @brief Starts the shard's message client and sender. */
+        bool start();
+
+        /** @brief Stops the shard's message client and sender. */
+        bool stop();
+
+        /** @brief Sends all pending messages of the shard. */
+        bool flush();
+
+        ELogMsgTarget* m_target;
+        uint32_t m_shardId;
+        commutil::DataClient* m_dataClient;
+        commutil::MsgClient m_msgClient;
+        commutil::MsgSender m_msgSender;
+        commutil::MsgBufferArray m_msgBufferArray;
+        std::mutex m_lock;
+    };
+
+    /** @brief Selects the shard for the current log record. */
+    ELogMsgShard* selectShard();
+
+    /**
+     * @brief Locks a shard. With a single shard the log target lock already serializes access to
+     * the shard, so the shard lock is not taken.
+     */
+    inline std::unique_lock<std::mutex> lockShard(ELogMsgShard* shard) {
+        if (m_shards.size() == 1) {
+            return std::unique_lock<std::mutex>(shard->m_lock, std::defer_lock);
+        }
+        return std::unique_lock<std::mutex>(shard->m_lock);
+    }
+
     commutil::MsgConfig m_msgConfig;
-    commutil::DataClient* m_dataClient;
-    commutil::MsgClient m_msgClient;
-    commutil::MsgSender m_msgSender;
+    std::vector<ELogMsgShard*> m_shards;
     ELogBinaryFormatProvider* m_binaryFormatProvider;
     ELogMsgStats* m_msgStats;
-    commutil::MsgBufferArray m_msgBufferArray;
+    ELogMsgShardMode m_shardMode;
+    std::atomic<uint64_t> m_nextShard;
     bool m_syncMode;
     bool m_compress;
     uint32_t m_maxConcurrentRequests;
@@ -27,6 +27,18 @@ public:
     void receiveStaticText(uint32_t typeId, const std::string& text,
                            const ELogFieldSpec& fieldSpec) override;
 
+    /** @brief Receives the time in nanoseconds elapsed since process start. */
+    void receiveRelativeTime(uint32_t typeId, uint64_t relativeTimeNanos,
+                             const ELogFieldSpec& fieldSpec) override;
+
+    /** @brief Receives the time in nanoseconds elapsed since the log source was created. */
+    void receiveSourceRelativeTime(uint32_t typeId, uint64_t relativeTimeNanos,
+                                   const ELogFieldSpec& fieldSpec) override;
+
+    /** @brief Receives the time in nanoseconds elapsed since the previous record of the thread. */
+    void receiveThreadDelta(uint32_t typeId, uint64_t deltaNanos,
+                            const ELogFieldSpec& fieldSpec) override;
+
     /** @brief Receives the log record id. */
     void receiveRecordId(uint32_t typeId, uint64_t recordId,
                          const ELogFieldSpec& fieldSpec) override;
@@ -7,21 +7,74 @@
 
 #include <librdkafka/rdkafka.h>
 
+#include <mutex>
+#include <vector>
+
 #include "elog_msgq_target.h"
 
+/** @def The default size of the kafka payload buffer pool. */
+#define ELOG_KAFKA_DEFAULT_BUFFER_POOL_SIZE 1024
+
+/** @def The maximum size of the kafka payload buffer pool. */
+#define ELOG_KAFKA_MAX_BUFFER_POOL_SIZE (1024 * 1024)
+
 namespace elog {
 
+/** @brief Message key used for kafka keyed partitioning. */
+enum class ELogKafkaPartitionKey : uint32_t {
+    /** @var No message key is used (messages are distributed by the partitioner). */
+    KPK_NONE,
+
+    /** @var The qualified name of the log source is used as message key. */
+    KPK_SOURCE,
+
+    /** @var The issuing thread id is used as message key. */
+    KPK_THREAD
+};
+
+/**
+ * @brief Kafka producer tuning parameters. Empty string values and zero numeric values denote
+ * the librdkafka defaults.
+ */
+struct ELOG_API ELogKafkaProducerParams {
+    /** @var Time to wait for more messages before sending a batch (linger.ms). */
+    uint64_t m_lingerMillis;
+
+    /** @var Maximum size in bytes of a message batch (batch.size). */
+    uint64_t m_batchSizeBytes;
+
+    /** @var Compression codec (none, gzip, snappy, lz4, zstd). */
+    std::string m_compression;
+
+    /** @var Partitioner (random, consistent, consistent_random, murmur2, murmur2_random, etc.). */
+    std::string m_partitioner;
+
+    /** @var Message key used for keyed partitioning. */
+    ELogKafkaPartitionKey m_partitionKey;
+
+    /** @var Number of recycled payload buffers (zero disables zero-copy produce). */
+    uint32_t m_bufferPoolSize;
+
+    ELogKafkaProducerParams()
+        : m_lingerMillis(0),
+          m_batchSizeBytes(0),
+          m_partitionKey(ELogKafkaPartitionKey::KPK_NONE),
+          m_bufferPoolSize(ELOG_KAFKA_DEFAULT_BUFFER_POOL_SIZE) {}
+};
+
 class ELOG_API ELogKafkaMsgQTarget : public ELogMsgQTarget {
 public:
     ELogKafkaMsgQTarget(const std::string& bootstrapServers, const std::string& topicName,
                         const std::string& headers, int partition = -1,
-                        uint64_t flushTimeoutMillis = 0, uint64_t shutdownFlushTimeoutMillis = 0)
+                        uint64_t flushTimeoutMillis = 0, uint64_t shutdownFlushTimeoutMillis = 0,
+                        const ELogKafkaProducerParams& producerParams = ELogKafkaProducerParams())
         : m_bootstrapServers(bootstrapServers),
           m_topicName(topicName),
           m_headers(headers),
           m_partition(partition),
           m_flushTimeoutMillis(flushTimeoutMillis),
           m_shutdownFlushTimeoutMillis(shutdownFlushTimeoutMillis),
+          m_producerParams(producerParams),
           m_conf(nullptr),
           m_topicConf(nullptr),
           m_producer(nullptr),
@@ -58,6 +111,7 @@ private:
     int m_partition;
     uint64_t m_flushTimeoutMillis;
     uint64_t m_shutdownFlushTimeoutMillis;
+    ELogKafkaProducerParams m_producerParams;
 
     std::string m_clientId;
     rd_kafka_conf_t* m_conf;
@@ -65,11 +119,24 @@ private:
     rd_kafka_t* m_producer;
     rd_kafka_topic_t* m_topic;
 
+    // recycled payload buffers, handed over to librdkafka without copying, and returned to the
+    // pool by the delivery report callback
+    std::vector<std::string*> m_bufferPool;
+    std::vector<std::string*> m_freeBuffers;
+    std::mutex m_bufferLock;
+
     void formatClientId();
 
-    // void convertToPgParamTypes();
-    void formatConnString(const std::string& host, uint32_t port, const std::string& db,
-                          const std::string& user, const std::string& passwd);
+    bool setConfProperty(const char* propName, const char* propValue);
+    bool setTopicConfProperty(const char* propName, const char* propValue);
+
+    bool initBufferPool();
+    void termBufferPool();
+    std::string* allocBuffer();
+    void releaseBuffer(std::string* buffer);
+
+    static void onDeliveryReport(rd_kafka_t* producer, const rd_kafka_message_t* msg,
+                                 void* opaque);
 
     void cleanup();
 };
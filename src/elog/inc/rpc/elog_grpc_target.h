@@ -5,9 +5,13 @@
 
 #ifdef ELOG_ENABLE_GRPC_CONNECTOR
 
+#include <grpc/compression.h>
 #include <grpc/grpc.h>
 #include <grpcpp/channel.h>
 
+#include <chrono>
+#include <type_traits>
+
 // disable some annoying warnings coming from protobuf generated headers
 #ifdef ELOG_MSVC
 #pragma warning(push)
@@ -30,12 +34,26 @@
 /** @def Default maximum number of pending messages used by the reactor code. */
 #define ELOG_GRPC_DEFAULT_MAX_INFLIGHT_CALLS 1024
 
+/** @def Minimum number of log records packed in a single batch message (batch streaming mode). */
+#define ELOG_GRPC_MIN_BATCH_SIZE 8
+
+/** @def Default maximum number of log records packed in a single batch message. */
+#define ELOG_GRPC_DEFAULT_MAX_BATCH_SIZE 1024
+
+/**
+ * @def Default target latency (in microseconds) of writing a single batch message to the stream.
+ * Batch size is adapted such that single batch write latency converges to this value.
+ */
+#define ELOG_GRPC_DEFAULT_BATCH_LATENCY_MICROS 2000
+
 // gRPC log target has the following possible configurations:
 // - simple: each log record is sent synchronously, flush does nothing
 // - streaming: each log record is sent through a writer, only during flush the writer calls
 // WritesDone(), so never flush policy is not allowed, and immediate flush policy will have adverse
 // effect, as it acts like simple mode but with more overhead
 // - async: in this mode a completion queue is used, as in a synchronous, where a send-receive
+// - stream batch: same as streaming, but log records are packed into batch messages, whose size
+// adapts to the observed write latency, so that per-message overhead is amortized
 
 namespace elog {
 
@@ -53,7 +71,74 @@ enum class ELogGRPCClientMode : uint32_t {
     GRPC_CM_ASYNC_CALLBACK_UNARY,
 
     /** @var Asynchronous client with callback, employing stream reactor. */
-    GRPC_CM_ASYNC_CALLBACK_STREAM
+    GRPC_CM_ASYNC_CALLBACK_STREAM,
+
+    /** @var Steaming client, sending log records in adaptive-size batches. */
+    GRPC_CM_STREAM_BATCH
+};
+
+/** @brief Batch streaming parameters (used only with @ref GRPC_CM_STREAM_BATCH client mode). */
+struct ELOG_API ELogGRPCBatchParams {
+    /** @brief The maximum number of log records packed in a single batch message. */
+    uint32_t m_maxBatchSize;
+
+    /** @brief The target latency (in microseconds) of writing a single batch message. */
+    uint64_t m_batchLatencyMicros;
+
+    ELogGRPCBatchParams(uint32_t maxBatchSize = ELOG_GRPC_DEFAULT_MAX_BATCH_SIZE,
+                        uint64_t batchLatencyMicros = ELOG_GRPC_DEFAULT_BATCH_LATENCY_MICROS)
+        : m_maxBatchSize(maxBatchSize), m_batchLatencyMicros(batchLatencyMicros) {}
+};
+
+// helper for extracting the batch message type from the stream writer returned by the stub
+template <typename WriterPtrType>
+struct ELogGRPCWriterMsgType {};
+
+template <template <typename> class WriterType, typename BatchMessageType>
+struct ELogGRPCWriterMsgType<std::unique_ptr<WriterType<BatchMessageType>>> {
+    typedef BatchMessageType Type;
+};
+
+// batch streaming traits, used for detecting whether a service stub supports the batch streaming
+// RPC call StreamLogRecordBatches() (user-defined services are not required to define it)
+template <typename StubType, typename ResponseType, typename = void>
+struct ELogGRPCBatchTraits {
+    static constexpr bool HAS_BATCH_STREAM = false;
+};
+
+template <typename StubType, typename ResponseType>
+struct ELogGRPCBatchTraits<
+    StubType, ResponseType,
+    std::void_t<decltype(std::declval<StubType&>().StreamLogRecordBatches(
+        std::declval<grpc::ClientContext*>(), std::declval<ResponseType*>()))>> {
+    static constexpr bool HAS_BATCH_STREAM = true;
+    typedef decltype(std::declval<StubType&>().StreamLogRecordBatches(
+        std::declval<grpc::ClientContext*>(), std::declval<ResponseType*>())) BatchWriterPtrType;
+    typedef typename ELogGRPCWriterMsgType<BatchWriterPtrType>::Type BatchMessageType;
+};
+
+// batch streaming state (empty if the service stub does not support batch streaming)
+template <typename StubType, typename ResponseType,
+          bool HasBatchStream = ELogGRPCBatchTraits<StubType, ResponseType>::HAS_BATCH_STREAM>
+struct ELogGRPCBatchState {};
+
+template <typename StubType, typename ResponseType>
+struct ELogGRPCBatchState<StubType, ResponseType, true> {
+    typedef ELogGRPCBatchTraits<StubType, ResponseType> Traits;
+
+    /** @brief The batch stream writer. */
+    typename Traits::BatchWriterPtrType m_batchWriter;
+
+    /** @brief The currently accumulated batch. */
+    typename Traits::BatchMessageType m_batchMsg;
+
+    /** @brief The current (adaptive) batch size. */
+    uint32_t m_batchSize;
+
+    /** @brief The size in bytes of the log records in the currently accumulated batch. */
+    uint64_t m_batchBytes;
+
+    ELogGRPCBatchState() : m_batchSize(ELOG_GRPC_MIN_BATCH_SIZE), m_batchBytes(0) {}
 };
 
 template <typename MessageType = elog_grpc::ELogRecordMsg>
@@ -281,7 +366,9 @@ public:
                        const std::string& params, const std::string& serverCA,
                        const std::string& clientCA, const std::string& clientKey,
                        ELogGRPCClientMode clientMode = ELogGRPCClientMode::GRPC_CM_UNARY,
-                       uint64_t deadlineTimeoutMillis = 0, uint32_t maxInflightCalls = 0)
+                       uint64_t deadlineTimeoutMillis = 0, uint32_t maxInflightCalls = 0,
+                       grpc_compression_algorithm compression = GRPC_COMPRESS_NONE,
+                       const ELogGRPCBatchParams& batchParams = ELogGRPCBatchParams())
         : ELogRpcTarget(server.c_str(), "", 0, ""),
           m_logger("grpc.ELogGRPCBaseTarget"),
           m_reportHandler(reportHandler),
@@ -292,6 +379,8 @@ public:
           m_clientMode(clientMode),
           m_maxInflightCalls(maxInflightCalls),
           m_deadlineTimeoutMillis(deadlineTimeoutMillis),
+          m_compression(compression),
+          m_batchParams(batchParams),
           m_streamContext(nullptr),
           m_reactor(nullptr) {}
 
@@ -330,6 +419,8 @@ private:
     ELogGRPCClientMode m_clientMode;
     uint32_t m_maxInflightCalls;
     uint64_t m_deadlineTimeoutMillis;
+    grpc_compression_algorithm m_compression;
+    ELogGRPCBatchParams m_batchParams;
 
     // the stub
     std::unique_ptr<StubType> m_serviceStub;
@@ -339,6 +430,9 @@ private:
     ResponseType m_streamStatus;
     std::unique_ptr<grpc::ClientWriter<MessageType>> m_clientWriter;
 
+    // synchronous batch stream mode members
+    ELogGRPCBatchState<StubType, ResponseType> m_batchState;
+
     // asynchronous unary mode members
     grpc::CompletionQueue m_cq;
 
@@ -351,6 +445,7 @@ private:
     bool writeLogRecordAsync(const ELogRecord& logRecord, uint64_t& bytesWritten);
     bool writeLogRecordAsyncCallbackUnary(const ELogRecord& logRecord, uint64_t& bytesWritten);
     bool writeLogRecordAsyncCallbackStream(const ELogRecord& logRecord, uint64_t& bytesWritten);
+    bool writeLogRecordStreamBatch(const ELogRecord& logRecord, uint64_t& bytesWritten);
 
     // helper method to set single RPC call deadline
     inline void setDeadline(grpc::ClientContext& context) {
@@ -359,6 +454,13 @@ private:
         context.set_deadline(deadlineMillis);
     }
 
+    // helper method to set message compression for a single RPC call
+    inline void setCompression(grpc::ClientContext& context) {
+        if (m_compression != GRPC_COMPRESS_NONE) {
+            context.set_compression_algorithm(m_compression);
+        }
+    }
+
     bool createStreamContext();
     void destroyStreamContext();
 
@@ -369,6 +471,12 @@ private:
     bool createReactor();
     bool flushReactor();
     void destroyReactor();
+
+    bool createBatchWriter();
+    bool sendBatch();
+    void adaptBatchSize(uint64_t writeLatencyMicros);
+    bool flushBatchWriter();
+    void destroyBatchWriter();
 };
 
 /** @typedef Define the default GRPC log target type, using ELog protocol types. */
@@ -388,7 +496,9 @@ public:
                                            const std::string& clientKey,
                                            ELogGRPCClientMode clientMode,
                                            uint64_t deadlineTimeoutMillis,
-                                           uint32_t maxInflightCalls) = 0;
+                                           uint32_t maxInflightCalls,
+                                           grpc_compression_algorithm compression,
+                                           const ELogGRPCBatchParams& batchParams) = 0;
 
 protected:
     ELogGRPCBaseTargetConstructor() {}
@@ -417,11 +527,13 @@ public:
                                    const std::string& params, const std::string& serverCA,
                                    const std::string& clientCA, const std::string& clientKey,
                                    ELogGRPCClientMode clientMode, uint64_t deadlineTimeoutMillis,
-                                   uint32_t maxInflightCalls) final {
+                                   uint32_t maxInflightCalls,
+                                   grpc_compression_algorithm compression,
+                                   const ELogGRPCBatchParams& batchParams) final {
         return new ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
-                                      ReceptorType>(reportHandler, server, params, serverCA,
-                                                    clientCA, clientKey, clientMode,
-                                                    deadlineTimeoutMillis, maxInflightCalls);
+                                      ReceptorType>(
+            reportHandler, server, params, serverCA, clientCA, clientKey, clientMode,
+            deadlineTimeoutMillis, maxInflightCalls, compression, batchParams);
     }  // namespace elog
 };
 
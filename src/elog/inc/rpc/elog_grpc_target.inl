@@ -8,6 +8,7 @@
 #include <grpcpp/security/credentials.h>
 #include <grpcpp/support/interceptor.h>
 
+#include <algorithm>
 #include <climits>
 
 #define ELOG_INVALID_REQUEST_ID ((uint64_t)-1)
@@ -531,6 +532,16 @@ bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
             destroyStreamContext();
             return false;
         }
+    } else if (m_clientMode == ELogGRPCClientMode::GRPC_CM_STREAM_BATCH) {
+        // log records are counted as written only after their batch is sent
+        setDeferredWriteStats();
+        if (!createStreamContext()) {
+            return false;
+        }
+        if (!createBatchWriter()) {
+            destroyStreamContext();
+            return false;
+        }
     }
 
     return true;
@@ -555,6 +566,12 @@ bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
         }
         destroyReactor();
         destroyStreamContext();
+    } else if (m_clientMode == ELogGRPCClientMode::GRPC_CM_STREAM_BATCH) {
+        if (!flushBatchWriter()) {
+            return false;
+        }
+        destroyBatchWriter();
+        destroyStreamContext();
     }
 
     // delete the stub
@@ -580,6 +597,8 @@ bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
         return writeLogRecordAsyncCallbackUnary(logRecord, bytesWritten);
     } else if (m_clientMode == ELogGRPCClientMode::GRPC_CM_ASYNC_CALLBACK_STREAM) {
         return writeLogRecordAsyncCallbackStream(logRecord, bytesWritten);
+    } else if (m_clientMode == ELogGRPCClientMode::GRPC_CM_STREAM_BATCH) {
+        return writeLogRecordStreamBatch(logRecord, bytesWritten);
     }
 
     std::string errorMsg = "Cannot write log record, invalid gRPC client mode: ";
@@ -633,6 +652,22 @@ bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
             // TODO: sub-sequent writes will crash, this requires a uniform strategy (bad_alloc?)
             res = false;
         }
+    } else if (m_clientMode == ELogGRPCClientMode::GRPC_CM_STREAM_BATCH) {
+        if (!flushBatchWriter()) {
+            res = false;
+        }
+        destroyBatchWriter();
+        destroyStreamContext();
+
+        // regenerate context and batch writer for next messages
+        // NOTE: sub-sequent writes are silently dropped if this fails (see
+        // writeLogRecordStreamBatch())
+        if (!createStreamContext()) {
+            res = false;
+        } else if (!createBatchWriter()) {
+            destroyStreamContext();
+            res = false;
+        }
     }
 
     return res;
@@ -655,6 +690,7 @@ bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
     if (m_deadlineTimeoutMillis != 0) {
         setDeadline(context);
     }
+    setCompression(context);
 
     // send the message
     ResponseType status;
@@ -730,6 +766,7 @@ bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
     if (m_deadlineTimeoutMillis != 0) {
         setDeadline(context);
     }
+    setCompression(context);
 
     // send a single async message
     std::unique_ptr<grpc::ClientAsyncResponseReader<ResponseType>> rpc =
@@ -800,6 +837,7 @@ bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
     if (m_deadlineTimeoutMillis != 0) {
         setDeadline(context);
     }
+    setCompression(context);
 
     // should we wait until response arrives before sending the next log record?
     // this is the same question as with async completion queue
@@ -850,6 +888,38 @@ bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType, Recept
     return m_reactor->writeLogRecord(logRecord, bytesWritten);
 }
 
+template <typename ServiceType, typename StubType, typename MessageType, typename ResponseType,
+          typename ReceptorType>
+bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
+                        ReceptorType>::writeLogRecordStreamBatch(const ELogRecord& logRecord,
+                                                                 uint64_t& bytesWritten) {
+    if constexpr (ELogGRPCBatchTraits<StubType, ResponseType>::HAS_BATCH_STREAM) {
+        // make sure we have a valid writer
+        if (m_batchState.m_batchWriter.get() == nullptr) {
+            // previous flush failed, we just silently drop the request
+            return false;
+        }
+
+        // add log record message to current batch
+        ReceptorType receptor;
+        auto* logRecordMsg = m_batchState.m_batchMsg.add_records();
+        receptor.setLogRecordMsg(logRecordMsg);
+        fillInParams(logRecord, &receptor);
+        bytesWritten = logRecordMsg->ByteSizeLong();
+        m_batchState.m_batchBytes += bytesWritten;
+
+        // send batch only when full (partial batch is sent during flush)
+        // NOTE: the log record is buffered at this point, so even if sending the batch fails, the
+        // log record is accounted for by the batch statistics (see sendBatch())
+        if ((uint32_t)m_batchState.m_batchMsg.records_size() >= m_batchState.m_batchSize) {
+            (void)sendBatch();
+        }
+        return true;
+    } else {
+        return false;
+    }
+}
+
 template <typename ServiceType, typename StubType, typename MessageType, typename ResponseType,
           typename ReceptorType>
 bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
@@ -861,6 +931,7 @@ bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
         return false;
     }
     setDeadline(*m_streamContext);
+    setCompression(*m_streamContext);
     return true;
 }
 
@@ -868,7 +939,7 @@ template <typename ServiceType, typename StubType, typename MessageType, typenam
           typename ReceptorType>
 void ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
                         ReceptorType>::destroyStreamContext() {
-    if (m_streamContext == nullptr) {
+    if (m_streamContext != nullptr) {
         delete m_streamContext;
         m_streamContext = nullptr;
     }
@@ -945,6 +1016,138 @@ void ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
     }
 }
 
+template <typename ServiceType, typename StubType, typename MessageType, typename ResponseType,
+          typename ReceptorType>
+bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
+                        ReceptorType>::createBatchWriter() {
+    if constexpr (ELogGRPCBatchTraits<StubType, ResponseType>::HAS_BATCH_STREAM) {
+        m_batchState.m_batchWriter =
+            m_serviceStub->StreamLogRecordBatches(m_streamContext, &m_streamStatus);
+        if (m_batchState.m_batchWriter.get() == nullptr) {
+            m_reportHandler->onReport(m_logger, ELEVEL_ERROR, __FILE__, __LINE__, ELOG_FUNCTION,
+                                      "Failed to create gRPC synchronous batch streaming writer");
+            return false;
+        }
+        // NOTE: batch size is preserved between streams, since it reflects channel conditions
+        if (m_batchState.m_batchSize > m_batchParams.m_maxBatchSize) {
+            m_batchState.m_batchSize = m_batchParams.m_maxBatchSize;
+        }
+        return true;
+    } else {
+        m_reportHandler->onReport(
+            m_logger, ELEVEL_ERROR, __FILE__, __LINE__, ELOG_FUNCTION,
+            "Cannot use gRPC batch streaming client mode: service does not define "
+            "StreamLogRecordBatches()");
+        return false;
+    }
+}
+
+template <typename ServiceType, typename StubType, typename MessageType, typename ResponseType,
+          typename ReceptorType>
+bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
+                        ReceptorType>::sendBatch() {
+    if constexpr (ELogGRPCBatchTraits<StubType, ResponseType>::HAS_BATCH_STREAM) {
+        std::chrono::steady_clock::time_point writeStart = std::chrono::steady_clock::now();
+        bool res = m_batchState.m_batchWriter->Write(m_batchState.m_batchMsg);
+        std::chrono::microseconds writeLatency =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - writeStart);
+
+        // account for the batch only now that the send result is known (a failed batch cannot be
+        // resent, since the stream is broken, so its log records are counted as discarded)
+        reportBatchWrite(res, (uint64_t)m_batchState.m_batchMsg.records_size(),
+                         m_batchState.m_batchBytes);
+        m_batchState.m_batchMsg.Clear();
+        m_batchState.m_batchBytes = 0;
+        if (!res) {
+            const char* errorMsg = "Failed to stream log record batch over gRPC";
+            static ELogModerate mod(errorMsg, 1, ELOG_DEFAULT_ERROR_RATE_SECONDS,
+                                    ELogTimeUnits::TU_SECONDS);
+            if (mod.moderate()) {
+                m_reportHandler->onReport(m_logger, ELEVEL_ERROR, __FILE__, __LINE__,
+                                          ELOG_FUNCTION, errorMsg);
+            }
+            return false;
+        }
+        adaptBatchSize((uint64_t)writeLatency.count());
+        return true;
+    } else {
+        return false;
+    }
+}
+
+template <typename ServiceType, typename StubType, typename MessageType, typename ResponseType,
+          typename ReceptorType>
+void ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
+                        ReceptorType>::adaptBatchSize(uint64_t writeLatencyMicros) {
+    if constexpr (ELogGRPCBatchTraits<StubType, ResponseType>::HAS_BATCH_STREAM) {
+        // NOTE: synchronous stream write blocks while the HTTP/2 flow control window is exhausted,
+        // so write latency reflects both batch serialization time and the amount of data already
+        // in flight. When latency exceeds the target, the batch is halved so that records do not
+        // wait too long, and when the channel is idle the batch is doubled, so that per-message
+        // overhead is further amortized. This way batch size converges around the target latency.
+        uint32_t batchSize = m_batchState.m_batchSize;
+        if (writeLatencyMicros > m_batchParams.m_batchLatencyMicros) {
+            batchSize = std::max(batchSize / 2, (uint32_t)ELOG_GRPC_MIN_BATCH_SIZE);
+        } else if (writeLatencyMicros < m_batchParams.m_batchLatencyMicros / 2) {
+            batchSize = std::min(batchSize * 2, m_batchParams.m_maxBatchSize);
+        }
+        if (batchSize != m_batchState.m_batchSize && m_reportHandler->isTraceEnabled()) {
+            std::string msg = "gRPC batch size adapted from ";
+            msg += std::to_string(m_batchState.m_batchSize) + " to " + std::to_string(batchSize) +
+                   " (write latency " + std::to_string(writeLatencyMicros) + " usec)";
+            m_reportHandler->onReport(m_logger, ELEVEL_TRACE, __FILE__, __LINE__, ELOG_FUNCTION,
+                                      msg.c_str());
+        }
+        m_batchState.m_batchSize = batchSize;
+    }
+}
+
+template <typename ServiceType, typename StubType, typename MessageType, typename ResponseType,
+          typename ReceptorType>
+bool ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
+                        ReceptorType>::flushBatchWriter() {
+    if constexpr (ELogGRPCBatchTraits<StubType, ResponseType>::HAS_BATCH_STREAM) {
+        if (m_batchState.m_batchWriter.get() == nullptr) {
+            return false;
+        }
+
+        // send partial batch
+        bool res = true;
+        if (m_batchState.m_batchMsg.records_size() > 0) {
+            res = sendBatch();
+        }
+
+        m_batchState.m_batchWriter->WritesDone();
+        grpc::Status callStatus = m_batchState.m_batchWriter->Finish();
+        if (!callStatus.ok()) {
+            std::string errorMsg =
+                "Failed to terminate log record synchronous batch stream sending over gRPC: ";
+            errorMsg += callStatus.error_message();
+            m_reportHandler->onReport(m_logger, ELEVEL_ERROR, __FILE__, __LINE__, ELOG_FUNCTION,
+                                      errorMsg.c_str());
+            return false;
+        }
+        return res;
+    } else {
+        return false;
+    }
+}
+
+template <typename ServiceType, typename StubType, typename MessageType, typename ResponseType,
+          typename ReceptorType>
+void ELogGRPCBaseTarget<ServiceType, StubType, MessageType, ResponseType,
+                        ReceptorType>::destroyBatchWriter() {
+    if constexpr (ELogGRPCBatchTraits<StubType, ResponseType>::HAS_BATCH_STREAM) {
+        m_batchState.m_batchWriter.reset(nullptr);
+        // log records that were never sent are counted as discarded
+        reportBatchWrite(false, (uint64_t)m_batchState.m_batchMsg.records_size(),
+                         m_batchState.m_batchBytes);
+        m_batchState.m_batchMsg.Clear();
+        m_batchState.m_batchBytes = 0;
+    }
+}
+
 }  // namespace elog
 
 #endif  // ELOG_ENABLE_GRPC_CONNECTOR
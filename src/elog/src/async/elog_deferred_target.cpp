@@ -1,13 +1,200 @@
 #include "async/elog_deferred_target.h"
 
 #include <cassert>
+#include <new>
+#include <vector>
 
 #include "elog_field_selector_internal.h"
+#include "elog_render_cache.h"
+#include "elog_report.h"
+#include "elog_tls.h"
 
 #define ELOG_FLUSH_REQUEST ((uint8_t)-1)
 
+// marks a queue node whose link was not set yet by the pushing thread
+#define ELOG_PENDING_LINK ((LogNode*)(uintptr_t)1)
+
+// number of queue nodes moved at once between a thread cache and the global node pool, which is
+// also the number of nodes allocated at once when the global node pool is empty
+#define ELOG_NODE_TRANSFER_SIZE 64u
+
+// maximum number of queue nodes cached by each thread
+#define ELOG_NODE_THREAD_CACHE_SIZE (2 * ELOG_NODE_TRANSFER_SIZE)
+
 namespace elog {
 
+ELOG_DECLARE_REPORT_LOGGER(ELogDeferredTarget)
+
+/** @brief A free queue node (the node's memory is used for the free list link). */
+struct ELogFreeNode {
+    ELogFreeNode* m_next;
+};
+
+/** @brief A list of free queue nodes. */
+struct ELogFreeNodeList {
+    ELogFreeNode* m_head;
+    uint32_t m_count;
+};
+
+// NOTE: queue nodes are allocated by logging threads and released by the log thread, so free nodes
+// flow from the log thread's cache back to logging threads through the global node pool, in lists
+// of ELOG_NODE_TRANSFER_SIZE nodes. the global node pool is not capped (unlike the message blob
+// pool), so after warm-up queueing a log record does not allocate, even during long bursts. nodes
+// are allocated in slabs, which are released only during termination.
+static std::mutex sNodePoolLock;
+static std::vector<ELogFreeNodeList> sFreeNodeLists;
+static std::vector<void*> sNodeSlabs;
+static ELogTlsKey sNodeCacheKey = ELOG_INVALID_TLS_KEY;
+
+static void pushFreeNodes(const ELogFreeNodeList& nodeList) {
+    std::unique_lock<std::mutex> lock(sNodePoolLock);
+    sFreeNodeLists.push_back(nodeList);
+}
+
+static bool popFreeNodes(ELogFreeNodeList& nodeList, size_t nodeSize) {
+    std::unique_lock<std::mutex> lock(sNodePoolLock);
+    if (!sFreeNodeLists.empty()) {
+        nodeList = sFreeNodeLists.back();
+        sFreeNodeLists.pop_back();
+        return true;
+    }
+
+    // global node pool is empty, so a new slab of nodes is allocated
+    char* slab = (char*)::operator new(nodeSize * ELOG_NODE_TRANSFER_SIZE, std::nothrow);
+    if (slab == nullptr) {
+        return false;
+    }
+    sNodeSlabs.push_back(slab);
+    nodeList.m_head = nullptr;
+    for (uint32_t i = ELOG_NODE_TRANSFER_SIZE; i > 0; --i) {
+        ELogFreeNode* node = (ELogFreeNode*)(slab + (i - 1) * nodeSize);
+        node->m_next = nodeList.m_head;
+        nodeList.m_head = node;
+    }
+    nodeList.m_count = ELOG_NODE_TRANSFER_SIZE;
+    return true;
+}
+
+static void freeNodeCache(void* data) {
+    ELogFreeNodeList* nodeCache = (ELogFreeNodeList*)data;
+    if (nodeCache != nullptr) {
+        if (nodeCache->m_count > 0) {
+            pushFreeNodes(*nodeCache);
+        }
+        delete nodeCache;
+    }
+}
+
+static ELogFreeNodeList* getNodeCache() {
+    if (sNodeCacheKey == ELOG_INVALID_TLS_KEY) {
+        // not initialized yet, or already terminated
+        return nullptr;
+    }
+    ELogFreeNodeList* nodeCache = (ELogFreeNodeList*)elogGetTls(sNodeCacheKey);
+    if (nodeCache == nullptr) {
+        nodeCache = new (std::nothrow) ELogFreeNodeList();
+        if (nodeCache == nullptr) {
+            return nullptr;
+        }
+        nodeCache->m_head = nullptr;
+        nodeCache->m_count = 0;
+        if (!elogSetTls(sNodeCacheKey, nodeCache)) {
+            delete nodeCache;
+            return nullptr;
+        }
+    }
+    return nodeCache;
+}
+
+static void* allocNode(size_t nodeSize) {
+    if (sNodeCacheKey == ELOG_INVALID_TLS_KEY) {
+        return ::operator new(nodeSize, std::nothrow);
+    }
+    ELogFreeNodeList* nodeCache = getNodeCache();
+    if (nodeCache == nullptr) {
+        // failed to allocate thread cache, so take a single node from the global node pool
+        ELogFreeNodeList nodeList;
+        if (!popFreeNodes(nodeList, nodeSize)) {
+            return nullptr;
+        }
+        ELogFreeNode* node = nodeList.m_head;
+        nodeList.m_head = node->m_next;
+        if (--nodeList.m_count > 0) {
+            pushFreeNodes(nodeList);
+        }
+        return node;
+    }
+    if (nodeCache->m_count == 0 && !popFreeNodes(*nodeCache, nodeSize)) {
+        return nullptr;
+    }
+    ELogFreeNode* node = nodeCache->m_head;
+    nodeCache->m_head = node->m_next;
+    --nodeCache->m_count;
+    return node;
+}
+
+static void freeNode(void* block) {
+    if (sNodeCacheKey == ELOG_INVALID_TLS_KEY) {
+        ::operator delete(block);
+        return;
+    }
+    ELogFreeNode* node = (ELogFreeNode*)block;
+    ELogFreeNodeList* nodeCache = getNodeCache();
+    if (nodeCache == nullptr) {
+        // failed to allocate thread cache, so return the node directly to the global node pool
+        node->m_next = nullptr;
+        pushFreeNodes({node, 1});
+        return;
+    }
+    node->m_next = nodeCache->m_head;
+    nodeCache->m_head = node;
+    if (++nodeCache->m_count == ELOG_NODE_THREAD_CACHE_SIZE) {
+        // detach the first nodes in the cache list and return them to the global node pool
+        ELogFreeNodeList nodeList = {nodeCache->m_head, ELOG_NODE_TRANSFER_SIZE};
+        ELogFreeNode* last = nodeCache->m_head;
+        for (uint32_t i = 1; i < ELOG_NODE_TRANSFER_SIZE; ++i) {
+            last = last->m_next;
+        }
+        nodeCache->m_head = last->m_next;
+        nodeCache->m_count -= ELOG_NODE_TRANSFER_SIZE;
+        last->m_next = nullptr;
+        pushFreeNodes(nodeList);
+    }
+}
+
+bool ELogDeferredTarget::createNodePoolKey() {
+    if (sNodeCacheKey != ELOG_INVALID_TLS_KEY) {
+        ELOG_REPORT_ERROR("Cannot create queue node pool TLS key, already created");
+        return false;
+    }
+    return elogCreateTls(sNodeCacheKey, freeNodeCache);
+}
+
+bool ELogDeferredTarget::destroyNodePoolKey() {
+    if (sNodeCacheKey == ELOG_INVALID_TLS_KEY) {
+        // silently ignore the request
+        return true;
+    }
+
+    // the TLS destructor is not called for the current thread, so its cache is released here
+    freeNodeCache(elogGetTls(sNodeCacheKey));
+    elogSetTls(sNodeCacheKey, nullptr);
+    bool res = elogDestroyTls(sNodeCacheKey);
+    if (res) {
+        sNodeCacheKey = ELOG_INVALID_TLS_KEY;
+    }
+
+    // all log targets are already stopped, so all queue nodes are free, and slabs can be released
+    // (caches of other threads still pointing to slab nodes are no longer reachable)
+    std::unique_lock<std::mutex> lock(sNodePoolLock);
+    for (void* slab : sNodeSlabs) {
+        ::operator delete(slab);
+    }
+    sNodeSlabs.clear();
+    sFreeNodeLists.clear();
+    return res;
+}
+
 ELOG_IMPLEMENT_LOG_TARGET(ELogDeferredTarget)
 
 bool ELogDeferredTarget::startLogTarget() {
@@ -24,19 +211,17 @@ bool ELogDeferredTarget::stopLogTarget() {
 }
 
 bool ELogDeferredTarget::writeLogRecord(const ELogRecord& logRecord, uint64_t& bytesWritten) {
-    m_writeCount.fetch_add(1, std::memory_order_relaxed);
-    std::unique_lock<std::mutex> lock(m_lock);
-    // NOTE: the log record could hold a binary buffer with nulls in intermediate indices
-    if (logRecord.m_flags & ELOG_RECORD_BINARY) {
-        std::pair<ELogRecord, std::string>& entry = m_logQueue.emplace_back(logRecord, "");
-        entry.second.assign(logRecord.m_logMsg, logRecord.m_logMsgLen);
-    } else {
-        m_logQueue.emplace_back(logRecord, logRecord.m_logMsg);
-    }
-    m_cv.notify_one();
     // asynchronous log targets do not report byte count
     bytesWritten = 0;
-    return true;
+
+    // the message copy is shared with other queues of the record
+    ELogMsgRef msgRef = acquireLogRecordMsg(logRecord);
+    if (msgRef.getMsgBlob() == nullptr) {
+        // error already reported
+        return false;
+    }
+    m_writeCount.fetch_add(1, std::memory_order_relaxed);
+    return pushLogNode(logRecord, std::move(msgRef));
 }
 
 bool ELogDeferredTarget::flushLogTarget() {
@@ -45,16 +230,13 @@ bool ELogDeferredTarget::flushLogTarget() {
     ELOG_CACHE_ALIGN ELogRecord flushRecord;
     flushRecord.m_logMsg = "";
     flushRecord.m_reserved = ELOG_FLUSH_REQUEST;
-    std::unique_lock<std::mutex> lock(m_lock);
-    m_logQueue.emplace_back(flushRecord, flushRecord.m_logMsg);
-    m_cv.notify_one();
-    return true;
+    return pushLogNode(flushRecord, ELogMsgRef());
 }
 
 void ELogDeferredTarget::logThread() {
     std::string threadName = std::string(getName()) + "-log-thread";
     setCurrentThreadNameField(threadName.c_str());
-    LogQueue logQueue;
+    uint64_t nodeCount = 0;
     while (!shouldStop()) {
         {
             // wait for queue event
@@ -63,25 +245,20 @@ void ELogDeferredTarget::logThread() {
             if (m_stop) {
                 break;
             }
-            if (m_logQueue.empty()) {
-                continue;
-            }
-
-            // drain queue (lock still held)
-            LogQueue::iterator itr = m_logQueue.begin();
-            while (itr != m_logQueue.end()) {
-                logQueue.push_back(*itr);
-                ++itr;
-            }
-            m_logQueue.clear();
         }
 
-        // write to log target outside of lock scope (allow loggers to push messages)
-        logQueueMsgs(logQueue, true);
+        // detach queue and write to log target without any lock (allow loggers to push messages)
+        LogNode* logNode = detachLogNodes(nodeCount);
+        if (logNode != nullptr) {
+            logQueueMsgs(logNode, nodeCount, true);
+        }
     }
 
-    // log whatever is left (no lock required)
-    logQueueMsgs(m_logQueue, false);
+    // log whatever is left
+    LogNode* logNode = detachLogNodes(nodeCount);
+    if (logNode != nullptr) {
+        logQueueMsgs(logNode, nodeCount, false);
+    }
 
     // finally flush
     m_subTarget->flush();
@@ -93,26 +270,90 @@ bool ELogDeferredTarget::shouldStop() {
 }
 
 void ELogDeferredTarget::waitQueue(std::unique_lock<std::mutex>& lock) {
-    m_cv.wait(lock, [this] { return m_stop || !m_logQueue.empty(); });
+    m_cv.wait(lock, [this] {
+        return m_stop || m_queueHead.load(std::memory_order_acquire) != nullptr;
+    });
+}
+
+bool ELogDeferredTarget::shouldNotify(bool wasEmpty, uint64_t queueSize) {
+    (void)queueSize;
+    return wasEmpty;
+}
+
+bool ELogDeferredTarget::pushLogNode(const ELogRecord& logRecord, ELogMsgRef&& msgRef) {
+    void* block = allocNode(sizeof(LogNode));
+    if (block == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate deferred log record, out of memory");
+        return false;
+    }
+    LogNode* logNode = new (block) LogNode(logRecord, std::move(msgRef));
+
+    // NOTE: queue size is incremented before the node is pushed, so that the log thread, which
+    // decrements the queue size only after detaching nodes, never sees a negative size
+    uint64_t queueSize = m_queueSize.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    // push with a single exchange, and link afterwards (the log thread waits for pending links)
+    logNode->m_next.store(ELOG_PENDING_LINK, std::memory_order_relaxed);
+    LogNode* prevHead = m_queueHead.exchange(logNode, std::memory_order_acq_rel);
+    logNode->m_next.store(prevHead, std::memory_order_release);
+
+    // the lock is taken for notification, so that the log thread either sees the new node when
+    // checking the queue, or is already waiting and gets notified
+    if (shouldNotify(prevHead == nullptr, queueSize)) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_cv.notify_one();
+    }
+    return true;
+}
+
+ELogDeferredTarget::LogNode* ELogDeferredTarget::detachLogNodes(uint64_t& nodeCount) {
+    nodeCount = 0;
+    LogNode* logNode = m_queueHead.exchange(nullptr, std::memory_order_acquire);
+
+    // reverse the list to restore arrival order
+    LogNode* reversed = nullptr;
+    while (logNode != nullptr) {
+        LogNode* next = logNode->m_next.load(std::memory_order_acquire);
+        while (next == ELOG_PENDING_LINK) {
+            // pushing thread was preempted between exchange and link
+            std::this_thread::yield();
+            next = logNode->m_next.load(std::memory_order_acquire);
+        }
+        logNode->m_next.store(reversed, std::memory_order_relaxed);
+        reversed = logNode;
+        logNode = next;
+        ++nodeCount;
+    }
+    if (nodeCount > 0) {
+        m_queueSize.fetch_sub(nodeCount, std::memory_order_relaxed);
+    }
+    return reversed;
 }
 
-void ELogDeferredTarget::logQueueMsgs(LogQueue& logQueue, bool disregardFlushRequests) {
-    LogQueue::iterator itr = logQueue.begin();
-    while (itr != logQueue.end()) {
-        ELogRecord& logRecord = itr->first;
+void ELogDeferredTarget::logQueueMsgs(LogNode* logNode, uint64_t nodeCount,
+                                      bool disregardFlushRequests) {
+    recordBatchSize(nodeCount);
+    while (logNode != nullptr) {
+        ELogRecord& logRecord = logNode->m_logRecord;
         if (logRecord.m_reserved == ELOG_FLUSH_REQUEST) {
             // empty log message signifies flush request (ignored during last time)
             if (!disregardFlushRequests) {
                 m_subTarget->flush();
             }
         } else {
-            logRecord.m_logMsg = itr->second.c_str();
+            // the message blob is shared with the sub-target, in case it queues the record again
+            logRecord.m_logMsg = logNode->m_msgRef.getData();
+            ELogRenderCache renderCache(logRecord);
+            renderCache.setMsgBlob(logNode->m_msgRef.getMsgBlob());
+            ELogScopedRenderCache scopedRenderCache(&renderCache);
             m_subTarget->log(logRecord);
             m_readCount.fetch_add(1, std::memory_order_relaxed);
         }
-        ++itr;
+        LogNode* next = logNode->m_next.load(std::memory_order_relaxed);
+        logNode->~LogNode();
+        freeNode(logNode);
+        logNode = next;
     }
-    logQueue.clear();
 }
 
 void ELogDeferredTarget::stopLogThread() {
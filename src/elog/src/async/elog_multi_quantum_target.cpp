@@ -1,12 +1,14 @@
 #include "async/elog_multi_quantum_target.h"
 
 #include <cassert>
+#include <chrono>
 #include <cinttypes>
 
 #include "elog_aligned_alloc.h"
 #include "elog_common.h"
 #include "elog_field_selector_internal.h"
 #include "elog_internal.h"
+#include "elog_numa.h"
 #include "elog_report.h"
 #include "elog_tls.h"
 
@@ -14,7 +16,6 @@
 #define ELOG_STOP_REQUEST ((uint8_t)-2)
 
 // TODO: add some backoff policy when queue is empty, to avoid tight loop when not needed
-// TODO: consider CPU affinity for log thread for better performance
 
 // TODO: allow quantum log target to specify in config what to do when queue is full:
 // - wait until queue is ready (or even allow to give a timeout)
@@ -35,6 +36,27 @@ ELOG_IMPLEMENT_LOG_TARGET(ELogMultiQuantumTarget)
 static ELogTlsKey sThreadSlotKey = ELOG_INVALID_TLS_KEY;
 static thread_local uint64_t sThreadSlotId = ELOG_INVALID_THREAD_SLOT_ID;
 
+inline uint64_t getSteadyTimeNanos() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// computes the bit mask of the slots of a bitset word that fall within a slot range
+inline uint64_t getWordRangeMask(uint64_t wordIndex, uint64_t fromSlotId, uint64_t toSlotId) {
+    uint64_t wordStartSlotId = wordIndex * WORD_BIT_SIZE;
+    uint64_t mask = ~0ull;
+    if (fromSlotId > wordStartSlotId) {
+        mask &= ~0ull << (fromSlotId - wordStartSlotId);
+    }
+    if (toSlotId <= wordStartSlotId) {
+        mask = 0;
+    } else if (toSlotId < wordStartSlotId + WORD_BIT_SIZE) {
+        mask &= ~0ull >> (WORD_BIT_SIZE - (toSlotId - wordStartSlotId));
+    }
+    return mask;
+}
+
 typedef std::pair<ELogMultiQuantumTarget*, uint64_t> CleanupPair;
 
 void ELogMultiQuantumTarget::cleanupThreadSlot(void* key) {
@@ -64,6 +86,7 @@ ELogMultiQuantumTarget::ELogMultiQuantumTarget(
     CongestionPolicy congestionPolicy /* = CongestionPolicy::CP_WAIT */)
     : ELogAsyncTarget(logTarget),
       m_ringBuffers(nullptr),
+      m_readers(nullptr),
       m_activeThreads(nullptr),
       m_activeRingBuffers(nullptr),
       m_threadLogTime(nullptr),
@@ -75,7 +98,11 @@ ELogMultiQuantumTarget::ELogMultiQuantumTarget(
       m_activeRevisitPeriod(activeRevisitPeriod),
       m_fullRevisitPeriod(fullRevisitPeriod),
       m_maxBatchSize(maxBatchSize),
-      m_collectPeriodMicros(collectPeriodMicros) {
+      m_collectPeriodMicros(collectPeriodMicros),
+      m_nodeCount(1),
+      m_numaAware(false),
+      m_startTimeNanos(0),
+      m_runTimeNanos(0) {
     m_bitsetSize = (m_maxThreadCount + WORD_BIT_SIZE - 1) / WORD_BIT_SIZE * WORD_BIT_SIZE;
     m_sortingFunnelSize = m_ringBufferSize * m_maxThreadCount;
 }
@@ -96,6 +123,36 @@ bool ELogMultiQuantumTarget::startLogTarget() {
         return false;
     }
 
+    // in NUMA-aware mode, each node has a single reader
+    m_nodeCount = m_numaAware ? elogGetNumaNodeCount() : 1;
+    if (m_nodeCount > m_maxThreadCount) {
+        m_nodeCount = (uint32_t)m_maxThreadCount;
+    }
+    if (m_nodeCount > 1) {
+        m_readerCount = m_nodeCount;
+    }
+    if (m_readerCount > m_maxThreadCount) {
+        m_readerCount = m_maxThreadCount;
+    } else if (m_readerCount == 0) {
+        m_readerCount = 1;
+    }
+
+    // create reader array, thread slots are evenly divided among readers
+    if (m_readers == nullptr) {
+        m_readers = elogAlignedAllocObjectArray<ReaderRange>(ELOG_CACHE_LINE, m_readerCount);
+        if (m_readers == nullptr) {
+            ELOG_REPORT_ERROR("Failed to allocate %" PRIu64 " readers for multi-quantum log target",
+                              m_readerCount);
+            cleanup();
+            return false;
+        }
+        for (uint64_t i = 0; i < m_readerCount; ++i) {
+            m_readers[i].m_readerId = i;
+            m_readers[i].m_fromSlotId = i * m_maxThreadCount / m_readerCount;
+            m_readers[i].m_toSlotId = (i + 1) * m_maxThreadCount / m_readerCount;
+        }
+    }
+
     // create ring buffer array
     if (m_ringBuffers == nullptr) {
         m_ringBuffers = elogAlignedAllocObjectArray<RingBuffer>(ELOG_CACHE_LINE, m_maxThreadCount);
@@ -106,11 +163,21 @@ bool ELogMultiQuantumTarget::startLogTarget() {
             cleanup();
             return false;
         }
-        for (uint64_t i = 0; i < m_maxThreadCount; ++i) {
-            if (!m_ringBuffers[i].initialize(m_ringBufferSize)) {
-                cleanup();
-                return false;
+        if (m_nodeCount > 1) {
+            // ring buffers of each node are first touched by a thread running on the node, so that
+            // they are allocated with node-local memory
+            for (uint32_t i = 0; i < m_nodeCount; ++i) {
+                ReaderRange* reader = &m_readers[i];
+                if (!elogRunOnNumaNode(i, [this, reader]() {
+                        return initRingBuffers(reader->m_fromSlotId, reader->m_toSlotId);
+                    })) {
+                    cleanup();
+                    return false;
+                }
             }
+        } else if (!initRingBuffers(0, m_maxThreadCount)) {
+            cleanup();
+            return false;
         }
     }
 
@@ -178,15 +245,18 @@ bool ELogMultiQuantumTarget::startLogTarget() {
 
     // launch reader threads, each reader takes a portion of threads
     // TODO: add policy to determine how to distribute new thread slots among readers
-    uint64_t wordsPerReader = m_bitsetSize / m_readerCount;
+    m_startTimeNanos = getSteadyTimeNanos();
     for (uint64_t i = 0; i < m_readerCount; ++i) {
-        uint64_t fromWordIndex = i * wordsPerReader;
-        uint64_t toWordIndex = fromWordIndex + wordsPerReader;
-        if (i + 1 == m_readerCount) {
-            toWordIndex = m_bitsetSize;
+        m_readerThreads.emplace_back(&ELogMultiQuantumTarget::readerThread, this, &m_readers[i]);
+    }
+    return true;
+}
+
+bool ELogMultiQuantumTarget::initRingBuffers(uint64_t fromSlotId, uint64_t toSlotId) {
+    for (uint64_t i = fromSlotId; i < toSlotId; ++i) {
+        if (!m_ringBuffers[i].initialize(m_ringBufferSize)) {
+            return false;
         }
-        m_readerThreads.emplace_back(&ELogMultiQuantumTarget::readerThread, this, i, fromWordIndex,
-                                     toWordIndex);
     }
     return true;
 }
@@ -196,10 +266,9 @@ bool ELogMultiQuantumTarget::stopLogTarget() {
     ELOG_CACHE_ALIGN ELogRecord poison;
     poison.m_logMsg = "";
     poison.m_reserved = ELOG_STOP_REQUEST;
-    uint64_t ringBuffersPerReader = m_maxThreadCount / m_readerCount;
     for (uint64_t i = 0; i < m_readerCount; ++i) {
         // choose any ring buffer that belongs to the reader
-        uint64_t slotId = i * ringBuffersPerReader;
+        uint64_t slotId = m_readers[i].m_fromSlotId;
         m_ringBuffers[slotId].writeLogRecord(poison);
     }
 
@@ -207,6 +276,7 @@ bool ELogMultiQuantumTarget::stopLogTarget() {
     for (uint64_t i = 0; i < m_readerCount; ++i) {
         m_readerThreads[i].join();
     }
+    m_readerThreads.clear();
 
     // TODO: stop sorting thread
     m_sortingThread.join();
@@ -217,10 +287,49 @@ bool ELogMultiQuantumTarget::stopLogTarget() {
         return false;
     }
 
+    // keep statistics of the last run
+    m_runTimeNanos = getSteadyTimeNanos() - m_startTimeNanos;
+    m_nodeMsgCounts.resize(m_nodeCount);
+    for (uint32_t i = 0; i < m_nodeCount; ++i) {
+        m_nodeMsgCounts[i] = getNodeMsgCount(i);
+    }
+
     cleanup();
     return true;
 }
 
+uint64_t ELogMultiQuantumTarget::getNodeMsgCount(uint32_t node) const {
+    if (m_readers == nullptr) {
+        return node < m_nodeMsgCounts.size() ? m_nodeMsgCounts[node] : 0;
+    }
+    if (node >= m_nodeCount) {
+        return 0;
+    }
+    if (m_nodeCount > 1) {
+        return m_readers[node].m_msgCount.load(std::memory_order_relaxed);
+    }
+    // not NUMA-aware, so all readers serve the single node
+    uint64_t msgCount = 0;
+    for (uint64_t i = 0; i < m_readerCount; ++i) {
+        msgCount += m_readers[i].m_msgCount.load(std::memory_order_relaxed);
+    }
+    return msgCount;
+}
+
+void ELogMultiQuantumTarget::printTargetStats(ELogBuffer& buffer) {
+    if (m_nodeCount <= 1) {
+        return;
+    }
+    uint64_t runTimeNanos =
+        (m_readers != nullptr) ? getSteadyTimeNanos() - m_startTimeNanos : m_runTimeNanos;
+    double runTimeSeconds = runTimeNanos / 1000000000.0;
+    for (uint32_t i = 0; i < m_nodeCount; ++i) {
+        uint64_t msgCount = getNodeMsgCount(i);
+        buffer.appendArgs("\tNUMA node %u log messages: %" PRIu64 " (%.1f msg/sec)\n", i,
+                          msgCount, runTimeSeconds > 0 ? msgCount / runTimeSeconds : 0.0);
+    }
+}
+
 bool ELogMultiQuantumTarget::writeLogRecord(const ELogRecord& logRecord, uint64_t& bytesWritten) {
     // obtain slot if needed
     uint64_t slotId = getThreadSlotId();
@@ -249,10 +358,11 @@ bool ELogMultiQuantumTarget::flushLogTarget() {
 }
 
 bool ELogMultiQuantumTarget::extractToSortingFunnel(RingBuffer* ringBuffer, uint64_t& maxTimeStamp,
-                                                    bool& isValid, bool& extractedAllRecords) {
+                                                    bool& isValid, bool& extractedAllRecords,
+                                                    uint64_t& msgCount) {
     bool isDone = false;
     ELogRecord logRecord = {};
-    uint64_t msgCount = 0;
+    msgCount = 0;
     ELogBuffer logBuffer;
     extractedAllRecords = false;
     while (msgCount < m_maxBatchSize && !isDone && !extractedAllRecords) {
@@ -287,11 +397,24 @@ bool ELogMultiQuantumTarget::extractToSortingFunnel(RingBuffer* ringBuffer, uint
     return isDone;
 }
 
-void ELogMultiQuantumTarget::readerThread(uint64_t readerId, uint64_t fromWordIndex,
-                                          uint64_t toWordIndex) {
+void ELogMultiQuantumTarget::readerThread(ReaderRange* reader) {
     // read from all active words in the region of this reader
-    std::string tname = std::string("reader-") + std::to_string(readerId);
+    std::string tname = std::string("reader-") + std::to_string(reader->m_readerId);
     setCurrentThreadNameField(tname.c_str());
+
+    // pin reader to its node (or to the configured CPUs)
+    std::vector<uint32_t> cpus;
+    if (m_nodeCount > 1) {
+        elogGetNodeConsumerCpus((uint32_t)reader->m_readerId, m_consumerCpus, cpus);
+    } else {
+        cpus = m_consumerCpus;
+    }
+    if (!cpus.empty() && !elogSetCurrentThreadAffinity(cpus)) {
+        ELOG_REPORT_WARN("Failed to set CPU affinity of multi-quantum reader %s", tname.c_str());
+    }
+
+    uint64_t fromWordIndex = reader->m_fromSlotId / WORD_BIT_SIZE;
+    uint64_t toWordIndex = (reader->m_toSlotId + WORD_BIT_SIZE - 1) / WORD_BIT_SIZE;
     uint64_t iterationCounter = 0;
     bool done = false;
     while (!done) {
@@ -308,63 +431,74 @@ void ELogMultiQuantumTarget::readerThread(uint64_t readerId, uint64_t fromWordIn
         for (uint64_t i = fromWordIndex; i < toWordIndex && !done; ++i) {
             if (fullRevisit) {
                 // visit all threads, whether active or not, regardless of ring buffer bit
-                done = revisitAllThreads(i);
+                done = revisitAllThreads(reader, i);
             } else if (activeRevisit) {
                 // visit all active threads, even if ring buffer bit is not raised
-                done = revisitAllActiveThreads(i);
+                done = revisitAllActiveThreads(reader, i);
             } else {
                 // read only from active ring buffers
-                done = visitActiveRingBuffers(i);
+                done = visitActiveRingBuffers(reader, i);
             }
         }
     }
 }
 
-bool ELogMultiQuantumTarget::visitActiveRingBuffers(uint64_t wordIndex) {
+bool ELogMultiQuantumTarget::visitActiveRingBuffers(ReaderRange* reader, uint64_t wordIndex) {
     bool done = false;
-    uint64_t word = m_activeRingBuffers[wordIndex].load(std::memory_order_acquire);
+    uint64_t word = m_activeRingBuffers[wordIndex].load(std::memory_order_acquire) &
+                    getWordRangeMask(wordIndex, reader->m_fromSlotId, reader->m_toSlotId);
     while (word != 0 && !done) {
         uint64_t offset = (uint64_t)std::countr_zero(word);
         uint64_t slotId = wordIndex * WORD_BIT_SIZE + offset;
         assert(slotId < m_maxThreadCount);
-        word &= ~(1 << offset);
-        done = readThreadRingBuffer(slotId);
+        word &= ~(1ull << offset);
+        done = readThreadRingBuffer(reader, slotId);
     }
     return done;
 }
 
-bool ELogMultiQuantumTarget::revisitAllActiveThreads(uint64_t wordIndex) {
+bool ELogMultiQuantumTarget::revisitAllActiveThreads(ReaderRange* reader, uint64_t wordIndex) {
     bool done = false;
     for (uint64_t j = 0; j < WORD_BIT_SIZE && !done; ++j) {
         uint64_t slotId = wordIndex * WORD_BIT_SIZE + j;
-        if (slotId >= m_maxThreadCount) {
+        if (slotId < reader->m_fromSlotId) {
+            continue;
+        }
+        if (slotId >= reader->m_toSlotId) {
             break;
         }
         if (isThreadActive(slotId)) {
-            done = readThreadRingBuffer(slotId);
+            done = readThreadRingBuffer(reader, slotId);
         }
     }
     return done;
 }
 
-bool ELogMultiQuantumTarget::revisitAllThreads(uint64_t wordIndex) {
+bool ELogMultiQuantumTarget::revisitAllThreads(ReaderRange* reader, uint64_t wordIndex) {
     bool done = false;
     for (uint64_t j = 0; j < WORD_BIT_SIZE && !done; ++j) {
         uint64_t slotId = wordIndex * WORD_BIT_SIZE + j;
-        if (slotId >= m_maxThreadCount) {
+        if (slotId < reader->m_fromSlotId) {
+            continue;
+        }
+        if (slotId >= reader->m_toSlotId) {
             break;
         }
-        done = readThreadRingBuffer(slotId);
+        done = readThreadRingBuffer(reader, slotId);
     }
     return done;
 }
 
-bool ELogMultiQuantumTarget::readThreadRingBuffer(uint64_t slotId) {
+bool ELogMultiQuantumTarget::readThreadRingBuffer(ReaderRange* reader, uint64_t slotId) {
     bool isValid = false;
     bool extractedAllRecords = false;
     uint64_t timeStamp = 0;
-    bool done =
-        extractToSortingFunnel(&m_ringBuffers[slotId], timeStamp, isValid, extractedAllRecords);
+    uint64_t msgCount = 0;
+    bool done = extractToSortingFunnel(&m_ringBuffers[slotId], timeStamp, isValid,
+                                       extractedAllRecords, msgCount);
+    if (msgCount > 0) {
+        reader->m_msgCount.fetch_add(msgCount, std::memory_order_relaxed);
+    }
     if (extractedAllRecords) {
         resetRingBufferBit(slotId);
     }
@@ -584,6 +718,9 @@ bool ELogMultiQuantumTarget::shipReadySortedRecords(uint64_t readPos, uint64_t e
         ++readPos;
     }
     m_shipCount.store(readPos, std::memory_order_relaxed);
+    if (msgCount > 0) {
+        recordBatchSize(msgCount);
+    }
 
     ELOG_REPORT_TRACE("Sorting funnel shipped %" PRIu64 " messages, readPos is at %" PRIu64,
                       msgCount, readPos);
@@ -634,7 +771,13 @@ uint64_t ELogMultiQuantumTarget::getThreadSlotId() {
 }
 
 uint64_t ELogMultiQuantumTarget::obtainThreadSlot() {
-    for (uint64_t i = 0; i < m_maxThreadCount; ++i) {
+    // in NUMA-aware mode, a slot served by the reader of the current node is preferred
+    uint64_t startSlotId = 0;
+    if (m_nodeCount > 1) {
+        startSlotId = m_readers[elogGetCurrentNumaNode() % m_nodeCount].m_fromSlotId;
+    }
+    for (uint64_t j = 0; j < m_maxThreadCount; ++j) {
+        uint64_t i = (startSlotId + j) % m_maxThreadCount;
         uint64_t isUsed = m_ringBuffers[i].m_isUsed.load(std::memory_order_acquire);
         if (!isUsed && m_ringBuffers[i].m_isUsed.compare_exchange_strong(
                            isUsed, 1, std::memory_order_release)) {
@@ -690,6 +833,11 @@ void ELogMultiQuantumTarget::cleanup() {
         m_ringBuffers = nullptr;
     }
 
+    if (m_readers != nullptr) {
+        elogAlignedFreeObjectArray(m_readers, m_readerCount);
+        m_readers = nullptr;
+    }
+
     if (m_recentThreadLogTime != nullptr) {
         elogAlignedFreeObjectArray(m_recentThreadLogTime, m_maxThreadCount);
         m_recentThreadLogTime = nullptr;
@@ -3,6 +3,7 @@
 #include "async/elog_multi_quantum_target.h"
 #include "elog_common.h"
 #include "elog_config_loader.h"
+#include "elog_numa.h"
 #include "elog_report.h"
 
 namespace elog {
@@ -55,13 +56,33 @@ ELogTarget* ELogMultiQuantumTargetProvider::loadTarget(const ELogConfigMapNode*
         return nullptr;
     }
 
+    // parse NUMA awareness
+    bool numaAware = false;
+    if (!ELogConfigLoader::getOptionalLogTargetBoolProperty(logTargetCfg, "asynchronous",
+                                                            "quantum_numa", numaAware)) {
+        return nullptr;
+    }
+
+    // parse consumer CPU list
+    std::string consumerCpuList;
+    std::vector<uint32_t> consumerCpus;
+    if (!ELogConfigLoader::getOptionalLogTargetStringProperty(
+            logTargetCfg, "asynchronous", "quantum_consumer_cpus", consumerCpuList)) {
+        return nullptr;
+    }
+    if (!consumerCpuList.empty() && !elogParseCpuList(consumerCpuList.c_str(), consumerCpus)) {
+        ELOG_REPORT_ERROR("Invalid quantum_consumer_cpus property value: %s",
+                          consumerCpuList.c_str());
+        return nullptr;
+    }
+
     // load nested target
     ELogTarget* target = loadNestedTarget(logTargetCfg);
     if (target == nullptr) {
         return nullptr;
     }
 
-    ELogAsyncTarget* asyncTarget = new (std::nothrow)
+    ELogMultiQuantumTarget* asyncTarget = new (std::nothrow)
         ELogMultiQuantumTarget(target, quantumBufferSize, readerCount, activeRevisitPeriod,
                                fullRevisitPeriod, maxBatchSize, quantumCollectPeriodMicros);
     if (asyncTarget == nullptr) {
@@ -69,6 +90,8 @@ ELogTarget* ELogMultiQuantumTargetProvider::loadTarget(const ELogConfigMapNode*
         target->destroy();
         return nullptr;
     }
+    asyncTarget->setNumaAware(numaAware);
+    asyncTarget->setConsumerCpus(consumerCpus);
     // NOTE: ELogSystem will configure common properties for this log target
     return asyncTarget;
 }
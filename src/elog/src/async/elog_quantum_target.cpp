@@ -1,17 +1,18 @@
 #include "async/elog_quantum_target.h"
 
 #include <cassert>
+#include <cinttypes>
 
 #include "elog_aligned_alloc.h"
 #include "elog_common.h"
 #include "elog_field_selector_internal.h"
+#include "elog_numa.h"
 #include "elog_report.h"
 
 #define ELOG_FLUSH_REQUEST ((uint8_t)-1)
 #define ELOG_STOP_REQUEST ((uint8_t)-2)
 
 // TODO: add some backoff policy when queue is empty, to avoid tight loop when not needed
-// TODO: consider CPU affinity for log thread for better performance
 
 // TODO: allow quantum log target to specify in config what to do when queue is full:
 // - wait until queue is ready (or even allow to give a timeout)
@@ -19,88 +20,200 @@
 
 // TODO: check again CPU relax and exponential backoff where needed
 
+// marks a thread that is not bound yet to a ring buffer
+#define ELOG_UNBOUND_NODE ((uint32_t)-1)
+
 namespace elog {
 
 ELOG_DECLARE_REPORT_LOGGER(ELogQuantumTarget)
 
+// each thread is bound on its first write to the NUMA node it runs on at that time, so that all
+// log records of a thread that later migrates to another node are written to the same ring
+// buffer, and are therefore delivered in order
+static thread_local uint32_t sThreadNode = ELOG_UNBOUND_NODE;
+
+// with more ring buffers than NUMA nodes, threads of the same node are spread among the ring
+// buffers of the node by their sequence number
+static thread_local uint32_t sThreadSeq = 0;
+static std::atomic<uint32_t> sNextThreadSeq(0);
+
 ELOG_IMPLEMENT_LOG_TARGET(ELogQuantumTarget)
 
 ELogQuantumTarget::ELogQuantumTarget(
     ELogTarget* logTarget, uint32_t bufferSize, uint64_t collectPeriodMicros /* = 0 */,
     CongestionPolicy congestionPolicy /* = CongestionPolicy::CP_WAIT */)
     : ELogAsyncTarget(logTarget),
-      m_ringBuffer(nullptr),
+      m_nodeRings(nullptr),
+      m_nodeCount(0),
+      m_nodeCountOverride(0),
+      m_numaNodeCount(1),
       m_ringBufferSize(bufferSize),
       m_collectPeriodMicros(collectPeriodMicros),
-      m_writePos(0),
-      m_readPos(0) {}
+      m_numaAware(false),
+      m_startTimeNanos(0),
+      m_runTimeNanos(0) {}
 // m_congestionPolicy(congestionPolicy)
 
+inline uint64_t getSteadyTimeNanos() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+uint64_t ELogQuantumTarget::getNodeMsgCount(uint32_t node) const {
+    if (m_nodeRings != nullptr) {
+        return node < m_nodeCount ? m_nodeRings[node].m_msgCount.load(std::memory_order_relaxed)
+                                  : 0;
+    }
+    return node < m_nodeMsgCounts.size() ? m_nodeMsgCounts[node] : 0;
+}
+
 bool ELogQuantumTarget::startLogTarget() {
-    if (m_ringBuffer == nullptr) {
-        m_ringBuffer =
-            elogAlignedAllocObjectArray<ELogRecordData>(ELOG_CACHE_LINE, m_ringBufferSize);
-        if (m_ringBuffer == nullptr) {
-            ELOG_REPORT_ERROR(
-                "Failed to allocate ring buffer of %u elements for quantum log target",
-                m_ringBufferSize);
+    if (m_nodeRings == nullptr) {
+        m_numaNodeCount = m_numaAware ? elogGetNumaNodeCount() : 1;
+        m_nodeCount = (m_numaAware && m_nodeCountOverride > 0) ? m_nodeCountOverride
+                                                                : m_numaNodeCount;
+        m_nodeRings = elogAlignedAllocObjectArray<NodeRing>(ELOG_CACHE_LINE, m_nodeCount);
+        if (m_nodeRings == nullptr) {
+            ELOG_REPORT_ERROR("Failed to allocate %u ring buffers for quantum log target",
+                              m_nodeCount);
             return false;
         }
-        m_bufferArray = elogAlignedAllocObjectArray<ELogBuffer>(ELOG_CACHE_LINE, m_ringBufferSize);
-        if (m_bufferArray == nullptr) {
-            ELOG_REPORT_ERROR(
-                "Failed to allocate log buffer array of %u elements for quantum log target",
-                m_ringBufferSize);
-            elogAlignedFreeObjectArray(m_ringBuffer, m_ringBufferSize);
-            return false;
-        }
-        //  reserve in advance some space to avoid penalty on first round
-        for (uint32_t i = 0; i < m_ringBufferSize; ++i) {
-            m_ringBuffer[i].setLogBuffer(&m_bufferArray[i]);
+        for (uint32_t i = 0; i < m_nodeCount; ++i) {
+            NodeRing& nodeRing = m_nodeRings[i];
+            nodeRing.m_node = i;
+            nodeRing.m_numaNode = i % m_numaNodeCount;
+            // with several NUMA nodes, the ring buffer memory is first touched by a thread running
+            // on the node, so that it is allocated with node-local memory
+            bool res = false;
+            if (m_numaNodeCount > 1) {
+                res = elogRunOnNumaNode(nodeRing.m_numaNode, [this, &nodeRing]() {
+                    return allocNodeRing(nodeRing);
+                });
+            } else {
+                res = allocNodeRing(nodeRing);
+            }
+            if (!res) {
+                freeNodeRings();
+                return false;
+            }
         }
     }
     if (!m_subTarget->start()) {
-        elogAlignedFreeObjectArray(m_bufferArray, m_ringBufferSize);
-        elogAlignedFreeObjectArray(m_ringBuffer, m_ringBufferSize);
-        m_ringBuffer = nullptr;
+        freeNodeRings();
         return false;
     }
-    m_logThread = std::thread(&ELogQuantumTarget::logThread, this);
+    m_startTimeNanos = getSteadyTimeNanos();
+    for (uint32_t i = 0; i < m_nodeCount; ++i) {
+        m_nodeRings[i].m_logThread =
+            std::thread(&ELogQuantumTarget::logThread, this, &m_nodeRings[i]);
+    }
     return true;
 }
 
 bool ELogQuantumTarget::stopLogTarget() {
-    // send a poison pill to the log thread
+    // send a poison pill to all log threads
     ELOG_CACHE_ALIGN ELogRecord poison;
     poison.m_logMsg = "";
     poison.m_reserved = ELOG_STOP_REQUEST;
-    uint64_t dummy = 0;
-    writeLogRecord(poison, dummy);
+    for (uint32_t i = 0; i < m_nodeCount; ++i) {
+        writeNodeRing(m_nodeRings[i], poison);
+    }
 
-    // now wait for log thread to finish
-    m_logThread.join();
+    // now wait for log threads to finish
+    for (uint32_t i = 0; i < m_nodeCount; ++i) {
+        m_nodeRings[i].m_logThread.join();
+    }
     if (!m_subTarget->stop()) {
         ELOG_REPORT_ERROR("Quantum log target failed to stop underlying log target");
         return false;
     }
-    if (m_ringBuffer != nullptr) {
-        elogAlignedFreeObjectArray(m_bufferArray, m_ringBufferSize);
-        elogAlignedFreeObjectArray(m_ringBuffer, m_ringBufferSize);
-        m_ringBuffer = nullptr;
+
+    // keep statistics of the last run
+    m_runTimeNanos = getSteadyTimeNanos() - m_startTimeNanos;
+    m_nodeMsgCounts.resize(m_nodeCount);
+    for (uint32_t i = 0; i < m_nodeCount; ++i) {
+        m_nodeMsgCounts[i] = m_nodeRings[i].m_msgCount.load(std::memory_order_relaxed);
     }
+    freeNodeRings();
     return true;
 }
 
+bool ELogQuantumTarget::allocNodeRing(NodeRing& nodeRing) {
+    nodeRing.m_ringBuffer =
+        elogAlignedAllocObjectArray<ELogRecordData>(ELOG_CACHE_LINE, m_ringBufferSize);
+    if (nodeRing.m_ringBuffer == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate ring buffer of %" PRIu64
+                          " elements for quantum log target",
+                          m_ringBufferSize);
+        return false;
+    }
+    nodeRing.m_bufferArray =
+        elogAlignedAllocObjectArray<ELogBuffer>(ELOG_CACHE_LINE, m_ringBufferSize);
+    if (nodeRing.m_bufferArray == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate log buffer array of %" PRIu64
+                          " elements for quantum log target",
+                          m_ringBufferSize);
+        elogAlignedFreeObjectArray(nodeRing.m_ringBuffer, m_ringBufferSize);
+        nodeRing.m_ringBuffer = nullptr;
+        return false;
+    }
+    //  reserve in advance some space to avoid penalty on first round
+    for (uint64_t i = 0; i < m_ringBufferSize; ++i) {
+        nodeRing.m_ringBuffer[i].setLogBuffer(&nodeRing.m_bufferArray[i]);
+    }
+    return true;
+}
+
+void ELogQuantumTarget::freeNodeRing(NodeRing& nodeRing) {
+    if (nodeRing.m_bufferArray != nullptr) {
+        elogAlignedFreeObjectArray(nodeRing.m_bufferArray, m_ringBufferSize);
+        nodeRing.m_bufferArray = nullptr;
+    }
+    if (nodeRing.m_ringBuffer != nullptr) {
+        elogAlignedFreeObjectArray(nodeRing.m_ringBuffer, m_ringBufferSize);
+        nodeRing.m_ringBuffer = nullptr;
+    }
+}
+
+void ELogQuantumTarget::freeNodeRings() {
+    if (m_nodeRings != nullptr) {
+        for (uint32_t i = 0; i < m_nodeCount; ++i) {
+            freeNodeRing(m_nodeRings[i]);
+        }
+        elogAlignedFreeObjectArray(m_nodeRings, m_nodeCount);
+        m_nodeRings = nullptr;
+    }
+}
+
 bool ELogQuantumTarget::writeLogRecord(const ELogRecord& logRecord, uint64_t& bytesWritten) {
-    uint64_t writePos = m_writePos.fetch_add(1, std::memory_order_acquire);
-    uint64_t readPos = m_readPos.load(std::memory_order_relaxed);
+    // with several NUMA nodes, each thread writes to the ring buffer of the node it was bound to
+    if (m_nodeCount == 1) {
+        writeNodeRing(m_nodeRings[0], logRecord);
+    } else {
+        if (sThreadNode == ELOG_UNBOUND_NODE) {
+            sThreadNode = elogGetCurrentNumaNode();
+            sThreadSeq = sNextThreadSeq.fetch_add(1, std::memory_order_relaxed);
+        }
+        uint32_t ringIndex = (sThreadNode + m_numaNodeCount * sThreadSeq) % m_nodeCount;
+        writeNodeRing(m_nodeRings[ringIndex], logRecord);
+    }
+
+    // NOTE: asynchronous loggers do not report bytes written
+    bytesWritten = 0;
+    return true;
+}
+
+void ELogQuantumTarget::writeNodeRing(NodeRing& nodeRing, const ELogRecord& logRecord) {
+    uint64_t writePos = nodeRing.m_writePos.fetch_add(1, std::memory_order_acquire);
+    uint64_t readPos = nodeRing.m_readPos.load(std::memory_order_relaxed);
 
     // wait until there is no other writer contending for the same entry
     while (writePos - readPos >= m_ringBufferSize) {
         CPU_RELAX;
-        readPos = m_readPos.load(std::memory_order_relaxed);
+        readPos = nodeRing.m_readPos.load(std::memory_order_relaxed);
     }
-    ELogRecordData& recordData = m_ringBuffer[writePos % m_ringBufferSize];
+    ELogRecordData& recordData = nodeRing.m_ringBuffer[writePos % m_ringBufferSize];
     EntryState entryState = recordData.m_entryState.load(std::memory_order_seq_cst);
 
     // now wait for entry to become vacant
@@ -116,34 +229,63 @@ bool ELogQuantumTarget::writeLogRecord(const ELogRecord& logRecord, uint64_t& by
     recordData.m_logBuffer->assign(logRecord.m_logMsg, logRecord.m_logMsgLen);
     recordData.m_logRecord.m_logMsg = recordData.m_logBuffer->getRef();
     recordData.m_entryState.store(ES_READY, std::memory_order_release);
-
-    // NOTE: asynchronous loggers do not report bytes written
-    bytesWritten = 0;
-    return true;
 }
 
 bool ELogQuantumTarget::flushLogTarget() {
-    // log empty message, which designated a flush request
+    // log empty message, which designated a flush request, to all ring buffers, since log records
+    // of other nodes are not ordered before a flush request posted only to the current node
     // NOTE: there is no waiting for flush to complete
     ELOG_CACHE_ALIGN ELogRecord flushRecord;
     flushRecord.m_logMsg = "";
     flushRecord.m_reserved = ELOG_FLUSH_REQUEST;
-    uint64_t dummy = 0;
-    writeLogRecord(flushRecord, dummy);
+    for (uint32_t i = 0; i < m_nodeCount; ++i) {
+        writeNodeRing(m_nodeRings[i], flushRecord);
+    }
     return true;
 }
 
-void ELogQuantumTarget::logThread() {
+void ELogQuantumTarget::printTargetStats(ELogBuffer& buffer) {
+    if (m_nodeCount <= 1) {
+        return;
+    }
+    uint64_t runTimeNanos =
+        (m_nodeRings != nullptr) ? getSteadyTimeNanos() - m_startTimeNanos : m_runTimeNanos;
+    double runTimeSeconds = runTimeNanos / 1000000000.0;
+    for (uint32_t i = 0; i < m_nodeCount; ++i) {
+        uint64_t msgCount = getNodeMsgCount(i);
+        buffer.appendArgs("\tRing %u (NUMA node %u) log messages: %" PRIu64 " (%.1f msg/sec)\n",
+                          i, i % m_numaNodeCount, msgCount,
+                          runTimeSeconds > 0 ? msgCount / runTimeSeconds : 0.0);
+    }
+}
+
+void ELogQuantumTarget::logThread(NodeRing* nodeRing) {
     std::string threadName = std::string(getName()) + "-log-thread";
+    if (m_nodeCount > 1) {
+        threadName += "-" + std::to_string(nodeRing->m_node);
+    }
     setCurrentThreadNameField(threadName.c_str());
+
+    // pin log thread to its node (or to the configured CPUs)
+    std::vector<uint32_t> cpus;
+    if (m_numaNodeCount > 1) {
+        elogGetNodeConsumerCpus(nodeRing->m_numaNode, m_consumerCpus, cpus);
+    } else {
+        cpus = m_consumerCpus;
+    }
+    if (!cpus.empty() && !elogSetCurrentThreadAffinity(cpus)) {
+        ELOG_REPORT_WARN("Failed to set CPU affinity of quantum log thread %s",
+                         threadName.c_str());
+    }
+
     bool done = false;
     // const uint64_t SPIN_COUNT_INIT = 256;
     // const uint64_t SPIN_COUNT_MAX = 16384;
     // uint64_t spinCount = SPIN_COUNT_INIT;
     while (!done) {
         // get read/write pos
-        uint64_t writePos = m_writePos.load(std::memory_order_relaxed);
-        uint64_t readPos = m_readPos.load(std::memory_order_relaxed);
+        uint64_t writePos = nodeRing->m_writePos.load(std::memory_order_relaxed);
+        uint64_t readPos = nodeRing->m_readPos.load(std::memory_order_relaxed);
 
         // check if there is a new log record
         if (writePos > readPos) {
@@ -154,39 +296,52 @@ void ELogQuantumTarget::logThread() {
             if (writePos - readPos > m_ringBufferSize) {
                 writePos = readPos + m_ringBufferSize;
             }
+            recordBatchSize(writePos - readPos);
 
-            // wait until record is ready for reading
-            ELogRecordData& recordData = m_ringBuffer[readPos % m_ringBufferSize];
-            EntryState entryState = recordData.m_entryState.load(std::memory_order_relaxed);
-            // uint32_t localSpinCount = SPIN_COUNT_INIT;
-            while (entryState != ES_READY) {
-                // cpu relax then try again
-                // NOTE: this degrades performance, not clear yet why
-                // spin and exponential backoff
-                // for (uint32_t spin = 0; spin < localSpinCount; ++spin) {
-                //    CPU_RELAX;
-                //}
-                // localSpinCount *= 2;
-                entryState = recordData.m_entryState.load(std::memory_order_relaxed);
-                // we don't spin/back-off here since the state change is expected to happen
-                // immediately
+            // with several log threads, the batch is delivered to the subordinate log target under
+            // the merge lock
+            std::unique_lock<std::mutex> lock(m_mergeLock, std::defer_lock);
+            if (m_nodeCount > 1) {
+                lock.lock();
             }
+            uint64_t msgCount = 0;
+            while (readPos < writePos && !done) {
+                // wait until record is ready for reading
+                ELogRecordData& recordData = nodeRing->m_ringBuffer[readPos % m_ringBufferSize];
+                EntryState entryState = recordData.m_entryState.load(std::memory_order_relaxed);
+                // uint32_t localSpinCount = SPIN_COUNT_INIT;
+                while (entryState != ES_READY) {
+                    // cpu relax then try again
+                    // NOTE: this degrades performance, not clear yet why
+                    // spin and exponential backoff
+                    // for (uint32_t spin = 0; spin < localSpinCount; ++spin) {
+                    //    CPU_RELAX;
+                    //}
+                    // localSpinCount *= 2;
+                    entryState = recordData.m_entryState.load(std::memory_order_relaxed);
+                    // we don't spin/back-off here since the state change is expected to happen
+                    // immediately
+                }
 
-            // no need to move state to reading
-            assert(recordData.m_entryState.load(std::memory_order_relaxed) == ES_READY);
+                // no need to move state to reading
+                assert(recordData.m_entryState.load(std::memory_order_relaxed) == ES_READY);
 
-            // log record, flush or terminate
-            if (recordData.m_logRecord.m_reserved == ELOG_STOP_REQUEST) {
-                done = true;
-            } else if (recordData.m_logRecord.m_reserved == ELOG_FLUSH_REQUEST) {
-                m_subTarget->flush();
-            } else {
-                m_subTarget->log(recordData.m_logRecord);
-            }
+                // log record, flush or terminate
+                if (recordData.m_logRecord.m_reserved == ELOG_STOP_REQUEST) {
+                    done = true;
+                } else if (recordData.m_logRecord.m_reserved == ELOG_FLUSH_REQUEST) {
+                    m_subTarget->flush();
+                } else {
+                    m_subTarget->log(recordData.m_logRecord);
+                    ++msgCount;
+                }
 
-            // change state back to vacant and update read pos
-            recordData.m_entryState.store(ES_VACANT, std::memory_order_relaxed);
-            m_readPos.fetch_add(1, std::memory_order_relaxed);
+                // change state back to vacant and update read pos
+                recordData.m_entryState.store(ES_VACANT, std::memory_order_relaxed);
+                nodeRing->m_readPos.fetch_add(1, std::memory_order_release);
+                ++readPos;
+            }
+            nodeRing->m_msgCount.fetch_add(msgCount, std::memory_order_relaxed);
         } else {
             // write pos is not changing yet, so this mostly means the writers are idle, but since
             // they might start any time, we don't do any spin/backoff, but rather just relax
@@ -210,6 +365,10 @@ void ELogQuantumTarget::logThread() {
     }
 
     // do a final flush and terminate
+    std::unique_lock<std::mutex> lock(m_mergeLock, std::defer_lock);
+    if (m_nodeCount > 1) {
+        lock.lock();
+    }
     m_subTarget->flush();
 }
 
@@ -3,6 +3,7 @@
 #include "async/elog_quantum_target.h"
 #include "elog_common.h"
 #include "elog_config_loader.h"
+#include "elog_numa.h"
 #include "elog_report.h"
 
 namespace elog {
@@ -27,19 +28,41 @@ ELogTarget* ELogQuantumTargetProvider::loadTarget(const ELogConfigMapNode* logTa
         return nullptr;
     }
 
+    // parse NUMA awareness
+    bool numaAware = false;
+    if (!ELogConfigLoader::getOptionalLogTargetBoolProperty(logTargetCfg, "asynchronous",
+                                                            "quantum_numa", numaAware)) {
+        return nullptr;
+    }
+
+    // parse consumer CPU list
+    std::string consumerCpuList;
+    std::vector<uint32_t> consumerCpus;
+    if (!ELogConfigLoader::getOptionalLogTargetStringProperty(
+            logTargetCfg, "asynchronous", "quantum_consumer_cpus", consumerCpuList)) {
+        return nullptr;
+    }
+    if (!consumerCpuList.empty() && !elogParseCpuList(consumerCpuList.c_str(), consumerCpus)) {
+        ELOG_REPORT_ERROR("Invalid quantum_consumer_cpus property value: %s",
+                          consumerCpuList.c_str());
+        return nullptr;
+    }
+
     // load nested target
     ELogTarget* target = loadNestedTarget(logTargetCfg);
     if (target == nullptr) {
         return nullptr;
     }
 
-    ELogAsyncTarget* asyncTarget =
+    ELogQuantumTarget* asyncTarget =
         new (std::nothrow) ELogQuantumTarget(target, quantumBufferSize, quantumCollectPeriodMicros);
     if (asyncTarget == nullptr) {
         ELOG_REPORT_ERROR("Failed to create quantum log target, out of memory");
         target->destroy();
         return nullptr;
     }
+    asyncTarget->setNumaAware(numaAware);
+    asyncTarget->setConsumerCpus(consumerCpus);
     // NOTE: ELogSystem will configure common properties for this log target
     return asyncTarget;
 }
@@ -10,6 +10,14 @@ ELogQueuedTarget::ELogQueuedTarget(ELogTarget* logTarget, uint32_t batchSize,
 
 void ELogQueuedTarget::waitQueue(std::unique_lock<std::mutex>& lock) {
     m_cv.wait_for(lock, m_timeoutMillis,
-                  [this]() { return m_stop || m_logQueue.size() >= m_batchSize; });
+                  [this]() {
+                      return m_stop || m_queueSize.load(std::memory_order_relaxed) >= m_batchSize;
+                  });
+}
+
+bool ELogQueuedTarget::shouldNotify(bool wasEmpty, uint64_t queueSize) {
+    // notify only when a full batch is ready (partial batches are picked up on timeout)
+    (void)wasEmpty;
+    return queueSize == m_batchSize;
 }
 }  // namespace elog
@@ -0,0 +1,292 @@
+#include "db/elog_columnar_batch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+#include "elog_field_receptor.h"
+#include "elog_report.h"
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogColumnarBatch)
+
+// receives fields from a field selector into the column currently being filled
+class ELogColumnReceptor : public ELogFieldReceptor {
+public:
+    ELogColumnReceptor(std::string& stringHeap)
+        : m_column(nullptr), m_stringHeap(stringHeap), m_received(false), m_overflow(false) {}
+    ELogColumnReceptor(const ELogColumnReceptor&) = delete;
+    ELogColumnReceptor(ELogColumnReceptor&&) = delete;
+    ELogColumnReceptor& operator=(const ELogColumnReceptor&) = delete;
+    ~ELogColumnReceptor() final {}
+
+    /** @brief Prepares for receiving the next field into a column. */
+    inline void startField(ELogColumnarBatch::Column& column) {
+        m_column = &column;
+        m_received = false;
+    }
+
+    /** @brief Completes the current field, adding an empty value if no field was received. */
+    inline void endField() {
+        if (!m_received) {
+            if (m_column->m_paramType == ELogDbFormatter::ParamType::PT_TEXT) {
+                appendText("", 0);
+            } else if (m_column->m_paramType == ELogDbFormatter::ParamType::PT_LOG_LEVEL) {
+                m_column->m_levelValues.push_back(ELEVEL_INFO);
+            } else {
+                m_column->m_intValues.push_back(0);
+            }
+        }
+    }
+
+    /** @brief Queries whether a string could not be appended since the string heap is full. */
+    inline bool hasOverflow() const { return m_overflow; }
+
+    /** @brief Resets the string heap overflow state. */
+    inline void resetOverflow() { m_overflow = false; }
+
+    /** @brief Appends a string to the string heap, and its offset and length to the column. */
+    inline void appendText(const char* text, size_t length) {
+        // zero length means the string is null terminated
+        if (length == 0) {
+            length = strlen(text);
+        }
+        // string offsets are 32 bit, so the heap cannot grow beyond that
+        if ((uint64_t)m_stringHeap.length() + length > UINT32_MAX) {
+            m_overflow = true;
+            return;
+        }
+        m_column->m_textOffsets.push_back((uint32_t)m_stringHeap.length());
+        m_column->m_textLengths.push_back((uint32_t)length);
+        m_stringHeap.append(text, length);
+    }
+
+    /** @brief Receives a string log record field. */
+    void receiveStringField(uint32_t typeId, const char* field, const ELogFieldSpec& fieldSpec,
+                            size_t length) final {
+        if (m_received) {
+            return;
+        }
+        if (m_column->m_paramType == ELogDbFormatter::ParamType::PT_TEXT) {
+            appendText(field, length);
+        } else if (m_column->m_paramType == ELogDbFormatter::ParamType::PT_LOG_LEVEL) {
+            ELogLevel logLevel = ELEVEL_INFO;
+            if (!elogLevelFromStr(field, logLevel)) {
+                ELOG_REPORT_WARN("Invalid log level '%s' in column %s", field,
+                                 m_column->m_name.c_str());
+            }
+            m_column->m_levelValues.push_back(logLevel);
+        } else {
+            // NOTE: string fields are null terminated
+            m_column->m_intValues.push_back((uint64_t)strtoull(field, nullptr, 10));
+        }
+        m_received = true;
+    }
+
+    /** @brief Receives an integer log record field. */
+    void receiveIntField(uint32_t typeId, uint64_t field, const ELogFieldSpec& fieldSpec) final {
+        if (m_received) {
+            return;
+        }
+        if (m_column->m_paramType == ELogDbFormatter::ParamType::PT_TEXT) {
+            std::string value = std::to_string(field);
+            appendText(value.c_str(), value.length());
+        } else if (m_column->m_paramType == ELogDbFormatter::ParamType::PT_LOG_LEVEL) {
+            m_column->m_levelValues.push_back((ELogLevel)field);
+        } else {
+            m_column->m_intValues.push_back(field);
+        }
+        m_received = true;
+    }
+
+    /** @brief Receives a time log record field. */
+    void receiveTimeField(uint32_t typeId, const ELogTime& logTime, const char* timeStr,
+                          const ELogFieldSpec& fieldSpec, size_t length) final {
+        if (m_received) {
+            return;
+        }
+        if (m_column->m_paramType == ELogDbFormatter::ParamType::PT_TEXT) {
+            appendText(timeStr, length);
+        } else if (m_column->m_paramType == ELogDbFormatter::ParamType::PT_LOG_LEVEL) {
+            m_column->m_levelValues.push_back(ELEVEL_INFO);
+        } else {
+            m_column->m_intValues.push_back(elogTimeToUnixTimeNanos(logTime));
+        }
+        m_received = true;
+    }
+
+    /** @brief Receives a log level log record field. */
+    void receiveLogLevelField(uint32_t typeId, ELogLevel logLevel,
+                              const ELogFieldSpec& fieldSpec) final {
+        if (m_received) {
+            return;
+        }
+        if (m_column->m_paramType == ELogDbFormatter::ParamType::PT_TEXT) {
+            const char* logLevelStr = elogLevelToStr(logLevel);
+            appendText(logLevelStr, strlen(logLevelStr));
+        } else if (m_column->m_paramType == ELogDbFormatter::ParamType::PT_LOG_LEVEL) {
+            m_column->m_levelValues.push_back(logLevel);
+        } else {
+            m_column->m_intValues.push_back((uint64_t)logLevel);
+        }
+        m_received = true;
+    }
+
+private:
+    ELogColumnarBatch::Column* m_column;
+    std::string& m_stringHeap;
+    bool m_received;
+    bool m_overflow;
+};
+
+ELogColumnarBatch::Column::Column(const std::string& name, ELogDbFormatter::ParamType paramType,
+                                  ELogFieldSelector* fieldSelector)
+    : m_name(name),
+      m_paramType(paramType),
+      m_fieldSelector(fieldSelector),
+      m_valueSource(ValueSource::VS_SELECTOR) {
+    // fields that are stored as-is in the log record are read directly, as long as the column
+    // type matches the field type (otherwise the selector/receptor pair takes care of conversion)
+    if (paramType == ELogDbFormatter::ParamType::PT_DATETIME &&
+        dynamic_cast<ELogTimeSelector*>(fieldSelector) != nullptr) {
+        m_valueSource = ValueSource::VS_LOG_TIME;
+    } else if (paramType == ELogDbFormatter::ParamType::PT_LOG_LEVEL &&
+               dynamic_cast<ELogLevelSelector*>(fieldSelector) != nullptr) {
+        m_valueSource = ValueSource::VS_LOG_LEVEL;
+    } else if (paramType == ELogDbFormatter::ParamType::PT_INT &&
+               dynamic_cast<ELogThreadIdSelector*>(fieldSelector) != nullptr) {
+        m_valueSource = ValueSource::VS_THREAD_ID;
+    } else if (paramType == ELogDbFormatter::ParamType::PT_INT &&
+               dynamic_cast<ELogRecordIdSelector*>(fieldSelector) != nullptr) {
+        m_valueSource = ValueSource::VS_RECORD_ID;
+    }
+}
+
+void ELogColumnarBatch::Column::clear() {
+    m_intValues.clear();
+    m_levelValues.clear();
+    m_textOffsets.clear();
+    m_textLengths.clear();
+}
+
+void ELogColumnarBatch::Column::truncate(size_t rowCount) {
+    if (m_paramType == ELogDbFormatter::ParamType::PT_TEXT) {
+        m_textOffsets.resize(rowCount);
+        m_textLengths.resize(rowCount);
+    } else if (m_paramType == ELogDbFormatter::ParamType::PT_LOG_LEVEL) {
+        m_levelValues.resize(rowCount);
+    } else {
+        m_intValues.resize(rowCount);
+    }
+}
+
+void ELogColumnarBatch::Column::reserve(size_t rowCount) {
+    // capacity grows geometrically, so appending a few records at a time does not reallocate on
+    // each append
+    auto reserveValues = [rowCount](auto& values) {
+        if (rowCount > values.capacity()) {
+            values.reserve(std::max(rowCount, 2 * values.capacity()));
+        }
+    };
+    if (m_paramType == ELogDbFormatter::ParamType::PT_TEXT) {
+        reserveValues(m_textOffsets);
+        reserveValues(m_textLengths);
+    } else if (m_paramType == ELogDbFormatter::ParamType::PT_LOG_LEVEL) {
+        reserveValues(m_levelValues);
+    } else {
+        reserveValues(m_intValues);
+    }
+}
+
+void ELogColumnarBatch::addColumn(const std::string& name, ELogDbFormatter::ParamType paramType,
+                                  ELogFieldSelector* fieldSelector) {
+    // columns cannot be added after rows were added
+    assert(m_rowCount == 0);
+    m_columns.emplace_back(name, paramType, fieldSelector);
+}
+
+void ELogColumnarBatch::reset() {
+    m_columns.clear();
+    m_stringHeap.clear();
+    m_rowCount = 0;
+}
+
+void ELogColumnarBatch::reserve(size_t rowCount) {
+    for (Column& column : m_columns) {
+        column.reserve(rowCount);
+    }
+}
+
+void ELogColumnarBatch::clear() {
+    for (Column& column : m_columns) {
+        column.clear();
+    }
+    m_stringHeap.clear();
+    m_rowCount = 0;
+}
+
+size_t ELogColumnarBatch::appendLogRecords(const ELogRecord* logRecords, size_t count) {
+    for (Column& column : m_columns) {
+        column.reserve(m_rowCount + count);
+    }
+
+    // single pass over the records, each record filling all columns, so that each record is
+    // brought into cache only once
+    ELogColumnReceptor receptor(m_stringHeap);
+    for (size_t i = 0; i < count; ++i) {
+        const ELogRecord& logRecord = logRecords[i];
+        size_t heapLength = m_stringHeap.length();
+        for (Column& column : m_columns) {
+            appendValue(column, logRecord, receptor);
+        }
+        if (receptor.hasOverflow()) {
+            // string heap is full, so the partial row is discarded, and the caller should consume
+            // the batch and clear it before appending the rest
+            for (Column& column : m_columns) {
+                column.truncate(m_rowCount);
+            }
+            m_stringHeap.resize(heapLength);
+            if (m_rowCount == 0) {
+                ELOG_REPORT_ERROR(
+                    "Cannot append log record to columnar batch: record strings exceed string "
+                    "heap size limit");
+            }
+            return i;
+        }
+        ++m_rowCount;
+    }
+    return count;
+}
+
+void ELogColumnarBatch::appendValue(Column& column, const ELogRecord& logRecord,
+                                    ELogColumnReceptor& receptor) {
+    switch (column.m_valueSource) {
+        case Column::ValueSource::VS_LOG_TIME:
+            column.m_intValues.push_back(elogTimeToUnixTimeNanos(logRecord.m_logTime));
+            break;
+
+        case Column::ValueSource::VS_LOG_LEVEL:
+            column.m_levelValues.push_back(logRecord.m_logLevel);
+            break;
+
+        case Column::ValueSource::VS_THREAD_ID:
+            column.m_intValues.push_back(logRecord.m_threadId);
+            break;
+
+        case Column::ValueSource::VS_RECORD_ID:
+            column.m_intValues.push_back(logRecord.m_logRecordId);
+            break;
+
+        case Column::ValueSource::VS_SELECTOR:
+        default:
+            receptor.startField(column);
+            column.m_fieldSelector->selectField(logRecord, &receptor);
+            receptor.endField();
+            break;
+    }
+}
+
+}  // namespace elog
@@ -2,6 +2,7 @@
 
 #include <cassert>
 
+#include "db/elog_columnar_batch.h"
 #include "elog_report.h"
 
 namespace elog {
@@ -35,33 +36,63 @@ bool ELogDbFormatter::handleField(const ELogFieldSpec& fieldSpec) {
     return ELogFormatter::handleField(fieldSpec);
 }
 
-void ELogDbFormatter::getParamTypes(std::vector<ParamType>& paramTypes) const {
-    for (ELogFieldSelector* fieldSelector : m_fieldSelectors) {
-        switch (fieldSelector->getFieldType()) {
-            case ELogFieldType::FT_TEXT:
-                paramTypes.push_back(ParamType::PT_TEXT);
-                break;
+static bool fieldTypeToParamType(ELogFieldType fieldType, ELogDbFormatter::ParamType& paramType) {
+    switch (fieldType) {
+        case ELogFieldType::FT_TEXT:
+            paramType = ELogDbFormatter::ParamType::PT_TEXT;
+            return true;
+
+        case ELogFieldType::FT_INT:
+            paramType = ELogDbFormatter::ParamType::PT_INT;
+            return true;
+
+        case ELogFieldType::FT_DATETIME:
+            paramType = ELogDbFormatter::ParamType::PT_DATETIME;
+            return true;
 
-            case ELogFieldType::FT_INT:
-                paramTypes.push_back(ParamType::PT_INT);
-                break;
+        case ELogFieldType::FT_LOG_LEVEL:
+            paramType = ELogDbFormatter::ParamType::PT_LOG_LEVEL;
+            return true;
 
-            case ELogFieldType::FT_DATETIME:
-                paramTypes.push_back(ParamType::PT_DATETIME);
-                break;
+        case ELogFieldType::FT_FORMAT:
+            // format fields can be ignored, as they do not represent a real field entity
+            return false;
 
-            case ELogFieldType::FT_LOG_LEVEL:
-                paramTypes.push_back(ParamType::PT_LOG_LEVEL);
-                break;
+        default:
+            assert(false);
+            return false;
+    }
+}
 
-            case ELogFieldType::FT_FORMAT:
-                // format fields can be ignored, as they do not represent a real field entity
-                break;
+void ELogDbFormatter::getParamTypes(std::vector<ParamType>& paramTypes) const {
+    for (ELogFieldSelector* fieldSelector : m_fieldSelectors) {
+        ParamType paramType = ParamType::PT_TEXT;
+        if (fieldTypeToParamType(fieldSelector->getFieldType(), paramType)) {
+            paramTypes.push_back(paramType);
+        }
+    }
+}
 
-            default:
-                assert(false);
+void ELogDbFormatter::prepareColumnarBatch(ELogColumnarBatch& batch) const {
+    batch.reset();
+    for (ELogFieldSelector* fieldSelector : m_fieldSelectors) {
+        // static text (printf query style) is not a column
+        if (dynamic_cast<ELogStaticTextSelector*>(fieldSelector) != nullptr) {
+            continue;
         }
+        ParamType paramType = ParamType::PT_TEXT;
+        if (fieldTypeToParamType(fieldSelector->getFieldType(), paramType)) {
+            batch.addColumn(fieldSelector->getFieldSpec().m_name, paramType, fieldSelector);
+        }
+    }
+}
+
+size_t ELogDbFormatter::fillColumnarBatch(const ELogRecord* logRecords, size_t count,
+                                          ELogColumnarBatch& batch) const {
+    if (batch.getColumnCount() == 0) {
+        prepareColumnarBatch(batch);
     }
+    return batch.appendLogRecords(logRecords, count);
 }
 
 }  // namespace elog
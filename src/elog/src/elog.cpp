@@ -7,11 +7,13 @@
 #include <fstream>
 #include <mutex>
 
+#include "async/elog_deferred_target.h"
 #include "elog_api.h"
 #include "elog_api_log_source.h"
 #include "elog_api_log_target.h"
 #include "elog_api_time_source.h"
 #include "elog_cache.h"
+#include "elog_call_site_limiter.h"
 #include "elog_common.h"
 #include "elog_config.h"
 #include "elog_config_loader.h"
@@ -23,15 +25,18 @@
 #include "elog_formatter_internal.h"
 #include "elog_internal.h"
 #include "elog_level_cfg.h"
+#include "elog_msg_blob.h"
 #include "elog_pre_init_logger.h"
 #include "elog_rate_limiter.h"
 #include "elog_report.h"
 #include "elog_schema_manager.h"
+#include "elog_self_profile.h"
 #include "elog_shared_logger.h"
 #include "elog_stats_internal.h"
 #include "elog_target_spec.h"
 #include "elog_time_internal.h"
 #include "elog_time_source.h"
+#include "elog_timer_service.h"
 
 #ifdef ELOG_ENABLE_MSG
 #include "msg/elog_msg_internal.h"
@@ -131,6 +136,30 @@ bool initGlobals() {
     }
     ELOG_REPORT_TRACE("Log buffer TLS key initialized");
 
+    // create thread local storage key for message blob pool caches
+    if (!ELogMsgBlob::createPoolKey()) {
+        ELOG_REPORT_ERROR("Failed to initialize message blob pool thread local storage");
+        termGlobals();
+        return false;
+    }
+    ELOG_REPORT_TRACE("Message blob pool TLS key initialized");
+
+    // create thread local storage key for deferred target queue node caches
+    if (!ELogDeferredTarget::createNodePoolKey()) {
+        ELOG_REPORT_ERROR("Failed to initialize queue node pool thread local storage");
+        termGlobals();
+        return false;
+    }
+    ELOG_REPORT_TRACE("Queue node pool TLS key initialized");
+
+    // create thread local storage key for self-profiling counters
+    if (!initSelfProfile()) {
+        ELOG_REPORT_ERROR("Failed to initialize self-profiling thread local storage");
+        termGlobals();
+        return false;
+    }
+    ELOG_REPORT_TRACE("Self-profiling TLS key initialized");
+
     // create thread local storage key for log buffers
     if (!ELogSharedLogger::createRecordBuilderKey()) {
         ELOG_REPORT_ERROR("Failed to initialize record builder thread local storage");
@@ -330,6 +359,8 @@ void termGlobals() {
         stopReloadConfigThread();
     }
 #endif
+    // report pending call site suppression summary while log targets are still available
+    getCallSiteLimiter().disable();
     clearAllLogTargets();
     ELogReport::termReport();
 
@@ -388,7 +419,15 @@ void termGlobals() {
     if (!ELogTarget::destroyLogBufferKey()) {
         ELOG_REPORT_ERROR("Failed to destroy log buffer thread-local storage");
     }
+    if (!ELogDeferredTarget::destroyNodePoolKey()) {
+        ELOG_REPORT_ERROR("Failed to destroy queue node pool thread-local storage");
+    }
+    if (!ELogMsgBlob::destroyPoolKey()) {
+        ELOG_REPORT_ERROR("Failed to destroy message blob pool thread-local storage");
+    }
+    termSelfProfile();
     termTimeSource();
+    termTimerService();
     termDateTable();
     sPreInitLogger.discardAccumulatedLogMessages();
 }
@@ -467,6 +506,18 @@ bool configureRateLimit(const char* rateLimitCfg, bool replaceGlobalFilter /* =
     return setRateLimit(maxMsg, timeout, units, replaceGlobalFilter);
 }
 
+bool configureCallSiteRateLimit(const char* rateLimitCfg) {
+    uint64_t maxMsg = 0;
+    uint64_t timeout = 0;
+    ELogTimeUnits units = ELogTimeUnits::TU_NONE;
+    // parse <max-msg>:<timeout>:<units>
+    if (!ELogConfigParser::parseRateLimit(rateLimitCfg, maxMsg, timeout, units)) {
+        ELOG_REPORT_ERROR("Failed to parse call site rate limit configuration: %s", rateLimitCfg);
+        return false;
+    }
+    return setCallSiteRateLimit(maxMsg, timeout, units);
+}
+
 // logger interface
 ELogLogger* getDefaultLogger() { return sDefaultLogger; }
 
@@ -686,7 +737,14 @@ bool setRateLimit(uint64_t maxMsg, uint64_t timeout, ELogTimeUnits timeoutUnits,
     return true;
 }
 
+bool setCallSiteRateLimit(uint64_t maxMsg, uint64_t timeout, ELogTimeUnits timeoutUnits) {
+    return getCallSiteLimiter().enable(maxMsg, timeout, timeoutUnits);
+}
+
+void clearCallSiteRateLimit() { getCallSiteLimiter().disable(); }
+
 bool filterLogMsg(const ELogRecord& logRecord) {
+    ELOG_PROFILE_SCOPE(ELogProfileStage::PS_FILTER);
 #ifdef ELOG_ENABLE_DYNAMIC_CONFIG
     ELOG_SCOPED_EPOCH(getLogTargetGC(), getLogTargetEpoch());
     ELogFilter* logFilter = sGlobalFilter.load(std::memory_order_relaxed);
@@ -791,6 +849,15 @@ void enableLogStatistics() { sEnableStatistics.store(true, std::memory_order_rel
 
 void disableLogStatistics() { sEnableStatistics.store(false, std::memory_order_relaxed); }
 
+void setStatsLatencySampleRate(uint32_t sampleRate) {
+    modifyParams().m_statsLatencySampleRate.m_atomicValue.store(sampleRate,
+                                                                std::memory_order_relaxed);
+}
+
+uint32_t getStatsLatencySampleRate() {
+    return getParams().m_statsLatencySampleRate.m_atomicValue.load(std::memory_order_relaxed);
+}
+
 void getLogStatistics(ELogStatistics& stats) {
     for (uint32_t i = 0; i < ELEVEL_COUNT; ++i) {
         stats.m_msgCount[i] = sMsgCount[i].load(std::memory_order_relaxed);
@@ -136,6 +136,14 @@ bool configureByProps(const ELogPropertySequence& props, bool defineLogSources /
         }
     }
 
+    // configure call site rate limit
+    std::string callSiteRateLimitCfg;
+    if (getProp(props, ELOG_CALL_SITE_RATE_LIMIT_CONFIG_NAME, callSiteRateLimitCfg)) {
+        if (!configureCallSiteRateLimit(callSiteRateLimitCfg.c_str())) {
+            return false;
+        }
+    }
+
     // configure global log level format (font/color)
     /*std::string logLevelFormatCfg;
     if (getProp(props, ELOG_LEVEL_FORMAT_CONFIG_NAME, logLevelFormatCfg)) {
@@ -436,6 +444,16 @@ bool configure(ELogConfig* config, bool defineLogSources /* = true */,
         return false;
     }
 
+    // configure call site rate limit
+    std::string callSiteRateLimitCfg;
+    if (!cfgMap->getStringValue(ELOG_CALL_SITE_RATE_LIMIT_CONFIG_NAME, found,
+                                callSiteRateLimitCfg)) {
+        // configuration error
+        return false;
+    } else if (found && !configureCallSiteRateLimit(callSiteRateLimitCfg.c_str())) {
+        return false;
+    }
+
     std::vector<ELogLevelCfg> logLevelCfg;
     ELogLevel logLevel = ELEVEL_INFO;
     ELogPropagateMode propagateMode = ELogPropagateMode::PM_NONE;
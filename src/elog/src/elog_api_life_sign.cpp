@@ -10,6 +10,7 @@
 #include "elog_internal.h"
 #include "elog_life_sign_filter.h"
 #include "elog_report.h"
+#include "elog_timer_service.h"
 #include "elog_tls.h"
 #include "life_sign_manager.h"
 #include "os_thread_manager.h"
@@ -27,10 +28,6 @@ static ELogTlsKey sThreadLifeSignKey = ELOG_INVALID_TLS_KEY;
 static ELogGC* sLifeSignGC = nullptr;
 static std::atomic<uint64_t> sLifeSignEpoch = 0;
 static std::atomic<ELogFormatter*> sLifeSignFormatter = nullptr;
-static uint64_t sLifeSignSyncPeriodMillis;
-static std::thread sLifeSignSyncThread;
-static std::mutex sLifeSignLock;
-static std::condition_variable sLifeSignCV;
 static std::atomic<bool> sTerminating = false;
 
 static void cleanupThreadLifeSignFilter(void* key);
@@ -657,35 +654,26 @@ bool setLifeSignLogFormat(const char* logFormat) {
     return true;
 }
 
+/** @brief Timer task for periodic life-sign report synchronization. */
+class ELogLifeSignSyncTask final : public ELogTimerTask {
+public:
+    ELogLifeSignSyncTask() {}
+    ELogLifeSignSyncTask(const ELogLifeSignSyncTask&) = delete;
+    ELogLifeSignSyncTask(ELogLifeSignSyncTask&&) = delete;
+    ELogLifeSignSyncTask& operator=(const ELogLifeSignSyncTask&) = delete;
+    ~ELogLifeSignSyncTask() final {}
+
+    void onTimer() final { syncLifeSignReport(); }
+};
+
+static ELogLifeSignSyncTask sLifeSignSyncTask;
+
 void setLifeSignSyncPeriod(uint64_t syncPeriodMillis) {
-    // check if the timer thread is running, and if so update it's period, otherwise launch a new
-    // timer thread
-    std::unique_lock<std::mutex> lock(sLifeSignLock);
-    sLifeSignSyncPeriodMillis = syncPeriodMillis;
+    // schedule/reschedule periodic synchronization on the timer service, or cancel it
     if (syncPeriodMillis > 0) {
-        // create timer thread on-demand (no race, we have the lock)
-        if (!sLifeSignSyncThread.joinable()) {
-            sLifeSignSyncThread = std::thread([]() {
-                setCurrentThreadNameField("life-sign-sync");
-                std::unique_lock<std::mutex> threadLock(sLifeSignLock);
-                while (sLifeSignSyncPeriodMillis > 0) {
-                    sLifeSignCV.wait_for(threadLock,
-                                         std::chrono::milliseconds(sLifeSignSyncPeriodMillis),
-                                         []() { return true; });
-                    syncLifeSignReport();
-                }
-            });
-        } else {
-            // otherwise just notify the thread about the change
-            sLifeSignCV.notify_one();
-        }
+        getTimerService().schedule(&sLifeSignSyncTask, syncPeriodMillis, syncPeriodMillis);
     } else {
-        // notify thread about zero period, and wait for it to terminate
-        if (sLifeSignSyncThread.joinable()) {
-            sLifeSignCV.notify_one();
-            lock.unlock();  // otherwise we dead-lock...
-            sLifeSignSyncThread.join();
-        }
+        getTimerService().cancel(&sLifeSignSyncTask);
     }
 }
 
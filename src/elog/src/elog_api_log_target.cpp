@@ -2,6 +2,7 @@
 
 #include "elog_api.h"
 #include "elog_internal.h"
+#include "elog_render_cache.h"
 #include "elog_report.h"
 #include "file/elog_buffered_file_target.h"
 #include "file/elog_file_schema_handler.h"
@@ -63,7 +64,8 @@ bool initLogTargets() {
     // initialize garbage collector
     if (!sLogTargetGC->initialize("elog_target_gc", getMaxThreads(), 0,
                                   getParams().m_logTargetGCPeriodMillis,
-                                  getParams().m_logTargetGCTaskCount)) {
+                                  getParams().m_logTargetGCTaskCount, 0,
+                                  getParams().m_logTargetGCMode)) {
         ELOG_REPORT_ERROR("Failed to initialize log target garbage collector");
         termLogTargets();
         return false;
@@ -477,18 +479,16 @@ ELogTarget* acquireLogTarget(ELogTargetId targetId, uint64_t& epoch) {
         return nullptr;
     }
 
-    // increment epoch before checking pointer
-    epoch = sLogTargetEpoch.fetch_add(1, std::memory_order_acquire);
-    sLogTargetGC->beginEpoch(epoch);
+    // enter epoch before checking pointer
+    epoch = sLogTargetGC->enterEpoch(sLogTargetEpoch);
 
     ELogTarget* logTarget = sLogTargets[targetId].m_atomicValue.load(std::memory_order_relaxed);
     return logTarget;
 }
 
 ELogTarget* acquireLogTarget(const char* logTargetName, uint64_t& epoch) {
-    // increment epoch before checking pointers
-    epoch = sLogTargetEpoch.fetch_add(1, std::memory_order_acquire);
-    sLogTargetGC->beginEpoch(epoch);
+    // enter epoch before checking pointers
+    epoch = sLogTargetGC->enterEpoch(sLogTargetEpoch);
 
     for (ELogAtomic<ELogTarget*>& logTargetRef : sLogTargets) {
         ELogTarget* logTarget = logTargetRef.m_atomicValue.load(std::memory_order_relaxed);
@@ -502,7 +502,7 @@ ELogTarget* acquireLogTarget(const char* logTargetName, uint64_t& epoch) {
     return nullptr;
 }
 
-void releaseLogTarget(uint64_t epoch) { sLogTargetGC->endEpoch(epoch); }
+void releaseLogTarget(uint64_t epoch) { sLogTargetGC->leaveEpoch(epoch); }
 #endif
 
 #ifdef ELOG_ENABLE_DYNAMIC_CONFIG
@@ -727,6 +727,10 @@ bool logMsgTarget(const ELogRecord& logRecord, ELogTargetAffinityMask logTargetA
     // remove
     ELOG_SCOPED_EPOCH(sLogTargetGC, sLogTargetEpoch);
 
+    // fields rendered by one target's formatter are reused by all other targets
+    ELogRenderCache renderCache(logRecord);
+    ELogScopedRenderCache scopedRenderCache(&renderCache);
+
     bool logged = false;
     for (ELogTargetId logTargetId = 0; logTargetId < sLogTargets.size(); ++logTargetId) {
         ELogTarget* logTarget =
@@ -760,6 +764,10 @@ bool logMsgTarget(const ELogRecord& logRecord, ELogTargetAffinityMask logTargetA
 }
 #else
 bool logMsgTarget(const ELogRecord& logRecord, ELogTargetAffinityMask logTargetAffinityMask) {
+    // fields rendered by one target's formatter are reused by all other targets
+    ELogRenderCache renderCache(logRecord);
+    ELogScopedRenderCache scopedRenderCache(&renderCache);
+
     bool logged = false;
     for (ELogTargetId logTargetId = 0; logTargetId < sLogTargets.size(); ++logTargetId) {
         ELogTarget* logTarget = sLogTargets[logTargetId];
@@ -1,23 +1,49 @@
 #include "elog_api_time_source.h"
 
+#include <cstring>
+#include <mutex>
+
 #include "elog_api.h"
 #include "elog_internal.h"
+#include "elog_report.h"
 #include "elog_time_source.h"
+#include "elog_tsc_clock.h"
 
 namespace elog {
 
+ELOG_DECLARE_REPORT_LOGGER(ELogTimeSourceApi)
+
 static ELogTimeSource sTimeSource;
+static ELogTscClock sTscClock;
+
+// serializes time capture mode changes (which may start/stop the TSC calibration thread)
+static std::mutex sTimeCaptureModeLock;
+static bool sTscClockRunning = false;
+
+static bool parseTimeCaptureMode(const std::string& modeStr, ELogTimeCaptureMode& mode);
+static bool configTimeCaptureMode(const std::string& modeStr);
 
 void initTimeSource() {
     if (isTimeSourceEnabled()) {
         sTimeSource.start();
     }
+    std::unique_lock<std::mutex> lock(sTimeCaptureModeLock);
+    if (getTimeCaptureMode() == ELogTimeCaptureMode::TCM_TSC && !sTscClockRunning) {
+        // NOTE: mode is already published, so the clock must be calibrated as early as possible
+        sTscClock.start();
+        sTscClockRunning = true;
+    }
 }
 
 void termTimeSource() {
     if (isTimeSourceEnabled()) {
         sTimeSource.stop();
     }
+    std::unique_lock<std::mutex> lock(sTimeCaptureModeLock);
+    if (sTscClockRunning) {
+        sTscClock.stop();
+        sTscClockRunning = false;
+    }
 }
 
 void enableLazyTimeSource() {
@@ -45,7 +71,70 @@ void configureLazyTimeSource(uint64_t resolution, ELogTimeUnits resolutionUnits)
     }
 }
 
+void setTimeCaptureMode(ELogTimeCaptureMode timeCaptureMode) {
+    std::unique_lock<std::mutex> lock(sTimeCaptureModeLock);
+    std::atomic<ELogTimeCaptureMode>& modeRef = modifyParams().m_timeCaptureMode.m_atomicValue;
+    if (timeCaptureMode == ELogTimeCaptureMode::TCM_TSC) {
+        // clock must be calibrated before any thread uses it
+        if (!sTscClockRunning) {
+            sTscClock.start();
+            sTscClockRunning = true;
+        }
+        modeRef.store(timeCaptureMode, std::memory_order_release);
+    } else {
+        // NOTE: loggers that still use the TSC clock after mode is switched, see valid (although
+        // no longer refreshed) calibration data
+        modeRef.store(timeCaptureMode, std::memory_order_release);
+        if (sTscClockRunning) {
+            sTscClock.stop();
+            sTscClockRunning = false;
+        }
+    }
+}
+
+ELogTimeCaptureMode getTimeCaptureMode() {
+    return getParams().m_timeCaptureMode.m_atomicValue.load(std::memory_order_relaxed);
+}
+
+void getCurrentLogTime(ELogTime& logTime) { captureCurrentTime(logTime); }
+
+bool parseTimeCaptureMode(const std::string& modeStr, ELogTimeCaptureMode& mode) {
+    if (modeStr.compare("realtime") == 0) {
+        mode = ELogTimeCaptureMode::TCM_REALTIME;
+    } else if (modeStr.compare("realtime_coarse") == 0) {
+        mode = ELogTimeCaptureMode::TCM_REALTIME_COARSE;
+    } else if (modeStr.compare("tsc") == 0) {
+        mode = ELogTimeCaptureMode::TCM_TSC;
+    } else {
+        ELOG_REPORT_ERROR(
+            "Invalid time capture mode: %s (expecting realtime, realtime_coarse or tsc)",
+            modeStr.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool configTimeCaptureMode(const std::string& modeStr) {
+    ELogTimeCaptureMode mode = ELOG_DEFAULT_TIME_CAPTURE_MODE;
+    if (!parseTimeCaptureMode(modeStr, mode)) {
+        return false;
+    }
+    if (mode != getTimeCaptureMode()) {
+        setTimeCaptureMode(mode);
+    }
+    return true;
+}
+
 bool configTimeSourceProps(const ELogPropertySequence& props) {
+    // configure time capture mode (allow override from env)
+    std::string timeCaptureMode;
+    if (getStringEnv(ELOG_CONFIG_TIME_CAPTURE_MODE_NAME, timeCaptureMode) ||
+        getProp(props, ELOG_CONFIG_TIME_CAPTURE_MODE_NAME, timeCaptureMode)) {
+        if (!configTimeCaptureMode(timeCaptureMode)) {
+            return false;
+        }
+    }
+
     // configure time source (allow override from env)
     bool enableTimeSource = false;
     bool found = false;
@@ -83,9 +172,20 @@ bool configTimeSourceProps(const ELogPropertySequence& props) {
 }
 
 bool configTimeSource(const ELogConfigMapNode* cfgMap) {
+    // configure time capture mode (allow override from env)
+    std::string timeCaptureMode;
+    bool found = getStringEnv(ELOG_CONFIG_TIME_CAPTURE_MODE_NAME, timeCaptureMode);
+    if (!found &&
+        !cfgMap->getStringValue(ELOG_CONFIG_TIME_CAPTURE_MODE_NAME, found, timeCaptureMode)) {
+        return false;
+    }
+    if (found && !configTimeCaptureMode(timeCaptureMode)) {
+        return false;
+    }
+
     // configure time source (allow override from env)
     bool enableTimeSource = false;
-    bool found = false;
+    found = false;
     if (!getBoolEnv(ELOG_CONFIG_ENABLE_TIME_SOURCE_NAME, enableTimeSource, true, &found)) {
         return false;
     }
@@ -125,4 +225,20 @@ bool configTimeSource(const ELogConfigMapNode* cfgMap) {
 
 void getCurrentTimeFromSource(ELogTime& currentTime) { sTimeSource.getCurrentTime(currentTime); }
 
+void getCurrentTimeFromClock(ELogTime& currentTime) {
+    switch (getTimeCaptureMode()) {
+        case ELogTimeCaptureMode::TCM_REALTIME_COARSE:
+            elogGetCurrentTimeCoarse(currentTime);
+            break;
+
+        case ELogTimeCaptureMode::TCM_TSC:
+            sTscClock.getCurrentTime(currentTime);
+            break;
+
+        default:
+            elogGetCurrentTime(currentTime);
+            break;
+    }
+}
+
 }  // namespace elog
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "elog_call_site_limiter.h"
+
+#include <cinttypes>
+#include <thread>
+
+#include "elog_common.h"
+#include "elog_report.h"
+#include "elog_time.h"
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogCallSiteLimiter)
+
+static ELogCallSiteLimiter sCallSiteLimiter;
+
+// row hash seeds (arbitrary odd constants)
+static const uint64_t sRowSeeds[ELOG_CALL_SITE_SKETCH_ROWS] = {
+    0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0xD6E8FEB86659FD93ull};
+
+inline uint64_t mixHash(uint64_t value) {
+    // splitmix64 finalizer
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ull;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBull;
+    value ^= value >> 31;
+    return value;
+}
+
+inline uint64_t getCallSiteKey(const char* file, int line) {
+    // NOTE: file names passed by logging macros are string literals, so the pointer identifies the
+    // file, and there is no need to hash the file name itself
+    uint64_t key = mixHash(((uint64_t)(uintptr_t)file) ^ (((uint64_t)line) << 48));
+    // zero is reserved for vacant offender slots
+    return key != 0 ? key : 1;
+}
+
+// low and high 32 bits of tagged counters and keys
+#define ELOG_TAG_MASK 0xFFFFFFFF00000000ull
+#define ELOG_COUNT_MASK 0xFFFFFFFFull
+
+inline uint64_t getWindowTag(uint64_t windowId) { return (windowId & ELOG_COUNT_MASK) << 32; }
+
+inline uint64_t getTaggedCount(uint64_t value, uint64_t windowTag) {
+    return ((value & ELOG_TAG_MASK) == windowTag) ? (value & ELOG_COUNT_MASK) : 0;
+}
+
+inline void addTaggedCount(std::atomic<uint64_t>& counter, uint64_t windowTag, uint64_t count) {
+    // first addition in a time window replaces the tag, and counts saturate at 32 bits
+    uint64_t value = counter.load(std::memory_order_relaxed);
+    for (;;) {
+        uint64_t newCount = getTaggedCount(value, windowTag) + count;
+        if (newCount > ELOG_COUNT_MASK) {
+            newCount = ELOG_COUNT_MASK;
+        }
+        if (counter.compare_exchange_weak(value, windowTag | newCount,
+                                          std::memory_order_relaxed)) {
+            break;
+        }
+    }
+}
+
+// suppression summary reports pass through the call site limiter as well, and are never limited
+static thread_local bool sIsReporting = false;
+
+thread_local ELogCallSiteLimiter::ELogCallSiteTokens
+    ELogCallSiteLimiter::sTokenCache[ELOG_CALL_SITE_THREAD_CACHE_SIZE] = {};
+
+ELogCallSiteLimiter& getCallSiteLimiter() { return sCallSiteLimiter; }
+
+ELogCallSiteLimiter::ELogCallSiteLimiter()
+    : m_enabled(false),
+      m_maxMsg(0),
+      m_currWindowId(1),
+      m_nextReportWindowId(1),
+      m_reporting(false),
+      m_reportTimeMillis(0) {
+    for (uint32_t i = 0; i < ELOG_CALL_SITE_SKETCH_ROWS; ++i) {
+        for (uint32_t j = 0; j < ELOG_CALL_SITE_SKETCH_COLUMNS; ++j) {
+            m_sketch[i][j].store(0, std::memory_order_relaxed);
+        }
+    }
+    for (uint32_t i = 0; i < 2; ++i) {
+        for (uint32_t j = 0; j < ELOG_CALL_SITE_MAX_OFFENDERS; ++j) {
+            ELogOffender& offender = m_offenders[i][j];
+            offender.m_key.store(0, std::memory_order_relaxed);
+            offender.m_file.store(nullptr, std::memory_order_relaxed);
+            offender.m_line.store(0, std::memory_order_relaxed);
+            offender.m_suppressCount.store(0, std::memory_order_relaxed);
+        }
+        m_otherSuppressCount[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool ELogCallSiteLimiter::enable(uint64_t maxMsg, uint64_t timeout, ELogTimeUnits timeoutUnits) {
+    uint64_t windowMillis = 0;
+    if (!convertTimeUnit(timeout, timeoutUnits, ELogTimeUnits::TU_MILLI_SECONDS, windowMillis)) {
+        ELOG_REPORT_ERROR("Invalid call site rate limit timeout value: %" PRIu64 " %s", timeout,
+                          timeUnitToString(timeoutUnits));
+        return false;
+    }
+    if (windowMillis == 0) {
+        ELOG_REPORT_ERROR("Call site rate limit timeout less than 1 millisecond: %" PRIu64 " %s",
+                          timeout, timeUnitToString(timeoutUnits));
+        return false;
+    }
+
+    lockReport();
+    getTimerService().cancel(this);
+
+    // start a new time window, so that counters and tokens reserved under previous settings are
+    // discarded
+    uint64_t windowId = m_currWindowId.fetch_add(1, std::memory_order_relaxed);
+    if (m_enabled.load(std::memory_order_relaxed)) {
+        reportSuppressed(windowId + 1);
+    } else {
+        m_nextReportWindowId.store(windowId + 1, std::memory_order_relaxed);
+        m_reportTimeMillis = elogGetSteadyMillisCoarse();
+    }
+    m_maxMsg.store(maxMsg, std::memory_order_relaxed);
+    m_enabled.store(true, std::memory_order_release);
+    getTimerService().schedule(this, windowMillis, windowMillis);
+    unlockReport();
+    return true;
+}
+
+void ELogCallSiteLimiter::disable() {
+    lockReport();
+    if (m_enabled.exchange(false, std::memory_order_acq_rel)) {
+        getTimerService().cancel(this);
+        uint64_t windowId = m_currWindowId.fetch_add(1, std::memory_order_relaxed);
+        reportSuppressed(windowId + 1);
+    }
+    unlockReport();
+}
+
+bool ELogCallSiteLimiter::admit(const char* file, int line) {
+    // NOTE: the time window id is advanced by the timer service, so no clock is read here
+    uint64_t windowId = m_currWindowId.load(std::memory_order_relaxed);
+    uint64_t key = getCallSiteKey(file, line);
+    ELogCallSiteTokens& tokens = sTokenCache[key & (ELOG_CALL_SITE_THREAD_CACHE_SIZE - 1)];
+    if (tokens.m_key != key || tokens.m_windowId != windowId || tokens.m_limiter != this) {
+        resetTokens(tokens, key, file, line, windowId);
+    }
+
+    // consume locally reserved tokens without touching the sketch
+    if (tokens.m_tokenCount > 0) {
+        --tokens.m_tokenCount;
+        return true;
+    }
+
+    if (sIsReporting) {
+        return true;
+    }
+    if (!tokens.m_exhausted) {
+        tokens.m_tokenCount = reserveTokens(key, windowId);
+        if (tokens.m_tokenCount > 0) {
+            --tokens.m_tokenCount;
+            return true;
+        }
+        // register the offender right away, so that it is reported even if this thread does not
+        // log from this call site again
+        tokens.m_exhausted = true;
+        addSuppressed(key, file, line, 1);
+        return false;
+    }
+
+    // once a call site is suppressed, suppressed messages are accounted for in batches, so that
+    // suppressed call sites do not contend on the offender table
+    if (++tokens.m_suppressCount >= ELOG_CALL_SITE_SUPPRESS_BATCH) {
+        addSuppressed(key, file, line, tokens.m_suppressCount);
+        tokens.m_suppressCount = 0;
+    }
+    return false;
+}
+
+void ELogCallSiteLimiter::onTimer() { m_currWindowId.fetch_add(1, std::memory_order_relaxed); }
+
+uint64_t ELogCallSiteLimiter::reserveTokens(uint64_t key, uint64_t windowId) {
+    uint64_t windowTag = getWindowTag(windowId);
+    ELogSketchCounter* counters[ELOG_CALL_SITE_SKETCH_ROWS];
+    uint64_t minCount = UINT64_MAX;
+    for (uint32_t i = 0; i < ELOG_CALL_SITE_SKETCH_ROWS; ++i) {
+        uint64_t column = mixHash(key ^ sRowSeeds[i]) & (ELOG_CALL_SITE_SKETCH_COLUMNS - 1);
+        counters[i] = &m_sketch[i][column];
+        uint64_t count = getTaggedCount(counters[i]->load(std::memory_order_relaxed), windowTag);
+        if (count < minCount) {
+            minCount = count;
+        }
+    }
+
+    uint64_t maxMsg = m_maxMsg.load(std::memory_order_relaxed);
+    if (minCount >= maxMsg) {
+        return 0;
+    }
+
+    // reserve a portion of the remaining messages, so that tokens held by other threads cannot
+    // cause the limit to be applied much earlier than due
+    uint64_t tokenCount = (maxMsg - minCount) / ELOG_CALL_SITE_CHUNK_DIVISOR;
+    if (tokenCount == 0) {
+        tokenCount = 1;
+    }
+    for (uint32_t i = 0; i < ELOG_CALL_SITE_SKETCH_ROWS; ++i) {
+        addTaggedCount(*counters[i], windowTag, tokenCount);
+    }
+    return tokenCount;
+}
+
+void ELogCallSiteLimiter::resetTokens(ELogCallSiteTokens& tokens, uint64_t key, const char* file,
+                                      int line, uint64_t windowId) {
+    // account for messages suppressed by the evicted call site, or during the previous window
+    if (tokens.m_limiter == this && tokens.m_suppressCount > 0) {
+        addSuppressed(tokens.m_key, tokens.m_file, tokens.m_line, tokens.m_suppressCount);
+    }
+
+    // first thread to notice time window change reports summary of previous windows
+    if (windowId != m_nextReportWindowId.load(std::memory_order_relaxed) && tryLockReport()) {
+        // NOTE: check again, since the window might have been reported in the meantime, and the
+        // window might have been switched again since it was read (so read it again)
+        uint64_t currWindowId = m_currWindowId.load(std::memory_order_relaxed);
+        if (currWindowId != m_nextReportWindowId.load(std::memory_order_relaxed) &&
+            m_enabled.load(std::memory_order_relaxed)) {
+            reportSuppressed(currWindowId);
+        }
+        unlockReport();
+    }
+
+    tokens.m_limiter = this;
+    tokens.m_key = key;
+    tokens.m_windowId = windowId;
+    tokens.m_tokenCount = 0;
+    tokens.m_suppressCount = 0;
+    tokens.m_file = file;
+    tokens.m_line = line;
+    tokens.m_exhausted = false;
+}
+
+void ELogCallSiteLimiter::addSuppressed(uint64_t key, const char* file, int line,
+                                        uint64_t count) {
+    uint64_t windowId = m_currWindowId.load(std::memory_order_relaxed);
+    uint64_t windowTag = getWindowTag(windowId);
+    ELogOffender* offenders = m_offenders[windowId & 1];
+
+    // open addressing with linear probing, slots tagged with an earlier window are vacant
+    uint64_t siteKey = key & ELOG_COUNT_MASK;
+    if (siteKey == 0) {
+        siteKey = 1;
+    }
+    uint64_t offenderKey = windowTag | siteKey;
+    uint64_t startSlot = siteKey % ELOG_CALL_SITE_MAX_OFFENDERS;
+    for (uint32_t i = 0; i < ELOG_CALL_SITE_MAX_OFFENDERS; ++i) {
+        ELogOffender& offender = offenders[(startSlot + i) % ELOG_CALL_SITE_MAX_OFFENDERS];
+        uint64_t slotKey = offender.m_key.load(std::memory_order_acquire);
+        if ((slotKey & ELOG_TAG_MASK) != windowTag) {
+            if (offender.m_key.compare_exchange_strong(slotKey, offenderKey,
+                                                       std::memory_order_acq_rel)) {
+                offender.m_line.store(line, std::memory_order_relaxed);
+                offender.m_file.store(file, std::memory_order_release);
+                slotKey = offenderKey;
+            }
+        }
+        if (slotKey == offenderKey) {
+            addTaggedCount(offender.m_suppressCount, windowTag, count);
+            return;
+        }
+    }
+
+    // offender table is full for this time window
+    addTaggedCount(m_otherSuppressCount[windowId & 1], windowTag, count);
+}
+
+void ELogCallSiteLimiter::reportSuppressed(uint64_t endWindowId) {
+    // NOTE: this is called with the report lock held, and only the offender tables of the last
+    // two windows are still available (earlier windows ended with no log message issued, and
+    // their tables may have been reused)
+    sIsReporting = true;
+    uint64_t nowMillis = elogGetSteadyMillisCoarse();
+    uint64_t elapsedMillis = nowMillis - m_reportTimeMillis;
+    uint64_t windowId = m_nextReportWindowId.load(std::memory_order_relaxed);
+    if (endWindowId - windowId > 2) {
+        windowId = endWindowId - 2;
+    }
+    for (; windowId < endWindowId; ++windowId) {
+        uint64_t windowTag = getWindowTag(windowId);
+        ELogOffender* offenders = m_offenders[windowId & 1];
+        for (uint32_t i = 0; i < ELOG_CALL_SITE_MAX_OFFENDERS; ++i) {
+            ELogOffender& offender = offenders[i];
+            if ((offender.m_key.load(std::memory_order_acquire) & ELOG_TAG_MASK) != windowTag) {
+                continue;
+            }
+            uint64_t suppressCount = getTaggedCount(
+                offender.m_suppressCount.load(std::memory_order_relaxed), windowTag);
+            const char* file = offender.m_file.load(std::memory_order_acquire);
+            if (suppressCount > 0 && file != nullptr) {
+                ELOG_REPORT_INFO("Suppressed %" PRIu64
+                                 " messages from call site %s:%d in the last %" PRIu64
+                                 " milliseconds",
+                                 suppressCount, file,
+                                 offender.m_line.load(std::memory_order_relaxed), elapsedMillis);
+            }
+        }
+        uint64_t otherSuppressCount = getTaggedCount(
+            m_otherSuppressCount[windowId & 1].load(std::memory_order_relaxed), windowTag);
+        if (otherSuppressCount > 0) {
+            ELOG_REPORT_INFO("Suppressed %" PRIu64
+                             " messages from other call sites in the last %" PRIu64
+                             " milliseconds",
+                             otherSuppressCount, elapsedMillis);
+        }
+    }
+    m_reportTimeMillis = nowMillis;
+    m_nextReportWindowId.store(endWindowId, std::memory_order_relaxed);
+    sIsReporting = false;
+}
+
+bool ELogCallSiteLimiter::tryLockReport() {
+    bool reporting = false;
+    return m_reporting.compare_exchange_strong(reporting, true, std::memory_order_acquire);
+}
+
+void ELogCallSiteLimiter::lockReport() {
+    while (!tryLockReport()) {
+        std::this_thread::yield();
+    }
+}
+
+void ELogCallSiteLimiter::unlockReport() { m_reporting.store(false, std::memory_order_release); }
+
+}  // namespace elog
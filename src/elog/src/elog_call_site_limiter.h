@@ -0,0 +1,167 @@
+#ifndef __ELOG_CALL_SITE_LIMITER_H__
+#define __ELOG_CALL_SITE_LIMITER_H__
+
+#include <atomic>
+#include <cstdint>
+
+#include "elog_common_def.h"
+#include "elog_def.h"
+#include "elog_timer_service.h"
+
+// NOTE: the call site limiter detects log call sites that issue messages at a high rate (heavy
+// hitters), regardless of whether the developer anticipated that (as opposed to ELOG_MODERATE_XXX
+// macros), and suppresses their messages before any formatting takes place.
+// call site message counts are estimated with a count-min sketch: each call site is hashed into
+// one counter in each of several rows, and the minimum counter value is taken as the estimation.
+// counters may be shared by several call sites, so the estimation may exceed the real count, but
+// it is never lower than the real count. counters are tagged with the id of the time window in
+// which they were last incremented, so that they do not need to be explicitly reset when a time
+// window ends.
+// in order to avoid contention on the shared sketch, each thread reserves chunks of messages
+// (tokens) for a call site from the sketch, and consumes them locally (similar to the sharded
+// mode of ELogRateLimiter). the chunk size shrinks as the call site approaches its limit, so the
+// limit may be applied slightly early (due to tokens reserved by other threads), but never late.
+// time windows are advanced by the timer service, so the logging hot path does not read the
+// clock at all.
+// call sites that are suppressed are registered in a small offender table, which is used for
+// reporting a summary of suppressed messages when a time window ends (similar to ELogModerate).
+// offender table entries are tagged with the time window id as well, so each window starts with
+// an empty table. two tables are used alternately, so that the table of the previous window can
+// be reported while the current window is being recorded.
+
+/** @def The number of count-min sketch rows. */
+#define ELOG_CALL_SITE_SKETCH_ROWS 4
+
+/** @def The number of counters in each count-min sketch row (must be a power of 2). */
+#define ELOG_CALL_SITE_SKETCH_COLUMNS 1024
+
+/** @def The maximum number of call sites tracked per time window for summary reporting. */
+#define ELOG_CALL_SITE_MAX_OFFENDERS 256
+
+/** @def The number of call sites each thread caches its reserved tokens for (power of 2). */
+#define ELOG_CALL_SITE_THREAD_CACHE_SIZE 16
+
+/**
+ * @def A thread reserves at most this fraction (1/N) of the remaining messages of a call site at
+ * once.
+ */
+#define ELOG_CALL_SITE_CHUNK_DIVISOR 16
+
+/**
+ * @def The number of messages a thread suppresses locally before adding them to the offender
+ * table.
+ */
+#define ELOG_CALL_SITE_SUPPRESS_BATCH 16
+
+namespace elog {
+
+class ELogCallSiteLimiter final : public ELogTimerTask {
+public:
+    ELogCallSiteLimiter();
+    ELogCallSiteLimiter(const ELogCallSiteLimiter&) = delete;
+    ELogCallSiteLimiter(ELogCallSiteLimiter&&) = delete;
+    ELogCallSiteLimiter& operator=(const ELogCallSiteLimiter&) = delete;
+    ~ELogCallSiteLimiter() final {}
+
+    /**
+     * @brief Enables the call site limiter. If the call site limiter is already enabled, any
+     * pending suppression summary is reported, and a new time window is started.
+     * @param maxMsg The maximum number of messages a single call site may issue in a time window.
+     * @param timeout The time window size.
+     * @param timeoutUnits The time window size units.
+     * @return True if the operation succeeded, otherwise false (invalid time window).
+     */
+    bool enable(uint64_t maxMsg, uint64_t timeout, ELogTimeUnits timeoutUnits);
+
+    /** @brief Disables the call site limiter, and reports any pending suppression summary. */
+    void disable();
+
+    /** @brief Queries whether the call site limiter is enabled. */
+    inline bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Checks whether a message issued from a call site may be logged, and counts it.
+     * @param file The issuing file.
+     * @param line The issuing line.
+     * @return True if the message may be logged, or false if it should be suppressed.
+     */
+    bool admit(const char* file, int line);
+
+    /** @brief Starts a new time window (called by the timer service). */
+    void onTimer() final;
+
+private:
+    /** @brief Sketch counter, holding time window id in high 32 bits, and count in low 32 bits. */
+    typedef std::atomic<uint64_t> ELogSketchCounter;
+
+    /**
+     * @brief A call site that had messages suppressed. The key holds the time window id in the
+     * high 32 bits and the call site key in the low 32 bits, and the suppression count holds the
+     * time window id in the high 32 bits and the count in the low 32 bits.
+     */
+    struct ELogOffender {
+        std::atomic<uint64_t> m_key;
+        std::atomic<const char*> m_file;
+        std::atomic<int> m_line;
+        std::atomic<uint64_t> m_suppressCount;
+    };
+
+    /** @brief Per-thread reserved tokens of a single call site. */
+    struct ELogCallSiteTokens {
+        const ELogCallSiteLimiter* m_limiter;
+        uint64_t m_key;
+        uint64_t m_windowId;
+        uint64_t m_tokenCount;
+        uint64_t m_suppressCount;
+        const char* m_file;
+        int m_line;
+        bool m_exhausted;
+    };
+
+    std::atomic<bool> m_enabled;
+    std::atomic<uint64_t> m_maxMsg;
+    std::atomic<uint64_t> m_currWindowId;
+    std::atomic<uint64_t> m_nextReportWindowId;
+    std::atomic<bool> m_reporting;
+    uint64_t m_reportTimeMillis;
+    ELogSketchCounter m_sketch[ELOG_CALL_SITE_SKETCH_ROWS][ELOG_CALL_SITE_SKETCH_COLUMNS];
+    ELogOffender m_offenders[2][ELOG_CALL_SITE_MAX_OFFENDERS];
+    ELogSketchCounter m_otherSuppressCount[2];
+
+    static thread_local ELogCallSiteTokens sTokenCache[ELOG_CALL_SITE_THREAD_CACHE_SIZE];
+
+    /** @brief Reserves tokens for a call site from the sketch (returns zero if none left). */
+    uint64_t reserveTokens(uint64_t key, uint64_t windowId);
+
+    /** @brief Starts caching tokens for another call site, or for a new time window. */
+    void resetTokens(ELogCallSiteTokens& tokens, uint64_t key, const char* file, int line,
+                     uint64_t windowId);
+
+    /** @brief Accounts for suppressed messages of a call site in the current time window. */
+    void addSuppressed(uint64_t key, const char* file, int line, uint64_t count);
+
+    /** @brief Reports suppression summary of all time windows that ended since last report. */
+    void reportSuppressed(uint64_t endWindowId);
+
+    // NOTE: reporting is serialized with a flag rather than a mutex, since reporting may issue log
+    // messages that pass through the call site limiter again (so the lock is only tried then)
+    bool tryLockReport();
+    void lockReport();
+    void unlockReport();
+};
+
+/** @brief The global call site limiter. */
+extern ELogCallSiteLimiter& getCallSiteLimiter();
+
+/**
+ * @brief Checks whether a message issued from a call site should be suppressed by the global call
+ * site limiter. This is called before any message formatting takes place.
+ */
+inline bool isCallSiteSuppressed(const char* file, int line) {
+    ELogCallSiteLimiter& limiter = getCallSiteLimiter();
+    return limiter.isEnabled() && !limiter.admit(file, line);
+}
+
+}  // namespace elog
+
+#endif  // __ELOG_CALL_SITE_LIMITER_H__
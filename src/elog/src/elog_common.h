@@ -30,6 +30,7 @@
 #define ELOG_FLUSH_POLICY_CONFIG_NAME "log_flush_policy"
 #define ELOG_TARGET_CONFIG_NAME "log_target"
 #define ELOG_RATE_LIMIT_CONFIG_NAME "log_rate_limit"
+#define ELOG_CALL_SITE_RATE_LIMIT_CONFIG_NAME "log_call_site_rate_limit"
 #define ELOG_AFFINITY_CONFIG_NAME "log_affinity"
 // #define ELOG_LEVEL_FORMAT_CONFIG_NAME "log_level_format"
 #ifdef ELOG_ENABLE_LIFE_SIGN
@@ -46,6 +47,7 @@
 #endif
 #define ELOG_CONFIG_ENABLE_TIME_SOURCE_NAME "enable_time_source"
 #define ELOG_CONFIG_TIME_SOURCE_RESOLUTION_NAME "time_source_resolution"
+#define ELOG_CONFIG_TIME_CAPTURE_MODE_NAME "time_capture_mode"
 #define ELOG_CONFIG_ENABLE_LOG_STATISTICS_NAME "enable_log_statistics"
 
 // simple colors for internal use
@@ -873,6 +873,11 @@ bool ELogConfigLoader::configureLogTargetCommon(ELogTarget* logTarget,
     if (!applyTargetFilter(logTarget, logTargetCfg)) {
         return false;
     }
+
+    // apply flat-combining mode if any
+    if (!applyTargetFlatCombining(logTarget, logTargetCfg)) {
+        return false;
+    }
     return true;
 }
 
@@ -955,6 +960,22 @@ bool ELogConfigLoader::applyTargetFlushPolicy(ELogTarget* logTarget,
     return true;
 }
 
+bool ELogConfigLoader::applyTargetFlatCombining(ELogTarget* logTarget,
+                                                const ELogConfigMapNode* logTargetCfg) {
+    bool flatCombining = false;
+    bool found = false;
+    if (!logTargetCfg->getBoolValue("flat_combining", found, flatCombining)) {
+        ELOG_REPORT_ERROR("Failed to set flat-combining mode for log target (context: %s)",
+                          logTargetCfg->getFullContext());
+        return false;
+    }
+
+    if (found) {
+        logTarget->setFlatCombining(flatCombining);
+    }
+    return true;
+}
+
 bool ELogConfigLoader::applyTargetFilter(ELogTarget* logTarget,
                                          const ELogConfigMapNode* logTargetCfg) {
     bool result = false;
@@ -137,6 +137,8 @@ private:
     static bool applyTargetFlushPolicy(ELogTarget* logTarget,
                                        const ELogConfigMapNode* logTargetCfg);
     static bool applyTargetFilter(ELogTarget* logTarget, const ELogConfigMapNode* logTargetCfg);
+    static bool applyTargetFlatCombining(ELogTarget* logTarget,
+                                         const ELogConfigMapNode* logTargetCfg);
 };
 
 inline bool validateConfigValueStringType(const ELogConfigValue* value, const char* key) {
@@ -39,6 +39,7 @@
 #endif
 
 #include <cassert>
+#include <chrono>
 #include <climits>
 #include <cstring>
 #include <format>
@@ -52,6 +53,8 @@
 #include "elog_concurrent_hash_table.h"
 #include "elog_field_selector_internal.h"
 #include "elog_filter.h"
+#include "elog_name_cache.h"
+#include "elog_render_cache.h"
 #include "elog_report.h"
 #include "elog_tls.h"
 
@@ -120,6 +123,9 @@ static void cleanupThreadName(void* key) {
     uint32_t entryId = sThreadNameMap.removeItem(threadId);
     ELOG_REPORT_TRACE("Removed thread name at entry %u", entryId);
 
+    // thread id may be reused by another thread, so cached names are no longer valid
+    invalidateThreadNameCache();
+
     // cleanup inverse map as well
     std::unique_lock<std::mutex> lock(sLock);
     ELogThreadDataMap::iterator itr = sThreadDataMap.find(threadName);
@@ -141,6 +147,9 @@ ELOG_IMPLEMENT_FIELD_SELECTOR(ELogStaticTextSelector)
 ELOG_IMPLEMENT_FIELD_SELECTOR(ELogRecordIdSelector)
 ELOG_IMPLEMENT_FIELD_SELECTOR(ELogTimeSelector)
 ELOG_IMPLEMENT_FIELD_SELECTOR(ELogTimeEpochSelector)
+ELOG_IMPLEMENT_FIELD_SELECTOR(ELogRelativeTimeSelector)
+ELOG_IMPLEMENT_FIELD_SELECTOR(ELogSourceRelativeTimeSelector)
+ELOG_IMPLEMENT_FIELD_SELECTOR(ELogThreadDeltaSelector)
 ELOG_IMPLEMENT_FIELD_SELECTOR(ELogHostNameSelector)
 ELOG_IMPLEMENT_FIELD_SELECTOR(ELogUserNameSelector)
 ELOG_IMPLEMENT_FIELD_SELECTOR(ELogOsNameSelector)
@@ -378,7 +387,11 @@ static bool getLinuxDistribution(std::string& dist) {
         dist += buf;
     }
     pclose(fp);
-    return true;
+
+    // command output ends with a new line, which should not be part of the OS name
+    size_t endPos = dist.find_last_not_of(" \t\r\n");
+    dist.erase(endPos == std::string::npos ? 0 : endPos + 1);
+    return !dist.empty();
 }
 #endif
 
@@ -547,6 +560,10 @@ extern bool initFieldSelectors() {
 #else
     pid = getpid();
 #endif  // ELOG_WINDOWS
+
+    // thread/source ids may be reused after re-initialization, so drop names cached so far
+    invalidateThreadNameCache();
+    invalidateLogSourceNameCache();
     return true;
 }
 
@@ -623,6 +640,7 @@ bool setCurrentThreadNameField(const char* threadName) {
 
     // save thread id/name (allocated on heap) in a global map
     uint32_t entryId = sThreadNameMap.setItem((uint64_t)threadId, threadNameDup);
+    invalidateThreadNameCache();
 
     // infrom life-sign of current thread name
 #ifdef ELOG_ENABLE_LIFE_SIGN
@@ -712,16 +730,8 @@ void ELogRecordIdSelector::selectField(const ELogRecord& record, ELogFieldRecept
 void ELogTimeSelector::selectField(const ELogRecord& record, ELogFieldReceptor* receptor) {
     ELogTimeBuffer timeBuffer;
     size_t len = 0;
-    if (m_fieldSpec.m_timeSpec != nullptr) {
-        len = elogTimeToString(record.m_logTime, timeBuffer, m_fieldSpec.m_timeSpec->m_useLocalTime,
-                               m_fieldSpec.m_timeSpec->m_timeUnits,
-                               m_fieldSpec.m_timeSpec->m_useTimeZone,
-                               m_fieldSpec.m_timeSpec->m_timeFormat.c_str());
-    } else {
-        len = elogTimeToString(record.m_logTime, timeBuffer);
-    }
-    receptor->receiveTimeField(getTypeId(), record.m_logTime, timeBuffer.m_buffer, m_fieldSpec,
-                               len);
+    const char* timeStr = renderLogRecordTime(record, m_fieldSpec.m_timeSpec, timeBuffer, len);
+    receptor->receiveTimeField(getTypeId(), record.m_logTime, timeStr, m_fieldSpec, len);
 }
 
 void ELogTimeEpochSelector::selectField(const ELogRecord& record, ELogFieldReceptor* receptor) {
@@ -733,6 +743,72 @@ void ELogTimeEpochSelector::selectField(const ELogRecord& record, ELogFieldRecep
     }
 }
 
+// NOTE: taken with std::chrono, since ELog time conversion depends on another static variable
+static const uint64_t sProcessStartNanos =
+    (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+        .count();
+
+std::atomic<bool> ELogThreadDeltaSelector::sCaptureEnabled(false);
+
+// NOTE: time of the previous record issued by the current logging thread
+static thread_local uint64_t sLastRecordNanos = 0;
+
+inline uint64_t getNanosSince(const ELogTime& logTime, uint64_t baseNanos) {
+    // record time may be slightly behind if it was taken from the lazy time source
+    uint64_t nanos = elogTimeToUnixTimeNanos(logTime);
+    return nanos > baseNanos ? nanos - baseNanos : 0;
+}
+
+uint64_t ELogRelativeTimeSelector::getRelativeTimeNanos(const ELogRecord& record) {
+    return getNanosSince(record.m_logTime, sProcessStartNanos);
+}
+
+void ELogRelativeTimeSelector::selectField(const ELogRecord& record,
+                                           ELogFieldReceptor* receptor) {
+    uint64_t relativeTimeNanos = getRelativeTimeNanos(record);
+    if (receptor->getFieldReceiveStyle() == ELogFieldReceptor::ReceiveStyle::RS_BY_NAME) {
+        receptor->receiveRelativeTime(getTypeId(), relativeTimeNanos, m_fieldSpec);
+    } else {
+        receptor->receiveIntField(getTypeId(), relativeTimeNanos, m_fieldSpec);
+    }
+}
+
+uint64_t ELogSourceRelativeTimeSelector::getSourceRelativeTimeNanos(const ELogRecord& record) {
+    if (record.m_logger == nullptr) {
+        return 0;
+    }
+    const ELogTime& creationTime = record.m_logger->getLogSource()->getCreationTime();
+    return getNanosSince(record.m_logTime, elogTimeToUnixTimeNanos(creationTime));
+}
+
+void ELogSourceRelativeTimeSelector::selectField(const ELogRecord& record,
+                                                 ELogFieldReceptor* receptor) {
+    uint64_t relativeTimeNanos = getSourceRelativeTimeNanos(record);
+    if (receptor->getFieldReceiveStyle() == ELogFieldReceptor::ReceiveStyle::RS_BY_NAME) {
+        receptor->receiveSourceRelativeTime(getTypeId(), relativeTimeNanos, m_fieldSpec);
+    } else {
+        receptor->receiveIntField(getTypeId(), relativeTimeNanos, m_fieldSpec);
+    }
+}
+
+void ELogThreadDeltaSelector::captureThreadDelta(ELogRecord& record) {
+    // record time may be slightly behind the previous one if it was taken from the lazy time source
+    uint64_t nanos = elogTimeToUnixTimeNanos(record.m_logTime);
+    record.m_threadDeltaNanos =
+        (sLastRecordNanos != 0 && nanos > sLastRecordNanos) ? nanos - sLastRecordNanos : 0;
+    sLastRecordNanos = nanos;
+}
+
+void ELogThreadDeltaSelector::selectField(const ELogRecord& record, ELogFieldReceptor* receptor) {
+    uint64_t deltaNanos = getThreadDeltaNanos(record);
+    if (receptor->getFieldReceiveStyle() == ELogFieldReceptor::ReceiveStyle::RS_BY_NAME) {
+        receptor->receiveThreadDelta(getTypeId(), deltaNanos, m_fieldSpec);
+    } else {
+        receptor->receiveIntField(getTypeId(), deltaNanos, m_fieldSpec);
+    }
+}
+
 void ELogHostNameSelector::selectField(const ELogRecord& record, ELogFieldReceptor* receptor) {
     if (receptor->getFieldReceiveStyle() == ELogFieldReceptor::ReceiveStyle::RS_BY_NAME) {
         receptor->receiveHostName(getTypeId(), sHostName, m_fieldSpec);
@@ -797,18 +873,32 @@ void ELogThreadIdSelector::selectField(const ELogRecord& record, ELogFieldRecept
     }
 }
 
+// NOTE: name selectors use the plain (unjustified) cached name, since receptors may ignore
+// justification, or apply it only around text formatting
+static const ELogJustifySpec sNoJustifySpec = {ELogJustifyMode::JM_NONE, 0};
+
 void ELogThreadNameSelector::selectField(const ELogRecord& record, ELogFieldReceptor* receptor) {
-    const char* threadName = getThreadNameField(record.m_threadId);
+    size_t threadNameLength = 0;
+    const char* threadName =
+        getCachedThreadName(record.m_threadId, sNoJustifySpec, threadNameLength);
+    if (threadName == nullptr) {
+        threadName = getThreadNameField(record.m_threadId);
+        threadNameLength = 0;
+    }
     if (receptor->getFieldReceiveStyle() == ELogFieldReceptor::ReceiveStyle::RS_BY_NAME) {
         receptor->receiveThreadName(getTypeId(), threadName, m_fieldSpec);
     } else {
-        receptor->receiveStringField(getTypeId(), threadName, m_fieldSpec);
+        receptor->receiveStringField(getTypeId(), threadName, m_fieldSpec, threadNameLength);
     }
 }
 
 void ELogSourceSelector::selectField(const ELogRecord& record, ELogFieldReceptor* receptor) {
     size_t logSourceNameLength = 0;
-    const char* logSourceName = getLogSourceName(record, logSourceNameLength);
+    const char* logSourceName =
+        getCachedLogSourceName(record, sNoJustifySpec, logSourceNameLength);
+    if (logSourceName == nullptr) {
+        logSourceName = getLogSourceName(record, logSourceNameLength);
+    }
     if (receptor->getFieldReceiveStyle() == ELogFieldReceptor::ReceiveStyle::RS_BY_NAME) {
         receptor->receiveLogSourceName(getTypeId(), logSourceName, m_fieldSpec);
     } else {
@@ -818,7 +908,10 @@ void ELogSourceSelector::selectField(const ELogRecord& record, ELogFieldReceptor
 
 void ELogModuleSelector::selectField(const ELogRecord& record, ELogFieldReceptor* receptor) {
     size_t moduleNameLength = 0;
-    const char* moduleName = getLogModuleName(record, moduleNameLength);
+    const char* moduleName = getCachedLogModuleName(record, sNoJustifySpec, moduleNameLength);
+    if (moduleName == nullptr) {
+        moduleName = getLogModuleName(record, moduleNameLength);
+    }
     if (receptor->getFieldReceiveStyle() == ELogFieldReceptor::ReceiveStyle::RS_BY_NAME) {
         receptor->receiveModuleName(getTypeId(), moduleName, m_fieldSpec);
     } else {
@@ -858,14 +951,27 @@ void ELogMsgSelector::selectField(const ELogRecord& record, ELogFieldReceptor* r
     // if log record is in binary form, it must be resolved
     if (record.m_flags & ELOG_RECORD_BINARY) {
 #ifdef ELOG_ENABLE_FMT_LIB
-        ELogBuffer logBuffer;
-        if (ELogLogger::resolveLogRecord(record, logBuffer)) {
+        auto receiveLogMsg = [this](ELogFieldReceptor* receptor, const char* logMsg, size_t len) {
             if (receptor->getFieldReceiveStyle() == ELogFieldReceptor::ReceiveStyle::RS_BY_NAME) {
-                receptor->receiveLogMsg(getTypeId(), logBuffer.getRef(), m_fieldSpec);
+                receptor->receiveLogMsg(getTypeId(), logMsg, m_fieldSpec);
             } else {
-                receptor->receiveStringField(getTypeId(), logBuffer.getRef(), m_fieldSpec,
-                                             logBuffer.getOffset());
+                receptor->receiveStringField(getTypeId(), logMsg, m_fieldSpec, len);
+            }
+        };
+
+        // when dispatched to several targets, the message is resolved only once
+        ELogRenderCache* renderCache = getRenderCache(record);
+        if (renderCache != nullptr) {
+            size_t len = 0;
+            const char* logMsg = renderCache->getResolvedMsg(len);
+            if (logMsg != nullptr) {
+                receiveLogMsg(receptor, logMsg, len);
             }
+            return;
+        }
+        ELogBuffer logBuffer;
+        if (ELogLogger::resolveLogRecord(record, logBuffer)) {
+            receiveLogMsg(receptor, logBuffer.getRef(), logBuffer.getOffset());
         }
 #endif
     } else {
@@ -438,7 +438,7 @@ bool ELogCmpFilter::loadIntFilter(const ELogConfigMapNode* filterCfg, const char
                                   const char* filterName, uint64_t& propertyValue) {
     bool found = false;
     int64_t value = 0;
-    if (filterCfg->getIntValue(propertyName, found, value)) {
+    if (!filterCfg->getIntValue(propertyName, found, value)) {
         ELOG_REPORT_ERROR("Failed to get %s property for %s filter (context: %s)", propertyName,
                           filterName, filterCfg->getFullContext());
         return false;
@@ -1,5 +1,6 @@
 #include "elog_flush_policy.h"
 
+#include <algorithm>
 #include <unordered_map>
 
 #include "elog_common.h"
@@ -9,6 +10,7 @@
 #include "elog_internal.h"
 #include "elog_report.h"
 #include "elog_target.h"
+#include "elog_timer_service.h"
 
 namespace elog {
 
@@ -94,7 +96,13 @@ static bool applyFlushPolicyConstructorRegistration() {
 
 bool initFlushPolicies() { return applyFlushPolicyConstructorRegistration(); }
 
-void termFlushPolicies() { sFlushPolicyConstructorMap.clear(); }
+// stops the shared timed flush thread
+static void stopFlushExecutor();
+
+void termFlushPolicies() {
+    stopFlushExecutor();
+    sFlushPolicyConstructorMap.clear();
+}
 
 ELogFlushPolicy* constructFlushPolicy(const char* name) {
     ELogFlushPolicyConstructorMap::iterator itr = sFlushPolicyConstructorMap.find(name);
@@ -509,17 +517,122 @@ bool ELogSizeFlushPolicy::shouldFlush(uint64_t msgSizeBytes) {
     return (currSizeBytes / m_logSizeLimitBytes) > (prevSizeBytes / m_logSizeLimitBytes);
 }
 
+/**
+ * @brief Executes timed flush requests on a background thread shared by all timed flush policies,
+ * so that log target I/O never takes place on the timer service thread (which also drives the
+ * lazy time source and TSC clock calibration). The thread is launched on demand.
+ */
+class ELogFlushExecutor {
+public:
+    ELogFlushExecutor() : m_stop(false), m_runningPolicy(nullptr) {}
+    ELogFlushExecutor(const ELogFlushExecutor&) = delete;
+    ELogFlushExecutor(ELogFlushExecutor&&) = delete;
+    ELogFlushExecutor& operator=(const ELogFlushExecutor&) = delete;
+    ~ELogFlushExecutor() {}
+
+    /** @brief Launches the flush thread if it is not running yet. */
+    void start() {
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (!m_flushThread.joinable()) {
+            m_stop = false;
+            m_flushThread = std::thread(&ELogFlushExecutor::flushThread, this);
+        }
+    }
+
+    /** @brief Posts a flush request (called by the timer service thread, does not block). */
+    void post(ELogTimedFlushPolicy* flushPolicy) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (std::find(m_pendingPolicies.begin(), m_pendingPolicies.end(), flushPolicy) ==
+            m_pendingPolicies.end()) {
+            m_pendingPolicies.push_back(flushPolicy);
+            m_cv.notify_one();
+        }
+    }
+
+    /** @brief Discards pending flush requests of a policy, and waits for its running flush. */
+    void cancel(ELogTimedFlushPolicy* flushPolicy) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_pendingPolicies.erase(
+            std::remove(m_pendingPolicies.begin(), m_pendingPolicies.end(), flushPolicy),
+            m_pendingPolicies.end());
+        if (std::this_thread::get_id() != m_flushThread.get_id()) {
+            m_doneCV.wait(lock, [this, flushPolicy]() { return m_runningPolicy != flushPolicy; });
+        }
+    }
+
+    /** @brief Stops the flush thread. */
+    void stop() {
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_stop = true;
+            m_cv.notify_one();
+        }
+        if (m_flushThread.joinable()) {
+            m_flushThread.join();
+        }
+        m_pendingPolicies.clear();
+    }
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_cv;
+    std::condition_variable m_doneCV;
+    std::thread m_flushThread;
+    bool m_stop;
+    std::vector<ELogTimedFlushPolicy*> m_pendingPolicies;
+    ELogTimedFlushPolicy* m_runningPolicy;
+
+    void flushThread() {
+        setCurrentThreadNameField("flush-executor");
+        std::unique_lock<std::mutex> lock(m_lock);
+        for (;;) {
+            m_cv.wait(lock, [this]() { return m_stop || !m_pendingPolicies.empty(); });
+            if (m_stop) {
+                break;
+            }
+            m_runningPolicy = m_pendingPolicies.front();
+            m_pendingPolicies.erase(m_pendingPolicies.begin());
+            lock.unlock();
+            m_runningPolicy->execTimedFlush();
+            lock.lock();
+            m_runningPolicy = nullptr;
+            m_doneCV.notify_all();
+        }
+    }
+};
+
+static ELogFlushExecutor sFlushExecutor;
+
+void stopFlushExecutor() { sFlushExecutor.stop(); }
+
+/** @brief Timer task that posts timed flush requests to the flush executor. */
+class ELogFlushTimerTask : public ELogTimerTask {
+public:
+    ELogFlushTimerTask(ELogTimedFlushPolicy* flushPolicy) : m_flushPolicy(flushPolicy) {}
+    ELogFlushTimerTask(const ELogFlushTimerTask&) = delete;
+    ELogFlushTimerTask(ELogFlushTimerTask&&) = delete;
+    ELogFlushTimerTask& operator=(const ELogFlushTimerTask&) = delete;
+    ~ELogFlushTimerTask() final {}
+
+    void onTimer() final { sFlushExecutor.post(m_flushPolicy); }
+
+private:
+    ELogTimedFlushPolicy* m_flushPolicy;
+};
+
 ELogTimedFlushPolicy::ELogTimedFlushPolicy()
     : ELogFlushPolicy(ELogTimedFlushPolicy::TYPE_NAME, true),
       m_logTimeLimitMillis(0),
       m_prevFlushTime(getTimestamp()),
-      m_stopTimer(false) {}
+      m_flushTimer(nullptr) {}
 
 ELogTimedFlushPolicy::ELogTimedFlushPolicy(uint64_t logTimeLimitMillis, ELogTarget* logTarget)
     : ELogFlushPolicy(ELogTimedFlushPolicy::TYPE_NAME, true),
       m_logTimeLimitMillis(logTimeLimitMillis),
       m_prevFlushTime(getTimestamp()),
-      m_stopTimer(false) {}
+      m_flushTimer(nullptr) {
+    setLogTarget(logTarget);
+}
 
 bool ELogTimedFlushPolicy::load(const ELogConfigMapNode* flushPolicyCfg) {
     return loadTimeoutFlushPolicy(flushPolicyCfg, "time", "flush_timeout", m_logTimeLimitMillis,
@@ -532,20 +645,27 @@ bool ELogTimedFlushPolicy::loadExpr(const ELogExpression* expr) {
 }
 
 bool ELogTimedFlushPolicy::start() {
-    m_timerThread = std::thread(&ELogTimedFlushPolicy::onTimer, this);
+    if (m_flushTimer == nullptr) {
+        m_flushTimer = new (std::nothrow) ELogFlushTimerTask(this);
+        if (m_flushTimer == nullptr) {
+            ELOG_REPORT_ERROR("Failed to allocate flush timer task, out of memory");
+            return false;
+        }
+    }
+    sFlushExecutor.start();
+    getTimerService().schedule(m_flushTimer, m_logTimeLimitMillis, m_logTimeLimitMillis);
     return true;
 }
 
 bool ELogTimedFlushPolicy::stop() {
-    // raise stop flag and wakeup timer thread
-    {
-        std::unique_lock<std::mutex> lock(m_lock);
-        m_stopTimer = true;
-        m_cv.notify_one();
+    // cancel flush timer first so no more flush requests are posted, then discard pending flush
+    // request (waits for any running flush to end)
+    if (m_flushTimer != nullptr) {
+        getTimerService().cancel(m_flushTimer);
+        sFlushExecutor.cancel(this);
+        delete m_flushTimer;
+        m_flushTimer = nullptr;
     }
-
-    // wait for timer thread to finish
-    m_timerThread.join();
     return true;
 }
 
@@ -564,32 +684,14 @@ bool ELogTimedFlushPolicy::shouldFlush(uint64_t msgSizeBytes) {
     return false;
 }
 
-void ELogTimedFlushPolicy::onTimer() {
-    setCurrentThreadNameField("flush-timer-thread");
-    while (!shouldStop()) {
-        // wait for timeout or for stop flag to be raised
-        {
-            std::unique_lock<std::mutex> lock(m_lock);
-            m_cv.wait_for(lock, std::chrono::milliseconds(m_logTimeLimitMillis),
-                          [this] { return m_stopTimer; });
-            if (m_stopTimer) {
-                break;
-            }
-        }
-
-        // we participate with the rest of the concurrent loggers as a phantom logger, so that we
-        // avoid duplicate flushes (others call shouldFlush() with some payload size)
-        if (shouldFlush(0)) {
-            getLogTarget()->flush();
-        }
+void ELogTimedFlushPolicy::execTimedFlush() {
+    // we participate with the rest of the concurrent loggers as a phantom logger, so that we
+    // avoid duplicate flushes (others call shouldFlush() with some payload size)
+    if (shouldFlush(0)) {
+        getLogTarget()->flush();
     }
 }
 
-bool ELogTimedFlushPolicy::shouldStop() {
-    std::unique_lock<std::mutex> lock(m_lock);
-    return m_stopTimer;
-}
-
 bool ELogChainedFlushPolicy::load(const ELogConfigMapNode* flushPolicyCfg) {
     // we expect to find two nested properties 'control_flush_policy', and 'moderate_flush_policy'
     m_controlPolicy = loadSubFlushPolicy("control", "control_flush_policy", flushPolicyCfg);
@@ -709,6 +811,60 @@ void ELogChainedFlushPolicy::propagateLogTarget(ELogTarget* logTarget) {
     }
 }
 
+/**
+ * @brief Timer task that notifies a group flush leader that the group timeout expired. A single
+ * task serves all groups of a policy, and is re-armed by each group leader. A new group is opened
+ * only after the previous one is full (or closed), so re-arming for a new group never takes away a
+ * deadline that the previous group still needs.
+ */
+class ELogGroupFlushPolicy::DeadlineTimer : public ELogTimerTask {
+public:
+    DeadlineTimer() : m_group(nullptr) {}
+    DeadlineTimer(const DeadlineTimer&) = delete;
+    DeadlineTimer(DeadlineTimer&&) = delete;
+    DeadlineTimer& operator=(const DeadlineTimer&) = delete;
+    ~DeadlineTimer() final {}
+
+    /** @brief Arms the deadline of a group, replacing any previously armed group. */
+    void arm(Group* group, Micros timeoutMicros) {
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_group = group;
+            m_deadline = std::chrono::steady_clock::now() + timeoutMicros;
+        }
+        uint64_t timeoutMillis =
+            (uint64_t)std::chrono::ceil<std::chrono::milliseconds>(timeoutMicros).count();
+        getTimerService().schedule(this, timeoutMillis);
+    }
+
+    /**
+     * @brief Disarms the deadline of a group, if still armed. The timer is not cancelled, since it
+     * may have been re-armed by the leader of the next group in the meantime, and an expiry that
+     * finds no armed group is ignored. When this call returns, the group is no longer referenced.
+     */
+    void disarm(Group* group) {
+        std::unique_lock<std::mutex> lock(m_lock);
+        if (m_group == group) {
+            m_group = nullptr;
+        }
+    }
+
+    void onTimer() final {
+        std::unique_lock<std::mutex> lock(m_lock);
+        // an expiry scheduled for a previous group may arrive before the deadline of the currently
+        // armed group, and in this case it is ignored (the timer was rescheduled when re-armed)
+        if (m_group != nullptr && std::chrono::steady_clock::now() >= m_deadline) {
+            m_group->onDeadline();
+            m_group = nullptr;
+        }
+    }
+
+private:
+    std::mutex m_lock;
+    Group* m_group;
+    std::chrono::steady_clock::time_point m_deadline;
+};
+
 bool ELogGroupFlushPolicy::load(const ELogConfigMapNode* flushPolicyCfg) {
     uint64_t groupSize = 0;
     if (!loadIntFlushPolicy(flushPolicyCfg, "group", "size", groupSize)) {
@@ -752,10 +908,19 @@ bool ELogGroupFlushPolicy::loadExpr(const ELogExpression* expr) {
 }
 
 bool ELogGroupFlushPolicy::start() {
+    // a single deadline timer task is re-armed by each group leader
+    m_deadlineTimer = new (std::nothrow) DeadlineTimer();
+    if (m_deadlineTimer == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate group flush deadline timer task, out of memory");
+        return false;
+    }
+
     // initialize the private garbage collector
     // TODO: have this configurable in the flush policy (max threads, flush frequency)
     if (!m_gc.initialize("Group-flush-policy GC", elog::getMaxThreads(), ELOG_FLUSH_GC_FREQ)) {
         ELOG_REPORT_ERROR("Failed to initialize private garbage collector for group flush policy");
+        delete m_deadlineTimer;
+        m_deadlineTimer = nullptr;
         return false;
     }
     // NOTE: there is no background garbage collection here, so we dont need to call start/stop
@@ -775,6 +940,13 @@ bool ELogGroupFlushPolicy::stop() {
 #ifdef ELOG_ENABLE_GROUP_FLUSH_GC_TRACE
     resetGCLogger();
 #endif
+
+    // a disarmed timer may still be scheduled, so it is cancelled before being deleted
+    if (m_deadlineTimer != nullptr) {
+        getTimerService().cancel(m_deadlineTimer);
+        delete m_deadlineTimer;
+        m_deadlineTimer = nullptr;
+    }
     return true;
 }
 
@@ -844,7 +1016,14 @@ bool ELogGroupFlushPolicy::moderateFlush(ELogTarget* logTarget) {
             // either no group, or group is full/closed, so try to form a new group
             // since there might be several iterations, we create new group only once
             if (newGroup == nullptr) {
-                newGroup = new (std::nothrow) Group(logTarget, m_groupSize, m_groupTimeoutMicros);
+                // the timer service cannot express timeouts shorter than its tick, so these are
+                // still waited for with a timed condition variable wait
+                DeadlineTimer* deadlineTimer =
+                    (m_groupTimeoutMicros >= std::chrono::milliseconds(ELOG_TIMER_TICK_MILLIS))
+                        ? m_deadlineTimer
+                        : nullptr;
+                newGroup = new (std::nothrow)
+                    Group(logTarget, m_groupSize, m_groupTimeoutMicros, deadlineTimer);
                 if (newGroup == nullptr) {
                     ELOG_REPORT_ERROR("Failed to allocate new group, out of memory");
                     m_gc.endEpoch(epoch);
@@ -907,13 +1086,15 @@ bool ELogGroupFlushPolicy::moderateFlush(ELogTarget* logTarget) {
 }
 
 ELogGroupFlushPolicy::Group::Group(ELogTarget* logTarget, uint64_t groupSize,
-                                   Micros groupTimeoutMicros)
+                                   Micros groupTimeoutMicros, DeadlineTimer* deadlineTimer)
     : m_logTarget(logTarget),
       m_groupSize(groupSize),
       m_groupTimeoutMicros(groupTimeoutMicros),
       m_memberCount(1),
       m_state(State::WAIT),
-      m_leaderThreadId(getCurrentThreadId()) {}
+      m_leaderThreadId(getCurrentThreadId()),
+      m_deadlineTimer(deadlineTimer),
+      m_deadlineExpired(false) {}
 
 bool ELogGroupFlushPolicy::Group::join() {
     assert(getCurrentThreadId() != m_leaderThreadId);
@@ -928,10 +1109,33 @@ bool ELogGroupFlushPolicy::Group::join() {
     return true;
 }
 
+void ELogGroupFlushPolicy::Group::onDeadline() {
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_deadlineExpired = true;
+    m_cv.notify_all();
+}
+
+void ELogGroupFlushPolicy::Group::waitGroupDeadline() {
+    // the timer task only wakes up the leader, and the flush itself is executed by the leader
+    m_deadlineTimer->arm(this, m_groupTimeoutMicros);
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_cv.wait(lock, [this]() { return m_state == State::FULL || m_deadlineExpired; });
+    }
+    // NOTE: timer is disarmed outside the group lock, since the timer task takes the group lock
+    // while holding its own lock
+    m_deadlineTimer->disarm(this);
+}
+
 bool ELogGroupFlushPolicy::Group::execLeader() {
     assert(getCurrentThreadId() == m_leaderThreadId);
+    if (m_deadlineTimer != nullptr) {
+        waitGroupDeadline();
+    }
     std::unique_lock<std::mutex> lock(m_lock);
-    m_cv.wait_for(lock, m_groupTimeoutMicros, [this]() { return m_state == State::FULL; });
+    if (m_deadlineTimer == nullptr) {
+        m_cv.wait_for(lock, m_groupTimeoutMicros, [this]() { return m_state == State::FULL; });
+    }
     // declare group closed, even if not ll possible members joined
     m_state = State::CLOSED;
 
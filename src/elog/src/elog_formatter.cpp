@@ -1,12 +1,16 @@
 #include "elog_formatter.h"
 
+#include <charconv>
 #include <cstring>
 
 #include "elog_buffer_receptor.h"
 #include "elog_common.h"
 #include "elog_config_loader.h"
+#include "elog_field_selector_internal.h"
 #include "elog_filter.h"
 #include "elog_formatter_internal.h"
+#include "elog_name_cache.h"
+#include "elog_render_cache.h"
 #include "elog_report.h"
 #include "elog_string_receptor.h"
 #include "elog_string_stream_receptor.h"
@@ -113,7 +117,12 @@ ELogFormatter::~ELogFormatter() {
     }
     m_fieldSelectors.clear();
 }
+
 void ELogFormatter::formatLogMsg(const ELogRecord& logRecord, std::string& logMsg) {
+    if (canUseInstructions()) {
+        executeInstructions(logRecord, logMsg);
+        return;
+    }
     // unlike the string stream receptor, the string receptor formats directly the resulting log
     // message string, and so we save one or two string copies
     ELogStringReceptor receptor(logMsg);
@@ -121,6 +130,10 @@ void ELogFormatter::formatLogMsg(const ELogRecord& logRecord, std::string& logMs
 }
 
 void ELogFormatter::formatLogBuffer(const ELogRecord& logRecord, ELogBuffer& logBuffer) {
+    if (canUseInstructions()) {
+        executeInstructions(logRecord, logBuffer);
+        return;
+    }
     ELogBufferReceptor receptor(logBuffer);
     applyFieldSelectors(logRecord, &receptor);
 }
@@ -160,6 +173,7 @@ bool ELogFormatter::parseFormatSpec(const std::string& formatSpec) {
             return false;
         }
     }
+    compileFieldSelectors();
     return true;
 }
 
@@ -959,4 +973,304 @@ ELogFieldSelector* ELogFormatter::loadConstSelector(const std::string& fieldSpec
     return selector;
 }
 
+void ELogFormatter::compileFieldSelectors() {
+    m_instructions.clear();
+    for (ELogFieldSelector* fieldSelector : m_fieldSelectors) {
+        compileFieldSelector(fieldSelector);
+    }
+    m_compiledSelectorCount = m_fieldSelectors.size();
+}
+
+void ELogFormatter::compileFieldSelector(ELogFieldSelector* fieldSelector) {
+    // static text, environment variables, format escape sequences and process-constant fields are
+    // rendered once (including justification and text formatting), and merged with adjacent text
+    // NOTE: process-constant fields are not available before field selectors are initialized, in
+    // which case they are selected at run-time as usual. The application name may be modified at
+    // any time, so it is never pre-rendered.
+    bool isStatic = false;
+    if (dynamic_cast<ELogStaticTextSelector*>(fieldSelector) != nullptr ||
+        dynamic_cast<ELogEnvSelector*>(fieldSelector) != nullptr ||
+        dynamic_cast<ELogFormatSelector*>(fieldSelector) != nullptr) {
+        isStatic = true;
+    } else if (dynamic_cast<ELogHostNameSelector*>(fieldSelector) != nullptr) {
+        isStatic = (*getHostNameField() != 0);
+    } else if (dynamic_cast<ELogUserNameSelector*>(fieldSelector) != nullptr) {
+        isStatic = (*getUserNameField() != 0);
+    } else if (dynamic_cast<ELogOsNameSelector*>(fieldSelector) != nullptr) {
+        isStatic = (*getOsNameField() != 0);
+    } else if (dynamic_cast<ELogOsVersionSelector*>(fieldSelector) != nullptr) {
+        isStatic = (*getOsVersionField() != 0);
+    } else if (dynamic_cast<ELogProgramNameSelector*>(fieldSelector) != nullptr) {
+        isStatic = (*getProgramNameField() != 0);
+    } else if (dynamic_cast<ELogProcessIdSelector*>(fieldSelector) != nullptr) {
+        isStatic = (getProcessIdField() != 0);
+    }
+    if (isStatic) {
+        std::string text;
+        ELogStringReceptor receptor(text);
+        fieldSelector->selectField(ELogRecord(), &receptor);
+        addStaticText(text);
+        return;
+    }
+
+    OpCode opCode = OpCode::OP_SELECTOR;
+    if (dynamic_cast<ELogRecordIdSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_RECORD_ID;
+    } else if (dynamic_cast<ELogTimeSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_TIME;
+    } else if (dynamic_cast<ELogTimeEpochSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_TIME_EPOCH;
+    } else if (dynamic_cast<ELogRelativeTimeSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_REL_TIME;
+    } else if (dynamic_cast<ELogSourceRelativeTimeSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_SOURCE_REL_TIME;
+    } else if (dynamic_cast<ELogThreadDeltaSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_THREAD_DELTA;
+    } else if (dynamic_cast<ELogAppNameSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_APP_NAME;
+    } else if (dynamic_cast<ELogThreadIdSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_THREAD_ID;
+    } else if (dynamic_cast<ELogThreadNameSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_THREAD_NAME;
+    } else if (dynamic_cast<ELogSourceSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_SOURCE;
+    } else if (dynamic_cast<ELogModuleSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_MODULE;
+    } else if (dynamic_cast<ELogFileSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_FILE;
+    } else if (dynamic_cast<ELogLineSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_LINE;
+    } else if (dynamic_cast<ELogFunctionSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_FUNCTION;
+    } else if (dynamic_cast<ELogLevelSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_LEVEL;
+    } else if (dynamic_cast<ELogMsgSelector*>(fieldSelector) != nullptr) {
+        opCode = OpCode::OP_MSG;
+    }
+
+    const ELogFieldSpec& fieldSpec = fieldSelector->getFieldSpec();
+    bool isPlain = fieldSpec.m_justifySpec.m_mode == ELogJustifyMode::JM_NONE &&
+                   fieldSpec.m_textSpec == nullptr;
+    m_instructions.push_back({opCode, isPlain, std::string(), fieldSelector});
+}
+
+void ELogFormatter::addStaticText(const std::string& text) {
+    if (!m_instructions.empty() && m_instructions.back().m_opCode == OpCode::OP_STATIC_TEXT) {
+        m_instructions.back().m_text.append(text);
+    } else {
+        m_instructions.push_back({OpCode::OP_STATIC_TEXT, true, text, nullptr});
+    }
+}
+
+// same as ELogStringReceptor/ELogBufferReceptor::applySpec(), but without a virtual call
+template <typename T>
+static inline void appendField(T& output, bool isPlain, const ELogFieldSpec& fieldSpec,
+                               const char* field, size_t fieldLen) {
+    if (isPlain) {
+        output.append(field, fieldLen);
+        return;
+    }
+    if (fieldSpec.m_justifySpec.m_mode == ELogJustifyMode::JM_RIGHT &&
+        fieldLen < fieldSpec.m_justifySpec.m_justify) {
+        output.append((uint64_t)(fieldSpec.m_justifySpec.m_justify - fieldLen), ' ');
+    }
+    if (fieldSpec.m_textSpec != nullptr) {
+        output.append(fieldSpec.m_textSpec->m_resolvedSpec.c_str(),
+                      fieldSpec.m_textSpec->m_resolvedSpec.length());
+    }
+    output.append(field, fieldLen);
+    if (fieldSpec.m_textSpec != nullptr && fieldSpec.m_textSpec->m_autoReset) {
+        output.append(fieldSpec.m_textSpec->m_resetSpec.c_str(),
+                      fieldSpec.m_textSpec->m_resetSpec.length());
+    }
+    if (fieldSpec.m_justifySpec.m_mode == ELogJustifyMode::JM_LEFT &&
+        fieldLen < fieldSpec.m_justifySpec.m_justify) {
+        output.append((uint64_t)(fieldSpec.m_justifySpec.m_justify - fieldLen), ' ');
+    }
+}
+
+template <typename T>
+static inline void appendIntField(T& output, bool isPlain, const ELogFieldSpec& fieldSpec,
+                                  uint64_t field) {
+    const int FIELD_SIZE = 32;
+    char strField[FIELD_SIZE];
+    // NOTE: ELogBuffer::append() also copies the terminating null
+    std::to_chars_result res = std::to_chars(strField, strField + FIELD_SIZE - 1, field);
+    *res.ptr = 0;
+    appendField(output, isPlain, fieldSpec, strField, res.ptr - strField);
+}
+
+// appends a name from the calling thread's name cache, where it is already justified, unless text
+// formatting is specified (since padding goes outside of it), returns false if name is not cached
+template <typename T, typename F>
+static inline bool appendCachedName(T& output, bool isPlain, const ELogFieldSpec& fieldSpec,
+                                    F getCachedNameFunc) {
+    static const ELogJustifySpec noJustifySpec = {ELogJustifyMode::JM_NONE, 0};
+    size_t length = 0;
+    if (fieldSpec.m_textSpec == nullptr) {
+        const char* name = getCachedNameFunc(fieldSpec.m_justifySpec, length);
+        if (name != nullptr) {
+            output.append(name, length);
+            return true;
+        }
+    } else {
+        const char* name = getCachedNameFunc(noJustifySpec, length);
+        if (name != nullptr) {
+            appendField(output, isPlain, fieldSpec, name, length);
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline void selectFieldInto(ELogFieldSelector* fieldSelector,
+                                   const ELogRecord& logRecord, std::string& logMsg) {
+    ELogStringReceptor receptor(logMsg);
+    fieldSelector->selectField(logRecord, &receptor);
+}
+
+static inline void selectFieldInto(ELogFieldSelector* fieldSelector,
+                                   const ELogRecord& logRecord, ELogBuffer& logBuffer) {
+    ELogBufferReceptor receptor(logBuffer);
+    fieldSelector->selectField(logRecord, &receptor);
+}
+
+template <typename T>
+void ELogFormatter::executeInstructions(const ELogRecord& logRecord, T& output) {
+    for (const Instruction& instruction : m_instructions) {
+        if (instruction.m_opCode == OpCode::OP_STATIC_TEXT) {
+            output.append(instruction.m_text.c_str(), instruction.m_text.length());
+            continue;
+        }
+        const ELogFieldSpec& fieldSpec = instruction.m_selector->getFieldSpec();
+        bool isPlain = instruction.m_isPlain;
+        switch (instruction.m_opCode) {
+            case OpCode::OP_RECORD_ID:
+                appendIntField(output, isPlain, fieldSpec, logRecord.m_logRecordId);
+                break;
+
+            case OpCode::OP_TIME: {
+                ELogTimeBuffer timeBuffer;
+                size_t len = 0;
+                const char* timeStr =
+                    renderLogRecordTime(logRecord, fieldSpec.m_timeSpec, timeBuffer, len);
+                appendField(output, isPlain, fieldSpec, timeStr, len);
+                break;
+            }
+
+            case OpCode::OP_TIME_EPOCH:
+                appendIntField(output, isPlain, fieldSpec,
+                               elogTimeToUnixTimeNanos(logRecord.m_logTime) / 1000ull);
+                break;
+
+            case OpCode::OP_REL_TIME:
+                appendIntField(output, isPlain, fieldSpec,
+                               ELogRelativeTimeSelector::getRelativeTimeNanos(logRecord));
+                break;
+
+            case OpCode::OP_SOURCE_REL_TIME:
+                appendIntField(
+                    output, isPlain, fieldSpec,
+                    ELogSourceRelativeTimeSelector::getSourceRelativeTimeNanos(logRecord));
+                break;
+
+            case OpCode::OP_THREAD_DELTA:
+                appendIntField(output, isPlain, fieldSpec,
+                               ELogThreadDeltaSelector::getThreadDeltaNanos(logRecord));
+                break;
+
+            case OpCode::OP_APP_NAME: {
+                const char* appName = getAppNameField();
+                appendField(output, isPlain, fieldSpec, appName, strlen(appName));
+                break;
+            }
+
+            case OpCode::OP_THREAD_ID:
+                appendIntField(output, isPlain, fieldSpec, logRecord.m_threadId);
+                break;
+
+            case OpCode::OP_THREAD_NAME: {
+                if (appendCachedName(output, isPlain, fieldSpec,
+                                     [&logRecord](const ELogJustifySpec& justifySpec,
+                                                  size_t& length) {
+                                         return getCachedThreadName(logRecord.m_threadId,
+                                                                    justifySpec, length);
+                                     })) {
+                    break;
+                }
+                const char* threadName = getThreadNameField(logRecord.m_threadId);
+                if (threadName == nullptr) {
+                    threadName = "";
+                }
+                appendField(output, isPlain, fieldSpec, threadName, strlen(threadName));
+                break;
+            }
+
+            case OpCode::OP_SOURCE: {
+                if (appendCachedName(output, isPlain, fieldSpec,
+                                     [&logRecord](const ELogJustifySpec& justifySpec,
+                                                  size_t& length) {
+                                         return getCachedLogSourceName(logRecord, justifySpec,
+                                                                       length);
+                                     })) {
+                    break;
+                }
+                size_t length = 0;
+                const char* logSourceName = getLogSourceName(logRecord, length);
+                appendField(output, isPlain, fieldSpec, logSourceName, length);
+                break;
+            }
+
+            case OpCode::OP_MODULE: {
+                if (appendCachedName(output, isPlain, fieldSpec,
+                                     [&logRecord](const ELogJustifySpec& justifySpec,
+                                                  size_t& length) {
+                                         return getCachedLogModuleName(logRecord, justifySpec,
+                                                                       length);
+                                     })) {
+                    break;
+                }
+                size_t length = 0;
+                const char* moduleName = getLogModuleName(logRecord, length);
+                appendField(output, isPlain, fieldSpec, moduleName, length);
+                break;
+            }
+
+            case OpCode::OP_FILE:
+                appendField(output, isPlain, fieldSpec, logRecord.m_file,
+                            strlen(logRecord.m_file));
+                break;
+
+            case OpCode::OP_LINE:
+                appendIntField(output, isPlain, fieldSpec, logRecord.m_line);
+                break;
+
+            case OpCode::OP_FUNCTION:
+                appendField(output, isPlain, fieldSpec, logRecord.m_function,
+                            strlen(logRecord.m_function));
+                break;
+
+            case OpCode::OP_LEVEL: {
+                const char* logLevelStr = elogLevelToStr(logRecord.m_logLevel);
+                appendField(output, isPlain, fieldSpec, logLevelStr, strlen(logLevelStr));
+                break;
+            }
+
+            case OpCode::OP_MSG:
+                // binary log records must be resolved first, so let the selector handle that
+                if (logRecord.m_flags & ELOG_RECORD_BINARY) {
+                    selectFieldInto(instruction.m_selector, logRecord, output);
+                } else {
+                    appendField(output, isPlain, fieldSpec, logRecord.m_logMsg,
+                                logRecord.m_logMsgLen);
+                }
+                break;
+
+            default:
+                selectFieldInto(instruction.m_selector, logRecord, output);
+                break;
+        }
+    }
+}
+
 }  // namespace elog
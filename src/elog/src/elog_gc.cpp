@@ -2,10 +2,12 @@
 
 #include <bit>
 
+#include "elog_aligned_alloc.h"
 #include "elog_api.h"
 #include "elog_common.h"
 #include "elog_field_selector_internal.h"
 #include "elog_report.h"
+#include "elog_self_profile.h"
 
 // the maximum number of GC objects in ELog
 #define ELOG_MAX_GC_OBJECTS 64
@@ -13,6 +15,12 @@
 #define ELOG_WORD_SIZE sizeof(uint64_t)
 #define ELOG_MAX_TXN_PER_THREAD 64
 
+// reader slot epoch value denoting a thread that is not inside a read-side critical section
+#define ELOG_QUIESCENT_EPOCH ((uint64_t)-1)
+
+// epoch returned to readers that could not obtain a reader slot (thread epoch mode)
+#define ELOG_OVERFLOW_EPOCH ((uint64_t)-2)
+
 // TODO: this GC needs much more testing
 
 namespace elog {
@@ -22,6 +30,9 @@ ELOG_DECLARE_REPORT_LOGGER(ELogGC)
 // atomic bit set of GC ids
 static std::atomic<uint64_t> sGcIds = 0;
 
+// GC instance generation counter (zero denotes no GC)
+static std::atomic<uint64_t> sGcGeneration = 0;
+
 inline bool allocGcId(uint32_t& gcId) {
     uint64_t gcIds = sGcIds.load(std::memory_order_acquire);
     while (gcIds != 0xFFFFFFFFFFFFFFFF) {
@@ -59,14 +70,26 @@ inline void freeGcId(uint32_t gcId) {
     }
 }
 
+// per-thread slot id cached for some GC, tagged with the generation of the GC instance, since GC ids
+// are reused after a GC is destroyed, and a slot id cached for a destroyed GC must not be used by
+// a new GC that was given the same id (the thread would then use a slot it does not own)
+struct ELogGCThreadSlot {
+    uint64_t m_generation;
+    uint64_t m_slotId;
+};
+
 // use per-thread array for allowing current thread access multiple GCs, so each GC can manage its
 // own per-thread slot id
-static thread_local uint64_t sCurrentThreadGCSlotId[ELOG_MAX_GC_OBJECTS] = {
-    ELOG_INVALID_GC_SLOT_ID};
+// NOTE: zero generation never matches a GC instance, so zero-initialization marks all as invalid
+static thread_local ELogGCThreadSlot sCurrentThreadGCSlot[ELOG_MAX_GC_OBJECTS] = {};
+
+// per-thread reader slot id (thread epoch mode), stored as slot index plus one
+static thread_local ELogGCThreadSlot sCurrentThreadReaderSlot[ELOG_MAX_GC_OBJECTS] = {};
 
 bool ELogGC::initialize(const char* name, uint32_t maxThreads, uint32_t gcFrequency,
                         uint32_t gcPeriodMillis /* = 0 */, uint32_t gcThreadCount /* = 0 */,
-                        uint32_t maxTxnSpan /* = 0 */) {
+                        uint32_t maxTxnSpan /* = 0 */,
+                        ELogGCMode mode /* = ELogGCMode::GM_EPOCH_SET */) {
     if (maxThreads == 0) {
         maxThreads = getMaxThreads();
     }
@@ -88,13 +111,16 @@ bool ELogGC::initialize(const char* name, uint32_t maxThreads, uint32_t gcFreque
     if (!allocGcId(m_id)) {
         ELOG_REPORT_ERROR(
             "Cannot initialize %s garbage collection, failed to allocate GC identifier", name);
+        return false;
     }
 
+    m_generation = sGcGeneration.fetch_add(1, std::memory_order_relaxed) + 1;
     m_name = name;
     m_gcFrequency = gcFrequency;
     m_gcPeriodMillis = gcPeriodMillis;
     m_gcThreadCount = gcThreadCount;
     m_maxThreads = maxThreads;
+    m_mode = mode;
     m_retireCount = 0;
     if (maxTxnSpan == 0) {
         // by default we allow for each thread in average to use ELOG_MAX_TXN_PER_THREAD object
@@ -105,6 +131,17 @@ bool ELogGC::initialize(const char* name, uint32_t maxThreads, uint32_t gcFreque
     m_epochSet.resizeRing(wordCount + 1);
     m_objectLists.resize(maxThreads);
     m_activeLists.resize(wordCount);
+    if (m_mode == ELogGCMode::GM_THREAD_EPOCH) {
+        m_readerSlots = elogAlignedAllocObjectArray<ReaderSlot>(ELOG_CACHE_LINE, maxThreads);
+        if (m_readerSlots == nullptr) {
+            ELOG_REPORT_ERROR("Cannot initialize %s garbage collector, failed to allocate %u "
+                              "reader slots, out of memory",
+                              name, maxThreads);
+            return false;
+        }
+        m_threadEpoch.store(0, std::memory_order_relaxed);
+        m_overflowReaders.store(0, std::memory_order_relaxed);
+    }
     if (!elogCreateTls(m_tlsKey, onThreadExit)) {
         ELOG_REPORT_ERROR("Failed to create TLS key used for GC thread exit notification");
         return false;
@@ -159,6 +196,18 @@ bool ELogGC::destroy() {
     for (ManagedObjectList& objectList : m_objectLists) {
         recycleObjectList(objectList.m_head.m_atomicValue.load(std::memory_order_relaxed));
     }
+
+    if (m_readerSlots != nullptr) {
+        elogAlignedFreeObjectArray(m_readerSlots, m_maxThreads);
+        m_readerSlots = nullptr;
+    }
+
+    // the id may now be reused by another GC, while threads still cache slot ids under it, but
+    // these are ignored due to generation mismatch
+    if (m_generation != 0) {
+        freeGcId(m_id);
+        m_generation = 0;
+    }
     return true;
 }
 
@@ -176,13 +225,71 @@ void ELogGC::endEpoch(uint64_t epoch) {
     }
 }
 
+uint64_t ELogGC::enterEpoch(std::atomic<uint64_t>& epoch) {
+    if (m_mode == ELogGCMode::GM_EPOCH_SET) {
+        uint64_t currentEpoch = epoch.fetch_add(1, std::memory_order_acquire);
+        beginEpoch(currentEpoch);
+        return currentEpoch;
+    }
+
+    ReaderSlot* readerSlot = getReaderSlot();
+    if (readerSlot == nullptr) {
+        // no slot available, so recycling is postponed until this reader leaves
+        m_overflowReaders.fetch_add(1, std::memory_order_seq_cst);
+        return ELOG_OVERFLOW_EPOCH;
+    }
+    if (readerSlot->m_nestLevel++ > 0) {
+        // nested critical section, already protected by the outer one
+        return readerSlot->m_epoch.load(std::memory_order_relaxed);
+    }
+
+    // publish the current epoch, and make sure the published value is still current after the
+    // store became visible, otherwise a concurrent recycler that did not see our store might have
+    // already recycled objects retired at the epoch we published
+    uint64_t currentEpoch = m_threadEpoch.load(std::memory_order_acquire);
+    for (;;) {
+        readerSlot->m_epoch.store(currentEpoch, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t globalEpoch = m_threadEpoch.load(std::memory_order_acquire);
+        if (globalEpoch == currentEpoch) {
+            break;
+        }
+        currentEpoch = globalEpoch;
+    }
+    return currentEpoch;
+}
+
+void ELogGC::leaveEpoch(uint64_t epoch) {
+    if (m_mode == ELogGCMode::GM_EPOCH_SET) {
+        endEpoch(epoch);
+        return;
+    }
+
+    if (epoch == ELOG_OVERFLOW_EPOCH) {
+        m_overflowReaders.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+    // slot is valid, since it was obtained in enterEpoch()
+    ReaderSlot* readerSlot = &m_readerSlots[sCurrentThreadReaderSlot[m_id].m_slotId - 1];
+    if (--readerSlot->m_nestLevel > 0) {
+        return;
+    }
+    readerSlot->m_epoch.store(ELOG_QUIESCENT_EPOCH, std::memory_order_release);
+
+    // cooperative recycling is triggered by a per-thread counter, so no shared counter is touched
+    if (m_gcFrequency > 0 && (++readerSlot->m_leaveCount % m_gcFrequency) == 0) {
+        recycleRetiredObjects();
+    }
+}
+
 bool ELogGC::retire(ELogManagedObject* object, uint64_t epoch) {
     // obtain current thead slot on-demand
     // consider release slot if we can get thread-finish event (we have already win32 support for
     // that, we can use special TLS destructor for that on Linux)
     // then just add the group to an internal data structure
-    uint64_t slotId = sCurrentThreadGCSlotId[m_id];
-    if (slotId == ELOG_INVALID_GC_SLOT_ID) {
+    ELogGCThreadSlot& threadSlot = sCurrentThreadGCSlot[m_id];
+    uint64_t slotId = threadSlot.m_slotId;
+    if (threadSlot.m_generation != m_generation) {
         slotId = obtainSlot();
         if (slotId == ELOG_INVALID_GC_SLOT_ID) {
             ELOG_REPORT_WARN(
@@ -191,7 +298,8 @@ bool ELogGC::retire(ELogManagedObject* object, uint64_t epoch) {
                 m_name.c_str(), m_maxThreads);
             return false;
         }
-        sCurrentThreadGCSlotId[m_id] = slotId;
+        threadSlot.m_generation = m_generation;
+        threadSlot.m_slotId = slotId;
     }
 
     // allocate new list item to push on head
@@ -199,6 +307,12 @@ bool ELogGC::retire(ELogManagedObject* object, uint64_t epoch) {
         ELOG_INFO_EX(m_traceLogger, "Retiring object %p on epoch %" PRIu64, object, epoch);
     }
 
+    // in thread epoch mode the object is stamped with the GC's own epoch counter, which is then
+    // advanced, so that readers entering from now on cannot be holding a reference to the object
+    if (m_mode == ELogGCMode::GM_THREAD_EPOCH) {
+        epoch = m_threadEpoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+
     // push on head
     object->setRetireEpoch(epoch);
     ManagedObjectList& objectList = m_objectLists[slotId];
@@ -216,10 +330,11 @@ bool ELogGC::retire(ELogManagedObject* object, uint64_t epoch) {
 }
 
 void ELogGC::recycleRetiredObjects() {
+    ELOG_PROFILE_SCOPE(ELogProfileStage::PS_GC_RECYCLE);
     // the minimum value here represents the CONSECUTIVE number of transactions that finished,
     // starting from epoch 0. in effect, the minimum value matches the minimum active transaction
     // epoch, so anything below that can be retired. we moderate GC access as configured.
-    uint64_t minActiveEpoch = m_epochSet.queryFullPrefix();
+    uint64_t minActiveEpoch = getMinActiveEpoch();
     if (minActiveEpoch == 0) {
         // no transaction finished at all up until now
         return;
@@ -255,6 +370,32 @@ void ELogGC::recycleRetiredObjects() {
     }
 }
 
+uint64_t ELogGC::getMinActiveEpoch() {
+    if (m_mode == ELogGCMode::GM_EPOCH_SET) {
+        return m_epochSet.queryFullPrefix();
+    }
+
+    // NOTE: the global epoch must be loaded before scanning the slots, so that a reader that
+    // publishes its epoch after we scanned its slot, is guaranteed to have published an epoch
+    // not less than the one we loaded
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t minActiveEpoch = m_threadEpoch.load(std::memory_order_acquire);
+    if (m_overflowReaders.load(std::memory_order_acquire) > 0) {
+        // some reader could not obtain a slot, so we cannot tell its epoch
+        return 0;
+    }
+    for (uint32_t i = 0; i < m_maxThreads; ++i) {
+        ReaderSlot& readerSlot = m_readerSlots[i];
+        if (readerSlot.m_inUse.load(std::memory_order_relaxed)) {
+            uint64_t epoch = readerSlot.m_epoch.load(std::memory_order_acquire);
+            if (epoch < minActiveEpoch) {
+                minActiveEpoch = epoch;
+            }
+        }
+    }
+    return minActiveEpoch;
+}
+
 void ELogGC::processObjectList(ManagedObjectList& objectList, uint64_t minActiveEpoch) {
     std::atomic<uint64_t>& recyclingAtomic = objectList.m_recycling.m_atomicValue;
     uint64_t recycling = recyclingAtomic.load(std::memory_order_acquire);
@@ -306,8 +447,43 @@ void ELogGC::processObjectList(ManagedObjectList& objectList, uint64_t minActive
 
 void ELogGC::onThreadExit(void* param) {
     ELogGC* gc = (ELogGC*)param;
-    if (sCurrentThreadGCSlotId[gc->m_id] != ELOG_INVALID_GC_SLOT_ID) {
-        gc->setListInactive(sCurrentThreadGCSlotId[gc->m_id]);
+    ELogGCThreadSlot& threadSlot = sCurrentThreadGCSlot[gc->m_id];
+    if (threadSlot.m_generation == gc->m_generation) {
+        gc->setListInactive(threadSlot.m_slotId);
+        threadSlot.m_generation = 0;
+    }
+    gc->releaseReaderSlot();
+}
+
+ELogGC::ReaderSlot* ELogGC::getReaderSlot() {
+    ELogGCThreadSlot& threadSlot = sCurrentThreadReaderSlot[m_id];
+    if (threadSlot.m_generation == m_generation) {
+        return &m_readerSlots[threadSlot.m_slotId - 1];
+    }
+    for (uint32_t i = 0; i < m_maxThreads; ++i) {
+        ReaderSlot& readerSlot = m_readerSlots[i];
+        uint64_t inUse = readerSlot.m_inUse.load(std::memory_order_relaxed);
+        if (inUse == 0 &&
+            readerSlot.m_inUse.compare_exchange_strong(inUse, 1, std::memory_order_seq_cst)) {
+            readerSlot.m_nestLevel = 0;
+            readerSlot.m_leaveCount = 0;
+            threadSlot.m_generation = m_generation;
+            threadSlot.m_slotId = i + 1;
+            // register for thread exit notification, so the slot can be released
+            (void)elogSetTls(m_tlsKey, this);
+            return &readerSlot;
+        }
+    }
+    return nullptr;
+}
+
+void ELogGC::releaseReaderSlot() {
+    ELogGCThreadSlot& threadSlot = sCurrentThreadReaderSlot[m_id];
+    if (threadSlot.m_generation == m_generation) {
+        ReaderSlot& readerSlot = m_readerSlots[threadSlot.m_slotId - 1];
+        readerSlot.m_epoch.store(ELOG_QUIESCENT_EPOCH, std::memory_order_relaxed);
+        readerSlot.m_inUse.store(0, std::memory_order_release);
+        threadSlot.m_generation = 0;
     }
 }
 
@@ -0,0 +1,154 @@
+#include "elog_histogram.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#include "elog_aligned_alloc.h"
+#include "elog_report.h"
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogHistogram)
+
+void ELogHistogramSnapshot::merge(const ELogHistogramSnapshot& snapshot) {
+    if (snapshot.m_count == 0) {
+        return;
+    }
+    if (m_count == 0) {
+        m_min = snapshot.m_min;
+        m_max = snapshot.m_max;
+    } else {
+        m_min = std::min(m_min, snapshot.m_min);
+        m_max = std::max(m_max, snapshot.m_max);
+    }
+    m_count += snapshot.m_count;
+    m_sum += snapshot.m_sum;
+    if (m_buckets.empty()) {
+        m_buckets.resize(ELOG_HISTOGRAM_BUCKET_COUNT, 0);
+    }
+    for (uint32_t i = 0; i < snapshot.m_buckets.size(); ++i) {
+        m_buckets[i] += snapshot.m_buckets[i];
+    }
+}
+
+uint64_t ELogHistogramSnapshot::getPercentile(double percentile) const {
+    if (m_count == 0) {
+        return 0;
+    }
+    if (percentile <= 0.0) {
+        return m_min;
+    }
+    if (percentile >= 100.0) {
+        return m_max;
+    }
+
+    // rank of the requested value, 1-based
+    uint64_t rank = (uint64_t)(percentile * m_count / 100.0 + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < m_buckets.size(); ++i) {
+        total += m_buckets[i];
+        if (total >= rank) {
+            return std::max(std::min(ELogHistogram::getBucketUpperBound(i), m_max), m_min);
+        }
+    }
+    return m_max;
+}
+
+bool ELogHistogram::initialize(uint32_t maxThreads) {
+    m_threadData = elogAlignedAllocObjectArray<std::atomic<ThreadData*>>(ELOG_CACHE_LINE,
+                                                                         maxThreads, nullptr);
+    if (m_threadData == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate histogram array for %u threads, out of memory",
+                          maxThreads);
+        return false;
+    }
+    m_maxThreads = maxThreads;
+    return true;
+}
+
+void ELogHistogram::terminate() {
+    if (m_threadData != nullptr) {
+        for (uint32_t i = 0; i < m_maxThreads; ++i) {
+            ThreadData* threadData = m_threadData[i].load(std::memory_order_relaxed);
+            if (threadData != nullptr) {
+                elogAlignedFreeObject(threadData);
+            }
+        }
+        elogAlignedFreeObjectArray<std::atomic<ThreadData*>>(m_threadData, m_maxThreads);
+        m_threadData = nullptr;
+    }
+    m_maxThreads = 0;
+}
+
+void ELogHistogram::reset(uint64_t slotId) {
+    ThreadData* threadData = m_threadData[slotId].load(std::memory_order_acquire);
+    if (threadData != nullptr) {
+        threadData->reset();
+    }
+}
+
+void ELogHistogram::getSnapshot(ELogHistogramSnapshot& snapshot) const {
+    snapshot = ELogHistogramSnapshot();
+    for (uint32_t i = 0; i < m_maxThreads; ++i) {
+        ThreadData* threadData = m_threadData[i].load(std::memory_order_acquire);
+        if (threadData == nullptr || threadData->m_count == 0) {
+            continue;
+        }
+
+        // NOTE: the owning thread may be recording concurrently, so the thread figures may be
+        // slightly inconsistent, which is acceptable for statistics reporting
+        ELogHistogramSnapshot threadSnapshot;
+        threadSnapshot.m_min = threadData->m_min;
+        threadSnapshot.m_max = threadData->m_max;
+        threadSnapshot.m_sum = threadData->m_sum;
+        threadSnapshot.m_buckets.resize(ELOG_HISTOGRAM_BUCKET_COUNT);
+        uint64_t count = 0;
+        for (uint32_t j = 0; j < ELOG_HISTOGRAM_BUCKET_COUNT; ++j) {
+            threadSnapshot.m_buckets[j] = threadData->m_buckets[j];
+            count += threadSnapshot.m_buckets[j];
+        }
+        // use the bucket sum as the count, so percentile computation stays consistent
+        threadSnapshot.m_count = count;
+        snapshot.merge(threadSnapshot);
+    }
+}
+
+uint64_t ELogHistogram::getBucketUpperBound(uint32_t bucketIndex) {
+    if (bucketIndex < ELOG_HISTOGRAM_SUB_BUCKET_COUNT) {
+        return bucketIndex;
+    }
+    if (bucketIndex >= ELOG_HISTOGRAM_BUCKET_COUNT - 1) {
+        return UINT64_MAX;
+    }
+    uint32_t shift = bucketIndex / ELOG_HISTOGRAM_SUB_BUCKET_COUNT - 1;
+    uint64_t subBucket = bucketIndex % ELOG_HISTOGRAM_SUB_BUCKET_COUNT;
+    uint64_t lowerBound = (ELOG_HISTOGRAM_SUB_BUCKET_COUNT + subBucket) << shift;
+    return lowerBound + (1ull << shift) - 1;
+}
+
+void ELogHistogram::ThreadData::reset() {
+    m_count = 0;
+    m_sum = 0;
+    m_min = UINT64_MAX;
+    m_max = 0;
+    for (uint32_t i = 0; i < ELOG_HISTOGRAM_BUCKET_COUNT; ++i) {
+        m_buckets[i] = 0;
+    }
+}
+
+ELogHistogram::ThreadData* ELogHistogram::allocThreadData(uint64_t slotId) {
+    // NOTE: only the thread owning the slot allocates its data, so no race can occur here
+    ThreadData* threadData = elogAlignedAllocObject<ThreadData>(ELOG_CACHE_LINE);
+    if (threadData == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate histogram thread data, out of memory");
+        return nullptr;
+    }
+    m_threadData[slotId].store(threadData, std::memory_order_release);
+    return threadData;
+}
+
+}  // namespace elog
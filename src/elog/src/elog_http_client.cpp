@@ -7,13 +7,31 @@
 #include <cassert>
 #include <chrono>
 #include <cinttypes>
+#include <cstring>
 
 #include "elog_report.h"
+#include "elog_spill_file.h"
+#include "elog_timer_service.h"
 
 namespace elog {
 
 ELOG_DECLARE_REPORT_LOGGER(ELogHttpClient)
 
+/** @brief Timer task that wakes up the HTTP client resend thread each resend period. */
+class ELogHttpResendTimerTask : public ELogTimerTask {
+public:
+    ELogHttpResendTimerTask(ELogHttpClient* httpClient) : m_httpClient(httpClient) {}
+    ELogHttpResendTimerTask(const ELogHttpResendTimerTask&) = delete;
+    ELogHttpResendTimerTask(ELogHttpResendTimerTask&&) = delete;
+    ELogHttpResendTimerTask& operator=(const ELogHttpResendTimerTask&) = delete;
+    ~ELogHttpResendTimerTask() final {}
+
+    void onTimer() final { m_httpClient->onResendTimer(); }
+
+private:
+    ELogHttpClient* m_httpClient;
+};
+
 bool ELogHttpClientAssistant::handleResult(const httplib::Result& result) {
     if (result->status != m_status) {
         ELOG_REPORT_ERROR(
@@ -53,11 +71,49 @@ bool ELogHttpClient::start() {
             return false;
         }
 
+        // open spill file if configured (may contain messages left over from previous run)
+        if (!m_config.m_spillDir.empty()) {
+            m_spillFile = new (std::nothrow) ELogSpillFile();
+            if (m_spillFile == nullptr) {
+                ELOG_REPORT_ERROR("Failed to allocate backlog spill file, out of memory");
+            } else if (!m_spillFile->open(m_config.m_spillDir.c_str(),
+                                          m_config.m_spillSegmentSizeBytes,
+                                          m_config.m_spillLimitBytes)) {
+                ELOG_REPORT_ERROR("Failed to open %s backlog spill file at %s",
+                                  m_logTargetName.c_str(), m_config.m_spillDir.c_str());
+                delete m_spillFile;
+                m_spillFile = nullptr;
+            }
+            if (m_spillFile == nullptr) {
+                delete m_resendClient;
+                m_resendClient = nullptr;
+                delete m_client;
+                m_client = nullptr;
+                return false;
+            }
+        }
+
+        m_resendTimer = new (std::nothrow) ELogHttpResendTimerTask(this);
+        if (m_resendTimer == nullptr) {
+            ELOG_REPORT_ERROR("Failed to allocate HTTP resend timer task, out of memory");
+            if (m_spillFile != nullptr) {
+                delete m_spillFile;
+                m_spillFile = nullptr;
+            }
+            delete m_resendClient;
+            m_resendClient = nullptr;
+            delete m_client;
+            m_client = nullptr;
+            return false;
+        }
+
         // start resend thread
         m_resendThread = std::thread([this] {
             setCurrentThreadNameField("http-resend");
             resendThread();
         });
+        getTimerService().schedule(m_resendTimer, m_config.m_resendPeriodMillis,
+                                   m_config.m_resendPeriodMillis);
     }
     return true;
 }
@@ -65,11 +121,20 @@ bool ELogHttpClient::start() {
 bool ELogHttpClient::stop() {
     // stop resend thread, but only if http clients are valid
     if (!m_disableResend) {
+        if (m_resendTimer != nullptr) {
+            getTimerService().cancel(m_resendTimer);
+            delete m_resendTimer;
+            m_resendTimer = nullptr;
+        }
         if (m_resendClient != nullptr) {
             stopResendThread();
             delete m_resendClient;
             m_resendClient = nullptr;
         }
+        if (m_spillFile != nullptr) {
+            delete m_spillFile;
+            m_spillFile = nullptr;
+        }
     }
     if (m_client != nullptr) {
         delete m_client;
@@ -225,23 +290,30 @@ void ELogHttpClient::addBacklog(const char* endpoint, const httplib::Headers& he
     m_cv.notify_one();
 }
 
+void ELogHttpClient::onResendTimer() {
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_resendDue = true;
+    m_cv.notify_one();
+}
+
 void ELogHttpClient::resendThread() {
     while (!shouldStopResend()) {
         // wait the full period until ordered to stop or that we are urged to resend
         {
             std::unique_lock<std::mutex> lock(m_lock);
-            m_cv.wait_for(lock, std::chrono::milliseconds(m_config.m_resendPeriodMillis),
-                          [this] { return m_stopResend || !m_pendingBackLog.empty(); });
+            m_cv.wait(lock, [this] {
+                return m_stopResend || m_resendDue || !m_pendingBackLog.empty();
+            });
             if (m_stopResend) {
                 break;
             }
-
-            // get out all pending back log messages and put in shipping back log queue, so we can
-            // release the lock quickly for more pending messages, otherwise we would be holding the
-            // lock while sending HTTP messages from the back log queue
-            copyPendingBacklog();
+            m_resendDue = false;
         }
 
+        // get out all pending back log messages and put in shipping back log queue (or spill them
+        // to disk)
+        copyPendingBacklog();
+
         // see if we exceeded limit
         dropExcessBacklog();
 
@@ -257,7 +329,7 @@ void ELogHttpClient::resendThread() {
         // compute a reasonable sleep time between resend attempt
         // NOTE: due to hard limit we know we can convert from size_t to uint32_t
         uint32_t backlogCount = (uint32_t)m_shippingBackLog.size();
-        if (backlogCount == 0) {
+        if (backlogCount == 0 && (m_spillFile == nullptr || m_spillFile->isEmpty())) {
             // nothing to send
             return;
         }
@@ -286,6 +358,24 @@ void ELogHttpClient::resendThread() {
         } while ((uint64_t)timePassedMillis.count() <= m_config.m_shutdownTimeoutMillis);
     }
 
+    // messages that could not be sent are kept in the spill file (if any), and are resent on the
+    // next run
+    // NOTE: these messages are older than those already spilled, so order is not preserved here
+    if (m_spillFile != nullptr) {
+        copyPendingBacklog();
+        while (!m_shippingBackLog.empty()) {
+            spillMessage(m_shippingBackLog.front());
+            m_shippingBackLog.pop_front();
+        }
+        m_backlogSizeBytes = 0;
+        if (!m_spillFile->isEmpty()) {
+            ELOG_REPORT_WARN("%s log target has %" PRIu64
+                             " bytes of unsent messages in backlog spill file, which will be "
+                             "resent on next run",
+                             m_logTargetName.c_str(), m_spillFile->getSizeBytes());
+        }
+    }
+
     size_t backlogCount = m_shippingBackLog.size();
     if (backlogCount > 0) {
         ELOG_REPORT_ERROR("%s log target has failed to resend %zu pending messages",
@@ -294,10 +384,26 @@ void ELogHttpClient::resendThread() {
 }
 
 void ELogHttpClient::copyPendingBacklog() {
-    while (!m_pendingBackLog.empty()) {
-        m_backlogSizeBytes += m_pendingBackLog.front().m_body.size();
-        m_shippingBackLog.push_back(m_pendingBackLog.front());
-        m_pendingBackLog.pop_front();
+    // take out all pending messages quickly, so that the lock is not held during disk I/O
+    std::list<HttpMessage> newBacklog;
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        newBacklog.splice(newBacklog.end(), m_pendingBackLog);
+    }
+
+    // once spilling started, all new messages are spilled as well (until the spill file is fully
+    // replayed), so that order is preserved
+    while (!newBacklog.empty()) {
+        size_t messageSize = newBacklog.front().m_body.size();
+        if (m_spillFile != nullptr &&
+            (!m_spillFile->isEmpty() ||
+             m_backlogSizeBytes + messageSize >= m_config.m_backlogLimitBytes)) {
+            spillMessage(newBacklog.front());
+            newBacklog.pop_front();
+        } else {
+            m_backlogSizeBytes += messageSize;
+            m_shippingBackLog.splice(m_shippingBackLog.end(), newBacklog, newBacklog.begin());
+        }
     }
 }
 
@@ -328,19 +434,69 @@ bool ELogHttpClient::resendShippingBacklog(bool duringShutdown /* = false */) {
     ELOG_REPORT_TRACE("Attempting to resend %zu HTTP pending messages", m_shippingBackLog.size());
     while (!m_shippingBackLog.empty() && (duringShutdown || !shouldStopResend())) {
         HttpMessage& msg = m_shippingBackLog.front();
-        httplib::Result res = m_resendClient->Post(msg.m_endpoint, msg.m_headers, &msg.m_body[0],
-                                                   msg.m_body.size(), msg.m_contentType);
-        ELOG_REPORT_TRACE("POST done");
-        if (!res) {
-            ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to resend POST HTTP request: %s",
-                                               httplib::to_string(res.error()).c_str());
-            // no need to consult result handler, this is a clear network error
+        if (!resendMessage(msg)) {
             return false;
         }
-        if (m_assistant != nullptr && !m_assistant->handleResult(res)) {
+        size_t messageSize = msg.m_body.size();
+        m_backlogSizeBytes -= std::min((uint64_t)messageSize, m_backlogSizeBytes);
+        m_shippingBackLog.pop_front();
+    }
+
+    // spilled messages are newer than all messages in memory, so they are replayed only after
+    // the in-memory backlog has been fully sent
+    if (m_spillFile != nullptr && m_shippingBackLog.empty()) {
+        return resendSpilledBacklog(duringShutdown);
+    }
+    return m_shippingBackLog.empty();
+}
+
+bool ELogHttpClient::resendSpilledBacklog(bool duringShutdown) {
+    std::vector<char> record;
+    HttpMessage msg;
+    while ((duringShutdown || !shouldStopResend()) && m_spillFile->peek(record)) {
+        if (!msg.deserialize(record)) {
+            ELOG_REPORT_MODERATE_ERROR_DEFAULT(
+                "Discarding invalid %s message in backlog spill file (%zu bytes)",
+                m_logTargetName.c_str(), record.size());
+        } else if (!resendMessage(msg)) {
             return false;
         }
-        m_shippingBackLog.pop_front();
+        m_spillFile->consume();
+
+        // replay may take a while, so keep new pending messages from accumulating in memory (they
+        // are spilled, since the spill file is not empty)
+        if (!duringShutdown) {
+            copyPendingBacklog();
+        }
+    }
+    return m_spillFile->isEmpty();
+}
+
+bool ELogHttpClient::resendMessage(const HttpMessage& msg) {
+    httplib::Result res = m_resendClient->Post(msg.m_endpoint, msg.m_headers, msg.m_body.data(),
+                                               msg.m_body.size(), msg.m_contentType);
+    ELOG_REPORT_TRACE("POST done");
+    if (!res) {
+        ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to resend POST HTTP request: %s",
+                                           httplib::to_string(res.error()).c_str());
+        // no need to consult result handler, this is a clear network error
+        return false;
+    }
+    if (m_assistant != nullptr && !m_assistant->handleResult(res)) {
+        return false;
+    }
+    return true;
+}
+
+bool ELogHttpClient::spillMessage(const HttpMessage& msg) {
+    std::string buffer;
+    msg.serialize(buffer);
+    if (!m_spillFile->append(buffer.data(), (uint32_t)buffer.size())) {
+        ELOG_REPORT_MODERATE_ERROR_DEFAULT(
+            "Failed to spill %s backlog message to disk (spill size %" PRIu64
+            " bytes, limit %" PRIu64 " bytes), message dropped",
+            m_logTargetName.c_str(), m_spillFile->getSizeBytes(), m_config.m_spillLimitBytes);
+        return false;
     }
     return true;
 }
@@ -365,6 +521,80 @@ ELogHttpClient::HttpMessage::HttpMessage(const char* endpoint, const httplib::He
     m_body.assign(body, body + len);
 }
 
+// spilled message layout (native byte order, since spill files are local to the host):
+// endpoint, content type, header count, header name/value pairs, body, where each string is
+// preceded by its 32 bit length
+static void appendSpillString(std::string& buffer, const char* str, size_t len) {
+    uint32_t len32 = (uint32_t)len;
+    buffer.append((const char*)&len32, sizeof(len32));
+    buffer.append(str, len);
+}
+
+static bool readSpillString(const std::vector<char>& buffer, size_t& offset, const char*& str,
+                            uint32_t& len) {
+    if (offset + sizeof(len) > buffer.size()) {
+        return false;
+    }
+    memcpy(&len, &buffer[offset], sizeof(len));
+    offset += sizeof(len);
+    if (offset + len > buffer.size()) {
+        return false;
+    }
+    str = buffer.data() + offset;
+    offset += len;
+    return true;
+}
+
+void ELogHttpClient::HttpMessage::serialize(std::string& buffer) const {
+    appendSpillString(buffer, m_endpoint.data(), m_endpoint.size());
+    appendSpillString(buffer, m_contentType.data(), m_contentType.size());
+    uint32_t headerCount = (uint32_t)m_headers.size();
+    buffer.append((const char*)&headerCount, sizeof(headerCount));
+    for (const auto& header : m_headers) {
+        appendSpillString(buffer, header.first.data(), header.first.size());
+        appendSpillString(buffer, header.second.data(), header.second.size());
+    }
+    appendSpillString(buffer, m_body.data(), m_body.size());
+}
+
+bool ELogHttpClient::HttpMessage::deserialize(const std::vector<char>& buffer) {
+    size_t offset = 0;
+    const char* str = nullptr;
+    uint32_t len = 0;
+    if (!readSpillString(buffer, offset, str, len)) {
+        return false;
+    }
+    m_endpoint.assign(str, len);
+    if (!readSpillString(buffer, offset, str, len)) {
+        return false;
+    }
+    m_contentType.assign(str, len);
+
+    uint32_t headerCount = 0;
+    if (offset + sizeof(headerCount) > buffer.size()) {
+        return false;
+    }
+    memcpy(&headerCount, &buffer[offset], sizeof(headerCount));
+    offset += sizeof(headerCount);
+    m_headers.clear();
+    for (uint32_t i = 0; i < headerCount; ++i) {
+        const char* value = nullptr;
+        uint32_t valueLen = 0;
+        if (!readSpillString(buffer, offset, str, len) ||
+            !readSpillString(buffer, offset, value, valueLen)) {
+            return false;
+        }
+        m_headers.insert(
+            httplib::Headers::value_type(std::string(str, len), std::string(value, valueLen)));
+    }
+
+    if (!readSpillString(buffer, offset, str, len)) {
+        return false;
+    }
+    m_body.assign(str, str + len);
+    return offset == buffer.size();
+}
+
 }  // namespace elog
 
 #endif  // ELOG_ENABLE_HTTP
\ No newline at end of file
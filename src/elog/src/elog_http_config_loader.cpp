@@ -9,6 +9,8 @@
 
 namespace elog {
 
+ELOG_DECLARE_REPORT_LOGGER(ELogHttpConfigLoader)
+
 bool ELogHttpConfigLoader::loadHttpConfig(const ELogConfigMapNode* logTargetCfg,
                                           const char* targetName, ELogHttpConfig& httpConfig) {
     if (!ELogConfigLoader::getOptionalLogTargetTimeoutProperty(
@@ -41,6 +43,30 @@ bool ELogHttpConfigLoader::loadHttpConfig(const ELogConfigMapNode* logTargetCfg,
             ELogTimeUnits::TU_MILLI_SECONDS)) {
         return false;
     }
+    if (!ELogConfigLoader::getOptionalLogTargetStringProperty(
+            logTargetCfg, targetName, "backlog_spill_dir", httpConfig.m_spillDir)) {
+        return false;
+    }
+    if (!ELogConfigLoader::getOptionalLogTargetSizeProperty(
+            logTargetCfg, targetName, "backlog_spill_limit", httpConfig.m_spillLimitBytes,
+            ELogSizeUnits::SU_BYTES)) {
+        return false;
+    }
+    if (!ELogConfigLoader::getOptionalLogTargetSizeProperty(
+            logTargetCfg, targetName, "backlog_spill_segment_size",
+            httpConfig.m_spillSegmentSizeBytes, ELogSizeUnits::SU_BYTES)) {
+        return false;
+    }
+    if (!httpConfig.m_spillDir.empty() &&
+        (httpConfig.m_spillSegmentSizeBytes == 0 ||
+         httpConfig.m_spillSegmentSizeBytes > httpConfig.m_spillLimitBytes)) {
+        ELOG_REPORT_ERROR("Invalid %s log target specification, backlog spill segment size %" PRIu64
+                          " must be positive and may not exceed the backlog spill limit %" PRIu64
+                          " (context: %s)",
+                          targetName, httpConfig.m_spillSegmentSizeBytes,
+                          httpConfig.m_spillLimitBytes, logTargetCfg->getFullContext());
+        return false;
+    }
     return true;
 }
 
@@ -121,6 +121,21 @@ inline bool isTimeSourceEnabled() {
 /** @brief Retrieves the current time from the time source. */
 extern void getCurrentTimeFromSource(ELogTime& currentTime);
 
+/** @brief Retrieves the current time from the clock selected by the time capture mode. */
+extern void getCurrentTimeFromClock(ELogTime& currentTime);
+
+/** @brief Retrieves the current time for a log record. */
+inline void captureCurrentTime(ELogTime& currentTime) {
+    if (isTimeSourceEnabled()) {
+        getCurrentTimeFromSource(currentTime);
+    } else if (getParams().m_timeCaptureMode.m_atomicValue.load(std::memory_order_relaxed) ==
+               ELogTimeCaptureMode::TCM_REALTIME) {
+        elogGetCurrentTime(currentTime);
+    } else {
+        getCurrentTimeFromClock(currentTime);
+    }
+}
+
 #ifdef ELOG_USING_COMM_UTIL
 extern void refreshCommUtilLogLevelCfg();
 #endif
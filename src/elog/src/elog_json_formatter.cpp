@@ -3,6 +3,7 @@
 #ifdef ELOG_ENABLE_JSON
 
 #include "elog_common.h"
+#include "elog_json_writer.h"
 #include "elog_report.h"
 
 namespace elog {
@@ -37,6 +38,102 @@ bool ELogJsonFormatter::parseJson(const std::string& jsonStr) {
     return true;
 }
 
+/**
+ * @brief A field receptor that writes fields directly as JSON, either as values of named object
+ * members (if property names are given), or as escaped text embedded within a JSON template.
+ */
+template <typename T>
+class ELogJsonWriterReceptor final : public ELogFieldReceptor {
+public:
+    ELogJsonWriterReceptor(T& output, const std::vector<std::string>& propNames)
+        : m_output(output), m_writer(output), m_propNames(propNames), m_propIndex(0) {}
+    ELogJsonWriterReceptor(const ELogJsonWriterReceptor&) = delete;
+    ELogJsonWriterReceptor(ELogJsonWriterReceptor&&) = delete;
+    ELogJsonWriterReceptor& operator=(const ELogJsonWriterReceptor&) = delete;
+    ~ELogJsonWriterReceptor() final {}
+
+    inline void begin() {
+        if (!m_propNames.empty()) {
+            m_writer.beginObject();
+        }
+    }
+
+    inline void end() {
+        if (!m_propNames.empty()) {
+            m_writer.endObject();
+        }
+        m_writer.finish();
+    }
+
+    void receiveStringField(uint32_t typeId, const char* field, const ELogFieldSpec& fieldSpec,
+                            size_t length) final {
+        if (length == 0) {
+            length = strlen(field);
+        }
+        if (m_propNames.empty()) {
+            // static text is part of the JSON template, so it is copied as is
+            if (typeId == ELOG_INVALID_FIELD_SELECTOR_TYPE_ID) {
+                elogJsonAppend(m_output, field, length);
+            } else {
+                elogJsonAppendEscaped(m_output, field, length);
+            }
+        } else if (writeNextKey()) {
+            m_writer.writeString(field, length);
+        }
+    }
+
+    void receiveIntField(uint32_t typeId, uint64_t field, const ELogFieldSpec& fieldSpec) final {
+        if (m_propNames.empty()) {
+            char buf[32];
+            std::to_chars_result res = std::to_chars(buf, buf + sizeof(buf), field);
+            elogJsonAppend(m_output, buf, res.ptr - buf);
+        } else if (writeNextKey()) {
+            m_writer.writeInt(field);
+        }
+    }
+
+    void receiveTimeField(uint32_t typeId, const ELogTime& logTime, const char* timeStr,
+                          const ELogFieldSpec& fieldSpec, size_t length) final {
+        receiveStringField(typeId, timeStr, fieldSpec, length);
+    }
+
+    void receiveLogLevelField(uint32_t typeId, ELogLevel logLevel,
+                              const ELogFieldSpec& fieldSpec) final {
+        receiveStringField(typeId, elogLevelToStr(logLevel), fieldSpec, 0);
+    }
+
+private:
+    T& m_output;
+    ELogJsonWriter<T> m_writer;
+    const std::vector<std::string>& m_propNames;
+    uint32_t m_propIndex;
+
+    inline bool writeNextKey() {
+        if (m_propIndex >= m_propNames.size()) {
+            return false;
+        }
+        const std::string& propName = m_propNames[m_propIndex++];
+        m_writer.writeKey(propName.c_str(), propName.length());
+        return true;
+    }
+};
+
+template <typename T>
+void ELogJsonFormatter::formatJson(const ELogRecord& logRecord, T& output) {
+    ELogJsonWriterReceptor<T> receptor(output, m_propNames);
+    receptor.begin();
+    applyFieldSelectors(logRecord, &receptor);
+    receptor.end();
+}
+
+void ELogJsonFormatter::formatLogMsg(const ELogRecord& logRecord, std::string& logMsg) {
+    formatJson(logRecord, logMsg);
+}
+
+void ELogJsonFormatter::formatLogBuffer(const ELogRecord& logRecord, ELogBuffer& logBuffer) {
+    formatJson(logRecord, logBuffer);
+}
+
 }  // namespace elog
 
 #endif  // ELOG_ENABLE_JSON
\ No newline at end of file
@@ -36,6 +36,21 @@ bool ELogJsonReceptor::prepareJsonMap(nlohmann::json& logAttributes,
 #pragma warning(pop)
 #endif
 
+bool ELogJsonReceptor::writeJsonMap(ELogJsonWriter<std::string>& writer,
+                                    const std::vector<std::string>& propNames) {
+    if (m_propValues.size() != propNames.size()) {
+        ELOG_REPORT_MODERATE_ERROR_DEFAULT(
+            "Mismatching JSON property names and values (%u names, %u values) in JSON receptor",
+            propNames.size(), m_propValues.size());
+        return false;
+    }
+    for (uint32_t i = 0; i < m_propValues.size(); ++i) {
+        writer.writeKey(propNames[i].c_str(), propNames[i].length());
+        writer.writeString(m_propValues[i].c_str(), m_propValues[i].length());
+    }
+    return true;
+}
+
 }  // namespace elog
 
 #endif  // ELOG_ENABLE_JSON
\ No newline at end of file
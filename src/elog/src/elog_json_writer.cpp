@@ -0,0 +1,121 @@
+#include "elog_json_writer.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ELOG_JSON_SSE2
+#include <emmintrin.h>
+#ifdef ELOG_MSVC
+#include <intrin.h>
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define ELOG_JSON_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace elog {
+
+// escape sequences of all control characters, double quote and backslash
+static const char* sEscapeSeqTable[0x20] = {
+    "\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005", "\\u0006", "\\u0007",
+    "\\b",     "\\t",     "\\n",     "\\u000b", "\\f",     "\\r",     "\\u000e", "\\u000f",
+    "\\u0010", "\\u0011", "\\u0012", "\\u0013", "\\u0014", "\\u0015", "\\u0016", "\\u0017",
+    "\\u0018", "\\u0019", "\\u001a", "\\u001b", "\\u001c", "\\u001d", "\\u001e", "\\u001f"};
+
+inline bool requiresEscape(char c) { return (unsigned char)c < 0x20 || c == '"' || c == '\\'; }
+
+static size_t findEscapeScalar(const char* str, size_t len, size_t pos) {
+    while (pos < len && !requiresEscape(str[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+#ifdef ELOG_JSON_SSE2
+static size_t findEscapeSSE2(const char* str, size_t len) {
+    // NOTE: there is no unsigned byte comparison in SSE2, so we check c <= 0x1F with
+    // max(c, 0x1F) == 0x1F
+    const __m128i ctrlMax = _mm_set1_epi8(0x1F);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    size_t pos = 0;
+    for (; pos + 16 <= len; pos += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(str + pos));
+        __m128i mask = _mm_or_si128(
+            _mm_cmpeq_epi8(_mm_max_epu8(chunk, ctrlMax), ctrlMax),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+        int bits = _mm_movemask_epi8(mask);
+        if (bits != 0) {
+#ifdef ELOG_MSVC
+            unsigned long index = 0;
+            _BitScanForward(&index, (unsigned long)bits);
+            return pos + index;
+#else
+            return pos + __builtin_ctz((unsigned)bits);
+#endif
+        }
+    }
+    return findEscapeScalar(str, len, pos);
+}
+#endif
+
+#ifdef ELOG_JSON_AVX2
+__attribute__((target("avx2"))) static size_t findEscapeAVX2(const char* str, size_t len) {
+    const __m256i ctrlMax = _mm256_set1_epi8(0x1F);
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    size_t pos = 0;
+    for (; pos + 32 <= len; pos += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)(str + pos));
+        __m256i mask = _mm256_or_si256(
+            _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, ctrlMax), ctrlMax),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash)));
+        unsigned bits = (unsigned)_mm256_movemask_epi8(mask);
+        if (bits != 0) {
+            return pos + __builtin_ctz(bits);
+        }
+    }
+    return findEscapeScalar(str, len, pos);
+}
+
+static bool checkAVX2() {
+    // NOTE: required since this is called during static initialization
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static bool sUseAVX2 = checkAVX2();
+#endif
+
+size_t elogJsonFindEscape(const char* str, size_t len) {
+#ifdef ELOG_JSON_AVX2
+    // short strings are not worth the AVX2 setup
+    if (sUseAVX2 && len >= 32) {
+        return findEscapeAVX2(str, len);
+    }
+#endif
+#ifdef ELOG_JSON_SSE2
+    return findEscapeSSE2(str, len);
+#else
+    return findEscapeScalar(str, len, 0);
+#endif
+}
+
+const char* elogJsonGetEscapeSeq(char c, size_t& len) {
+    const char* escapeSeq = nullptr;
+    if (c == '"') {
+        escapeSeq = "\\\"";
+    } else if (c == '\\') {
+        escapeSeq = "\\\\";
+    } else if ((unsigned char)c < 0x20) {
+        escapeSeq = sEscapeSeqTable[(unsigned char)c];
+    } else {
+        // not expected, return character as is
+        static thread_local char sPlainChar[2] = {};
+        sPlainChar[0] = c;
+        escapeSeq = sPlainChar;
+    }
+    len = strlen(escapeSeq);
+    return escapeSeq;
+}
+
+}  // namespace elog
@@ -10,10 +10,13 @@
 #include <cstring>
 
 #include "elog_api.h"
+#include "elog_call_site_limiter.h"
 #include "elog_common.h"
+#include "elog_field_selector.h"
 #include "elog_internal.h"
 #include "elog_read_buffer.h"
 #include "elog_report.h"
+#include "elog_self_profile.h"
 
 #ifndef ELOG_WINDOWS
 #include <sys/stat.h>
@@ -42,6 +45,9 @@ void ELogLogger::logFormat(ELogLevel logLevel, const char* file, int line, const
 
 void ELogLogger::logFormatV(ELogLevel logLevel, const char* file, int line, const char* function,
                             const char* fmt, va_list args) {
+    if (isCallSiteSuppressed(file, line)) {
+        return;
+    }
     ELogRecordBuilder* recordBuilder = getRecordBuilder();
     if (isLogging(recordBuilder)) {
         recordBuilder = pushRecordBuilder();
@@ -53,6 +59,9 @@ void ELogLogger::logFormatV(ELogLevel logLevel, const char* file, int line, cons
 
 void ELogLogger::logNoFormat(ELogLevel logLevel, const char* file, int line, const char* function,
                              const char* msg) {
+    if (isCallSiteSuppressed(file, line)) {
+        return;
+    }
     ELogRecordBuilder* recordBuilder = getRecordBuilder();
     if (isLogging(recordBuilder)) {
         recordBuilder = pushRecordBuilder();
@@ -115,6 +124,7 @@ void ELogLogger::appendLogNoFormat(const char* msg) {
 
 void ELogLogger::finishLog(ELogRecordBuilder* recordBuilder) {
     if (isLogging(recordBuilder)) {
+        ELOG_PROFILE_SCOPE(ELogProfileStage::PS_FINISH_LOG);
         // NOTE: new line character at the end of the line is added by each log target individually
         // add terminating null and transfer to log record
         recordBuilder->finalize();
@@ -153,10 +163,11 @@ void ELogLogger::startLogRecord(ELogRecord& logRecord, ELogLevel logLevel, const
     // TODO: maybe we can take 2 bytes from another filed (e.g. not so importnat record id)?
     logRecord.m_line = line > UINT16_MAX ? (uint16_t)0 : (uint16_t)line;
     logRecord.m_function = function;
-    if (isTimeSourceEnabled()) {
-        getCurrentTimeFromSource(logRecord.m_logTime);
+    captureCurrentTime(logRecord.m_logTime);
+    if (ELogThreadDeltaSelector::isCaptureEnabled()) {
+        ELogThreadDeltaSelector::captureThreadDelta(logRecord);
     } else {
-        elogGetCurrentTime(logRecord.m_logTime);
+        logRecord.m_threadDeltaNanos = 0;
     }
     logRecord.m_threadId = getCurrentThreadId();
     logRecord.m_logger = this;
@@ -166,6 +177,9 @@ void ELogLogger::startLogRecord(ELogRecord& logRecord, ELogLevel logLevel, const
 ELogRecordBuilder* ELogLogger::startBinaryLogRecord(ELogLevel logLevel, const char* file, int line,
                                                     const char* function,
                                                     uint8_t flags /* = ELOG_RECORD_FORMATTED */) {
+    if (isCallSiteSuppressed(file, line)) {
+        return nullptr;
+    }
     ELogRecordBuilder* recordBuilder = getRecordBuilder();
     if (isLogging(recordBuilder)) {
         recordBuilder = pushRecordBuilder();
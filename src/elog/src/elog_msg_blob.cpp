@@ -0,0 +1,238 @@
+#include "elog_msg_blob.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "elog_render_cache.h"
+#include "elog_report.h"
+#include "elog_tls.h"
+
+// blocks sizes are 64, 128, 256, ..., 4096 bytes (including the blob header)
+#define ELOG_MSG_BLOB_MIN_BLOCK_SIZE 64u
+#define ELOG_MSG_BLOB_SIZE_CLASS_COUNT 7u
+
+// size class of blobs too large for pooling
+#define ELOG_MSG_BLOB_NO_SIZE_CLASS ELOG_MSG_BLOB_SIZE_CLASS_COUNT
+
+// maximum number of blocks cached by each thread per size class
+#define ELOG_MSG_BLOB_THREAD_CACHE_SIZE 64u
+
+// number of blocks moved at once between a thread cache and the global pool
+#define ELOG_MSG_BLOB_TRANSFER_SIZE 32u
+
+// maximum number of blocks kept in the global pool per size class (the rest are deallocated)
+#define ELOG_MSG_BLOB_POOL_MAX 4096u
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogMsgBlob)
+
+/** @brief Global free list of a single size class. */
+struct ELogMsgBlobFreeList {
+    std::mutex m_lock;
+    std::vector<void*> m_blocks;
+};
+
+/**
+ * @brief Per-thread block cache. Blocks move between the thread cache and the global pool in
+ * batches, so the global lock is taken once every few allocations, even in producer/consumer
+ * scenarios, where one thread allocates all blobs, and another thread releases them.
+ */
+struct ELogMsgBlobThreadCache {
+    uint32_t m_count[ELOG_MSG_BLOB_SIZE_CLASS_COUNT];
+    void* m_blocks[ELOG_MSG_BLOB_SIZE_CLASS_COUNT][ELOG_MSG_BLOB_THREAD_CACHE_SIZE];
+};
+
+static ELogMsgBlobFreeList sFreeLists[ELOG_MSG_BLOB_SIZE_CLASS_COUNT];
+static ELogTlsKey sThreadCacheKey = ELOG_INVALID_TLS_KEY;
+
+inline size_t getBlockSize(uint32_t sizeClass) {
+    return ((size_t)ELOG_MSG_BLOB_MIN_BLOCK_SIZE) << sizeClass;
+}
+
+inline uint32_t getSizeClass(size_t size) {
+    uint32_t sizeClass = 0;
+    while (sizeClass < ELOG_MSG_BLOB_SIZE_CLASS_COUNT && getBlockSize(sizeClass) < size) {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+static void pushFreeBlocks(uint32_t sizeClass, void** blocks, uint32_t count) {
+    ELogMsgBlobFreeList& freeList = sFreeLists[sizeClass];
+    uint32_t pushCount = 0;
+    {
+        std::unique_lock<std::mutex> lock(freeList.m_lock);
+        if (freeList.m_blocks.size() < ELOG_MSG_BLOB_POOL_MAX) {
+            uint32_t room = (uint32_t)(ELOG_MSG_BLOB_POOL_MAX - freeList.m_blocks.size());
+            pushCount = std::min(count, room);
+            freeList.m_blocks.insert(freeList.m_blocks.end(), blocks, blocks + pushCount);
+        }
+    }
+    for (uint32_t i = pushCount; i < count; ++i) {
+        ::operator delete(blocks[i]);
+    }
+}
+
+static uint32_t popFreeBlocks(uint32_t sizeClass, void** blocks, uint32_t count) {
+    ELogMsgBlobFreeList& freeList = sFreeLists[sizeClass];
+    std::unique_lock<std::mutex> lock(freeList.m_lock);
+    uint32_t popCount = std::min(count, (uint32_t)freeList.m_blocks.size());
+    size_t offset = freeList.m_blocks.size() - popCount;
+    std::copy(freeList.m_blocks.begin() + offset, freeList.m_blocks.end(), blocks);
+    freeList.m_blocks.resize(offset);
+    return popCount;
+}
+
+static void freeThreadCache(void* data) {
+    ELogMsgBlobThreadCache* threadCache = (ELogMsgBlobThreadCache*)data;
+    if (threadCache != nullptr) {
+        for (uint32_t i = 0; i < ELOG_MSG_BLOB_SIZE_CLASS_COUNT; ++i) {
+            pushFreeBlocks(i, threadCache->m_blocks[i], threadCache->m_count[i]);
+        }
+        delete threadCache;
+    }
+}
+
+static ELogMsgBlobThreadCache* getThreadCache() {
+    if (sThreadCacheKey == ELOG_INVALID_TLS_KEY) {
+        // not initialized yet, or already terminated, so only the global pool is used
+        return nullptr;
+    }
+    ELogMsgBlobThreadCache* threadCache = (ELogMsgBlobThreadCache*)elogGetTls(sThreadCacheKey);
+    if (threadCache == nullptr) {
+        threadCache = new (std::nothrow) ELogMsgBlobThreadCache();
+        if (threadCache == nullptr) {
+            return nullptr;
+        }
+        if (!elogSetTls(sThreadCacheKey, threadCache)) {
+            delete threadCache;
+            return nullptr;
+        }
+    }
+    return threadCache;
+}
+
+static void* allocBlock(uint32_t sizeClass) {
+    ELogMsgBlobThreadCache* threadCache = getThreadCache();
+    if (threadCache != nullptr) {
+        uint32_t& count = threadCache->m_count[sizeClass];
+        if (count == 0) {
+            count = popFreeBlocks(sizeClass, threadCache->m_blocks[sizeClass],
+                                  ELOG_MSG_BLOB_TRANSFER_SIZE);
+        }
+        if (count > 0) {
+            return threadCache->m_blocks[sizeClass][--count];
+        }
+    } else {
+        void* block = nullptr;
+        if (popFreeBlocks(sizeClass, &block, 1) == 1) {
+            return block;
+        }
+    }
+    return ::operator new(getBlockSize(sizeClass), std::nothrow);
+}
+
+static void freeBlock(void* block, uint32_t sizeClass) {
+    ELogMsgBlobThreadCache* threadCache = getThreadCache();
+    if (threadCache != nullptr) {
+        uint32_t& count = threadCache->m_count[sizeClass];
+        if (count == ELOG_MSG_BLOB_THREAD_CACHE_SIZE) {
+            // return the oldest blocks to the global pool
+            void** blocks = threadCache->m_blocks[sizeClass];
+            pushFreeBlocks(sizeClass, blocks, ELOG_MSG_BLOB_TRANSFER_SIZE);
+            std::copy(blocks + ELOG_MSG_BLOB_TRANSFER_SIZE, blocks + count, blocks);
+            count -= ELOG_MSG_BLOB_TRANSFER_SIZE;
+        }
+        threadCache->m_blocks[sizeClass][count++] = block;
+    } else {
+        pushFreeBlocks(sizeClass, &block, 1);
+    }
+}
+
+bool ELogMsgBlob::createPoolKey() {
+    if (sThreadCacheKey != ELOG_INVALID_TLS_KEY) {
+        ELOG_REPORT_ERROR("Cannot create message blob pool TLS key, already created");
+        return false;
+    }
+    return elogCreateTls(sThreadCacheKey, freeThreadCache);
+}
+
+bool ELogMsgBlob::destroyPoolKey() {
+    if (sThreadCacheKey == ELOG_INVALID_TLS_KEY) {
+        // silently ignore the request
+        return true;
+    }
+
+    // the TLS destructor is not called for the current thread, so its cache is released here
+    freeThreadCache(elogGetTls(sThreadCacheKey));
+    elogSetTls(sThreadCacheKey, nullptr);
+    bool res = elogDestroyTls(sThreadCacheKey);
+    if (res) {
+        sThreadCacheKey = ELOG_INVALID_TLS_KEY;
+    }
+
+    // release all pooled blocks (blobs still referenced will be returned to the pool later)
+    for (uint32_t i = 0; i < ELOG_MSG_BLOB_SIZE_CLASS_COUNT; ++i) {
+        ELogMsgBlobFreeList& freeList = sFreeLists[i];
+        std::unique_lock<std::mutex> lock(freeList.m_lock);
+        for (void* block : freeList.m_blocks) {
+            ::operator delete(block);
+        }
+        freeList.m_blocks.clear();
+        freeList.m_blocks.shrink_to_fit();
+    }
+    return res;
+}
+
+ELogMsgBlob* ELogMsgBlob::create(const char* msg, uint32_t length) {
+    size_t size = sizeof(ELogMsgBlob) + length + 1;
+    uint32_t sizeClass = getSizeClass(size);
+    void* block = (sizeClass == ELOG_MSG_BLOB_NO_SIZE_CLASS)
+                      ? ::operator new(size, std::nothrow)
+                      : allocBlock(sizeClass);
+    if (block == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate message blob of %zu bytes, out of memory", size);
+        return nullptr;
+    }
+    ELogMsgBlob* msgBlob = new (block) ELogMsgBlob(length, sizeClass);
+    char* data = (char*)(msgBlob + 1);
+    memcpy(data, msg, length);
+    data[length] = 0;
+    return msgBlob;
+}
+
+void ELogMsgBlob::destroy(ELogMsgBlob* msgBlob) {
+    uint32_t sizeClass = msgBlob->m_sizeClass;
+    msgBlob->~ELogMsgBlob();
+    if (sizeClass == ELOG_MSG_BLOB_NO_SIZE_CLASS) {
+        ::operator delete(msgBlob);
+    } else {
+        freeBlock(msgBlob, sizeClass);
+    }
+}
+
+ELogMsgBlob* createLogRecordMsgBlob(const ELogRecord& logRecord) {
+    // NOTE: binary log records may contain nulls in intermediate indices
+    uint32_t length = (logRecord.m_flags & ELOG_RECORD_BINARY)
+                          ? logRecord.m_logMsgLen
+                          : (uint32_t)strlen(logRecord.m_logMsg);
+    return ELogMsgBlob::create(logRecord.m_logMsg, length);
+}
+
+ELogMsgRef acquireLogRecordMsg(const ELogRecord& logRecord) {
+    ELogRenderCache* renderCache = getRenderCache(logRecord);
+    if (renderCache != nullptr) {
+        ELogMsgBlob* msgBlob = renderCache->getMsgBlob();
+        if (msgBlob != nullptr) {
+            msgBlob->addRef();
+        }
+        return ELogMsgRef(msgBlob);
+    }
+    return ELogMsgRef(createLogRecordMsgBlob(logRecord));
+}
+
+}  // namespace elog
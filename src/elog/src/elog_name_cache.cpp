@@ -0,0 +1,143 @@
+#include "elog_name_cache.h"
+
+#include <atomic>
+#include <cstring>
+
+#include "elog_field_selector_internal.h"
+#include "elog_logger.h"
+
+namespace elog {
+
+// generation counters start at 1, so that zeroed cache entries are never valid
+static std::atomic<uint64_t> sThreadNameGeneration(1);
+static std::atomic<uint64_t> sLogSourceGeneration(1);
+
+/** @brief A single name cache entry (occupies two cache lines). */
+struct ELogNameCacheEntry {
+    uint64_t m_generation;
+    uint64_t m_justifyKey;
+    uint32_t m_key;
+    uint32_t m_length;
+    char m_text[ELOG_NAME_CACHE_MAX_TEXT + 1];
+};
+
+/** @brief A direct-mapped cache of rendered names, keyed by id and justification. */
+struct ELogNameCache {
+    ELogNameCacheEntry m_entries[ELOG_NAME_CACHE_SIZE];
+};
+
+static_assert((ELOG_NAME_CACHE_SIZE & (ELOG_NAME_CACHE_SIZE - 1)) == 0,
+              "Name cache size must be a power of 2");
+
+// NOTE: the caches are plain data, so they are zero-initialized without any TLS constructor call
+static thread_local ELogNameCache sThreadNameCache;
+static thread_local ELogNameCache sLogSourceNameCache;
+static thread_local ELogNameCache sLogModuleNameCache;
+
+inline uint64_t getJustifyKey(const ELogJustifySpec& justifySpec) {
+    if (justifySpec.m_mode == ELogJustifyMode::JM_NONE) {
+        return 0;
+    }
+    return (((uint64_t)justifySpec.m_mode) << 32) | justifySpec.m_justify;
+}
+
+inline ELogNameCacheEntry& getCacheEntry(ELogNameCache& cache, uint32_t key,
+                                         uint64_t justifyKey) {
+    // thread/source ids are mostly sequential, so low bits are good enough for direct mapping,
+    // and justification is mixed in so the same name with different justification does not thrash
+    uint32_t index = (key ^ (uint32_t)(justifyKey * 0x9E3779B1ull)) & (ELOG_NAME_CACHE_SIZE - 1);
+    return cache.m_entries[index];
+}
+
+static const char* renderName(ELogNameCacheEntry& entry, uint32_t key, uint64_t generation,
+                              uint64_t justifyKey, const ELogJustifySpec& justifySpec,
+                              const char* name, size_t nameLength, size_t& length) {
+    size_t padding = 0;
+    if (justifySpec.m_mode != ELogJustifyMode::JM_NONE && nameLength < justifySpec.m_justify) {
+        padding = justifySpec.m_justify - nameLength;
+    }
+    if (nameLength + padding > ELOG_NAME_CACHE_MAX_TEXT) {
+        return nullptr;
+    }
+
+    char* pos = entry.m_text;
+    if (justifySpec.m_mode == ELogJustifyMode::JM_RIGHT) {
+        memset(pos, ' ', padding);
+        pos += padding;
+    }
+    memcpy(pos, name, nameLength);
+    pos += nameLength;
+    if (justifySpec.m_mode == ELogJustifyMode::JM_LEFT) {
+        memset(pos, ' ', padding);
+        pos += padding;
+    }
+    *pos = 0;
+
+    entry.m_generation = generation;
+    entry.m_justifyKey = justifyKey;
+    entry.m_key = key;
+    entry.m_length = (uint32_t)(pos - entry.m_text);
+    length = entry.m_length;
+    return entry.m_text;
+}
+
+template <typename F>
+inline const char* getCachedName(ELogNameCache& cache, std::atomic<uint64_t>& generationCounter,
+                                 uint32_t key, const ELogJustifySpec& justifySpec,
+                                 size_t& length, F resolveName) {
+    // NOTE: generation must be sampled before the name is resolved, so that a concurrent rename
+    // (which bumps the generation only after the name was changed) invalidates the entry
+    uint64_t generation = generationCounter.load(std::memory_order_acquire);
+    uint64_t justifyKey = getJustifyKey(justifySpec);
+    ELogNameCacheEntry& entry = getCacheEntry(cache, key, justifyKey);
+    if (entry.m_generation == generation && entry.m_key == key &&
+        entry.m_justifyKey == justifyKey) {
+        length = entry.m_length;
+        return entry.m_text;
+    }
+
+    size_t nameLength = 0;
+    const char* name = resolveName(nameLength);
+    return renderName(entry, key, generation, justifyKey, justifySpec, name, nameLength, length);
+}
+
+const char* getCachedThreadName(uint32_t threadId, const ELogJustifySpec& justifySpec,
+                                size_t& length) {
+    return getCachedName(sThreadNameCache, sThreadNameGeneration, threadId, justifySpec, length,
+                         [threadId](size_t& nameLength) {
+                             const char* threadName = getThreadNameField(threadId);
+                             if (threadName == nullptr) {
+                                 threadName = "";
+                             }
+                             nameLength = strlen(threadName);
+                             return threadName;
+                         });
+}
+
+const char* getCachedLogSourceName(const ELogRecord& logRecord,
+                                   const ELogJustifySpec& justifySpec, size_t& length) {
+    return getCachedName(sLogSourceNameCache, sLogSourceGeneration,
+                         logRecord.m_logger->getLogSource()->getId(), justifySpec, length,
+                         [&logRecord](size_t& nameLength) {
+                             return getLogSourceName(logRecord, nameLength);
+                         });
+}
+
+const char* getCachedLogModuleName(const ELogRecord& logRecord,
+                                   const ELogJustifySpec& justifySpec, size_t& length) {
+    return getCachedName(sLogModuleNameCache, sLogSourceGeneration,
+                         logRecord.m_logger->getLogSource()->getId(), justifySpec, length,
+                         [&logRecord](size_t& nameLength) {
+                             return getLogModuleName(logRecord, nameLength);
+                         });
+}
+
+void invalidateThreadNameCache() {
+    sThreadNameGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void invalidateLogSourceNameCache() {
+    sLogSourceGeneration.fetch_add(1, std::memory_order_release);
+}
+
+}  // namespace elog
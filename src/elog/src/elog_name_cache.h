@@ -0,0 +1,65 @@
+#ifndef __ELOG_NAME_CACHE_H__
+#define __ELOG_NAME_CACHE_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "elog_field_spec.h"
+#include "elog_record.h"
+
+/** @def The number of entries in each per-thread name cache (must be a power of 2). */
+#define ELOG_NAME_CACHE_SIZE 32
+
+/**
+ * @def The maximum rendered name length (including justification padding) that can be held in a
+ * name cache entry. Longer names are not cached.
+ */
+#define ELOG_NAME_CACHE_MAX_TEXT 103
+
+namespace elog {
+
+/**
+ * @brief Retrieves the name of a thread from the calling thread's name cache, rendered according
+ * to the given justification specification (for internal use only). On cache miss the thread name
+ * is looked up in the global thread name map, rendered and cached.
+ * @param threadId The thread identifier.
+ * @param justifySpec The justification to apply. Pass JM_NONE to get the plain thread name.
+ * @param[out] length The rendered name length.
+ * @return The rendered name, or null if it is too long to be cached, in which case the caller
+ * should resolve the name directly. The returned pointer is valid until the next call on the
+ * calling thread.
+ */
+extern const char* getCachedThreadName(uint32_t threadId, const ELogJustifySpec& justifySpec,
+                                       size_t& length);
+
+/**
+ * @brief Retrieves the qualified name of the log source of a log record from the calling thread's
+ * name cache, rendered according to the given justification specification (for internal use
+ * only). See @ref getCachedThreadName() for details.
+ */
+extern const char* getCachedLogSourceName(const ELogRecord& logRecord,
+                                          const ELogJustifySpec& justifySpec, size_t& length);
+
+/**
+ * @brief Retrieves the module name of the log source of a log record from the calling thread's
+ * name cache, rendered according to the given justification specification (for internal use
+ * only). See @ref getCachedThreadName() for details.
+ */
+extern const char* getCachedLogModuleName(const ELogRecord& logRecord,
+                                          const ELogJustifySpec& justifySpec, size_t& length);
+
+/**
+ * @brief Invalidates all cached thread names in all threads (for internal use only). Should be
+ * called after a thread name is installed or removed.
+ */
+extern void invalidateThreadNameCache();
+
+/**
+ * @brief Invalidates all cached log source and module names in all threads (for internal use
+ * only). Should be called after a log source or module name changes.
+ */
+extern void invalidateLogSourceNameCache();
+
+}  // namespace elog
+
+#endif  // __ELOG_NAME_CACHE_H__
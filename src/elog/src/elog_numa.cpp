@@ -0,0 +1,247 @@
+#include "elog_numa.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#ifdef ELOG_LINUX
+#include <pthread.h>
+#include <sched.h>
+#elif defined(ELOG_MINGW)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#endif
+
+#include "elog_report.h"
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogNuma)
+
+struct ELogNumaTopology {
+    // CPUs of each logical node
+    std::vector<std::vector<uint32_t>> m_nodeCpus;
+
+    // logical node of each CPU
+    std::vector<uint32_t> m_cpuNode;
+
+    ELogNumaTopology() { load(); }
+
+    void load();
+    void addNode(const std::vector<uint32_t>& cpus);
+};
+
+void ELogNumaTopology::addNode(const std::vector<uint32_t>& cpus) {
+    uint32_t node = (uint32_t)m_nodeCpus.size();
+    m_nodeCpus.push_back(cpus);
+    for (uint32_t cpu : cpus) {
+        if (cpu >= m_cpuNode.size()) {
+            m_cpuNode.resize(cpu + 1, 0);
+        }
+        m_cpuNode[cpu] = node;
+    }
+}
+
+#ifdef ELOG_LINUX
+static bool readSysFile(const std::string& path, std::string& line) {
+    std::ifstream sysFile(path);
+    if (!sysFile.is_open()) {
+        return false;
+    }
+    return (bool)std::getline(sysFile, line);
+}
+
+void ELogNumaTopology::load() {
+    // online nodes are specified in cpulist format, and may be sparse
+    std::string line;
+    std::vector<uint32_t> nodeIds;
+    if (readSysFile("/sys/devices/system/node/online", line)) {
+        elogParseCpuList(line.c_str(), nodeIds);
+    }
+    for (uint32_t nodeId : nodeIds) {
+        std::vector<uint32_t> cpus;
+        if (readSysFile("/sys/devices/system/node/node" + std::to_string(nodeId) + "/cpulist",
+                        line) &&
+            elogParseCpuList(line.c_str(), cpus) && !cpus.empty()) {
+            // memory-only nodes are skipped
+            addNode(cpus);
+        }
+    }
+}
+#elif defined(ELOG_WINDOWS)
+void ELogNumaTopology::load() {
+    // NOTE: only processor group 0 is supported
+    ULONG highestNode = 0;
+    if (!GetNumaHighestNodeNumber(&highestNode)) {
+        return;
+    }
+    for (ULONG nodeId = 0; nodeId <= highestNode; ++nodeId) {
+        ULONGLONG mask = 0;
+        if (!GetNumaNodeProcessorMask((UCHAR)nodeId, &mask) || mask == 0) {
+            continue;
+        }
+        std::vector<uint32_t> cpus;
+        for (uint32_t cpu = 0; cpu < 64; ++cpu) {
+            if (mask & (1ull << cpu)) {
+                cpus.push_back(cpu);
+            }
+        }
+        addNode(cpus);
+    }
+}
+#else
+void ELogNumaTopology::load() {}
+#endif
+
+static const ELogNumaTopology& getNumaTopology() {
+    static ELogNumaTopology sTopology;
+    return sTopology;
+}
+
+inline int getCurrentCpu() {
+#ifdef ELOG_LINUX
+    return sched_getcpu();
+#elif defined(ELOG_WINDOWS)
+    return (int)GetCurrentProcessorNumber();
+#else
+    return -1;
+#endif
+}
+
+uint32_t elogGetNumaNodeCount() {
+    size_t nodeCount = getNumaTopology().m_nodeCpus.size();
+    return nodeCount > 0 ? (uint32_t)nodeCount : 1;
+}
+
+uint32_t elogGetCurrentNumaNode() {
+    static thread_local uint32_t sNode = 0;
+    static thread_local uint32_t sCallCount = 0;
+    if ((sCallCount++ % ELOG_NUMA_NODE_REFRESH_PERIOD) == 0) {
+        const ELogNumaTopology& topology = getNumaTopology();
+        int cpu = getCurrentCpu();
+        sNode = (cpu >= 0 && (size_t)cpu < topology.m_cpuNode.size()) ? topology.m_cpuNode[cpu]
+                                                                      : 0;
+    }
+    return sNode;
+}
+
+bool elogGetNumaNodeCpus(uint32_t node, std::vector<uint32_t>& cpus) {
+    const ELogNumaTopology& topology = getNumaTopology();
+    if (node >= topology.m_nodeCpus.size()) {
+        return false;
+    }
+    cpus = topology.m_nodeCpus[node];
+    return true;
+}
+
+void elogGetNodeConsumerCpus(uint32_t node, const std::vector<uint32_t>& cpuList,
+                             std::vector<uint32_t>& cpus) {
+    cpus.clear();
+    const ELogNumaTopology& topology = getNumaTopology();
+    for (uint32_t cpu : cpuList) {
+        if (cpu < topology.m_cpuNode.size() && topology.m_cpuNode[cpu] == node) {
+            cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) {
+        elogGetNumaNodeCpus(node, cpus);
+    }
+}
+
+bool elogSetCurrentThreadAffinity(const std::vector<uint32_t>& cpus) {
+    if (cpus.empty()) {
+        ELOG_REPORT_ERROR("Cannot set thread CPU affinity, empty CPU list");
+        return false;
+    }
+#ifdef ELOG_LINUX
+    uint32_t cpuCount = *std::max_element(cpus.begin(), cpus.end()) + 1;
+    cpu_set_t* cpuSet = CPU_ALLOC(cpuCount);
+    if (cpuSet == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate CPU set for %u CPUs", cpuCount);
+        return false;
+    }
+    size_t setSize = CPU_ALLOC_SIZE(cpuCount);
+    CPU_ZERO_S(setSize, cpuSet);
+    for (uint32_t cpu : cpus) {
+        CPU_SET_S(cpu, setSize, cpuSet);
+    }
+    int res = pthread_setaffinity_np(pthread_self(), setSize, cpuSet);
+    CPU_FREE(cpuSet);
+    if (res != 0) {
+        ELOG_REPORT_SYS_ERROR_NUM(pthread_setaffinity_np, res,
+                                  "Failed to set thread CPU affinity");
+        return false;
+    }
+    return true;
+#elif defined(ELOG_WINDOWS)
+    // NOTE: only processor group 0 is supported
+    DWORD_PTR mask = 0;
+    for (uint32_t cpu : cpus) {
+        if (cpu >= sizeof(DWORD_PTR) * 8) {
+            ELOG_REPORT_ERROR("Cannot set thread CPU affinity, CPU %u out of range", cpu);
+            return false;
+        }
+        mask |= ((DWORD_PTR)1) << cpu;
+    }
+    if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+        ELOG_REPORT_WIN32_ERROR(SetThreadAffinityMask, "Failed to set thread CPU affinity");
+        return false;
+    }
+    return true;
+#else
+    ELOG_REPORT_ERROR("Setting thread CPU affinity is not supported on this platform");
+    return false;
+#endif
+}
+
+bool elogParseCpuList(const char* cpuList, std::vector<uint32_t>& cpus) {
+    cpus.clear();
+    const char* pos = cpuList;
+    while (*pos != 0 && *pos != '\n') {
+        char* endPos = nullptr;
+        unsigned long from = strtoul(pos, &endPos, 10);
+        if (endPos == pos) {
+            ELOG_REPORT_ERROR("Invalid CPU list '%s', expecting number at: %s", cpuList, pos);
+            return false;
+        }
+        unsigned long to = from;
+        pos = endPos;
+        if (*pos == '-') {
+            ++pos;
+            to = strtoul(pos, &endPos, 10);
+            if (endPos == pos || to < from) {
+                ELOG_REPORT_ERROR("Invalid CPU list '%s', invalid range end at: %s", cpuList, pos);
+                return false;
+            }
+            pos = endPos;
+        }
+        for (unsigned long cpu = from; cpu <= to; ++cpu) {
+            cpus.push_back((uint32_t)cpu);
+        }
+        if (*pos == ',') {
+            ++pos;
+        } else if (*pos != 0 && *pos != '\n') {
+            ELOG_REPORT_ERROR("Invalid CPU list '%s', unexpected character at: %s", cpuList, pos);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool elogRunOnNumaNode(uint32_t node, const std::function<bool()>& task) {
+    bool res = false;
+    std::thread taskThread([node, &task, &res]() {
+        std::vector<uint32_t> cpus;
+        if (!elogGetNumaNodeCpus(node, cpus) || !elogSetCurrentThreadAffinity(cpus)) {
+            ELOG_REPORT_WARN("Cannot pin thread to NUMA node %u, memory may not be node-local",
+                             node);
+        }
+        res = task();
+    });
+    taskThread.join();
+    return res;
+}
+
+}  // namespace elog
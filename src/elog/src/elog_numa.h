@@ -0,0 +1,76 @@
+#ifndef __ELOG_NUMA_H__
+#define __ELOG_NUMA_H__
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "elog_def.h"
+
+// NOTE: NUMA topology is read from sysfs on Linux (and from the Win32 API on Windows), so there is
+// no dependency on libnuma. node-local memory is obtained by first-touch: memory is allocated and
+// initialized by a thread that is pinned to the CPUs of the target node, so that the kernel places
+// the touched pages on that node (according to the default local allocation policy).
+// NUMA nodes are identified by a logical index in the range [0, node-count), which may differ
+// from the system node id if system node ids are sparse.
+
+/** @def The number of calls after which the cached NUMA node of the current thread is refreshed. */
+#define ELOG_NUMA_NODE_REFRESH_PERIOD 256
+
+namespace elog {
+
+/** @brief Retrieves the number of NUMA nodes (one if NUMA is not supported). */
+extern uint32_t elogGetNumaNodeCount();
+
+/**
+ * @brief Retrieves the NUMA node of the CPU on which the current thread runs. The result is cached
+ * per-thread, and refreshed periodically, since threads may migrate between nodes.
+ */
+extern uint32_t elogGetCurrentNumaNode();
+
+/**
+ * @brief Retrieves the CPUs of a NUMA node.
+ * @param node The logical NUMA node index.
+ * @param[out] cpus The node's CPUs.
+ * @return True if the operation succeeded, otherwise false (invalid node).
+ */
+extern bool elogGetNumaNodeCpus(uint32_t node, std::vector<uint32_t>& cpus);
+
+/**
+ * @brief Selects the CPUs to which a consumer thread serving a NUMA node should be pinned.
+ * @param node The logical NUMA node index.
+ * @param cpuList The configured consumer CPU list. Only CPUs belonging to the node are selected.
+ * If none of them belongs to the node, then all the CPUs of the node are selected.
+ * @param[out] cpus The selected CPUs.
+ */
+extern void elogGetNodeConsumerCpus(uint32_t node, const std::vector<uint32_t>& cpuList,
+                                    std::vector<uint32_t>& cpus);
+
+/**
+ * @brief Pins the current thread to a set of CPUs.
+ * @param cpus The CPUs.
+ * @return True if the operation succeeded, otherwise false.
+ */
+extern bool elogSetCurrentThreadAffinity(const std::vector<uint32_t>& cpus);
+
+/**
+ * @brief Parses a CPU list (e.g. "0-3,8,10-11", as in Linux cpulist format).
+ * @param cpuList The CPU list string.
+ * @param[out] cpus The parsed CPUs.
+ * @return True if the operation succeeded, otherwise false (invalid format).
+ */
+extern bool elogParseCpuList(const char* cpuList, std::vector<uint32_t>& cpus);
+
+/**
+ * @brief Runs a task on a temporary thread pinned to the CPUs of a NUMA node, such that memory
+ * first touched by the task is allocated on that node. If the thread cannot be pinned, the task is
+ * executed anyway (without memory placement guarantee).
+ * @param node The logical NUMA node index.
+ * @param task The task to run.
+ * @return The task's result.
+ */
+extern bool elogRunOnNumaNode(uint32_t node, const std::function<bool()>& task);
+
+}  // namespace elog
+
+#endif  // __ELOG_NUMA_H__
@@ -4,6 +4,13 @@
 
 #include "elog_common.h"
 #include "elog_report.h"
+#include "elog_time.h"
+
+// the number of sharded rate limiters each thread can hold tokens for at the same time
+#define ELOG_RATE_LIMIT_SHARD_CACHE_SIZE 8
+
+// the number of calls after which a thread refreshes its cached time stamp while holding tokens
+#define ELOG_RATE_LIMIT_CLOCK_REFRESH_CALLS 64
 
 namespace elog {
 
@@ -11,12 +18,43 @@ ELOG_DECLARE_REPORT_LOGGER(ELogRateLimitFilter)
 
 ELOG_IMPLEMENT_FILTER(ELogRateLimitFilter)
 
-ELogRateLimitFilter::ELogRateLimitFilter(uint64_t maxMsg /* = 0 */, uint64_t timeout /* = 0 */,
-                                         ELogTimeUnits timeoutUnits /* = ELogTimeUnits::TU_NONE */)
+/** @brief Thread-local token allowance of a sharded rate limiter. */
+struct ELogRateLimitShard {
+    /** @brief The rate limiter owning the shard (zero if unused). */
+    uint64_t m_instanceId;
+
+    /** @brief The interval in which the tokens were acquired. */
+    uint64_t m_intervalId;
+
+    /** @brief The number of tokens left. */
+    uint64_t m_tokenCount;
+
+    /** @brief Cached coarse time stamp (milliseconds). */
+    uint64_t m_tstamp;
+
+    /** @brief The number of calls since the time stamp was last refreshed. */
+    uint64_t m_callCount;
+};
+
+// NOTE: shards are kept in a small direct-mapped thread-local cache, keyed by rate limiter
+// instance id, so no TLS key needs to be allocated per rate limiter (there may be many of these,
+// e.g. one per moderated call site). instance ids are never reused, so a shard cannot be confused
+// with that of a destroyed rate limiter.
+static thread_local ELogRateLimitShard sShards[ELOG_RATE_LIMIT_SHARD_CACHE_SIZE] = {};
+static std::atomic<uint64_t> sNextInstanceId(1);
+
+ELogRateLimitFilter::ELogRateLimitFilter(
+    uint64_t maxMsg /* = 0 */, uint64_t timeout /* = 0 */,
+    ELogTimeUnits timeoutUnits /* = ELogTimeUnits::TU_NONE */, bool sharded /* = false */,
+    uint32_t shardErrorPercent /* = ELOG_DEFAULT_RATE_LIMIT_SHARD_ERROR */)
     : ELogCmpFilter(ELogRateLimitFilter::TYPE_NAME, ELogCmpOp::CMP_OP_EQ),
       m_maxMsg(maxMsg),
       m_timeout(timeout),
       m_timeoutUnits(timeoutUnits),
+      m_sharded(sharded),
+      m_shardErrorPercent(shardErrorPercent),
+      m_shardChunk(1),
+      m_instanceId(sNextInstanceId.fetch_add(1, std::memory_order_relaxed)),
       m_intervalMillis(0),
       m_currIntervalId(0),
       m_currIntervalCount(0),
@@ -24,6 +62,7 @@ ELogRateLimitFilter::ELogRateLimitFilter(uint64_t maxMsg /* = 0 */, uint64_t tim
     if (m_timeout != 0 && m_timeoutUnits != ELogTimeUnits::TU_NONE) {
         prepareInterval();
     }
+    prepareShards();
 }
 
 ELogRateLimitFilter::ELogRateLimitFilter(const ELogRateLimitParams& params)
@@ -31,6 +70,10 @@ ELogRateLimitFilter::ELogRateLimitFilter(const ELogRateLimitParams& params)
       m_maxMsg(params.m_maxMsgs),
       m_timeout(params.m_timeout),
       m_timeoutUnits(params.m_units),
+      m_sharded(params.m_sharded),
+      m_shardErrorPercent(params.m_shardErrorPercent),
+      m_shardChunk(1),
+      m_instanceId(sNextInstanceId.fetch_add(1, std::memory_order_relaxed)),
       m_intervalMillis(0),
       m_currIntervalId(0),
       m_currIntervalCount(0),
@@ -38,6 +81,7 @@ ELogRateLimitFilter::ELogRateLimitFilter(const ELogRateLimitParams& params)
     if (m_timeout != 0 && m_timeoutUnits != ELogTimeUnits::TU_NONE) {
         prepareInterval();
     }
+    prepareShards();
 }
 
 bool ELogRateLimitFilter::prepareInterval() {
@@ -58,8 +102,19 @@ bool ELogRateLimitFilter::prepareInterval() {
     return true;
 }
 
+void ELogRateLimitFilter::prepareShards() {
+    if (m_shardErrorPercent > 100) {
+        ELOG_REPORT_WARN("Rate limiter shard error %u%% truncated to 100%%", m_shardErrorPercent);
+        m_shardErrorPercent = 100;
+    }
+    m_shardChunk = m_maxMsg * m_shardErrorPercent / 100;
+    if (m_shardChunk == 0) {
+        m_shardChunk = 1;
+    }
+}
+
 bool ELogRateLimitFilter::load(const ELogConfigMapNode* filterCfg) {
-    if (!loadIntFilter(filterCfg, "rate", "max_msg", m_maxMsg)) {
+    if (!loadIntFilter(filterCfg, "max_msg", "rate", m_maxMsg)) {
         return false;
     }
 
@@ -70,6 +125,31 @@ bool ELogRateLimitFilter::load(const ELogConfigMapNode* filterCfg) {
     if (!prepareInterval()) {
         return false;
     }
+
+    // sharded mode is optional
+    bool found = false;
+    if (!filterCfg->getBoolValue("sharded", found, m_sharded)) {
+        ELOG_REPORT_ERROR("Failed to get sharded property for rate filter (context: %s)",
+                          filterCfg->getFullContext());
+        return false;
+    }
+    int64_t shardError = 0;
+    if (!filterCfg->getIntValue("shard_error", found, shardError)) {
+        ELOG_REPORT_ERROR("Failed to get shard_error property for rate filter (context: %s)",
+                          filterCfg->getFullContext());
+        return false;
+    }
+    if (found) {
+        if (shardError < 0 || shardError > 100) {
+            ELOG_REPORT_ERROR(
+                "Invalid shard_error property value %" PRId64
+                " for rate filter, expecting percent in range [0, 100] (context: %s)",
+                shardError, filterCfg->getFullContext());
+            return false;
+        }
+        m_shardErrorPercent = (uint32_t)shardError;
+    }
+    prepareShards();
     return true;
 }
 
@@ -128,11 +208,58 @@ bool ELogRateLimitFilter::filterLogRecord(const ELogRecord& logRecord) {
         return true;
     }
 
+    if (m_sharded) {
+        return filterLogRecordSharded();
+    }
+
     // take time stamp from steady/monotonic clock to avoid negative time diffs
     uint64_t tstamp = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
                           std::chrono::steady_clock::now().time_since_epoch())
                           .count();
+    return acquireTokens(tstamp, 1) > 0;
+}
+
+bool ELogRateLimitFilter::filterLogRecordSharded() {
+    // each thread consumes tokens from a local allowance, which is refilled in chunks from the
+    // shared sliding window. the time stamp is taken from the coarse clock and cached, so while the
+    // thread holds tokens, it neither touches shared state nor reads the clock on each call.
+    // tokens are dropped when the interval in which they were acquired ends, so the sliding window
+    // semantics are preserved, except for tokens left unused, which are bounded by the chunk size.
+    ELogRateLimitShard& shard = sShards[m_instanceId % ELOG_RATE_LIMIT_SHARD_CACHE_SIZE];
+    if (shard.m_instanceId != m_instanceId) {
+        // first use, or taken over from another rate limiter (whose tokens are dropped)
+        shard.m_instanceId = m_instanceId;
+        shard.m_intervalId = 0;
+        shard.m_tokenCount = 0;
+        shard.m_callCount = 0;
+    }
 
+    // refresh time stamp when tokens are required, or periodically, so that tokens of an interval
+    // that already ended are not used for too long
+    if (shard.m_tokenCount == 0 || ++shard.m_callCount >= ELOG_RATE_LIMIT_CLOCK_REFRESH_CALLS) {
+        shard.m_callCount = 0;
+        shard.m_tstamp = elogGetSteadyMillisCoarse();
+        if (shard.m_tstamp / m_intervalMillis != shard.m_intervalId) {
+            shard.m_tokenCount = 0;
+        }
+    }
+
+    if (shard.m_tokenCount > 0) {
+        --shard.m_tokenCount;
+        return true;
+    }
+
+    uint64_t tokenCount = acquireTokens(shard.m_tstamp, m_shardChunk);
+    if (tokenCount == 0) {
+        return false;
+    }
+    // one token is consumed by the current call
+    shard.m_intervalId = shard.m_tstamp / m_intervalMillis;
+    shard.m_tokenCount = tokenCount - 1;
+    return true;
+}
+
+uint64_t ELogRateLimitFilter::acquireTokens(uint64_t tstamp, uint64_t maxCount) {
     // we are not expecting negative value here
     uint64_t wholeInterval = tstamp / m_intervalMillis;
     uint64_t currIntervalId = m_currIntervalId.load(std::memory_order_acquire);
@@ -150,10 +277,14 @@ bool ELogRateLimitFilter::filterLogRecord(const ELogRecord& logRecord) {
         if (estimatedCount < m_maxMsg) {
             // NOTE: there might be a small breach here (due to possible sudden thundering herd),
             // but we are ok with that, because this is not a strict rate limiter
-            m_currIntervalCount.fetch_add(1, std::memory_order_release);
-            return true;
+            uint64_t tokenCount = m_maxMsg - estimatedCount;
+            if (tokenCount > maxCount) {
+                tokenCount = maxCount;
+            }
+            m_currIntervalCount.fetch_add(tokenCount, std::memory_order_release);
+            return tokenCount;
         } else {
-            return false;
+            return 0;
         }
     }
 
@@ -170,10 +301,16 @@ bool ELogRateLimitFilter::filterLogRecord(const ELogRecord& logRecord) {
             // otherwise previous interval is zero
             m_prevIntervalCount.store(0, std::memory_order_relaxed);
         }
-        // in any case we count first sample in current interval
-        m_currIntervalCount.store(1, std::memory_order_release);
+        // in any case we count first samples in current interval
+        // NOTE: at least one sample is always granted on a new interval
+        uint64_t tokenCount = maxCount < m_maxMsg ? maxCount : m_maxMsg;
+        if (tokenCount == 0) {
+            tokenCount = 1;
+        }
+        m_currIntervalCount.store(tokenCount, std::memory_order_release);
+        return tokenCount;
     }
-    return true;
+    return 1;
 }
 
 ELogRateLimiter::ELogRateLimiter(uint64_t maxMsg /* = 0 */, uint64_t timeout /* = 0 */,
@@ -0,0 +1,94 @@
+#include "elog_render_cache.h"
+
+#include "elog_logger.h"
+
+namespace elog {
+
+// the render cache of the log record currently being dispatched by this thread
+static thread_local ELogRenderCache* sRenderCache = nullptr;
+
+inline bool isSameTimeSpec(const ELogTimeSpec* lhs, const ELogTimeSpec* rhs) {
+    if (lhs == rhs) {
+        return true;
+    }
+    // distinct formatters may still use the same time format
+    return lhs != nullptr && rhs != nullptr && lhs->m_useLocalTime == rhs->m_useLocalTime &&
+           lhs->m_timeUnits == rhs->m_timeUnits && lhs->m_useTimeZone == rhs->m_useTimeZone &&
+           lhs->m_timeFormat == rhs->m_timeFormat;
+}
+
+inline size_t formatTime(const ELogRecord& logRecord, const ELogTimeSpec* timeSpec,
+                         ELogTimeBuffer& timeBuffer) {
+    if (timeSpec != nullptr) {
+        return elogTimeToString(logRecord.m_logTime, timeBuffer, timeSpec->m_useLocalTime,
+                                timeSpec->m_timeUnits, timeSpec->m_useTimeZone,
+                                timeSpec->m_timeFormat.c_str());
+    }
+    return elogTimeToString(logRecord.m_logTime, timeBuffer);
+}
+
+const char* ELogRenderCache::getTimeString(const ELogTimeSpec* timeSpec, size_t& length) {
+    for (uint32_t i = 0; i < m_timeSlotCount; ++i) {
+        TimeSlot& slot = m_timeSlots[i];
+        if (isSameTimeSpec(slot.m_timeSpec, timeSpec)) {
+            length = slot.m_length;
+            return slot.m_timeBuffer.m_buffer;
+        }
+    }
+
+    // when all slots are used, the last one is recycled
+    uint32_t slotId = m_timeSlotCount;
+    if (slotId < ELOG_RENDER_CACHE_TIME_SLOTS) {
+        ++m_timeSlotCount;
+    } else {
+        slotId = ELOG_RENDER_CACHE_TIME_SLOTS - 1;
+    }
+    TimeSlot& slot = m_timeSlots[slotId];
+    slot.m_timeSpec = timeSpec;
+    slot.m_length = (uint32_t)formatTime(m_logRecord, timeSpec, slot.m_timeBuffer);
+    length = slot.m_length;
+    return slot.m_timeBuffer.m_buffer;
+}
+
+const char* ELogRenderCache::getResolvedMsg(size_t& length) {
+#ifdef ELOG_ENABLE_FMT_LIB
+    if (m_msgState == MsgState::MS_NONE) {
+        m_msgState = ELogLogger::resolveLogRecord(m_logRecord, m_resolvedMsg)
+                         ? MsgState::MS_RESOLVED
+                         : MsgState::MS_FAILED;
+    }
+    if (m_msgState == MsgState::MS_RESOLVED) {
+        length = m_resolvedMsg.getOffset();
+        return m_resolvedMsg.getRef();
+    }
+#endif
+    length = 0;
+    return nullptr;
+}
+
+ELogRenderCache* getRenderCache(const ELogRecord& logRecord) {
+    ELogRenderCache* renderCache = sRenderCache;
+    if (renderCache != nullptr && &renderCache->getLogRecord() == &logRecord) {
+        return renderCache;
+    }
+    return nullptr;
+}
+
+const char* renderLogRecordTime(const ELogRecord& logRecord, const ELogTimeSpec* timeSpec,
+                                ELogTimeBuffer& timeBuffer, size_t& length) {
+    ELogRenderCache* renderCache = getRenderCache(logRecord);
+    if (renderCache != nullptr) {
+        return renderCache->getTimeString(timeSpec, length);
+    }
+    length = formatTime(logRecord, timeSpec, timeBuffer);
+    return timeBuffer.m_buffer;
+}
+
+ELogScopedRenderCache::ELogScopedRenderCache(ELogRenderCache* renderCache)
+    : m_prevRenderCache(sRenderCache) {
+    sRenderCache = renderCache;
+}
+
+ELogScopedRenderCache::~ELogScopedRenderCache() { sRenderCache = m_prevRenderCache; }
+
+}  // namespace elog
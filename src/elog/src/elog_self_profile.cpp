@@ -0,0 +1,178 @@
+#include "elog_self_profile.h"
+
+#include <cinttypes>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "elog_aligned_alloc.h"
+#include "elog_api.h"
+#include "elog_report.h"
+#include "elog_tls.h"
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogSelfProfile)
+
+static const char* sStageNames[ELOG_PROFILE_STAGE_COUNT] = {
+    "finish-log", "filter", "target-log", "target-flush", "format", "gc-recycle"};
+
+#ifdef ELOG_ENABLE_SELF_PROFILE
+/** @brief Per-thread stage counters (single writer, many readers). */
+struct ELOG_CACHE_ALIGN ELogProfileThreadData {
+    volatile uint64_t m_ticks[ELOG_PROFILE_STAGE_COUNT];
+    volatile uint64_t m_callCount[ELOG_PROFILE_STAGE_COUNT];
+
+    ELogProfileThreadData() { reset(); }
+
+    inline void reset() {
+        for (uint32_t i = 0; i < ELOG_PROFILE_STAGE_COUNT; ++i) {
+            m_ticks[i] = 0;
+            m_callCount[i] = 0;
+        }
+    }
+
+    inline void addTo(ELogProfileStats& stats) const {
+        for (uint32_t i = 0; i < ELOG_PROFILE_STAGE_COUNT; ++i) {
+            stats.m_ticks[i] += m_ticks[i];
+            stats.m_callCount[i] += m_callCount[i];
+        }
+    }
+};
+
+static ELogTlsKey sProfileKey = ELOG_INVALID_TLS_KEY;
+
+// registry of live thread counters, and the accumulated counters of terminated threads
+static std::mutex sLock;
+static std::vector<ELogProfileThreadData*> sThreadData;
+static ELogProfileStats sRetiredStats = {};
+
+static void freeThreadData(void* data) {
+    ELogProfileThreadData* threadData = (ELogProfileThreadData*)data;
+    if (threadData != nullptr) {
+        {
+            std::unique_lock<std::mutex> lock(sLock);
+            threadData->addTo(sRetiredStats);
+            for (uint32_t i = 0; i < sThreadData.size(); ++i) {
+                if (sThreadData[i] == threadData) {
+                    sThreadData[i] = sThreadData.back();
+                    sThreadData.pop_back();
+                    break;
+                }
+            }
+        }
+        elogAlignedFreeObject(threadData);
+    }
+}
+
+static ELogProfileThreadData* getThreadData() {
+    if (sProfileKey == ELOG_INVALID_TLS_KEY) {
+        // not initialized yet, or already terminated
+        return nullptr;
+    }
+    ELogProfileThreadData* threadData = (ELogProfileThreadData*)elogGetTls(sProfileKey);
+    if (threadData == nullptr) {
+        // NOTE: failures are not reported, since reporting is itself profiled
+        threadData = elogAlignedAllocObject<ELogProfileThreadData>(ELOG_CACHE_LINE);
+        if (threadData == nullptr) {
+            return nullptr;
+        }
+        if (!elogSetTls(sProfileKey, threadData)) {
+            elogAlignedFreeObject(threadData);
+            return nullptr;
+        }
+        std::unique_lock<std::mutex> lock(sLock);
+        sThreadData.push_back(threadData);
+    }
+    return threadData;
+}
+
+void addProfileTicks(ELogProfileStage stage, uint64_t ticks) {
+    ELogProfileThreadData* threadData = getThreadData();
+    if (threadData != nullptr) {
+        uint32_t stageId = (uint32_t)stage;
+        threadData->m_ticks[stageId] = threadData->m_ticks[stageId] + ticks;
+        threadData->m_callCount[stageId] = threadData->m_callCount[stageId] + 1;
+    }
+}
+
+bool initSelfProfile() {
+    if (sProfileKey != ELOG_INVALID_TLS_KEY) {
+        ELOG_REPORT_ERROR("Cannot create self-profiling TLS key, already created");
+        return false;
+    }
+    return elogCreateTls(sProfileKey, freeThreadData);
+}
+
+void termSelfProfile() {
+    if (sProfileKey == ELOG_INVALID_TLS_KEY) {
+        return;
+    }
+
+    // the TLS destructor is not called for the current thread, so its counters are released here
+    freeThreadData(elogGetTls(sProfileKey));
+    elogSetTls(sProfileKey, nullptr);
+    if (elogDestroyTls(sProfileKey)) {
+        sProfileKey = ELOG_INVALID_TLS_KEY;
+    }
+
+    // counters of threads that are still alive are released as well (not used anymore, since the
+    // TLS key is invalid)
+    std::unique_lock<std::mutex> lock(sLock);
+    for (ELogProfileThreadData* threadData : sThreadData) {
+        elogAlignedFreeObject(threadData);
+    }
+    sThreadData.clear();
+    sRetiredStats = {};
+}
+
+bool isSelfProfileEnabled() { return true; }
+
+void getSelfProfileStats(ELogProfileStats& stats) {
+    std::unique_lock<std::mutex> lock(sLock);
+    stats = sRetiredStats;
+    for (ELogProfileThreadData* threadData : sThreadData) {
+        threadData->addTo(stats);
+    }
+}
+
+void resetSelfProfileStats() {
+    // NOTE: counters of concurrently logging threads may miss a few updates during reset
+    std::unique_lock<std::mutex> lock(sLock);
+    sRetiredStats = {};
+    for (ELogProfileThreadData* threadData : sThreadData) {
+        threadData->reset();
+    }
+}
+#else
+bool initSelfProfile() { return true; }
+
+void termSelfProfile() {}
+
+bool isSelfProfileEnabled() { return false; }
+
+void getSelfProfileStats(ELogProfileStats& stats) { stats = {}; }
+
+void resetSelfProfileStats() {}
+#endif
+
+void reportSelfProfileStats(ELogLevel reportLevel /* = ELEVEL_INFO */) {
+    if (!isSelfProfileEnabled()) {
+        ELOG_REPORT(reportLevel, "Self-profiling is disabled (requires ELOG_ENABLE_SELF_PROFILE)");
+        return;
+    }
+
+    ELogProfileStats stats;
+    getSelfProfileStats(stats);
+    ELOG_REPORT(reportLevel, "Self-profiling statistics (inclusive ticks per stage):");
+    for (uint32_t i = 0; i < ELOG_PROFILE_STAGE_COUNT; ++i) {
+        uint64_t callCount = stats.m_callCount[i];
+        ELOG_REPORT(reportLevel,
+                    "\t%-12s calls: %" PRIu64 ", ticks: %" PRIu64 ", ticks/call: %" PRIu64,
+                    sStageNames[i], callCount, stats.m_ticks[i],
+                    callCount > 0 ? stats.m_ticks[i] / callCount : 0);
+    }
+}
+
+}  // namespace elog
@@ -0,0 +1,67 @@
+#ifndef __ELOG_SELF_PROFILE_H__
+#define __ELOG_SELF_PROFILE_H__
+
+#include <cstdint>
+
+#include "elog_common_def.h"
+
+#ifdef ELOG_ENABLE_SELF_PROFILE
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ELOG_PROFILE_USE_TSC
+#ifdef ELOG_MSVC
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#include <chrono>
+#endif
+#endif
+
+namespace elog {
+
+/** @brief Initializes the self-profiling thread local storage. */
+extern bool initSelfProfile();
+
+/** @brief Terminates the self-profiling thread local storage. */
+extern void termSelfProfile();
+
+#ifdef ELOG_ENABLE_SELF_PROFILE
+/** @brief Adds the ticks of a single call of a pipeline stage to the current thread's counters. */
+extern void addProfileTicks(ELogProfileStage stage, uint64_t ticks);
+
+/** @brief Reads the profiling clock. */
+inline uint64_t getProfileTicks() {
+#ifdef ELOG_PROFILE_USE_TSC
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+/** @brief Scoped timer of a single pipeline stage. */
+class ELogProfileScope {
+public:
+    explicit ELogProfileScope(ELogProfileStage stage)
+        : m_stage(stage), m_startTicks(getProfileTicks()) {}
+    ELogProfileScope(const ELogProfileScope&) = delete;
+    ELogProfileScope(ELogProfileScope&&) = delete;
+    ELogProfileScope& operator=(const ELogProfileScope&) = delete;
+    ~ELogProfileScope() { addProfileTicks(m_stage, getProfileTicks() - m_startTicks); }
+
+private:
+    ELogProfileStage m_stage;
+    uint64_t m_startTicks;
+};
+
+/** @def Measures the time spent in the enclosing scope as part of a pipeline stage. */
+#define ELOG_PROFILE_SCOPE(stage) elog::ELogProfileScope profileScope(stage)
+#else
+#define ELOG_PROFILE_SCOPE(stage)
+#endif
+
+}  // namespace elog
+
+#endif  // __ELOG_SELF_PROFILE_H__
@@ -1,5 +1,6 @@
 #include "elog_source.h"
 
+#include "elog_name_cache.h"
 #include "elog_private_logger.h"
 #include "elog_shared_logger.h"
 #include "elog_target.h"
@@ -14,6 +15,7 @@ ELogSource::ELogSource(ELogSourceId sourceId, const char* name, ELogSource* pare
       m_parent(parent),
       m_logLevel(logLevel),
       m_logTargetAffinityMask(ELOG_ALL_TARGET_AFFINITY_MASK) {
+    elogGetCurrentTime(m_creationTime);
     if (parent != nullptr) {
         const char* parentQName = parent->getQualifiedName();
         if (*parentQName == 0) {
@@ -41,6 +43,13 @@ ELogSource::~ELogSource() {
     }
 }
 
+void ELogSource::setModuleName(const char* moduleName) {
+    m_moduleName = moduleName;
+
+    // formatting threads may have cached the previous module name
+    invalidateLogSourceNameCache();
+}
+
 bool ELogSource::addChild(ELogSource* logSource) {
     return m_children.insert(ChildMap::value_type(logSource->getName(), logSource)).second;
 }
@@ -0,0 +1,262 @@
+#include "elog_spill_file.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <filesystem>
+
+#include "elog_common.h"
+#include "elog_report.h"
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogSpillFile)
+
+bool ELogSpillFile::open(const char* dirPath, uint64_t segmentSizeBytes, uint64_t limitBytes) {
+    m_dirPath = dirPath;
+    m_segmentSizeBytes = segmentSizeBytes;
+    m_limitBytes = limitBytes;
+    m_sizeBytes = 0;
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_dirPath, ec);
+    if (ec) {
+        ELOG_REPORT_ERROR("Failed to create spill directory %s: %s", dirPath,
+                          ec.message().c_str());
+        return false;
+    }
+
+    // pick up segments left over from previous run
+    std::vector<uint64_t> segmentIds;
+    if (!scanSegments(segmentIds)) {
+        return false;
+    }
+    for (uint64_t segmentId : segmentIds) {
+        uint64_t fileSize = std::filesystem::file_size(getSegmentPath(segmentId), ec);
+        if (!ec) {
+            m_sizeBytes += fileSize;
+        }
+    }
+    if (!segmentIds.empty()) {
+        m_readSegmentId = segmentIds.front();
+        m_writeSegmentId = segmentIds.back();
+        ELOG_REPORT_INFO("Found %zu spill segments in %s, with total size of %" PRIu64 " bytes",
+                         segmentIds.size(), dirPath, m_sizeBytes);
+    } else {
+        // first segment to be written is 1 (see append())
+        m_readSegmentId = 1;
+        m_writeSegmentId = 0;
+    }
+    m_readOffset = 0;
+    m_peekSize = 0;
+
+    // NOTE: writing always starts in a new segment (see append()), so a possibly corrupt tail of
+    // the last segment from previous run is left intact
+    return true;
+}
+
+void ELogSpillFile::close() {
+    if (m_readFile != nullptr) {
+        fclose(m_readFile);
+        m_readFile = nullptr;
+    }
+    if (m_writeFile != nullptr) {
+        fclose(m_writeFile);
+        m_writeFile = nullptr;
+    }
+}
+
+bool ELogSpillFile::append(const char* data, uint32_t length) {
+    uint64_t recordSize = sizeof(RecordHeader) + length;
+    if (m_sizeBytes + recordSize > m_limitBytes) {
+        return false;
+    }
+
+    // start a new segment if needed
+    if (m_writeFile == nullptr ||
+        (m_writeOffset > 0 && m_writeOffset + recordSize > m_segmentSizeBytes)) {
+        if (m_writeFile != nullptr) {
+            fclose(m_writeFile);
+            m_writeFile = nullptr;
+        }
+        if (!openWriteSegment(m_writeSegmentId + 1)) {
+            return false;
+        }
+    }
+
+    // flush each record so it is immediately visible to the reader
+    RecordHeader header = {ELOG_SPILL_RECORD_MAGIC, length};
+    if (fwrite(&header, sizeof(header), 1, m_writeFile) != 1 ||
+        fwrite(data, 1, length, m_writeFile) != length || fflush(m_writeFile) != 0) {
+        ELOG_REPORT_SYS_ERROR(fwrite, "Failed to write %u bytes to spill segment %s", length,
+                              getSegmentPath(m_writeSegmentId).c_str());
+        // the segment tail may be corrupt, so continue with a new segment (the reader will skip
+        // the corrupt tail)
+        fclose(m_writeFile);
+        m_writeFile = nullptr;
+        return false;
+    }
+    m_writeOffset += recordSize;
+    m_sizeBytes += recordSize;
+    return true;
+}
+
+bool ELogSpillFile::peek(std::vector<char>& record) {
+    while (m_sizeBytes > 0) {
+        if (m_readFile == nullptr && !openReadSegment()) {
+            return false;
+        }
+
+        RecordHeader header = {};
+        if (fseek(m_readFile, (long)m_readOffset, SEEK_SET) != 0) {
+            ELOG_REPORT_SYS_ERROR(fseek, "Failed to seek in spill segment %s",
+                                  getSegmentPath(m_readSegmentId).c_str());
+            return false;
+        }
+        size_t count = fread(&header, sizeof(header), 1, m_readFile);
+        if (count == 0 && feof(m_readFile)) {
+            if (m_readSegmentId == m_writeSegmentId) {
+                // all records were read
+                return false;
+            }
+            // done with this segment
+            removeReadSegment();
+            continue;
+        }
+
+        // verify record is intact
+        bool valid = (count == 1 && header.m_magic == ELOG_SPILL_RECORD_MAGIC);
+        if (valid) {
+            record.resize(header.m_length);
+            valid = (header.m_length == 0 ||
+                     fread(&record[0], 1, header.m_length, m_readFile) == header.m_length);
+        }
+        if (!valid) {
+            ELOG_REPORT_ERROR("Corrupt record at offset %" PRIu64
+                              " of spill segment %s, skipping rest of segment",
+                              m_readOffset, getSegmentPath(m_readSegmentId).c_str());
+            std::error_code ec;
+            uint64_t fileSize =
+                std::filesystem::file_size(getSegmentPath(m_readSegmentId), ec);
+            if (!ec && fileSize > m_readOffset) {
+                m_sizeBytes -= std::min(fileSize - m_readOffset, m_sizeBytes);
+            }
+            removeReadSegment();
+            continue;
+        }
+
+        m_peekSize = sizeof(RecordHeader) + header.m_length;
+        return true;
+    }
+    return false;
+}
+
+void ELogSpillFile::consume() {
+    m_readOffset += m_peekSize;
+    m_sizeBytes -= std::min(m_peekSize, m_sizeBytes);
+    m_peekSize = 0;
+
+    // reclaim disk space as soon as everything was consumed
+    if (m_sizeBytes == 0) {
+        removeReadSegment();
+    }
+}
+
+std::string ELogSpillFile::getSegmentPath(uint64_t segmentId) const {
+    char name[64];
+    snprintf(name, sizeof(name), "%s%010" PRIu64 "%s", ELOG_SPILL_SEGMENT_PREFIX, segmentId,
+             ELOG_SPILL_SEGMENT_SUFFIX);
+    return (std::filesystem::path(m_dirPath) / name).string();
+}
+
+bool ELogSpillFile::scanSegments(std::vector<uint64_t>& segmentIds) {
+    const size_t prefixLen = strlen(ELOG_SPILL_SEGMENT_PREFIX);
+    const size_t suffixLen = strlen(ELOG_SPILL_SEGMENT_SUFFIX);
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(m_dirPath, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.length() <= prefixLen + suffixLen ||
+            name.compare(0, prefixLen, ELOG_SPILL_SEGMENT_PREFIX) != 0 ||
+            name.compare(name.length() - suffixLen, suffixLen, ELOG_SPILL_SEGMENT_SUFFIX) != 0) {
+            continue;
+        }
+        std::string idStr = name.substr(prefixLen, name.length() - prefixLen - suffixLen);
+        char* endPtr = nullptr;
+        uint64_t segmentId = strtoull(idStr.c_str(), &endPtr, 10);
+        if (endPtr == nullptr || *endPtr != 0) {
+            continue;
+        }
+        segmentIds.push_back(segmentId);
+    }
+    if (ec) {
+        ELOG_REPORT_ERROR("Failed to list spill directory %s: %s", m_dirPath.c_str(),
+                          ec.message().c_str());
+        return false;
+    }
+    std::sort(segmentIds.begin(), segmentIds.end());
+    return true;
+}
+
+bool ELogSpillFile::openWriteSegment(uint64_t segmentId) {
+    std::string segmentPath = getSegmentPath(segmentId);
+    m_writeFile = elog_fopen(segmentPath.c_str(), "ab");
+    if (m_writeFile == nullptr) {
+        ELOG_REPORT_SYS_ERROR(fopen, "Failed to open spill segment %s for writing",
+                              segmentPath.c_str());
+        return false;
+    }
+    if (fseek(m_writeFile, 0, SEEK_END) != 0) {
+        ELOG_REPORT_SYS_ERROR(fseek, "Failed to seek to end of spill segment %s",
+                              segmentPath.c_str());
+        fclose(m_writeFile);
+        m_writeFile = nullptr;
+        return false;
+    }
+    m_writeOffset = (uint64_t)ftell(m_writeFile);
+    m_writeSegmentId = segmentId;
+    return true;
+}
+
+bool ELogSpillFile::openReadSegment() {
+    while (m_readFile == nullptr) {
+        std::string segmentPath = getSegmentPath(m_readSegmentId);
+        std::error_code ec;
+        if (m_readSegmentId < m_writeSegmentId && !std::filesystem::exists(segmentPath, ec)) {
+            // segment was removed externally, skip it
+            ++m_readSegmentId;
+            m_readOffset = 0;
+            continue;
+        }
+        m_readFile = elog_fopen(segmentPath.c_str(), "rb");
+        if (m_readFile == nullptr) {
+            ELOG_REPORT_SYS_ERROR(fopen, "Failed to open spill segment %s for reading",
+                                  segmentPath.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+void ELogSpillFile::removeReadSegment() {
+    if (m_readFile != nullptr) {
+        fclose(m_readFile);
+        m_readFile = nullptr;
+    }
+
+    // when the write segment is removed, writing continues in a new segment
+    if (m_readSegmentId == m_writeSegmentId && m_writeFile != nullptr) {
+        fclose(m_writeFile);
+        m_writeFile = nullptr;
+    }
+
+    std::string segmentPath = getSegmentPath(m_readSegmentId);
+    std::error_code ec;
+    if (!std::filesystem::remove(segmentPath, ec) && ec) {
+        ELOG_REPORT_ERROR("Failed to remove spill segment %s: %s", segmentPath.c_str(),
+                          ec.message().c_str());
+    }
+    ++m_readSegmentId;
+    m_readOffset = 0;
+}
+
+}  // namespace elog
@@ -0,0 +1,110 @@
+#ifndef __ELOG_SPILL_FILE_H__
+#define __ELOG_SPILL_FILE_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "elog_def.h"
+
+/** @def Magic word preceding each record in a spill file segment ("ELSP"). */
+#define ELOG_SPILL_RECORD_MAGIC 0x50534C45u
+
+/** @def Name prefix of spill file segments. */
+#define ELOG_SPILL_SEGMENT_PREFIX "elog_spill."
+
+/** @def Name suffix of spill file segments. */
+#define ELOG_SPILL_SEGMENT_SUFFIX ".dat"
+
+namespace elog {
+
+/**
+ * @brief An append-only on-disk FIFO of opaque records, made of a sequence of segment files in a
+ * dedicated directory. Records are appended to the last segment, and read back in order from the
+ * first segment. Fully consumed segments are deleted. Segments left over from a previous run are
+ * picked up when the spill file is opened, so their records are replayed as well (records of a
+ * partially consumed segment may be replayed twice).
+ * @note This class is not thread-safe.
+ */
+class ELogSpillFile {
+public:
+    ELogSpillFile()
+        : m_segmentSizeBytes(0),
+          m_limitBytes(0),
+          m_readSegmentId(0),
+          m_writeSegmentId(0),
+          m_readFile(nullptr),
+          m_writeFile(nullptr),
+          m_readOffset(0),
+          m_writeOffset(0),
+          m_peekSize(0),
+          m_sizeBytes(0) {}
+    ELogSpillFile(const ELogSpillFile&) = delete;
+    ELogSpillFile(ELogSpillFile&&) = delete;
+    ELogSpillFile& operator=(const ELogSpillFile&) = delete;
+    ~ELogSpillFile() { close(); }
+
+    /**
+     * @brief Opens the spill file, creating the directory if needed.
+     * @param dirPath The directory containing all spill file segments.
+     * @param segmentSizeBytes The size of each segment, after which a new segment is started.
+     * @param limitBytes The total size limit of all segments.
+     * @return The operation result.
+     */
+    bool open(const char* dirPath, uint64_t segmentSizeBytes, uint64_t limitBytes);
+
+    /** @brief Closes the spill file. Records not consumed yet remain on disk. */
+    void close();
+
+    /**
+     * @brief Appends a record to the spill file.
+     * @return True if succeeded, or false if the size limit has been reached or an I/O error
+     * occurred.
+     */
+    bool append(const char* data, uint32_t length);
+
+    /**
+     * @brief Reads the next record in the spill file without consuming it.
+     * @param[out] record The record data.
+     * @return True if a record was read, or false if the spill file is empty.
+     */
+    bool peek(std::vector<char>& record);
+
+    /** @brief Consumes the record last returned by @ref peek(). */
+    void consume();
+
+    /** @brief Queries whether the spill file contains no records. */
+    inline bool isEmpty() const { return m_sizeBytes == 0; }
+
+    /** @brief Retrieves the total size of records not consumed yet. */
+    inline uint64_t getSizeBytes() const { return m_sizeBytes; }
+
+private:
+    std::string m_dirPath;
+    uint64_t m_segmentSizeBytes;
+    uint64_t m_limitBytes;
+    uint64_t m_readSegmentId;
+    uint64_t m_writeSegmentId;
+    FILE* m_readFile;
+    FILE* m_writeFile;
+    uint64_t m_readOffset;
+    uint64_t m_writeOffset;
+    uint64_t m_peekSize;
+    uint64_t m_sizeBytes;
+
+    struct RecordHeader {
+        uint32_t m_magic;
+        uint32_t m_length;
+    };
+
+    std::string getSegmentPath(uint64_t segmentId) const;
+    bool scanSegments(std::vector<uint64_t>& segmentIds);
+    bool openWriteSegment(uint64_t segmentId);
+    bool openReadSegment();
+    void removeReadSegment();
+};
+
+}  // namespace elog
+
+#endif  // __ELOG_SPILL_FILE_H__
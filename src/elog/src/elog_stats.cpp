@@ -1,6 +1,7 @@
 #include "elog_stats.h"
 
 #include <cinttypes>
+#include <cstring>
 
 #include "elog_aligned_alloc.h"
 #include "elog_internal.h"
@@ -108,36 +109,69 @@ void freeThreadSlotId(uint64_t slotId) {
 }
 
 bool ELogStatVar::initialize(uint32_t maxThreads) {
-    m_threadCounters = elogAlignedAllocObjectArray<ELogCounter>(ELOG_CACHE_LINE, maxThreads);
-    if (m_threadCounters == nullptr) {
+    ELogCounter* counters = elogAlignedAllocObjectArray<ELogCounter>(ELOG_CACHE_LINE, maxThreads);
+    if (counters == nullptr) {
         ELOG_REPORT_ERROR(
             "Failed to allocate statistics variable counter array for %u threads, out of memory",
             maxThreads);
         return false;
     }
-    m_maxThreads = maxThreads;
+    bind(counters, sizeof(ELogCounter), maxThreads);
+    m_ownsCounters = true;
     return true;
 }
 
+void ELogStatVar::bind(ELogCounter* firstCounter, uint32_t stride, uint32_t maxThreads) {
+    m_counters = (char*)firstCounter;
+    m_stride = stride;
+    m_maxThreads = maxThreads;
+    m_ownsCounters = false;
+}
+
 void ELogStatVar::terminate() {
-    if (m_threadCounters != nullptr) {
-        elogAlignedFreeObjectArray<ELogCounter>(m_threadCounters, m_maxThreads);
-        m_threadCounters = nullptr;
+    if (m_counters != nullptr && m_ownsCounters) {
+        elogAlignedFreeObjectArray<ELogCounter>((ELogCounter*)m_counters, m_maxThreads);
     }
+    m_counters = nullptr;
+    m_ownsCounters = false;
 }
 
 bool ELogStats::initialize(uint32_t maxThreads) {
-    if (!m_msgDiscarded.initialize(maxThreads) || !m_msgSubmitted.initialize(maxThreads) ||
-        !m_msgWritten.initialize(maxThreads) || !m_msgFailWrite.initialize(maxThreads) ||
-        !m_bytesSubmitted.initialize(maxThreads) || !m_bytesWritten.initialize(maxThreads) ||
-        !m_bytesFailWrite.initialize(maxThreads) || !m_flushSubmitted.initialize(maxThreads) ||
-        !m_flushExecuted.initialize(maxThreads) || !m_flushFailed.initialize(maxThreads) ||
-        !m_flushDiscarded.initialize(maxThreads)) {
-        ELOG_REPORT_ERROR("Failed to initialize statistics variables");
-        terminate();
+    // each thread block is padded to a whole number of cache lines
+    size_t blockSize = m_varCount * sizeof(ELogCounter);
+    blockSize = (blockSize + ELOG_CACHE_LINE - 1) / ELOG_CACHE_LINE * ELOG_CACHE_LINE;
+    m_threadBlocks = (char*)elogAlignedAlloc(blockSize * maxThreads, ELOG_CACHE_LINE);
+    if (m_threadBlocks == nullptr) {
+        ELOG_REPORT_ERROR(
+            "Failed to allocate statistics counter blocks for %u threads, out of memory",
+            maxThreads);
         return false;
     }
+    memset(m_threadBlocks, 0, blockSize * maxThreads);
+    m_blockSize = (uint32_t)blockSize;
+    m_maxThreads = maxThreads;
+    m_boundVarCount = 0;
 
+    // bind counters (cannot fail, since the base variables are always accounted for)
+    bindStatVar(m_msgDiscarded);
+    bindStatVar(m_msgSubmitted);
+    bindStatVar(m_msgWritten);
+    bindStatVar(m_msgFailWrite);
+
+    bindStatVar(m_bytesSubmitted);
+    bindStatVar(m_bytesWritten);
+    bindStatVar(m_bytesFailWrite);
+
+    bindStatVar(m_flushSubmitted);
+    bindStatVar(m_flushExecuted);
+    bindStatVar(m_flushFailed);
+    bindStatVar(m_flushDiscarded);
+
+    if (!m_writeLatency.initialize(maxThreads) || !m_flushLatency.initialize(maxThreads) ||
+        !m_queueResidence.initialize(maxThreads) || !m_batchSize.initialize(maxThreads)) {
+        terminate();
+        return false;
+    }
     return true;
 }
 
@@ -155,6 +189,46 @@ void ELogStats::terminate() {
     m_flushExecuted.terminate();
     m_flushFailed.terminate();
     m_flushDiscarded.terminate();
+
+    m_writeLatency.terminate();
+    m_flushLatency.terminate();
+    m_queueResidence.terminate();
+    m_batchSize.terminate();
+
+    freeThreadBlocks();
+}
+
+bool ELogStats::bindStatVar(ELogStatVar& statVar) {
+    if (m_boundVarCount == m_varCount) {
+        ELOG_REPORT_ERROR(
+            "Cannot bind statistics variable, all %u counters are bound (the number of variables "
+            "in derived class was not declared correctly)",
+            m_varCount);
+        return false;
+    }
+    ELogCounter* firstCounter = ((ELogCounter*)m_threadBlocks) + m_boundVarCount++;
+    statVar.bind(firstCounter, m_blockSize, m_maxThreads);
+    return true;
+}
+
+void ELogStats::freeThreadBlocks() {
+    if (m_threadBlocks != nullptr) {
+        elogAlignedFree(m_threadBlocks);
+        m_threadBlocks = nullptr;
+    }
+}
+
+static void printHistogram(ELogBuffer& buffer, const ELogHistogram& histogram, const char* msg) {
+    ELogHistogramSnapshot snapshot;
+    histogram.getSnapshot(snapshot);
+    if (snapshot.m_count > 0) {
+        buffer.appendArgs("\t%s: count=%" PRIu64 ", mean=%" PRIu64 ", p50=%" PRIu64
+                          ", p90=%" PRIu64 ", p99=%" PRIu64 ", p99.9=%" PRIu64 ", max=%" PRIu64
+                          "\n",
+                          msg, snapshot.m_count, snapshot.getMean(), snapshot.getPercentile(50.0),
+                          snapshot.getPercentile(90.0), snapshot.getPercentile(99.0),
+                          snapshot.getPercentile(99.9), snapshot.m_max);
+    }
 }
 
 void ELogStats::toString(ELogBuffer& buffer, ELogTarget* logTarget, const char* msg /* = "" */) {
@@ -187,6 +261,11 @@ void ELogStats::toString(ELogBuffer& buffer, ELogTarget* logTarget, const char*
     PRINT_STAT(m_flushExecuted, "Flush requests executed");
     PRINT_STAT(m_flushFailed, "Flush requests failed write");
     PRINT_STAT(m_flushDiscarded, "Flush requests discarded");
+
+    printHistogram(buffer, m_writeLatency, "Write latency (ns)");
+    printHistogram(buffer, m_flushLatency, "Flush latency (ns)");
+    printHistogram(buffer, m_queueResidence, "Queue residence (ns)");
+    printHistogram(buffer, m_batchSize, "Batch size (records)");
 }
 
 uint64_t ELogStats::getSlotId() {
@@ -225,6 +304,11 @@ void ELogStats::resetThreadCounters(uint64_t slotId) {
     m_flushExecuted.reset(slotId);
     m_flushFailed.reset(slotId);
     m_flushDiscarded.reset(slotId);
+
+    m_writeLatency.reset(slotId);
+    m_flushLatency.reset(slotId);
+    m_queueResidence.reset(slotId);
+    m_batchSize.reset(slotId);
 }
 
 }  // namespace elog
\ No newline at end of file
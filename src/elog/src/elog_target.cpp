@@ -1,6 +1,8 @@
 #include "elog_target.h"
 
+#include <cinttypes>
 #include <random>
+#include <thread>
 
 #include "elog_aligned_alloc.h"
 #include "elog_api.h"
@@ -10,9 +12,23 @@
 #include "elog_flush_policy.h"
 #include "elog_formatter.h"
 #include "elog_internal.h"
+#include "elog_render_cache.h"
 #include "elog_report.h"
+#include "elog_self_profile.h"
+#include "elog_time.h"
 #include "elog_tls.h"
 
+// the number of times a thread waiting for its published log record to be written yields before
+// retracting the log record and pushing it to the backlog queue
+#define ELOG_COMBINE_MAX_SPIN 256
+
+// the number of times a thread waiting for its published log record to be written yields between
+// attempts to acquire the log target lock
+#define ELOG_COMBINE_LOCK_RETRY 8
+
+// marks a published log record that is being written by the lock holder
+#define ELOG_COMBINE_CLAIMED ((const ELogRecord*)(uintptr_t)1)
+
 namespace elog {
 
 ELOG_DECLARE_REPORT_LOGGER(ELogTarget)
@@ -21,6 +37,31 @@ ELOG_IMPLEMENT_LOG_TARGET(ELogCombinedTarget)
 
 static ELogTlsKey sLogBufferKey = ELOG_INVALID_TLS_KEY;
 
+// NOTE: wall clock is used (rather than steady clock), so that it can be compared with log record
+// time for queue residence computation
+inline uint64_t getStatsTimeNanos() { return getCurrentTimeEpoch<std::chrono::nanoseconds>(); }
+
+inline uint64_t getElapsedNanos(uint64_t startNanos, uint64_t endNanos) {
+    // wall clock may go backwards
+    return endNanos > startNanos ? endNanos - startNanos : 0;
+}
+
+// latency histograms require two clock reads per log record, so they are disabled by default, and
+// when enabled only one in every N log records (per thread) is measured
+inline bool shouldSampleLatency() {
+    uint32_t sampleRate =
+        getParams().m_statsLatencySampleRate.m_atomicValue.load(std::memory_order_relaxed);
+    if (sampleRate == 0) {
+        return false;
+    }
+    static thread_local uint32_t sLatencySampleCounter = 0;
+    if (++sLatencySampleCounter < sampleRate) {
+        return false;
+    }
+    sLatencySampleCounter = 0;
+    return true;
+}
+
 inline ELogBuffer* allocLogBuffer() {
     // ELogBuffer* logBuffer = new (std::align_val_t(ELOG_CACHE_LINE), std::nothrow) ELogBuffer();
     return elogAlignedAllocObject<ELogBuffer>(ELOG_CACHE_LINE);
@@ -61,6 +102,7 @@ ELogTarget::~ELogTarget() {
         delete m_stats;
         m_stats = nullptr;
     }
+    freeCombineSlots();
 }
 
 bool ELogTarget::createLogBufferKey() {
@@ -99,6 +141,13 @@ bool ELogTarget::startNoLock() {
                           m_name.c_str());
         return false;
     }
+    if (m_flatCombining && m_requiresLock && m_combineSlots == nullptr) {
+        if (!allocCombineSlots()) {
+            ELOG_REPORT_ERROR("Cannot start log target %s/%s, failed to allocate combining slots",
+                              m_typeName.c_str(), m_name.c_str());
+            return false;
+        }
+    }
     if (m_enableStats && m_stats == nullptr) {
         m_stats = createStats();
         if (m_stats == nullptr) {
@@ -172,11 +221,18 @@ bool ELogTarget::stopNoLock() {
 }
 
 void ELogTarget::log(const ELogRecord& logRecord) {
+    ELOG_PROFILE_SCOPE(ELogProfileStage::PS_TARGET_LOG);
     if (!m_requiresLock) {
         logNoLock(logRecord);
         return;
     }
 
+    // in flat-combining mode, threads that fail to acquire the lock publish their log record and
+    // let the lock holder write it
+    if (m_combineSlots != nullptr && logCombining(logRecord)) {
+        return;
+    }
+
     // in order to avoid complex deadlocks, we first do a try-lock and if failed put the message in
     // a backlog queue and back off. then occasionally someone checks the backlog queue and drains
     // it under lock (another lock), and print the queued messages
@@ -194,39 +250,162 @@ void ELogTarget::log(const ELogRecord& logRecord) {
     }
 }
 
+bool ELogTarget::allocCombineSlots() {
+    m_combineSlotCount = elog::getMaxThreads();
+    m_combineSlots = elogAlignedAllocObjectArray<CombineSlot>(ELOG_CACHE_LINE, m_combineSlotCount);
+    if (m_combineSlots == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate %" PRIu64 " flat-combining slots for log target",
+                          m_combineSlotCount);
+        m_combineSlotCount = 0;
+        return false;
+    }
+    return true;
+}
+
+void ELogTarget::freeCombineSlots() {
+    if (m_combineSlots != nullptr) {
+        elogAlignedFreeObjectArray(m_combineSlots, m_combineSlotCount);
+        m_combineSlots = nullptr;
+        m_combineSlotCount = 0;
+    }
+}
+
+bool ELogTarget::logCombining(const ELogRecord& logRecord) {
+    uint64_t slotId = ELogStats::getSlotId();
+    if (slotId == ELOG_INVALID_STAT_SLOT_ID || slotId >= m_combineSlotCount) {
+        // no slot, so fall back to try-lock/backlog
+        return false;
+    }
+    CombineSlot& slot = m_combineSlots[slotId];
+    uint64_t slotHigh = m_combineSlotHigh.load(std::memory_order_relaxed);
+    while (slotHigh <= slotId &&
+           !m_combineSlotHigh.compare_exchange_weak(slotHigh, slotId + 1,
+                                                    std::memory_order_relaxed)) {
+    }
+
+    // NOTE: the log record is published by address, since this thread waits until it is written
+    // (the render cache is matched by record address, so it is safe to use by the lock holder)
+    slot.m_logRecord.store(&logRecord, std::memory_order_release);
+    for (uint32_t spinCount = 0;; ++spinCount) {
+        if ((spinCount % ELOG_COMBINE_LOCK_RETRY) == 0 && m_lock.try_lock()) {
+            // records of this thread that were previously pushed to the backlog are written first,
+            // so that per-thread record order is kept
+            if (m_backlogSize.load(std::memory_order_relaxed) > 0) {
+                drainBacklog();
+            }
+
+            // retract own log record, unless it was already written by the previous lock holder
+            // (records are claimed and released only under lock, so it cannot be claimed now)
+            uint64_t recordCount = 0;
+            const ELogRecord* ownRecord = &logRecord;
+            if (slot.m_logRecord.compare_exchange_strong(ownRecord, nullptr,
+                                                         std::memory_order_acq_rel)) {
+                logNoLock(logRecord);
+                ++recordCount;
+            }
+            recordCount += combineLogRecords();
+            if (recordCount > 1) {
+                recordBatchSize(recordCount);
+            }
+            if (m_backlogSize.load(std::memory_order_relaxed) > 0) {
+                drainBacklog();
+            }
+            m_lock.unlock();
+            return true;
+        }
+
+        if (slot.m_logRecord.load(std::memory_order_acquire) == nullptr) {
+            // written by lock holder
+            return true;
+        }
+
+        // in order to avoid complex deadlocks (e.g. lock holder blocking on some resource held by
+        // this thread), waiting is bounded, after which the log record is pushed to the backlog
+        if (spinCount >= ELOG_COMBINE_MAX_SPIN) {
+            const ELogRecord* ownRecord = &logRecord;
+            if (slot.m_logRecord.compare_exchange_strong(ownRecord, nullptr,
+                                                         std::memory_order_acq_rel)) {
+                pushBacklog(logRecord);
+                return true;
+            }
+
+            // the log record is being written by the lock holder, so wait for it to finish
+            while (slot.m_logRecord.load(std::memory_order_acquire) != nullptr) {
+                std::this_thread::yield();
+            }
+            return true;
+        }
+        std::this_thread::yield();
+    }
+}
+
+uint64_t ELogTarget::combineLogRecords() {
+    // NOTE: this is called under lock, and publishing threads wait until their log record is
+    // released, so the log record may be accessed until the slot is cleared
+    uint64_t recordCount = 0;
+    uint64_t slotHigh = m_combineSlotHigh.load(std::memory_order_relaxed);
+    for (uint64_t i = 0; i < slotHigh; ++i) {
+        CombineSlot& slot = m_combineSlots[i];
+        const ELogRecord* logRecord = slot.m_logRecord.load(std::memory_order_acquire);
+        if (logRecord == nullptr || logRecord == ELOG_COMBINE_CLAIMED) {
+            continue;
+        }
+        // claim the log record so that the publishing thread does not retract it while writing
+        if (slot.m_logRecord.compare_exchange_strong(logRecord, ELOG_COMBINE_CLAIMED,
+                                                     std::memory_order_acq_rel)) {
+            // the publishing thread may have pushed its previous log record to the backlog (after
+            // waiting too long), so the backlog is drained first to keep per-thread record order
+            // (the backlog push happens before the publication, so it is visible here)
+            if (m_backlogSize.load(std::memory_order_relaxed) > 0) {
+                drainBacklog();
+            }
+            // statistics and latency samples are charged to the publishing thread, whose slot
+            // index is its statistics slot id (it is blocked until the slot is released, which
+            // also publishes the statistics update to it)
+            logNoLock(*logRecord, m_enableStats ? i : ELOG_INVALID_STAT_SLOT_ID);
+            slot.m_logRecord.store(nullptr, std::memory_order_release);
+            ++recordCount;
+        }
+    }
+    return recordCount;
+}
+
 void ELogTarget::pushBacklog(const ELogRecord& logRecord) {
+    // the message copy is made outside the lock, and is shared with other queues of the record
+    ELogMsgRef msgRef = acquireLogRecordMsg(logRecord);
+    if (msgRef.getMsgBlob() == nullptr) {
+        // error already reported
+        return;
+    }
     std::unique_lock<std::mutex> lock(m_backlogLock);
-    m_backlog.emplace_back(
-        std::make_pair(logRecord, std::string(logRecord.m_logMsg, logRecord.m_logMsgLen)));
+    m_backlog.emplace_back(logRecord, std::move(msgRef));
     m_backlogSize.fetch_add(1, std::memory_order_relaxed);
 }
 
 void ELogTarget::drainBacklog() {
     // drain to local container
-    std::vector<std::pair<ELogRecord, std::string>> backlog;
+    std::vector<std::pair<ELogRecord, ELogMsgRef>> backlog;
     {
         std::unique_lock<std::mutex> lock(m_backlogLock);
-        if (!m_backlog.empty()) {
-            backlog.resize(m_backlog.size());
-            std::copy(m_backlog.begin(), m_backlog.end(), backlog.begin());
-            m_backlog.clear();
-        }
+        backlog.swap(m_backlog);
     }
 
     // now log outside backlog lock scope
-    for (std::pair<ELogRecord, std::string>& logItem : backlog) {
-        logItem.first.m_logMsg = logItem.second.data();
+    for (std::pair<ELogRecord, ELogMsgRef>& logItem : backlog) {
+        logItem.first.m_logMsg = logItem.second.getData();
+        ELogRenderCache renderCache(logItem.first);
+        renderCache.setMsgBlob(logItem.second.getMsgBlob());
+        ELogScopedRenderCache scopedRenderCache(&renderCache);
         logNoLock(logItem.first);
     }
 
     // NOTE: other threads might be adding to this atomic var so we use atomic-sub instead of
     // storing zero
-    m_backlogSize.fetch_add(backlog.size(), std::memory_order_relaxed);
+    m_backlogSize.fetch_sub(backlog.size(), std::memory_order_relaxed);
     backlog.clear();
 }
 
-void ELogTarget::logNoLock(const ELogRecord& logRecord) {
-    uint64_t slotId = m_enableStats ? m_stats->getSlotId() : ELOG_INVALID_STAT_SLOT_ID;
+void ELogTarget::logNoLock(const ELogRecord& logRecord, uint64_t slotId) {
     if (!canLog(logRecord)) {
         if (slotId != ELOG_INVALID_STAT_SLOT_ID) {
             m_stats->incrementMsgDiscarded(slotId);
@@ -234,8 +413,14 @@ void ELogTarget::logNoLock(const ELogRecord& logRecord) {
         return;
     }
 
+    bool sampleLatency = false;
+    uint64_t startNanos = 0;
     if (slotId != ELOG_INVALID_STAT_SLOT_ID) {
         m_stats->incrementMsgSubmitted(slotId);
+        sampleLatency = shouldSampleLatency();
+        if (sampleLatency) {
+            startNanos = getStatsTimeNanos();
+        }
     }
 
     // write log record
@@ -244,9 +429,19 @@ void ELogTarget::logNoLock(const ELogRecord& logRecord) {
 
     // update statistics counter
     if (slotId != ELOG_INVALID_STAT_SLOT_ID) {
+        if (sampleLatency) {
+            uint64_t endNanos = getStatsTimeNanos();
+            m_stats->recordWriteLatency(slotId, getElapsedNanos(startNanos, endNanos));
+            m_stats->recordQueueResidence(
+                slotId, getElapsedNanos(elogTimeToUnixTimeNanos(logRecord.m_logTime), endNanos));
+        }
         if (res) {
-            m_stats->incrementMsgWritten(slotId);
-            m_stats->addBytesWritten(slotId, bytesWritten);
+            // NOTE: with deferred write statistics, the log record was only buffered, and is
+            // accounted for when its batch is sent (see reportBatchWrite())
+            if (!m_deferredWriteStats) {
+                m_stats->incrementMsgWritten(slotId);
+                m_stats->addBytesWritten(slotId, bytesWritten);
+            }
         } else {
             m_stats->incrementMsgFailWrite(slotId);
             m_stats->addBytesFailWrite(bytesWritten);
@@ -268,6 +463,23 @@ void ELogTarget::logNoLock(const ELogRecord& logRecord) {
     }
 }
 
+void ELogTarget::reportBatchWrite(bool success, uint64_t msgCount, uint64_t bytes) {
+    if (!m_enableStats || m_stats == nullptr || msgCount == 0) {
+        return;
+    }
+    uint64_t slotId = m_stats->getSlotId();
+    if (slotId == ELOG_INVALID_STAT_SLOT_ID) {
+        return;
+    }
+    if (success) {
+        m_stats->addMsgWritten(slotId, msgCount);
+        m_stats->addBytesWritten(slotId, bytes);
+    } else {
+        m_stats->addMsgDiscarded(slotId, msgCount);
+        m_stats->addBytesFailWrite(slotId, bytes);
+    }
+}
+
 ELogStats* ELogTarget::createStats() {
     ELogStats* res = new (std::nothrow) ELogStats();
     if (res == nullptr) {
@@ -322,12 +534,19 @@ void ELogTarget::statsToString(ELogBuffer& buffer, const char* msg /* = "" */) {
 }
 
 bool ELogTarget::flushNoLock(bool allowModeration) {
+    ELOG_PROFILE_SCOPE(ELogProfileStage::PS_TARGET_FLUSH);
     // flush moderation should take place only when log target is natively thread-safe
     // NOTE: Being externally thread safe means that either there is an external lock, or that only
     // one thread accesses the log target - in either case, flush moderation is not required
     uint64_t slotId = m_enableStats ? m_stats->getSlotId() : ELOG_INVALID_STAT_SLOT_ID;
+    bool sampleLatency = false;
+    uint64_t startNanos = 0;
     if (slotId != ELOG_INVALID_STAT_SLOT_ID) {
         m_stats->incrementFlushSubmitted(slotId);
+        sampleLatency = shouldSampleLatency();
+        if (sampleLatency) {
+            startNanos = getStatsTimeNanos();
+        }
     }
     bool res = false;
     if (m_isNativelyThreadSafe && allowModeration) {
@@ -340,6 +559,10 @@ bool ELogTarget::flushNoLock(bool allowModeration) {
     }
 
     if (slotId != ELOG_INVALID_STAT_SLOT_ID) {
+        if (sampleLatency) {
+            m_stats->recordFlushLatency(slotId,
+                                        getElapsedNanos(startNanos, getStatsTimeNanos()));
+        }
         if (res) {
             m_stats->incrementFlushExecuted(slotId);
         } else {
@@ -446,6 +669,9 @@ bool ELogTarget::isCaughtUp(uint64_t targetMsgCount, bool& caughtUp) {
 }
 
 void ELogTarget::formatLogMsg(const ELogRecord& logRecord, std::string& logMsg) {
+    // NOTE: formatting is profiled here rather than in field selector application, since
+    // formatters with precompiled instructions do not apply field selectors at all
+    ELOG_PROFILE_SCOPE(ELogProfileStage::PS_FORMAT);
     ELogFormatter* logFormatter = getLogFormatter();
     if (logFormatter != nullptr) {
         logFormatter->formatLogMsg(logRecord, logMsg);
@@ -458,6 +684,7 @@ void ELogTarget::formatLogMsg(const ELogRecord& logRecord, std::string& logMsg)
 }
 
 void ELogTarget::formatLogBuffer(const ELogRecord& logRecord, ELogBuffer& logBuffer) {
+    ELOG_PROFILE_SCOPE(ELogProfileStage::PS_FORMAT);
     ELogFormatter* logFormatter = getLogFormatter();
     if (logFormatter != nullptr) {
         logFormatter->formatLogBuffer(logRecord, logBuffer);
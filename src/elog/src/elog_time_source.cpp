@@ -23,23 +23,17 @@ void ELogTimeSource::initialize(uint64_t resolution, ELogTimeUnits resolutionUni
 }
 
 void ELogTimeSource::start() {
-    m_stop.store(false, std::memory_order_release);
     updateCurrentTime();
-    m_updateTimeTask = std::thread(&ELogTimeSource::updateTimeTask, this);
-}
-
-void ELogTimeSource::stop() {
-    m_stop.store(true, std::memory_order_release);
-    m_updateTimeTask.join();
-}
-
-void ELogTimeSource::updateTimeTask() {
-    while (!m_stop.load(std::memory_order_relaxed)) {
-        updateCurrentTime();
-        std::this_thread::sleep_for(std::chrono::nanoseconds(m_resolutionNanos));
+    // timer service resolution is one millisecond
+    uint64_t resolutionMillis = (m_resolutionNanos + 999999ull) / 1000000ull;
+    if (resolutionMillis == 0) {
+        resolutionMillis = 1;
     }
+    getTimerService().schedule(this, resolutionMillis, resolutionMillis);
 }
 
+void ELogTimeSource::stop() { getTimerService().cancel(this); }
+
 void ELogTimeSource::updateCurrentTime() {
     ELogTime currentTime;
     elogGetCurrentTime(currentTime);
@@ -2,25 +2,26 @@
 #define __ELOG_TIME_SOURCE_H__
 
 #include <atomic>
-#include <thread>
 
 #include "elog_common_def.h"
 #include "elog_def.h"
 #include "elog_time.h"
+#include "elog_timer_service.h"
 
 namespace elog {
 
 /**
  * @brief A lazy time source that provides the current time. The internal timestamp is periodically
- * updated by a background task, so that taking timestamp does not affect performance that much.
+ * updated by a timer task, so that taking timestamp does not affect performance that much.
+ * @note The timer service resolution is one millisecond, so finer resolutions are rounded up.
  */
-class ELogTimeSource {
+class ELogTimeSource final : public ELogTimerTask {
 public:
-    ELogTimeSource() : m_resolutionNanos(0), m_stop(false) {}
+    ELogTimeSource() : m_resolutionNanos(0) {}
     ELogTimeSource(const ELogTimeSource&) = delete;
     ELogTimeSource(ELogTimeSource&&) = delete;
     ELogTimeSource& operator=(const ELogTimeSource&) = delete;
-    ~ELogTimeSource() {}
+    ~ELogTimeSource() final {}
 
     /** @brief Configures the time source. */
     void initialize(uint64_t resolution, ELogTimeUnits resolutionUnits);
@@ -36,13 +37,13 @@ public:
         currentTime = m_currentTime.load(std::memory_order_relaxed);
     }
 
+    /** @brief Updates the current timestamp (called by the timer service). */
+    void onTimer() final { updateCurrentTime(); }
+
 private:
     uint64_t m_resolutionNanos;
     std::atomic<ELogTime> m_currentTime;
-    std::thread m_updateTimeTask;
-    std::atomic<bool> m_stop;
 
-    void updateTimeTask();
     void updateCurrentTime();
 };
 
@@ -0,0 +1,251 @@
+#include "elog_timer_service.h"
+
+#include "elog_field_selector_internal.h"
+
+#define ELOG_TIMER_WHEEL_SLOT_MASK (ELOG_TIMER_WHEEL_SLOTS - 1)
+
+namespace elog {
+
+static ELogTimerService sTimerService;
+
+ELogTimerService::ELogTimerService()
+    : m_stop(false),
+      m_startTime(std::chrono::steady_clock::now()),
+      m_currTick(0),
+      m_wakeTick(UINT64_MAX),
+      m_taskCount(0),
+      m_runningTask(nullptr) {
+    for (uint32_t i = 0; i < ELOG_TIMER_WHEEL_LEVELS; ++i) {
+        for (uint32_t j = 0; j < ELOG_TIMER_WHEEL_SLOTS; ++j) {
+            m_wheel[i][j] = nullptr;
+        }
+    }
+}
+
+void ELogTimerService::schedule(ELogTimerTask* task, uint64_t delayMillis,
+                                uint64_t periodMillis /* = 0 */) {
+    std::unique_lock<std::mutex> lock(m_lock);
+    if (task->m_slot != nullptr) {
+        removeTask(task);
+    }
+
+    // the current tick is not advanced while the wheel is empty, so it is synchronized now, such
+    // that the timer thread does not need to catch up with many empty ticks
+    if (m_taskCount == 0 && m_runningTask == nullptr) {
+        uint64_t nowTick = getCurrentTick();
+        if (nowTick > m_currTick) {
+            m_currTick = nowTick;
+        }
+    }
+
+    // round up delay and period to tick resolution
+    uint64_t delayTicks = (delayMillis + ELOG_TIMER_TICK_MILLIS - 1) / ELOG_TIMER_TICK_MILLIS;
+    uint64_t periodTicks = (periodMillis + ELOG_TIMER_TICK_MILLIS - 1) / ELOG_TIMER_TICK_MILLIS;
+    // NOTE: the current tick may have already partially elapsed, so an extra tick is added to
+    // avoid early expiry
+    task->m_expireTick = getCurrentTick() + delayTicks + (delayTicks > 0 ? 1 : 0);
+    task->m_periodTicks = periodTicks;
+    insertTask(task);
+
+    // launch timer thread on-demand, or wake it up if the task is due before its next wake up
+    if (!m_timerThread.joinable()) {
+        m_stop = false;
+        m_timerThread = std::thread(&ELogTimerService::timerThread, this);
+    } else if (task->m_expireTick < m_wakeTick) {
+        m_wakeCV.notify_one();
+    }
+}
+
+void ELogTimerService::cancel(ELogTimerTask* task) {
+    std::unique_lock<std::mutex> lock(m_lock);
+    if (task->m_slot != nullptr) {
+        removeTask(task);
+    }
+    task->m_periodTicks = 0;
+
+    // wait for task execution to end (unless a task cancels itself)
+    if (std::this_thread::get_id() != m_timerThread.get_id()) {
+        m_doneCV.wait(lock, [this, task]() { return m_runningTask != task; });
+    }
+}
+
+void ELogTimerService::stop() {
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_stop = true;
+        m_wakeCV.notify_one();
+    }
+    if (m_timerThread.joinable()) {
+        m_timerThread.join();
+    }
+
+    // cancel all remaining tasks
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (uint32_t i = 0; i < ELOG_TIMER_WHEEL_LEVELS; ++i) {
+        for (uint32_t j = 0; j < ELOG_TIMER_WHEEL_SLOTS; ++j) {
+            while (m_wheel[i][j] != nullptr) {
+                removeTask(m_wheel[i][j]);
+            }
+        }
+    }
+    m_stop = false;
+}
+
+void ELogTimerService::timerThread() {
+    setCurrentThreadNameField("elog-timer");
+    std::unique_lock<std::mutex> lock(m_lock);
+    while (!m_stop) {
+        // run all due ticks, skipping ticks that have nothing to do
+        uint64_t nowTick = getCurrentTick();
+        uint64_t nextTick = getNextWakeTick();
+        while (nextTick <= nowTick && !m_stop) {
+            m_currTick = nextTick;
+            runTick(lock, nowTick);
+            nextTick = getNextWakeTick();
+        }
+        if (m_stop) {
+            break;
+        }
+
+        // NOTE: the current tick must not run ahead of time, otherwise tasks scheduled while
+        // waiting would be delayed
+        if (m_currTick <= nowTick) {
+            m_currTick = nowTick + 1;
+        }
+        m_wakeTick = nextTick;
+        if (nextTick == UINT64_MAX) {
+            m_wakeCV.wait(lock);
+        } else {
+            m_wakeCV.wait_until(
+                lock, m_startTime + std::chrono::milliseconds(nextTick * ELOG_TIMER_TICK_MILLIS));
+        }
+        m_wakeTick = 0;
+    }
+}
+
+void ELogTimerService::insertTask(ELogTimerTask* task) {
+    // overdue tasks are executed on the next tick, and tasks too far in the future are placed in
+    // the farthest slot, and are re-inserted when that slot expires
+    uint64_t expireTick = task->m_expireTick;
+    if (expireTick < m_currTick) {
+        expireTick = m_currTick;
+    }
+    uint64_t deltaTicks = expireTick - m_currTick;
+    if (deltaTicks > ELOG_TIMER_WHEEL_MAX_TICKS) {
+        deltaTicks = ELOG_TIMER_WHEEL_MAX_TICKS;
+        expireTick = m_currTick + deltaTicks;
+    }
+
+    // find the lowest level that can hold the task
+    uint32_t level = 0;
+    while (level + 1 < ELOG_TIMER_WHEEL_LEVELS &&
+           deltaTicks >= (1ull << (ELOG_TIMER_WHEEL_SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+    uint64_t slot = (expireTick >> (ELOG_TIMER_WHEEL_SLOT_BITS * level)) &
+                    ELOG_TIMER_WHEEL_SLOT_MASK;
+
+    // push at list head
+    ELogTimerTask** head = &m_wheel[level][slot];
+    task->m_prev = nullptr;
+    task->m_next = *head;
+    if (*head != nullptr) {
+        (*head)->m_prev = task;
+    }
+    *head = task;
+    task->m_slot = head;
+    ++m_taskCount;
+}
+
+void ELogTimerService::removeTask(ELogTimerTask* task) {
+    if (task->m_prev != nullptr) {
+        task->m_prev->m_next = task->m_next;
+    } else {
+        *task->m_slot = task->m_next;
+    }
+    if (task->m_next != nullptr) {
+        task->m_next->m_prev = task->m_prev;
+    }
+    task->m_prev = nullptr;
+    task->m_next = nullptr;
+    task->m_slot = nullptr;
+    --m_taskCount;
+}
+
+uint32_t ELogTimerService::cascade(uint32_t level) {
+    uint32_t slot =
+        (uint32_t)((m_currTick >> (ELOG_TIMER_WHEEL_SLOT_BITS * level)) & ELOG_TIMER_WHEEL_SLOT_MASK);
+    ELogTimerTask* task = m_wheel[level][slot];
+    m_wheel[level][slot] = nullptr;
+    while (task != nullptr) {
+        ELogTimerTask* next = task->m_next;
+        --m_taskCount;
+        insertTask(task);
+        task = next;
+    }
+    return slot;
+}
+
+void ELogTimerService::runTick(std::unique_lock<std::mutex>& lock, uint64_t nowTick) {
+    // when the lowest level completes a revolution, cascade down the next slot of upper levels
+    uint32_t slot = (uint32_t)(m_currTick & ELOG_TIMER_WHEEL_SLOT_MASK);
+    if (slot == 0) {
+        for (uint32_t level = 1; level < ELOG_TIMER_WHEEL_LEVELS; ++level) {
+            if (cascade(level) != 0) {
+                break;
+            }
+        }
+    }
+
+    // NOTE: the slot list is re-examined after each execution, since the lock is released during
+    // execution, and other tasks may be scheduled to or cancelled from this slot in the meantime
+    while (m_wheel[0][slot] != nullptr && !m_stop) {
+        ELogTimerTask* task = m_wheel[0][slot];
+        removeTask(task);
+        if (task->m_expireTick > m_currTick) {
+            // task was too far in the future for the wheel
+            insertTask(task);
+            continue;
+        }
+
+        // periodic tasks are rescheduled before execution, so that they can be cancelled during
+        // execution (late ticks are skipped rather than executed in a burst)
+        if (task->m_periodTicks > 0) {
+            task->m_expireTick += task->m_periodTicks;
+            if (task->m_expireTick <= nowTick) {
+                task->m_expireTick = nowTick + task->m_periodTicks;
+            }
+            insertTask(task);
+        }
+
+        m_runningTask = task;
+        lock.unlock();
+        task->onTimer();
+        lock.lock();
+        m_runningTask = nullptr;
+        m_doneCV.notify_all();
+    }
+    ++m_currTick;
+}
+
+uint64_t ELogTimerService::getNextWakeTick() const {
+    if (m_taskCount == 0) {
+        return UINT64_MAX;
+    }
+
+    // scan the lowest level until the next cascading point
+    uint64_t tick = m_currTick;
+    for (;;) {
+        if ((tick & ELOG_TIMER_WHEEL_SLOT_MASK) == 0 ||
+            m_wheel[0][tick & ELOG_TIMER_WHEEL_SLOT_MASK] != nullptr) {
+            return tick;
+        }
+        ++tick;
+    }
+}
+
+void termTimerService() { sTimerService.stop(); }
+
+ELogTimerService& getTimerService() { return sTimerService; }
+
+}  // namespace elog
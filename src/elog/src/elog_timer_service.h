@@ -0,0 +1,147 @@
+#ifndef __ELOG_TIMER_SERVICE_H__
+#define __ELOG_TIMER_SERVICE_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "elog_def.h"
+
+// NOTE: the timer service runs all periodic background work of the library (timed flush, lazy
+// time source updates, TSC clock calibration, life-sign synchronization) on a single thread,
+// instead of having each component run its own mostly sleeping thread.
+// timers are kept in a hierarchical timer wheel (similar to the classic Linux kernel timer wheel):
+// each level has a fixed number of slots, where each slot in level N spans all the slots of level
+// N-1. a timer is placed in the lowest level that can hold its expiry, so that scheduling and
+// cancelling are O(1) operations (insertion to/removal from an intrusive doubly-linked list). each
+// time the lowest level completes a full revolution, the timers of the next slot in the upper
+// level are cascaded down to lower levels.
+// the timer thread does not wake up on each tick, but rather only when the next non-empty slot of
+// the lowest level is due, or when cascading is required.
+
+/** @def The timer service tick resolution in milliseconds. */
+#define ELOG_TIMER_TICK_MILLIS 1
+
+/** @def The number of timer wheel levels. */
+#define ELOG_TIMER_WHEEL_LEVELS 4
+
+/** @def The number of bits used to index slots within a single timer wheel level. */
+#define ELOG_TIMER_WHEEL_SLOT_BITS 6
+
+/** @def The number of slots in each timer wheel level. */
+#define ELOG_TIMER_WHEEL_SLOTS (1u << ELOG_TIMER_WHEEL_SLOT_BITS)
+
+/** @def The maximum timer expiry (in ticks) that can be held by the timer wheel. */
+#define ELOG_TIMER_WHEEL_MAX_TICKS \
+    ((1ull << (ELOG_TIMER_WHEEL_SLOT_BITS * ELOG_TIMER_WHEEL_LEVELS)) - 1)
+
+namespace elog {
+
+/**
+ * @brief A timer task that can be scheduled on the timer service. The timer task is owned by the
+ * caller, and must be cancelled before it is deleted.
+ */
+class ELogTimerTask {
+public:
+    ELogTimerTask()
+        : m_prev(nullptr),
+          m_next(nullptr),
+          m_slot(nullptr),
+          m_expireTick(0),
+          m_periodTicks(0) {}
+    ELogTimerTask(const ELogTimerTask&) = delete;
+    ELogTimerTask(ELogTimerTask&&) = delete;
+    ELogTimerTask& operator=(const ELogTimerTask&) = delete;
+    virtual ~ELogTimerTask() {}
+
+    /**
+     * @brief Executes the timer task. This is called by the timer service thread, and should
+     * not block for long periods of time, since that delays all other timer tasks.
+     */
+    virtual void onTimer() = 0;
+
+private:
+    // intrusive timer wheel slot list
+    ELogTimerTask* m_prev;
+    ELogTimerTask* m_next;
+    ELogTimerTask** m_slot;
+
+    uint64_t m_expireTick;
+    uint64_t m_periodTicks;
+
+    friend class ELogTimerService;
+};
+
+/** @brief Single-threaded timer service, based on a hierarchical timer wheel. */
+class ELogTimerService {
+public:
+    ELogTimerService();
+    ELogTimerService(const ELogTimerService&) = delete;
+    ELogTimerService(ELogTimerService&&) = delete;
+    ELogTimerService& operator=(const ELogTimerService&) = delete;
+    ~ELogTimerService() {}
+
+    /**
+     * @brief Schedules a timer task. If the task is already scheduled, it is rescheduled. The
+     * timer thread is launched on-demand.
+     * @param task The task to schedule.
+     * @param delayMillis The delay in milliseconds until the first execution of the task.
+     * @param periodMillis The period in milliseconds of task execution, or zero for a one-shot
+     * task.
+     */
+    void schedule(ELogTimerTask* task, uint64_t delayMillis, uint64_t periodMillis = 0);
+
+    /**
+     * @brief Cancels a timer task. If the task is being executed by the timer thread, the call
+     * waits for the execution to end (unless called by the task itself), so when this call returns
+     * the task may be safely deleted.
+     * @param task The task to cancel.
+     */
+    void cancel(ELogTimerTask* task);
+
+    /**
+     * @brief Stops the timer thread. All scheduled tasks are cancelled. The timer thread is
+     * launched again on-demand if any task is scheduled afterwards.
+     */
+    void stop();
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_wakeCV;
+    std::condition_variable m_doneCV;
+    std::thread m_timerThread;
+    bool m_stop;
+
+    std::chrono::steady_clock::time_point m_startTime;
+    uint64_t m_currTick;
+    uint64_t m_wakeTick;
+    uint64_t m_taskCount;
+    ELogTimerTask* m_runningTask;
+    ELogTimerTask* m_wheel[ELOG_TIMER_WHEEL_LEVELS][ELOG_TIMER_WHEEL_SLOTS];
+
+    inline uint64_t getCurrentTick() const {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now() - m_startTime)
+                   .count() /
+               ELOG_TIMER_TICK_MILLIS;
+    }
+
+    void timerThread();
+    void insertTask(ELogTimerTask* task);
+    void removeTask(ELogTimerTask* task);
+    uint32_t cascade(uint32_t level);
+    void runTick(std::unique_lock<std::mutex>& lock, uint64_t nowTick);
+    uint64_t getNextWakeTick() const;
+};
+
+/** @brief Terminates the global timer service. */
+extern void termTimerService();
+
+/** @brief Retrieves the global timer service. */
+extern ELogTimerService& getTimerService();
+
+}  // namespace elog
+
+#endif  // __ELOG_TIMER_SERVICE_H__
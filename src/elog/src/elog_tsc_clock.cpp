@@ -0,0 +1,80 @@
+#include "elog_tsc_clock.h"
+
+#include <chrono>
+#include <thread>
+
+namespace elog {
+
+#ifdef ELOG_HAS_TSC
+inline uint64_t getRealTimeNanos() {
+    ELogTime currentTime;
+    elogGetCurrentTime(currentTime);
+    return elogTimeToUnixTimeNanos(currentTime);
+}
+#endif
+
+void ELogTscClock::start() {
+#ifdef ELOG_HAS_TSC
+    // initial calibration must be complete before the clock is used
+    uint64_t prevTicks = __rdtsc();
+    uint64_t prevNanos = getRealTimeNanos();
+    std::this_thread::sleep_for(std::chrono::milliseconds(ELOG_TSC_INIT_CALIBRATION_MILLIS));
+    uint64_t ticks = 0;
+    uint64_t nanos = 0;
+    calibrate(prevTicks, prevNanos, ticks, nanos);
+
+    getTimerService().schedule(this, ELOG_TSC_CALIBRATION_PERIOD_MILLIS,
+                               ELOG_TSC_CALIBRATION_PERIOD_MILLIS);
+#endif
+}
+
+void ELogTscClock::stop() {
+#ifdef ELOG_HAS_TSC
+    getTimerService().cancel(this);
+#endif
+}
+
+void ELogTscClock::onTimer() {
+    // the ratio is computed over the entire period since the previous calibration, which gives
+    // good accuracy
+    uint64_t prevTicks = m_baseTicks.load(std::memory_order_relaxed);
+    uint64_t prevNanos = m_baseNanos.load(std::memory_order_relaxed);
+    uint64_t ticks = 0;
+    uint64_t nanos = 0;
+    calibrate(prevTicks, prevNanos, ticks, nanos);
+}
+
+void ELogTscClock::calibrate(uint64_t prevTicks, uint64_t prevNanos, uint64_t& ticks,
+                             uint64_t& nanos) {
+#ifdef ELOG_HAS_TSC
+    // take the TSC reading as close as possible to the real-time reading
+    ticks = __rdtsc();
+    nanos = getRealTimeNanos();
+    uint64_t deltaTicks = ticks - prevTicks;
+    uint64_t deltaNanos = nanos > prevNanos ? nanos - prevNanos : 0;
+    // if the real-time clock was set backwards, the ratio is kept and only the reference moves
+    uint64_t nanosPerTick = m_nanosPerTick.load(std::memory_order_relaxed);
+    if (deltaTicks > 0 && deltaNanos > 0) {
+        nanosPerTick = (uint64_t)(((double)deltaNanos / (double)deltaTicks) * 4294967296.0);
+    } else if (nanosPerTick == 0) {
+        // real-time clock was set backwards during initial calibration, so assume 1 GHz
+        nanosPerTick = 1ull << 32;
+    }
+
+    // publish under seqlock
+    uint64_t seq = m_seq.load(std::memory_order_relaxed);
+    m_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_baseTicks.store(ticks, std::memory_order_relaxed);
+    m_baseNanos.store(nanos, std::memory_order_relaxed);
+    m_nanosPerTick.store(nanosPerTick, std::memory_order_relaxed);
+    m_seq.store(seq + 2, std::memory_order_release);
+#else
+    (void)prevTicks;
+    (void)prevNanos;
+    ticks = 0;
+    nanos = 0;
+#endif
+}
+
+}  // namespace elog
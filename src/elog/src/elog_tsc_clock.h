@@ -0,0 +1,97 @@
+#ifndef __ELOG_TSC_CLOCK_H__
+#define __ELOG_TSC_CLOCK_H__
+
+#include <atomic>
+
+#include "elog_def.h"
+#include "elog_time.h"
+#include "elog_timer_service.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ELOG_HAS_TSC
+#ifdef ELOG_MSVC
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+/** @def The period in milliseconds of TSC clock re-calibration against the real-time clock. */
+#define ELOG_TSC_CALIBRATION_PERIOD_MILLIS 1000
+
+/** @def The duration in milliseconds of the initial TSC clock calibration. */
+#define ELOG_TSC_INIT_CALIBRATION_MILLIS 10
+
+namespace elog {
+
+/**
+ * @brief A clock based on the CPU time-stamp counter (TSC). Reading the clock costs only the TSC
+ * read and a fixed-point multiplication, without any call to the OS. Ticks are converted to
+ * wall-clock time using a tick-to-nanos ratio and a reference point, which a timer task
+ * periodically re-calibrates against the real-time clock, so clock drift (and any real-time clock
+ * adjustments) are picked up within one calibration period.
+ *
+ * @note This requires a constant/invariant TSC, which is the case with all modern x86 CPUs. On
+ * other platforms the real-time clock is used instead.
+ */
+class ELogTscClock final : public ELogTimerTask {
+public:
+    ELogTscClock() : m_seq(0), m_baseTicks(0), m_baseNanos(0), m_nanosPerTick(0) {}
+    ELogTscClock(const ELogTscClock&) = delete;
+    ELogTscClock(ELogTscClock&&) = delete;
+    ELogTscClock& operator=(const ELogTscClock&) = delete;
+    ~ELogTscClock() final {}
+
+    /** @brief Calibrates the clock and schedules periodic re-calibration. */
+    void start();
+
+    /** @brief Stops periodic re-calibration. */
+    void stop();
+
+    /** @brief Re-calibrates the clock (called by the timer service). */
+    void onTimer() final;
+
+    /** @brief Retrieves the current time. */
+    inline void getCurrentTime(ELogTime& currentTime) {
+#ifdef ELOG_HAS_TSC
+        uint64_t baseTicks = 0;
+        uint64_t baseNanos = 0;
+        uint64_t nanosPerTick = 0;
+        uint64_t seq = 0;
+        do {
+            seq = m_seq.load(std::memory_order_acquire);
+            baseTicks = m_baseTicks.load(std::memory_order_relaxed);
+            baseNanos = m_baseNanos.load(std::memory_order_relaxed);
+            nanosPerTick = m_nanosPerTick.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1) || seq != m_seq.load(std::memory_order_relaxed));
+        uint64_t ticks = __rdtsc();
+        // TSC is not serializing, so a read on another core may be slightly behind the base
+        uint64_t deltaTicks = ticks > baseTicks ? ticks - baseTicks : 0;
+        elogTimeFromUnixTimeNanos(baseNanos + ticksToNanos(deltaTicks, nanosPerTick),
+                                  currentTime);
+#else
+        elogGetCurrentTime(currentTime);
+#endif
+    }
+
+private:
+    // seqlock protecting the calibration data
+    std::atomic<uint64_t> m_seq;
+    std::atomic<uint64_t> m_baseTicks;
+    std::atomic<uint64_t> m_baseNanos;
+
+    // nanos per tick in 32.32 fixed point
+    std::atomic<uint64_t> m_nanosPerTick;
+
+    inline static uint64_t ticksToNanos(uint64_t ticks, uint64_t nanosPerTick) {
+        // split multiplication to avoid overflow when calibration is late
+        return (ticks >> 32) * nanosPerTick + (((ticks & 0xFFFFFFFFull) * nanosPerTick) >> 32);
+    }
+
+    void calibrate(uint64_t prevTicks, uint64_t prevNanos, uint64_t& ticks, uint64_t& nanos);
+};
+
+}  // namespace elog
+
+#endif  // __ELOG_TSC_CLOCK_H__
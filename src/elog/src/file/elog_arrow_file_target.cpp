@@ -0,0 +1,455 @@
+#include "file/elog_arrow_file_target.h"
+
+#include <cinttypes>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+
+#include "db/elog_columnar_batch.h"
+#include "db/elog_db_formatter.h"
+#include "elog_common.h"
+#include "elog_field_selector_internal.h"
+#include "elog_report.h"
+#include "file/elog_arrow_ipc.h"
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogArrowFileTarget)
+
+ELOG_IMPLEMENT_LOG_TARGET(ELogArrowFileTarget)
+
+static const char* ARROW_SUFFIX = ".arrows";
+
+// record columns are collected through a database formatter into a columnar batch, so the spec
+// order must match the column identifiers below
+static const char* ARROW_COLUMN_SPEC =
+    "${rid}${time}${level}${tid}${tname}${src}${mod}${file}${line}${func}${msg}";
+
+// column and dictionary identifiers
+enum ArrowColumn : uint32_t {
+    AC_RECORD_ID,
+    AC_TIME,
+    AC_LEVEL,
+    AC_THREAD_ID,
+    AC_THREAD_NAME,
+    AC_LOG_SOURCE,
+    AC_MODULE,
+    AC_FILE,
+    AC_LINE,
+    AC_FUNCTION,
+    AC_MSG,
+    AC_COUNT
+};
+
+enum ArrowDictionary : uint32_t {
+    AD_LEVEL,
+    AD_THREAD_NAME,
+    AD_LOG_SOURCE,
+    AD_MODULE,
+    AD_FILE,
+    AD_FUNCTION,
+    AD_COUNT
+};
+
+static const std::vector<ELogArrowField> sArrowFields = {
+    {"record_id", ELogArrowType::AT_UINT64, -1},
+    {"time", ELogArrowType::AT_TIMESTAMP_NANOS, -1},
+    {"level", ELogArrowType::AT_UTF8, AD_LEVEL},
+    {"thread_id", ELogArrowType::AT_UINT64, -1},
+    {"thread_name", ELogArrowType::AT_UTF8, AD_THREAD_NAME},
+    {"log_source", ELogArrowType::AT_UTF8, AD_LOG_SOURCE},
+    {"module", ELogArrowType::AT_UTF8, AD_MODULE},
+    {"file", ELogArrowType::AT_UTF8, AD_FILE},
+    {"line", ELogArrowType::AT_UINT64, -1},
+    {"function", ELogArrowType::AT_UTF8, AD_FUNCTION},
+    {"msg", ELogArrowType::AT_UTF8, -1}};
+
+// dictionary encoded text columns and their dictionaries
+static const std::pair<uint32_t, uint32_t> sDictionaryColumns[] = {
+    {AC_THREAD_NAME, AD_THREAD_NAME},
+    {AC_LOG_SOURCE, AD_LOG_SOURCE},
+    {AC_MODULE, AD_MODULE},
+    {AC_FILE, AD_FILE},
+    {AC_FUNCTION, AD_FUNCTION}};
+
+// Arrow string offsets are signed 32 bit, so a batch is written once its string heap reaches 1 GB
+#define ELOG_ARROW_MAX_STRING_HEAP_SIZE (1024ul * 1024ul * 1024ul)
+
+struct ELogArrowFileTarget::RecordBatch {
+    // column store, filled through the formatter field selectors
+    ELogDbFormatter* m_formatter;
+    ELogColumnarBatch m_columns;
+
+    // Arrow encoding of text columns, produced just before the batch is written: dictionary
+    // indices, and message offsets into contiguous message data
+    std::vector<int32_t> m_dictionaryIndices[AD_COUNT];
+    std::vector<int32_t> m_msgOffsets;
+    std::string m_msgData;
+
+    ELogArrowDictionary m_dictionaries[AD_COUNT];
+    ELogArrowMessage m_message;
+
+    RecordBatch() : m_formatter(nullptr) {}
+    ~RecordBatch() {
+        // columns refer to the formatter field selectors, so they are removed first
+        m_columns.reset();
+        if (m_formatter != nullptr) {
+            destroyLogFormatter(m_formatter);
+            m_formatter = nullptr;
+        }
+    }
+
+    bool initialize(uint32_t batchSize);
+    void resetDictionaries();
+    bool append(const ELogRecord& logRecord, uint64_t& bytesAppended);
+    void encodeTextColumns();
+    inline void clear() { m_columns.clear(); }
+    inline size_t getRowCount() const { return m_columns.getRowCount(); }
+};
+
+bool ELogArrowFileTarget::RecordBatch::initialize(uint32_t batchSize) {
+    m_formatter = new (std::nothrow) ELogDbFormatter(ELogDbFormatter::QueryStyle::QS_NONE);
+    if (m_formatter == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate formatter for Arrow log target, out of memory");
+        return false;
+    }
+    if (!m_formatter->initialize(ARROW_COLUMN_SPEC)) {
+        ELOG_REPORT_ERROR("Failed to initialize formatter for Arrow log target");
+        return false;
+    }
+    m_formatter->prepareColumnarBatch(m_columns);
+    if (m_columns.getColumnCount() != AC_COUNT) {
+        ELOG_REPORT_ERROR("Invalid column count %zu for Arrow log target, expecting %u",
+                          m_columns.getColumnCount(), (uint32_t)AC_COUNT);
+        return false;
+    }
+    m_columns.reserve(batchSize);
+    for (const auto& dictionaryColumn : sDictionaryColumns) {
+        m_dictionaryIndices[dictionaryColumn.second].reserve(batchSize);
+    }
+    m_msgOffsets.reserve(batchSize + 1);
+    resetDictionaries();
+    return true;
+}
+
+void ELogArrowFileTarget::RecordBatch::resetDictionaries() {
+    for (uint32_t i = 0; i < AD_COUNT; ++i) {
+        m_dictionaries[i].clear();
+    }
+    // log level dictionary is fixed, so that the index is the log level
+    for (uint32_t i = 0; i < ELEVEL_COUNT; ++i) {
+        const char* logLevelStr = elogLevelToStr((ELogLevel)i);
+        m_dictionaries[AD_LEVEL].getIndex(logLevelStr, strlen(logLevelStr));
+    }
+}
+
+bool ELogArrowFileTarget::RecordBatch::append(const ELogRecord& logRecord,
+                                              uint64_t& bytesAppended) {
+    size_t heapSize = m_columns.getStringHeap().size();
+    if (heapSize >= ELOG_ARROW_MAX_STRING_HEAP_SIZE ||
+        m_formatter->fillColumnarBatch(&logRecord, 1, m_columns) == 0) {
+        return false;
+    }
+
+    // report the column data size: integer columns, log level, text offset/length pairs, and the
+    // text itself
+    bytesAppended = 4 * sizeof(uint64_t) + sizeof(ELogLevel) + 6 * 2 * sizeof(uint32_t) +
+                    (m_columns.getStringHeap().size() - heapSize);
+    return true;
+}
+
+void ELogArrowFileTarget::RecordBatch::encodeTextColumns() {
+    size_t rowCount = m_columns.getRowCount();
+    size_t length = 0;
+    for (const auto& dictionaryColumn : sDictionaryColumns) {
+        ELogArrowDictionary& dictionary = m_dictionaries[dictionaryColumn.second];
+        std::vector<int32_t>& indices = m_dictionaryIndices[dictionaryColumn.second];
+        indices.resize(rowCount);
+        for (size_t row = 0; row < rowCount; ++row) {
+            const char* value = m_columns.getString(dictionaryColumn.first, row, length);
+            indices[row] = dictionary.getIndex(value, length);
+        }
+    }
+
+    // message strings are interleaved with other strings in the batch string heap, so they are
+    // copied to contiguous data as required by Arrow
+    m_msgOffsets.resize(rowCount + 1);
+    m_msgOffsets[0] = 0;
+    m_msgData.clear();
+    for (size_t row = 0; row < rowCount; ++row) {
+        const char* msg = m_columns.getString(AC_MSG, row, length);
+        m_msgData.append(msg, length);
+        m_msgOffsets[row + 1] = (int32_t)m_msgData.size();
+    }
+}
+
+ELogArrowFileTarget::ELogArrowFileTarget(const char* logPath, const char* logName,
+                                         uint32_t batchSize /* = ELOG_DEFAULT_ARROW_BATCH_SIZE */,
+                                         uint64_t segmentLimitBytes /* = 0 */,
+                                         uint32_t segmentCount /* = 0 */,
+                                         ELogFlushPolicy* flushPolicy /* = nullptr */,
+                                         bool enableStats /* = true */)
+    : ELogTarget("arrow-file", flushPolicy, enableStats),
+      m_logPath(logPath),
+      m_logName(logName),
+      m_batchSize(batchSize),
+      m_segmentLimitBytes(segmentLimitBytes),
+      m_segmentCount(segmentCount),
+      m_segmentId(0),
+      m_segmentBytes(0),
+      m_segmentFile(nullptr),
+      m_recordBatch(nullptr) {
+    if (m_batchSize == 0) {
+        m_batchSize = ELOG_DEFAULT_ARROW_BATCH_SIZE;
+    } else if (m_batchSize > ELOG_MAX_ARROW_BATCH_SIZE) {
+        ELOG_REPORT_WARN("Truncating Arrow batch size from %u to %u log records (exceeding "
+                         "allowed limit), at Arrow log target at %s",
+                         m_batchSize, (uint32_t)ELOG_MAX_ARROW_BATCH_SIZE, logPath);
+        m_batchSize = ELOG_MAX_ARROW_BATCH_SIZE;
+    }
+    if (m_segmentCount > 0 && m_segmentLimitBytes == 0) {
+        ELOG_REPORT_WARN("Ignoring segment count of Arrow log target at %s, since no segment size "
+                         "limit was specified",
+                         logPath);
+        m_segmentCount = 0;
+    }
+}
+
+bool ELogArrowFileTarget::startLogTarget() {
+    m_recordBatch = new (std::nothrow) RecordBatch();
+    if (m_recordBatch == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate record batch for Arrow log target, out of memory");
+        return false;
+    }
+    if (!m_recordBatch->initialize(m_batchSize) || !selectFirstSegment() || !openSegment()) {
+        delete m_recordBatch;
+        m_recordBatch = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool ELogArrowFileTarget::stopLogTarget() {
+    bool res = true;
+    if (m_recordBatch != nullptr) {
+        if (m_segmentFile != nullptr && m_recordBatch->getRowCount() > 0) {
+            res = writeRecordBatch();
+        }
+        if (!closeSegment()) {
+            res = false;
+        }
+        delete m_recordBatch;
+        m_recordBatch = nullptr;
+    }
+    return res;
+}
+
+bool ELogArrowFileTarget::writeLogRecord(const ELogRecord& logRecord, uint64_t& bytesWritten) {
+    if (m_recordBatch == nullptr || m_segmentFile == nullptr) {
+        return false;
+    }
+    if (!m_recordBatch->append(logRecord, bytesWritten)) {
+        // string heap is full, so the current batch is written before appending again
+        if (m_recordBatch->getRowCount() == 0 || !writeRecordBatch() ||
+            !m_recordBatch->append(logRecord, bytesWritten)) {
+            return false;
+        }
+    }
+    if (m_recordBatch->getRowCount() >= m_batchSize) {
+        return writeRecordBatch();
+    }
+    return true;
+}
+
+bool ELogArrowFileTarget::flushLogTarget() {
+    if (m_recordBatch == nullptr || m_segmentFile == nullptr) {
+        return false;
+    }
+    if (m_recordBatch->getRowCount() > 0 && !writeRecordBatch()) {
+        return false;
+    }
+    if (fflush(m_segmentFile) == EOF) {
+        ELOG_REPORT_SYS_ERROR(fflush, "Failed to flush Arrow log file %s", m_segmentPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void ELogArrowFileTarget::formatSegmentPath(std::string& segmentPath, uint32_t segmentId) {
+    std::stringstream s;
+    if (!m_logPath.empty()) {
+        s << m_logPath << "/";
+    }
+    s << m_logName;
+    if (segmentId > 0) {
+        s << "." << segmentId;
+    }
+    s << ARROW_SUFFIX;
+    segmentPath = s.str();
+    ELOG_REPORT_TRACE("Using Arrow segment path %s", segmentPath.c_str());
+}
+
+bool ELogArrowFileTarget::selectFirstSegment() {
+    // existing segments are never appended to, since each segment is a complete stream, so:
+    // - without rotation, the first unused segment id is used
+    // - with rotation, the first unused segment id is used, and if all are used, then the least
+    //   recently modified segment is overwritten
+    m_segmentId = 0;
+    if (m_segmentLimitBytes == 0) {
+        // single file, truncated on start
+        return true;
+    }
+    std::string segmentPath;
+    uint64_t oldestTime = UINT64_MAX;
+    uint32_t oldestSegmentId = 0;
+    uint32_t maxSegmentId = (m_segmentCount > 0) ? m_segmentCount : UINT32_MAX;
+    for (uint32_t segmentId = 0; segmentId < maxSegmentId; ++segmentId) {
+        formatSegmentPath(segmentPath, segmentId);
+        try {
+            std::filesystem::path p{segmentPath};
+            if (!std::filesystem::exists(p)) {
+                m_segmentId = segmentId;
+                return true;
+            }
+            uint64_t fileTime =
+                (uint64_t)std::filesystem::last_write_time(p).time_since_epoch().count();
+            if (fileTime < oldestTime) {
+                oldestTime = fileTime;
+                oldestSegmentId = segmentId;
+            }
+        } catch (std::exception& e) {
+            ELOG_REPORT_ERROR("Failed to check Arrow segment %s: %s", segmentPath.c_str(),
+                              e.what());
+            return false;
+        }
+    }
+    m_segmentId = oldestSegmentId;
+    return true;
+}
+
+bool ELogArrowFileTarget::openSegment() {
+    formatSegmentPath(m_segmentPath, m_segmentId);
+    m_segmentFile = elog_fopen(m_segmentPath.c_str(), "wb");
+    if (m_segmentFile == nullptr) {
+        ELOG_REPORT_SYS_ERROR(fopen, "Failed to open Arrow log file %s", m_segmentPath.c_str());
+        return false;
+    }
+    m_segmentBytes = 0;
+
+    // each segment is a complete stream, starting with a schema, and full dictionaries
+    m_recordBatch->resetDictionaries();
+    ELogArrowMetadata metadata = {{"host", getHostNameField()},
+                                  {"user", getUserNameField()},
+                                  {"os_name", getOsNameField()},
+                                  {"os_version", getOsVersionField()},
+                                  {"app", getAppNameField()},
+                                  {"program", getProgramNameField()},
+                                  {"pid", std::to_string(getProcessIdField())}};
+    m_recordBatch->m_message.encodeSchema(sArrowFields, metadata);
+    if (!m_recordBatch->m_message.write(m_segmentFile, m_segmentBytes)) {
+        ELOG_REPORT_ERROR("Failed to write schema to Arrow log file %s", m_segmentPath.c_str());
+        fclose(m_segmentFile);
+        m_segmentFile = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool ELogArrowFileTarget::closeSegment() {
+    if (m_segmentFile == nullptr) {
+        return true;
+    }
+    // readers expect all dictionaries before end of stream, even if no batch was written
+    bool res = true;
+    if (m_recordBatch->m_dictionaries[AD_LEVEL].getWrittenCount() == 0) {
+        res = writeDictionaries();
+    }
+    if (!ELogArrowMessage::writeEndOfStream(m_segmentFile, m_segmentBytes)) {
+        res = false;
+    }
+    if (fclose(m_segmentFile) == EOF) {
+        ELOG_REPORT_SYS_ERROR(fclose, "Failed to close Arrow log file %s", m_segmentPath.c_str());
+        res = false;
+    }
+    m_segmentFile = nullptr;
+    return res;
+}
+
+bool ELogArrowFileTarget::writeDictionaries() {
+    // dictionaries are written before each record batch: full dictionaries for the first batch in
+    // the segment, and afterwards only new values, as delta dictionary batches
+    RecordBatch& batch = *m_recordBatch;
+    bool firstBatch = (batch.m_dictionaries[AD_LEVEL].getWrittenCount() == 0);
+    for (uint32_t i = 0; i < AD_COUNT; ++i) {
+        ELogArrowDictionary& dictionary = batch.m_dictionaries[i];
+        if (firstBatch || dictionary.getSize() > dictionary.getWrittenCount()) {
+            dictionary.encodeBatch(i, batch.m_message);
+            if (!batch.m_message.write(m_segmentFile, m_segmentBytes)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool ELogArrowFileTarget::writeRecordBatch() {
+    RecordBatch& batch = *m_recordBatch;
+    ELogArrowMessage& message = batch.m_message;
+
+    // dictionaries must be updated before they are written
+    batch.encodeTextColumns();
+    if (!writeDictionaries()) {
+        return false;
+    }
+
+    const ELogColumnarBatch& columns = batch.m_columns;
+    uint64_t rowCount = columns.getRowCount();
+    message.beginBatch();
+    for (uint32_t i = 0; i < AC_COUNT; ++i) {
+        message.addFieldNode(rowCount);
+    }
+    // each column has an (absent) validity buffer followed by data buffers, and integer columns
+    // are referenced directly in the columnar batch
+    auto addColumn = [&message](const auto& values) {
+        message.addBuffer(nullptr, 0);
+        message.addBuffer(values.data(), values.size() * sizeof(values[0]));
+    };
+    auto addIntColumn = [&addColumn, &columns](uint32_t columnId) {
+        addColumn(columns.getColumn(columnId).getIntValues());
+    };
+    // log levels serve directly as indices into the fixed log level dictionary
+    static_assert(sizeof(ELogLevel) == sizeof(int32_t));
+    addIntColumn(AC_RECORD_ID);
+    addIntColumn(AC_TIME);
+    addColumn(columns.getColumn(AC_LEVEL).getLogLevelValues());
+    addIntColumn(AC_THREAD_ID);
+    addColumn(batch.m_dictionaryIndices[AD_THREAD_NAME]);
+    addColumn(batch.m_dictionaryIndices[AD_LOG_SOURCE]);
+    addColumn(batch.m_dictionaryIndices[AD_MODULE]);
+    addColumn(batch.m_dictionaryIndices[AD_FILE]);
+    addIntColumn(AC_LINE);
+    addColumn(batch.m_dictionaryIndices[AD_FUNCTION]);
+    addColumn(batch.m_msgOffsets);
+    message.addBuffer(batch.m_msgData.data(), batch.m_msgData.size());
+    message.encodeRecordBatch(rowCount);
+    bool res = message.write(m_segmentFile, m_segmentBytes);
+    batch.clear();
+    if (!res) {
+        return false;
+    }
+
+    // switch segment if needed
+    if (m_segmentLimitBytes > 0 && m_segmentBytes >= m_segmentLimitBytes) {
+        if (!closeSegment()) {
+            return false;
+        }
+        ++m_segmentId;
+        if (m_segmentCount > 0 && m_segmentId >= m_segmentCount) {
+            m_segmentId = 0;
+        }
+        return openSegment();
+    }
+    return true;
+}
+
+}  // namespace elog
@@ -0,0 +1,419 @@
+#include "file/elog_arrow_ipc.h"
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+
+#include "elog_report.h"
+
+// Arrow format constants (see Schema.fbs and Message.fbs in the Arrow format specification)
+#define ARROW_METADATA_VERSION_V5 4
+#define ARROW_HEADER_SCHEMA 1
+#define ARROW_HEADER_DICTIONARY_BATCH 2
+#define ARROW_HEADER_RECORD_BATCH 3
+#define ARROW_TYPE_INT 2
+#define ARROW_TYPE_UTF8 5
+#define ARROW_TYPE_TIMESTAMP 10
+#define ARROW_TIME_UNIT_NANOS 3
+#define ARROW_CONTINUATION_MARKER 0xFFFFFFFFu
+#define ARROW_ALIGNMENT 8
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogArrowIpc)
+
+inline uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+inline void appendScalar(std::string& buffer, uint64_t value, uint32_t size) {
+    // flatbuffers and Arrow are both little endian
+    for (uint32_t i = 0; i < size; ++i) {
+        buffer.push_back((char)((value >> (8 * i)) & 0xFF));
+    }
+}
+
+inline void patchScalar(std::string& buffer, size_t pos, uint64_t value, uint32_t size) {
+    for (uint32_t i = 0; i < size; ++i) {
+        buffer[pos + i] = (char)((value >> (8 * i)) & 0xFF);
+    }
+}
+
+inline void padBuffer(std::string& buffer, size_t alignment, size_t shift = 0) {
+    while ((buffer.size() + shift) % alignment != 0) {
+        buffer.push_back(0);
+    }
+}
+
+// A minimal flatbuffers serializer. Objects are collected into a tree and then serialized front
+// to back, so that every offset points forward, as required by the flatbuffers format.
+class ELogFbObject {
+public:
+    enum class Kind : uint32_t { FK_TABLE, FK_STRING, FK_OFFSET_VECTOR, FK_STRUCT_VECTOR };
+
+    ELogFbObject(Kind kind) : m_kind(kind), m_count(0) {}
+
+    inline ELogFbObject* addScalar(uint16_t fieldId, uint64_t value, uint8_t size) {
+        m_fields.push_back({fieldId, size, value, nullptr});
+        return this;
+    }
+
+    inline ELogFbObject* addObject(uint16_t fieldId, ELogFbObject* object) {
+        m_fields.push_back({fieldId, 4, 0, object});
+        return this;
+    }
+
+private:
+    struct Field {
+        uint16_t m_fieldId;
+        uint8_t m_size;
+        uint64_t m_value;
+        ELogFbObject* m_object;
+    };
+
+    Kind m_kind;
+    std::vector<Field> m_fields;
+    std::vector<ELogFbObject*> m_elements;
+    std::string m_data;
+    uint32_t m_count;
+
+    friend class ELogFbBuilder;
+};
+
+class ELogFbBuilder {
+public:
+    ELogFbBuilder() {}
+    ELogFbBuilder(const ELogFbBuilder&) = delete;
+    ELogFbBuilder(ELogFbBuilder&&) = delete;
+    ELogFbBuilder& operator=(const ELogFbBuilder&) = delete;
+    ~ELogFbBuilder() {}
+
+    inline ELogFbObject* createTable() {
+        return &m_objects.emplace_back(ELogFbObject::Kind::FK_TABLE);
+    }
+
+    inline ELogFbObject* createString(const std::string& str) {
+        ELogFbObject* object = &m_objects.emplace_back(ELogFbObject::Kind::FK_STRING);
+        object->m_data = str;
+        return object;
+    }
+
+    inline ELogFbObject* createOffsetVector(const std::vector<ELogFbObject*>& elements) {
+        ELogFbObject* object = &m_objects.emplace_back(ELogFbObject::Kind::FK_OFFSET_VECTOR);
+        object->m_elements = elements;
+        return object;
+    }
+
+    // NOTE: struct elements are assumed to require 8 bytes alignment
+    inline ELogFbObject* createStructVector(const void* data, uint32_t elementSize,
+                                            uint32_t count) {
+        ELogFbObject* object = &m_objects.emplace_back(ELogFbObject::Kind::FK_STRUCT_VECTOR);
+        object->m_data.assign((const char*)data, (size_t)elementSize * count);
+        object->m_count = count;
+        return object;
+    }
+
+    /** @brief Serializes the object tree into a flatbuffer. */
+    void finish(ELogFbObject* root, std::string& buffer) {
+        buffer.clear();
+        appendScalar(buffer, 0, 4);
+        uint32_t rootPos = serialize(root, buffer);
+        patchScalar(buffer, 0, rootPos, 4);
+    }
+
+private:
+    std::deque<ELogFbObject> m_objects;
+
+    uint32_t serialize(ELogFbObject* object, std::string& buffer);
+    uint32_t serializeTable(ELogFbObject* object, std::string& buffer);
+};
+
+uint32_t ELogFbBuilder::serialize(ELogFbObject* object, std::string& buffer) {
+    uint32_t pos = 0;
+    switch (object->m_kind) {
+        case ELogFbObject::Kind::FK_TABLE:
+            return serializeTable(object, buffer);
+
+        case ELogFbObject::Kind::FK_STRING:
+            padBuffer(buffer, 4);
+            pos = (uint32_t)buffer.size();
+            appendScalar(buffer, object->m_data.size(), 4);
+            buffer.append(object->m_data);
+            buffer.push_back(0);
+            return pos;
+
+        case ELogFbObject::Kind::FK_OFFSET_VECTOR: {
+            padBuffer(buffer, 4);
+            pos = (uint32_t)buffer.size();
+            appendScalar(buffer, object->m_elements.size(), 4);
+            size_t slotPos = buffer.size();
+            buffer.append(object->m_elements.size() * 4, 0);
+            for (size_t i = 0; i < object->m_elements.size(); ++i) {
+                uint32_t elementPos = serialize(object->m_elements[i], buffer);
+                patchScalar(buffer, slotPos + i * 4, elementPos - (slotPos + i * 4), 4);
+            }
+            return pos;
+        }
+
+        case ELogFbObject::Kind::FK_STRUCT_VECTOR:
+        default:
+            // length prefix is placed right before the 8 bytes aligned elements
+            padBuffer(buffer, 8, 4);
+            pos = (uint32_t)buffer.size();
+            appendScalar(buffer, object->m_count, 4);
+            buffer.append(object->m_data);
+            return pos;
+    }
+}
+
+uint32_t ELogFbBuilder::serializeTable(ELogFbObject* object, std::string& buffer) {
+    // inline fields are ordered by size, so that natural alignment is kept without padding
+    std::vector<ELogFbObject::Field>& fields = object->m_fields;
+    std::stable_sort(fields.begin(), fields.end(),
+                     [](const ELogFbObject::Field& lhs, const ELogFbObject::Field& rhs) {
+                         return lhs.m_size > rhs.m_size;
+                     });
+    uint16_t fieldCount = 0;
+    bool hasLongField = false;
+    for (const ELogFbObject::Field& field : fields) {
+        fieldCount = std::max(fieldCount, (uint16_t)(field.m_fieldId + 1));
+        hasLongField = hasLongField || field.m_size == 8;
+    }
+
+    // vtable comes first
+    padBuffer(buffer, 2);
+    size_t vtablePos = buffer.size();
+    uint16_t vtableSize = (uint16_t)(4 + 2 * fieldCount);
+    buffer.append(vtableSize, 0);
+
+    // table starts with the vtable signed offset, so long fields start at 8 bytes alignment
+    padBuffer(buffer, hasLongField ? 8 : 4, hasLongField ? 4 : 0);
+    size_t tablePos = buffer.size();
+    appendScalar(buffer, (uint64_t)(int64_t)(int32_t)(tablePos - vtablePos), 4);
+    std::vector<size_t> fieldPos(fields.size());
+    for (size_t i = 0; i < fields.size(); ++i) {
+        fieldPos[i] = buffer.size();
+        appendScalar(buffer, fields[i].m_value, fields[i].m_size);
+        patchScalar(buffer, vtablePos + 4 + 2 * fields[i].m_fieldId, fieldPos[i] - tablePos, 2);
+    }
+    patchScalar(buffer, vtablePos, vtableSize, 2);
+    patchScalar(buffer, vtablePos + 2, buffer.size() - tablePos, 2);
+
+    // referenced objects are serialized after the table
+    for (size_t i = 0; i < fields.size(); ++i) {
+        if (fields[i].m_object != nullptr) {
+            uint32_t objectPos = serialize(fields[i].m_object, buffer);
+            patchScalar(buffer, fieldPos[i], objectPos - fieldPos[i], 4);
+        }
+    }
+    return (uint32_t)tablePos;
+}
+
+static ELogFbObject* createIntType(ELogFbBuilder& builder, uint32_t bitWidth, bool isSigned) {
+    return builder.createTable()->addScalar(0, bitWidth, 4)->addScalar(1, isSigned ? 1 : 0, 1);
+}
+
+static ELogFbObject* createField(ELogFbBuilder& builder, const ELogArrowField& field) {
+    ELogFbObject* fieldTable = builder.createTable();
+    fieldTable->addObject(0, builder.createString(field.m_name));
+    fieldTable->addScalar(1, 0, 1);  // not nullable
+    switch (field.m_type) {
+        case ELogArrowType::AT_UINT32:
+            fieldTable->addScalar(2, ARROW_TYPE_INT, 1);
+            fieldTable->addObject(3, createIntType(builder, 32, false));
+            break;
+
+        case ELogArrowType::AT_UINT64:
+            fieldTable->addScalar(2, ARROW_TYPE_INT, 1);
+            fieldTable->addObject(3, createIntType(builder, 64, false));
+            break;
+
+        case ELogArrowType::AT_TIMESTAMP_NANOS: {
+            ELogFbObject* typeTable = builder.createTable();
+            typeTable->addScalar(0, ARROW_TIME_UNIT_NANOS, 2);
+            typeTable->addObject(1, builder.createString("UTC"));
+            fieldTable->addScalar(2, ARROW_TYPE_TIMESTAMP, 1);
+            fieldTable->addObject(3, typeTable);
+            break;
+        }
+
+        case ELogArrowType::AT_UTF8:
+        default:
+            fieldTable->addScalar(2, ARROW_TYPE_UTF8, 1);
+            fieldTable->addObject(3, builder.createTable());
+            break;
+    }
+    if (field.m_dictionaryId >= 0) {
+        ELogFbObject* dictTable = builder.createTable();
+        dictTable->addScalar(0, (uint64_t)field.m_dictionaryId, 8);
+        dictTable->addObject(1, createIntType(builder, 32, true));
+        fieldTable->addObject(4, dictTable);
+    }
+    // Arrow readers require the children vector even if it is empty
+    fieldTable->addObject(5, builder.createOffsetVector({}));
+    return fieldTable;
+}
+
+static ELogFbObject* createMessage(ELogFbBuilder& builder, uint8_t headerType,
+                                   ELogFbObject* header, uint64_t bodyLength) {
+    ELogFbObject* message = builder.createTable();
+    message->addScalar(0, ARROW_METADATA_VERSION_V5, 2);
+    message->addScalar(1, headerType, 1);
+    message->addObject(2, header);
+    message->addScalar(3, bodyLength, 8);
+    return message;
+}
+
+static void frameMetadata(ELogFbBuilder& builder, ELogFbObject* message, std::string& metadata) {
+    std::string flatBuffer;
+    builder.finish(message, flatBuffer);
+    // continuation marker and length prefix are followed by metadata padded to 8 bytes
+    padBuffer(flatBuffer, ARROW_ALIGNMENT);
+    metadata.clear();
+    appendScalar(metadata, ARROW_CONTINUATION_MARKER, 4);
+    appendScalar(metadata, flatBuffer.size(), 4);
+    metadata.append(flatBuffer);
+}
+
+void ELogArrowMessage::encodeSchema(const std::vector<ELogArrowField>& fields,
+                                    const ELogArrowMetadata& metadata) {
+    ELogFbBuilder builder;
+    std::vector<ELogFbObject*> fieldTables;
+    for (const ELogArrowField& field : fields) {
+        fieldTables.push_back(createField(builder, field));
+    }
+    std::vector<ELogFbObject*> keyValues;
+    for (const auto& keyValue : metadata) {
+        keyValues.push_back(builder.createTable()
+                                ->addObject(0, builder.createString(keyValue.first))
+                                ->addObject(1, builder.createString(keyValue.second)));
+    }
+    ELogFbObject* schema = builder.createTable();
+    schema->addScalar(0, 0, 2);  // little endian
+    schema->addObject(1, builder.createOffsetVector(fieldTables));
+    if (!keyValues.empty()) {
+        schema->addObject(2, builder.createOffsetVector(keyValues));
+    }
+    frameMetadata(builder, createMessage(builder, ARROW_HEADER_SCHEMA, schema, 0), m_metadata);
+    m_bodyBuffers.clear();
+    m_bodyLength = 0;
+}
+
+void ELogArrowMessage::beginBatch() {
+    m_nodes.clear();
+    m_bufferSpecs.clear();
+    m_bodyBuffers.clear();
+    m_bodyLength = 0;
+}
+
+void ELogArrowMessage::addFieldNode(uint64_t length) {
+    m_nodes.push_back({(int64_t)length, 0});
+}
+
+void ELogArrowMessage::addBuffer(const void* data, uint64_t length) {
+    m_bufferSpecs.push_back({(int64_t)m_bodyLength, (int64_t)length});
+    if (length > 0) {
+        m_bodyBuffers.push_back({data, length});
+        m_bodyLength += alignUp(length, ARROW_ALIGNMENT);
+    }
+}
+
+void ELogArrowMessage::encodeRecordBatch(uint64_t rowCount) {
+    encodeBatch(ARROW_HEADER_RECORD_BATCH, rowCount, -1, false);
+}
+
+void ELogArrowMessage::encodeDictionaryBatch(int64_t dictionaryId, uint64_t rowCount,
+                                             bool isDelta) {
+    encodeBatch(ARROW_HEADER_DICTIONARY_BATCH, rowCount, dictionaryId, isDelta);
+}
+
+void ELogArrowMessage::encodeBatch(uint8_t headerType, uint64_t rowCount, int64_t dictionaryId,
+                                   bool isDelta) {
+    static_assert(sizeof(FieldNode) == 16 && sizeof(BufferSpec) == 16);
+    ELogFbBuilder builder;
+    ELogFbObject* recordBatch = builder.createTable();
+    recordBatch->addScalar(0, rowCount, 8);
+    recordBatch->addObject(
+        1, builder.createStructVector(m_nodes.data(), sizeof(FieldNode), (uint32_t)m_nodes.size()));
+    recordBatch->addObject(2, builder.createStructVector(m_bufferSpecs.data(), sizeof(BufferSpec),
+                                                         (uint32_t)m_bufferSpecs.size()));
+    ELogFbObject* header = recordBatch;
+    if (headerType == ARROW_HEADER_DICTIONARY_BATCH) {
+        header = builder.createTable();
+        header->addScalar(0, (uint64_t)dictionaryId, 8);
+        header->addObject(1, recordBatch);
+        header->addScalar(2, isDelta ? 1 : 0, 1);
+    }
+    frameMetadata(builder, createMessage(builder, headerType, header, m_bodyLength), m_metadata);
+}
+
+bool ELogArrowMessage::write(FILE* file, uint64_t& bytesWritten) {
+    static const char sPadding[ARROW_ALIGNMENT] = {};
+    if (fwrite(m_metadata.data(), 1, m_metadata.size(), file) != m_metadata.size()) {
+        ELOG_REPORT_SYS_ERROR(fwrite, "Failed to write Arrow message metadata");
+        return false;
+    }
+    bytesWritten += m_metadata.size();
+    for (const BodyBuffer& bodyBuffer : m_bodyBuffers) {
+        size_t paddingLength =
+            (size_t)(alignUp(bodyBuffer.m_length, ARROW_ALIGNMENT) - bodyBuffer.m_length);
+        if (fwrite(bodyBuffer.m_data, 1, bodyBuffer.m_length, file) != bodyBuffer.m_length ||
+            (paddingLength > 0 && fwrite(sPadding, 1, paddingLength, file) != paddingLength)) {
+            ELOG_REPORT_SYS_ERROR(fwrite, "Failed to write Arrow message body");
+            return false;
+        }
+        bytesWritten += bodyBuffer.m_length + paddingLength;
+    }
+    return true;
+}
+
+bool ELogArrowMessage::writeEndOfStream(FILE* file, uint64_t& bytesWritten) {
+    std::string marker;
+    appendScalar(marker, ARROW_CONTINUATION_MARKER, 4);
+    appendScalar(marker, 0, 4);
+    if (fwrite(marker.data(), 1, marker.size(), file) != marker.size()) {
+        ELOG_REPORT_SYS_ERROR(fwrite, "Failed to write Arrow end-of-stream marker");
+        return false;
+    }
+    bytesWritten += marker.size();
+    return true;
+}
+
+int32_t ELogArrowDictionary::getIndex(const char* value, size_t length) {
+    std::string_view key(value, length);
+    auto itr = m_index.find(key);
+    if (itr != m_index.end()) {
+        return itr->second;
+    }
+    int32_t index = (int32_t)getSize();
+    m_index.emplace(std::string(key), index);
+    m_data.append(value, length);
+    m_offsets.push_back((int32_t)m_data.size());
+    return index;
+}
+
+void ELogArrowDictionary::encodeBatch(int64_t dictionaryId, ELogArrowMessage& message) {
+    uint32_t size = getSize();
+    int32_t baseOffset = m_offsets[m_writtenCount];
+    m_batchOffsets.clear();
+    for (uint32_t i = m_writtenCount; i <= size; ++i) {
+        m_batchOffsets.push_back(m_offsets[i] - baseOffset);
+    }
+    uint32_t count = size - m_writtenCount;
+    message.beginBatch();
+    message.addFieldNode(count);
+    message.addBuffer(nullptr, 0);
+    message.addBuffer(m_batchOffsets.data(), m_batchOffsets.size() * sizeof(int32_t));
+    message.addBuffer(m_data.data() + baseOffset, m_data.size() - baseOffset);
+    message.encodeDictionaryBatch(dictionaryId, count, m_writtenCount > 0);
+    m_writtenCount = size;
+}
+
+void ELogArrowDictionary::clear() {
+    m_index.clear();
+    m_offsets.resize(1);
+    m_data.clear();
+    m_writtenCount = 0;
+}
+
+}  // namespace elog
@@ -0,0 +1,160 @@
+#ifndef __ELOG_ARROW_IPC_H__
+#define __ELOG_ARROW_IPC_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace elog {
+
+/** @enum Arrow column types supported by the IPC stream encoder. */
+enum class ELogArrowType : uint32_t {
+    /** @var Unsigned 32 bit integer. */
+    AT_UINT32,
+
+    /** @var Unsigned 64 bit integer. */
+    AT_UINT64,
+
+    /** @var Time stamp in nanoseconds since the epoch (UTC). */
+    AT_TIMESTAMP_NANOS,
+
+    /** @var UTF-8 string (32 bit offsets). */
+    AT_UTF8
+};
+
+/** @struct Arrow schema field. */
+struct ELogArrowField {
+    /** @var The field name. */
+    const char* m_name;
+
+    /** @var The field type (the value type in case of dictionary encoded field). */
+    ELogArrowType m_type;
+
+    /** @var The dictionary id, or -1 if the field is not dictionary encoded (int32 indices). */
+    int64_t m_dictionaryId;
+};
+
+/** @typedef Schema custom metadata (key-value pairs). */
+typedef std::vector<std::pair<std::string, std::string>> ELogArrowMetadata;
+
+/**
+ * @brief Encodes a single Arrow IPC stream message (schema, dictionary batch or record batch).
+ * Message metadata is encoded with a minimal flatbuffers serializer, so no Arrow or flatbuffers
+ * dependency is required. Record batch body buffers are not copied, but rather referenced until
+ * the message is written, so they must remain valid until then.
+ */
+class ELogArrowMessage {
+public:
+    ELogArrowMessage() : m_bodyLength(0) {}
+    ELogArrowMessage(const ELogArrowMessage&) = delete;
+    ELogArrowMessage(ELogArrowMessage&&) = delete;
+    ELogArrowMessage& operator=(const ELogArrowMessage&) = delete;
+    ~ELogArrowMessage() {}
+
+    /** @brief Encodes a schema message. */
+    void encodeSchema(const std::vector<ELogArrowField>& fields,
+                      const ELogArrowMetadata& metadata);
+
+    /** @brief Starts building a record batch or dictionary batch. */
+    void beginBatch();
+
+    /** @brief Adds a field node (one per column) to the batch being built. */
+    void addFieldNode(uint64_t length);
+
+    /**
+     * @brief Adds a body buffer to the batch being built. Pass null and zero length for an absent
+     * validity bitmap.
+     */
+    void addBuffer(const void* data, uint64_t length);
+
+    /** @brief Encodes a record batch message, from the nodes and buffers added. */
+    void encodeRecordBatch(uint64_t rowCount);
+
+    /** @brief Encodes a dictionary batch message, from the nodes and buffers added. */
+    void encodeDictionaryBatch(int64_t dictionaryId, uint64_t rowCount, bool isDelta);
+
+    /** @brief Writes the encoded message (metadata and body) to a file. */
+    bool write(FILE* file, uint64_t& bytesWritten);
+
+    /** @brief Writes the end-of-stream marker to a file. */
+    static bool writeEndOfStream(FILE* file, uint64_t& bytesWritten);
+
+private:
+    struct FieldNode {
+        int64_t m_length;
+        int64_t m_nullCount;
+    };
+
+    struct BufferSpec {
+        int64_t m_offset;
+        int64_t m_length;
+    };
+
+    struct BodyBuffer {
+        const void* m_data;
+        uint64_t m_length;
+    };
+
+    std::string m_metadata;
+    std::vector<FieldNode> m_nodes;
+    std::vector<BufferSpec> m_bufferSpecs;
+    std::vector<BodyBuffer> m_bodyBuffers;
+    uint64_t m_bodyLength;
+
+    void encodeBatch(uint8_t headerType, uint64_t rowCount, int64_t dictionaryId, bool isDelta);
+};
+
+/**
+ * @brief A dictionary of UTF-8 strings for dictionary-encoded columns. Values are stored in Arrow
+ * layout (offsets and data), so new entries can be written directly as delta dictionary batches.
+ */
+class ELogArrowDictionary {
+public:
+    ELogArrowDictionary() : m_writtenCount(0) { m_offsets.push_back(0); }
+    ELogArrowDictionary(const ELogArrowDictionary&) = delete;
+    ELogArrowDictionary(ELogArrowDictionary&&) = delete;
+    ELogArrowDictionary& operator=(const ELogArrowDictionary&) = delete;
+    ~ELogArrowDictionary() {}
+
+    /** @brief Retrieves the index of a value, adding it to the dictionary if needed. */
+    int32_t getIndex(const char* value, size_t length);
+
+    /** @brief Retrieves the number of values in the dictionary. */
+    inline uint32_t getSize() const { return (uint32_t)(m_offsets.size() - 1); }
+
+    /** @brief Retrieves the number of values already written to the stream. */
+    inline uint32_t getWrittenCount() const { return m_writtenCount; }
+
+    /**
+     * @brief Encodes a dictionary batch with all values not written yet, and marks them as
+     * written. The first batch is a full dictionary batch, and the next ones are delta batches.
+     */
+    void encodeBatch(int64_t dictionaryId, ELogArrowMessage& message);
+
+    /** @brief Removes all values (required when starting a new stream). */
+    void clear();
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        inline size_t operator()(std::string_view value) const {
+            return std::hash<std::string_view>()(value);
+        }
+    };
+
+    std::unordered_map<std::string, int32_t, Hash, std::equal_to<>> m_index;
+    std::vector<int32_t> m_offsets;
+    std::string m_data;
+    uint32_t m_writtenCount;
+
+    // offsets of the last encoded batch, rebased to zero
+    std::vector<int32_t> m_batchOffsets;
+};
+
+}  // namespace elog
+
+#endif  // __ELOG_ARROW_IPC_H__
@@ -20,9 +20,8 @@ bool ELogBufferedStats::initialize(uint32_t maxThreads) {
     if (!ELogStats::initialize(maxThreads)) {
         return false;
     }
-    if (!m_bufferWriteCount.initialize(maxThreads) || !m_bufferByteCount.initialize(maxThreads) ||
-        !m_bufferWriteFailCount.initialize(maxThreads) ||
-        !m_bufferByteFailCount.initialize(maxThreads)) {
+    if (!bindStatVar(m_bufferWriteCount) || !bindStatVar(m_bufferByteCount) ||
+        !bindStatVar(m_bufferWriteFailCount) || !bindStatVar(m_bufferByteFailCount)) {
         ELOG_REPORT_ERROR("Failed to initialize buffered file target statistics variables");
         terminate();
         return false;
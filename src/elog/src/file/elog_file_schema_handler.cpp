@@ -3,15 +3,19 @@
 #include "elog_common.h"
 #include "elog_config_loader.h"
 #include "elog_report.h"
+#include "file/elog_arrow_file_target.h"
 #include "file/elog_buffered_file_target.h"
 #include "file/elog_file_target.h"
 #include "file/elog_segmented_file_target.h"
 
 namespace elog {
 
+ELOG_DECLARE_REPORT_LOGGER(ELogFileSchemaHandler)
+
 ELOG_IMPLEMENT_SCHEMA_HANDLER(ELogFileSchemaHandler)
 
 static const char* LOG_SUFFIX = ".log";
+static const char* ARROW_SUFFIX = ".arrows";
 
 ELogTarget* ELogFileSchemaHandler::loadTarget(const ELogConfigMapNode* logTargetCfg) {
     // path should be already parsed
@@ -58,13 +62,33 @@ ELogTarget* ELogFileSchemaHandler::loadTarget(const ELogConfigMapNode* logTarget
         return nullptr;
     }
 
-    // finally, there could be an optional property enable_stats
+    // there could be an optional property enable_stats
     bool enableStats = true;
     if (!ELogConfigLoader::getOptionalLogTargetBoolProperty(logTargetCfg, "file", "enable_stats",
                                                             enableStats)) {
         return nullptr;
     }
 
+    // finally, there could be an optional property file_format (text or arrow)
+    std::string fileFormat = "text";
+    if (!ELogConfigLoader::getOptionalLogTargetStringProperty(logTargetCfg, "file", "file_format",
+                                                              fileFormat)) {
+        return nullptr;
+    }
+    if (fileFormat.compare("arrow") == 0) {
+        // arrow format has an optional property arrow_batch_size
+        uint32_t batchSize = ELOG_DEFAULT_ARROW_BATCH_SIZE;
+        if (!ELogConfigLoader::getOptionalLogTargetUInt32Property(
+                logTargetCfg, "file", "arrow_batch_size", batchSize)) {
+            return nullptr;
+        }
+        return createArrowLogTarget(path, batchSize, segmentSizeBytes, segmentCount, enableStats);
+    } else if (fileFormat.compare("text") != 0) {
+        ELOG_REPORT_ERROR("Invalid file log target format '%s' (context: %s)", fileFormat.c_str(),
+                          logTargetCfg->getFullContext());
+        return nullptr;
+    }
+
     return createLogTarget(path, bufferSizeBytes, useFileLock, segmentSizeBytes, segmentRingSize,
                            segmentCount, enableStats);
 }
@@ -109,4 +133,23 @@ ELogTarget* ELogFileSchemaHandler::createLogTarget(const std::string& path,
     return logTarget;
 }
 
+ELogTarget* ELogFileSchemaHandler::createArrowLogTarget(const std::string& path,
+                                                        uint32_t batchSize,
+                                                        uint64_t segmentSizeBytes,
+                                                        uint32_t segmentCount, bool enableStats) {
+    std::string logPath;
+    std::string logName = path;
+    std::string::size_type lastSlashPos = path.find_last_of("\\/");
+    if (lastSlashPos != std::string::npos) {
+        logPath = path.substr(0, lastSlashPos);
+        logName = path.substr(lastSlashPos + 1);
+    }
+    if (logName.ends_with(ARROW_SUFFIX)) {
+        logName = logName.substr(0, logName.size() - strlen(ARROW_SUFFIX));
+    }
+    return new (std::nothrow)
+        ELogArrowFileTarget(logPath.c_str(), logName.c_str(), batchSize, segmentSizeBytes,
+                            segmentCount, nullptr, enableStats);
+}
+
 }  // namespace elog
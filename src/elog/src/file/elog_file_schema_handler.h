@@ -48,6 +48,21 @@ public:
                                        bool useFileLock, uint64_t segmentSizeBytes,
                                        uint32_t segmentRingSize, uint32_t segmentCount,
                                        bool enableStats);
+
+    /**
+     * @brief Create an Arrow file log target object.
+     *
+     * @param path The file path. In case of segmented/rotating file, the containing directory is
+     * used for log segments.
+     * @param batchSize The maximum number of log records in each record batch.
+     * @param segmentSizeBytes Segment size limit in bytes. Specify zero for not using segments.
+     * @param segmentCount Segment count limitation, causing segments to rotate.
+     * @param enableStats Specifies whether log target statistics should be collected.
+     * @return ELogTarget* The resulting log target or null if failed.
+     */
+    static ELogTarget* createArrowLogTarget(const std::string& path, uint32_t batchSize,
+                                            uint64_t segmentSizeBytes, uint32_t segmentCount,
+                                            bool enableStats);
 };
 
 }  // namespace elog
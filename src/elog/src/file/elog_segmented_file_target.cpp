@@ -477,10 +477,9 @@ bool ELogSegmentedFileTarget::SegmentedStats::initialize(uint32_t maxThreads) {
     if (!ELogStats::initialize(maxThreads)) {
         return false;
     }
-    if (!m_segmentCount.initialize(maxThreads) || !m_openSegmentFailCount.initialize(maxThreads) ||
-        !m_closeSegmentFailCount.initialize(maxThreads) ||
-        !m_closedSegmentBytes.initialize(maxThreads) || !m_pendingMsgCount.initialize(maxThreads) ||
-        !m_bufferedStats.initialize(maxThreads)) {
+    if (!bindStatVar(m_segmentCount) || !bindStatVar(m_openSegmentFailCount) ||
+        !bindStatVar(m_closeSegmentFailCount) || !bindStatVar(m_closedSegmentBytes) ||
+        !bindStatVar(m_pendingMsgCount) || !m_bufferedStats.initialize(maxThreads)) {
         ELOG_REPORT_ERROR("Failed to initialize segmented file target statistics variables");
         terminate();
         return false;
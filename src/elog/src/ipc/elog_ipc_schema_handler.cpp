@@ -9,6 +9,7 @@
 #include "elog_report.h"
 #include "elog_schema_handler_internal.h"
 #include "ipc/elog_pipe_target_provider.h"
+#include "ipc/elog_shm_target_provider.h"
 
 namespace elog {
 
@@ -21,6 +22,11 @@ bool ELogIpcSchemaHandler::registerPredefinedProviders() {
     if (!initNamedTargetProvider<ELogPipeTargetProvider>(ELOG_REPORT_LOGGER, this, "pipe")) {
         return false;
     }
+#ifdef ELOG_LINUX
+    if (!initTargetProvider<ELogShmTargetProvider>(ELOG_REPORT_LOGGER, this, "shm")) {
+        return false;
+    }
+#endif
     return true;
 }
 
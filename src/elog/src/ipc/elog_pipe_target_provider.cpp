@@ -39,6 +39,8 @@ ELogTarget* ELogPipeTargetProvider::loadTarget(const ELogConfigMapNode* logTarge
     //  binary_format={protobuf/thrift/avro}&
     //  compress=value&
     //  max_concurrent_requests=value&
+    //  connections=value&
+    //  shard_by=[thread/round_robin]&
     //  connect_timeout=value&
     //  send_timeout=value&
     //  resend_period=value&
@@ -67,18 +69,28 @@ ELogTarget* ELogPipeTargetProvider::loadTarget(const ELogConfigMapNode* logTarge
         return nullptr;
     }
 
-    commutil::DataClient* dataClient = new (std::nothrow)
-        commutil::PipeClient(pipeName.c_str(), msgConfig.m_commConfig.m_connectTimeoutMillis);
-    if (dataClient == nullptr) {
-        ELOG_REPORT_ERROR("Failed to allocate data client, out of memory");
-        delete msgConfig.m_binaryFormatProvider;
-        return nullptr;
+    // create the data clients (one per connection)
+    std::vector<commutil::DataClient*> dataClients;
+    for (uint32_t i = 0; i < msgConfig.m_connectionCount; ++i) {
+        commutil::DataClient* dataClient = new (std::nothrow)
+            commutil::PipeClient(pipeName.c_str(), msgConfig.m_commConfig.m_connectTimeoutMillis);
+        if (dataClient == nullptr) {
+            ELOG_REPORT_ERROR("Failed to allocate data client, out of memory");
+            for (commutil::DataClient* client : dataClients) {
+                delete client;
+            }
+            delete msgConfig.m_binaryFormatProvider;
+            return nullptr;
+        }
+        dataClients.push_back(dataClient);
     }
 
-    ELogMsgTarget* target = new (std::nothrow) ELogMsgTarget("pipe", msgConfig, dataClient);
+    ELogMsgTarget* target = new (std::nothrow) ELogMsgTarget("pipe", msgConfig, dataClients);
     if (target == nullptr) {
         ELOG_REPORT_ERROR("Failed to allocate pipe log target, out of memory");
-        delete dataClient;
+        for (commutil::DataClient* client : dataClients) {
+            delete client;
+        }
         delete msgConfig.m_binaryFormatProvider;
     }
     return target;
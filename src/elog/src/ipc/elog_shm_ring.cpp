@@ -0,0 +1,477 @@
+#include "ipc/elog_shm_ring.h"
+
+#if defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <climits>
+#include <cstring>
+
+#include "elog_report.h"
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogShmRing)
+
+inline int futexWait(std::atomic<uint32_t>* addr, uint32_t value, uint64_t timeoutMillis) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(timeoutMillis / 1000);
+    ts.tv_nsec = (long)((timeoutMillis % 1000) * 1000000ull);
+    // NOTE: not using FUTEX_PRIVATE_FLAG, since the futex word resides in shared memory
+    return (int)syscall(SYS_futex, (uint32_t*)addr, FUTEX_WAIT, value, &ts, nullptr, 0);
+}
+
+inline int futexWake(std::atomic<uint32_t>* addr) {
+    return (int)syscall(SYS_futex, (uint32_t*)addr, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+inline uint64_t roundUpPowerOf2(uint64_t value) {
+    uint64_t res = 1;
+    while (res < value) {
+        res <<= 1;
+    }
+    return res;
+}
+
+inline uint64_t getSteadyMillis() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+inline uint32_t getDataOffset() {
+    return (uint32_t)((sizeof(ELogShmRingHeader) + ELOG_CACHE_LINE - 1) &
+                      ~(uint64_t)(ELOG_CACHE_LINE - 1));
+}
+
+bool ELogShmRing::create(const char* name, uint64_t capacity) {
+    if (isOpen()) {
+        ELOG_REPORT_ERROR("Cannot create shared memory ring %s, already open", name);
+        return false;
+    }
+    capacity = roundUpPowerOf2(capacity);
+    if (capacity < ELOG_SHM_RING_MIN_SIZE || capacity > ELOG_SHM_RING_MAX_SIZE) {
+        ELOG_REPORT_ERROR("Invalid shared memory ring size %" PRIu64 " (allowed range: %" PRIu64
+                          " - %" PRIu64 ")",
+                          capacity, ELOG_SHM_RING_MIN_SIZE, ELOG_SHM_RING_MAX_SIZE);
+        return false;
+    }
+
+    m_shmName = std::string("/") + ELOG_SHM_RING_PREFIX + name;
+    m_fd = shm_open(m_shmName.c_str(), O_CREAT | O_RDWR, 0666);
+    if (m_fd == -1) {
+        ELOG_REPORT_SYS_ERROR(shm_open, "Failed to create shared memory object %s",
+                              m_shmName.c_str());
+        return false;
+    }
+
+    // the writer holds a shared lock while attached, so the consumer can tell whether it is alive
+    // (the lock is released automatically by the kernel if the writer process dies)
+    if (flock(m_fd, LOCK_SH) == -1) {
+        ELOG_REPORT_SYS_ERROR(flock, "Failed to lock shared memory object %s", m_shmName.c_str());
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    // if segment already exists with a matching layout (e.g. writer restarted while a collector is
+    // still attached), then we reuse it as is, otherwise it is initialized from scratch
+    uint64_t mapSize = getDataOffset() + capacity;
+    struct stat st;
+    bool reuse = false;
+    if (fstat(m_fd, &st) == 0 && (uint64_t)st.st_size == mapSize) {
+        reuse = true;
+    } else if (ftruncate(m_fd, (off_t)mapSize) == -1) {
+        ELOG_REPORT_SYS_ERROR(ftruncate, "Failed to set size of shared memory object %s",
+                              m_shmName.c_str());
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    if (!mapSegment(mapSize, false)) {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    if (reuse && (m_header->m_magic != ELOG_SHM_RING_MAGIC ||
+                  m_header->m_version != ELOG_SHM_RING_VERSION ||
+                  m_header->m_capacity != capacity)) {
+        reuse = false;
+    }
+    if (!reuse) {
+        memset((void*)m_header, 0, mapSize);
+        m_header->m_version = ELOG_SHM_RING_VERSION;
+        m_header->m_dataOffset = getDataOffset();
+        m_header->m_capacity = capacity;
+        m_header->m_createTimeEpochMillis =
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        m_header->m_reservePos.store(0, std::memory_order_relaxed);
+        m_header->m_readPos.store(0, std::memory_order_relaxed);
+        m_header->m_futexWord.store(0, std::memory_order_relaxed);
+        m_header->m_waiterCount.store(0, std::memory_order_relaxed);
+        m_header->m_recordCount.store(0, std::memory_order_relaxed);
+        m_header->m_dropCount.store(0, std::memory_order_relaxed);
+        m_header->m_abandonCount.store(0, std::memory_order_relaxed);
+        m_header->m_reclaimPos.store(0, std::memory_order_relaxed);
+    } else {
+        // any record still uncommitted below this point was abandoned by the previous writer
+        m_header->m_reclaimPos.store(m_header->m_reservePos.load(std::memory_order_acquire),
+                                     std::memory_order_release);
+    }
+    m_header->m_writerPid = (uint64_t)getpid();
+
+    // publish magic last, so that readers see a fully initialized segment
+    std::atomic_thread_fence(std::memory_order_release);
+    m_header->m_magic = ELOG_SHM_RING_MAGIC;
+    m_data = (char*)m_header + m_header->m_dataOffset;
+    m_capacity = capacity;
+    m_mask = capacity - 1;
+    m_isOwner = true;
+    return true;
+}
+
+bool ELogShmRing::open(const char* name) {
+    if (isOpen()) {
+        ELOG_REPORT_ERROR("Cannot open shared memory ring %s, already open", name);
+        return false;
+    }
+    m_shmName = std::string("/") + ELOG_SHM_RING_PREFIX + name;
+    m_fd = shm_open(m_shmName.c_str(), O_RDWR, 0666);
+    if (m_fd == -1) {
+        ELOG_REPORT_SYS_ERROR(shm_open, "Failed to open shared memory object %s",
+                              m_shmName.c_str());
+        return false;
+    }
+    struct stat st;
+    if (fstat(m_fd, &st) == -1) {
+        ELOG_REPORT_SYS_ERROR(fstat, "Failed to get size of shared memory object %s",
+                              m_shmName.c_str());
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    uint64_t mapSize = (uint64_t)st.st_size;
+    if (mapSize < getDataOffset() + ELOG_SHM_RING_MIN_SIZE) {
+        ELOG_REPORT_ERROR("Shared memory object %s is too small (%" PRIu64 " bytes)",
+                          m_shmName.c_str(), mapSize);
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    if (!mapSegment(mapSize, false)) {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    if (m_header->m_magic != ELOG_SHM_RING_MAGIC ||
+        m_header->m_version != ELOG_SHM_RING_VERSION ||
+        m_header->m_dataOffset + m_header->m_capacity != mapSize) {
+        ELOG_REPORT_ERROR("Shared memory object %s is not a valid ELog ring segment",
+                          m_shmName.c_str());
+        (void)close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    m_data = (char*)m_header + m_header->m_dataOffset;
+    m_capacity = m_header->m_capacity;
+    m_mask = m_capacity - 1;
+    m_isOwner = false;
+    return true;
+}
+
+bool ELogShmRing::close(bool unlink /* = false */) {
+    bool res = true;
+    if (m_header != nullptr) {
+        if (munmap((void*)m_header, m_mapSize) == -1) {
+            ELOG_REPORT_SYS_ERROR(munmap, "Failed to unmap shared memory object %s",
+                                  m_shmName.c_str());
+            res = false;
+        }
+        m_header = nullptr;
+        m_data = nullptr;
+    }
+    if (m_fd != -1) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    if (unlink && !m_shmName.empty()) {
+        if (shm_unlink(m_shmName.c_str()) == -1) {
+            ELOG_REPORT_SYS_ERROR(shm_unlink, "Failed to remove shared memory object %s",
+                                  m_shmName.c_str());
+            res = false;
+        }
+    }
+    m_capacity = 0;
+    m_mask = 0;
+    m_mapSize = 0;
+    m_peekSize = 0;
+    m_stallPos = UINT64_MAX;
+    m_stallTimeMillis = 0;
+    return res;
+}
+
+bool ELogShmRing::write(const char* data, uint32_t length) {
+    uint64_t recordSize = alignRecordSize(sizeof(ELogShmRecordHeader) + length);
+    if (recordSize > m_capacity) {
+        m_header->m_dropCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // reserve space (including padding up to the end of the data area if record does not fit)
+    uint64_t pos = m_header->m_reservePos.load(std::memory_order_relaxed);
+    uint64_t padSize = 0;
+    uint64_t newPos = 0;
+    do {
+        uint64_t offset = pos & m_mask;
+        padSize = (offset + recordSize > m_capacity) ? (m_capacity - offset) : 0;
+        newPos = pos + padSize + recordSize;
+        if (newPos - m_header->m_readPos.load(std::memory_order_acquire) > m_capacity) {
+            m_header->m_dropCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!m_header->m_reservePos.compare_exchange_weak(pos, newPos, std::memory_order_acq_rel,
+                                                           std::memory_order_relaxed));
+
+    // commit padding record first (it precedes the actual record)
+    if (padSize > 0) {
+        ELogShmRecordHeader* padHeader = getRecordHeader(pos);
+        padHeader->m_payloadSize = (uint32_t)(padSize - sizeof(ELogShmRecordHeader));
+        padHeader->m_commitWord.store(ELOG_SHM_RECORD_PADDING, std::memory_order_release);
+    }
+
+    // publish record size first, so the consumer can skip the record if we crash while copying
+    ELogShmRecordHeader* recordHeader = getRecordHeader(pos + padSize);
+    recordHeader->m_payloadSize = length;
+    recordHeader->m_commitWord.store(ELOG_SHM_RECORD_RESERVED, std::memory_order_release);
+
+    // copy record data and commit
+    memcpy((char*)(recordHeader + 1), data, length);
+    recordHeader->m_commitWord.store(ELOG_SHM_RECORD_COMMITTED, std::memory_order_release);
+    m_header->m_recordCount.fetch_add(1, std::memory_order_relaxed);
+
+    notify();
+    return true;
+}
+
+void ELogShmRing::notify() {
+    // pairs with the fence in wait(): either we see the waiter, or the waiter sees our commit
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_header->m_waiterCount.load(std::memory_order_relaxed) > 0) {
+        m_header->m_futexWord.fetch_add(1, std::memory_order_release);
+        (void)futexWake(&m_header->m_futexWord);
+    }
+}
+
+bool ELogShmRing::peek(const char*& data, uint32_t& length) {
+    for (;;) {
+        uint64_t pos = m_header->m_readPos.load(std::memory_order_relaxed);
+        ELogShmRecordHeader* recordHeader = getRecordHeader(pos);
+        uint32_t state = recordHeader->m_commitWord.load(std::memory_order_acquire);
+        if (state == ELOG_SHM_RECORD_EMPTY || state == ELOG_SHM_RECORD_RESERVED) {
+            if (!recoverStalledRecord(pos)) {
+                return false;
+            }
+            continue;
+        }
+        uint64_t recordSize =
+            alignRecordSize(sizeof(ELogShmRecordHeader) + recordHeader->m_payloadSize);
+        if (state == ELOG_SHM_RECORD_PADDING) {
+            releaseSpace(pos, recordSize);
+            continue;
+        }
+        data = (const char*)(recordHeader + 1);
+        length = recordHeader->m_payloadSize;
+        m_peekSize = recordSize;
+        m_stallPos = UINT64_MAX;
+        return true;
+    }
+}
+
+void ELogShmRing::consume() {
+    if (m_peekSize > 0) {
+        releaseSpace(m_header->m_readPos.load(std::memory_order_relaxed), m_peekSize);
+        m_peekSize = 0;
+    }
+}
+
+bool ELogShmRing::wait(uint64_t timeoutMillis) {
+    const char* data = nullptr;
+    uint32_t length = 0;
+    if (peek(data, length)) {
+        return true;
+    }
+    uint32_t futexValue = m_header->m_futexWord.load(std::memory_order_acquire);
+    m_header->m_waiterCount.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!peek(data, length)) {
+        // if a producer already bumped the futex word, this returns immediately
+        (void)futexWait(&m_header->m_futexWord, futexValue, timeoutMillis);
+    }
+    m_header->m_waiterCount.fetch_sub(1, std::memory_order_relaxed);
+    return peek(data, length);
+}
+
+bool ELogShmRing::inspect(uint64_t& pos, const char*& data, uint32_t& length) const {
+    uint64_t reservePos = m_header->m_reservePos.load(std::memory_order_acquire);
+    while (pos < reservePos) {
+        const ELogShmRecordHeader* recordHeader = getRecordHeader(pos);
+        uint32_t state = recordHeader->m_commitWord.load(std::memory_order_acquire);
+        if (state == ELOG_SHM_RECORD_EMPTY) {
+            return false;
+        }
+        uint64_t recordSize =
+            alignRecordSize(sizeof(ELogShmRecordHeader) + recordHeader->m_payloadSize);
+        pos += recordSize;
+        if (state == ELOG_SHM_RECORD_COMMITTED) {
+            data = (const char*)(recordHeader + 1);
+            length = recordHeader->m_payloadSize;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ELogShmRing::listRings(ELogShmRingList& ringList) {
+    // POSIX shared memory objects are visible on Linux under /dev/shm
+    DIR* dir = opendir("/dev/shm");
+    if (dir == nullptr) {
+        ELOG_REPORT_SYS_ERROR(opendir, "Failed to list shared memory objects");
+        return false;
+    }
+    const size_t prefixLen = strlen(ELOG_SHM_RING_PREFIX);
+    struct dirent* entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (strncmp(entry->d_name, ELOG_SHM_RING_PREFIX, prefixLen) != 0) {
+            continue;
+        }
+        std::string path = std::string("/dev/shm/") + entry->d_name;
+        struct stat st;
+        uint64_t size = 0;
+        if (stat(path.c_str(), &st) == 0) {
+            size = (uint64_t)st.st_size;
+        }
+        ringList.push_back({entry->d_name + prefixLen, size});
+    }
+    closedir(dir);
+    return true;
+}
+
+bool ELogShmRing::unlinkRing(const char* name) {
+    std::string shmName = std::string("/") + ELOG_SHM_RING_PREFIX + name;
+    if (shm_unlink(shmName.c_str()) == -1) {
+        ELOG_REPORT_SYS_ERROR(shm_unlink, "Failed to remove shared memory object %s",
+                              shmName.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ELogShmRing::mapSegment(uint64_t mapSize, bool readOnly) {
+    int prot = readOnly ? PROT_READ : (PROT_READ | PROT_WRITE);
+    void* addr = mmap(nullptr, mapSize, prot, MAP_SHARED, m_fd, 0);
+    if (addr == MAP_FAILED) {
+        ELOG_REPORT_SYS_ERROR(mmap, "Failed to map shared memory object %s", m_shmName.c_str());
+        return false;
+    }
+    m_header = (ELogShmRingHeader*)addr;
+    m_mapSize = mapSize;
+    return true;
+}
+
+void ELogShmRing::releaseSpace(uint64_t pos, uint64_t size) {
+    // record boundaries differ between ring laps, so the entire area must be zeroed, such that
+    // producers in the next lap find only empty commit words (the area may wrap around only when
+    // skipping abandoned space of unknown record size)
+    uint64_t offset = pos & m_mask;
+    uint64_t headSize = std::min(size, m_capacity - offset);
+    memset(m_data + offset, 0, headSize);
+    if (headSize < size) {
+        memset(m_data, 0, size - headSize);
+    }
+    m_header->m_readPos.store(pos + size, std::memory_order_release);
+}
+
+bool ELogShmRing::recoverStalledRecord(uint64_t pos) {
+    // if nothing is reserved beyond the read position, then the ring is just empty
+    uint64_t reservePos = m_header->m_reservePos.load(std::memory_order_acquire);
+    if (pos >= reservePos) {
+        return false;
+    }
+
+    // space reserved by a previous writer process will never be committed
+    uint64_t reclaimPos = m_header->m_reclaimPos.load(std::memory_order_acquire);
+    if (pos < reclaimPos) {
+        skipAbandonedRecord(pos, reclaimPos);
+        return true;
+    }
+
+    // otherwise the producer may be still writing the record, so we check whether the writer
+    // process is still alive, but only if the record is stuck for a while (to avoid a system call
+    // on each peek)
+    uint64_t nowMillis = getSteadyMillis();
+    if (pos != m_stallPos) {
+        m_stallPos = pos;
+        m_stallTimeMillis = nowMillis;
+        return false;
+    }
+    if (nowMillis - m_stallTimeMillis < ELOG_SHM_RING_LIVENESS_CHECK_MILLIS) {
+        return false;
+    }
+    m_stallTimeMillis = nowMillis;
+    if (flock(m_fd, LOCK_EX | LOCK_NB) == -1) {
+        if (errno != EWOULDBLOCK) {
+            ELOG_REPORT_SYS_ERROR(flock, "Failed to check writer lock of shared memory object %s",
+                                  m_shmName.c_str());
+        }
+        return false;
+    }
+
+    // writer is gone, and no writer can attach while we hold the lock, so all space up to the
+    // reserve position is either committed or abandoned
+    skipAbandonedRecord(pos, m_header->m_reservePos.load(std::memory_order_acquire));
+    if (flock(m_fd, LOCK_UN) == -1) {
+        ELOG_REPORT_SYS_ERROR(flock, "Failed to unlock shared memory object %s",
+                              m_shmName.c_str());
+    }
+    return true;
+}
+
+void ELogShmRing::skipAbandonedRecord(uint64_t pos, uint64_t endPos) {
+    // record might have been committed just before the writer went away
+    ELogShmRecordHeader* recordHeader = getRecordHeader(pos);
+    uint32_t state = recordHeader->m_commitWord.load(std::memory_order_acquire);
+    if (state == ELOG_SHM_RECORD_COMMITTED || state == ELOG_SHM_RECORD_PADDING) {
+        return;
+    }
+
+    // if the producer died before publishing the record size, then the record boundary is unknown,
+    // and all space up to the end position is skipped (records committed there are lost)
+    uint64_t skipSize = endPos - pos;
+    if (state == ELOG_SHM_RECORD_RESERVED) {
+        skipSize = alignRecordSize(sizeof(ELogShmRecordHeader) + recordHeader->m_payloadSize);
+    }
+    ELOG_REPORT_WARN("Skipping abandoned record of %" PRIu64
+                     " bytes at position %" PRIu64 " in shared memory ring %s",
+                     skipSize, pos, m_shmName.c_str());
+    releaseSpace(pos, skipSize);
+    m_header->m_abandonCount.fetch_add(1, std::memory_order_relaxed);
+    m_stallPos = UINT64_MAX;
+}
+
+}  // namespace elog
+
+#endif  // defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
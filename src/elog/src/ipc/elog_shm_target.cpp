@@ -0,0 +1,50 @@
+#include "ipc/elog_shm_target.h"
+
+#if defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
+
+#include "elog_report.h"
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogShmTarget)
+
+ELOG_IMPLEMENT_LOG_TARGET(ELogShmTarget)
+
+bool ELogShmTarget::startLogTarget() {
+    if (!m_ring.create(m_ringName.c_str(), m_ringSize)) {
+        ELOG_REPORT_ERROR("Failed to create shared memory ring %s", m_ringName.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ELogShmTarget::stopLogTarget() {
+    // wake up any waiting collector, so it can drain remaining records
+    m_ring.notify();
+    if (!m_ring.close(m_unlinkOnStop)) {
+        ELOG_REPORT_ERROR("Failed to close shared memory ring %s", m_ringName.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ELogShmTarget::logFormattedMsg(const char* formattedLogMsg, size_t length) {
+    if (!m_ring.write(formattedLogMsg, (uint32_t)length)) {
+        ELOG_REPORT_MODERATE_ERROR_DEFAULT(
+            "Shared memory ring %s is full, log record dropped (total dropped: %" PRIu64 ")",
+            m_ringName.c_str(), getDropCount());
+        return false;
+    }
+    return true;
+}
+
+bool ELogShmTarget::flushLogTarget() {
+    // records are visible to the collector as soon as they are committed, so flush only makes sure
+    // the collector is awake
+    m_ring.notify();
+    return true;
+}
+
+}  // namespace elog
+
+#endif  // defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
@@ -0,0 +1,49 @@
+#include "ipc/elog_shm_target_provider.h"
+
+#if defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
+
+#include "elog_common.h"
+#include "elog_config_loader.h"
+#include "elog_report.h"
+#include "ipc/elog_shm_target.h"
+
+namespace elog {
+
+ELOG_DECLARE_REPORT_LOGGER(ELogShmTargetProvider)
+
+ELogTarget* ELogShmTargetProvider::loadTarget(const ELogConfigMapNode* logTargetCfg) {
+    // expected url is as follows:
+    // ipc://shm?address=ringName&
+    //  size=value&
+    //  unlink_on_stop=value
+    std::string ringName;
+    if (!ELogConfigLoader::getLogTargetStringProperty(logTargetCfg, "ipc", "address", ringName)) {
+        return nullptr;
+    }
+
+    uint64_t ringSize = ELOG_SHM_RING_DEFAULT_SIZE;
+    if (!ELogConfigLoader::getOptionalLogTargetSizeProperty(logTargetCfg, "ipc", "size", ringSize,
+                                                            ELogSizeUnits::SU_BYTES)) {
+        return nullptr;
+    }
+    if (!verifyUInt64PropRange("ipc", "size", ringSize, ELOG_SHM_RING_MIN_SIZE,
+                               ELOG_SHM_RING_MAX_SIZE, true, ELOG_SHM_RING_DEFAULT_SIZE)) {
+        return nullptr;
+    }
+
+    bool unlinkOnStop = false;
+    if (!ELogConfigLoader::getOptionalLogTargetBoolProperty(logTargetCfg, "ipc", "unlink_on_stop",
+                                                            unlinkOnStop)) {
+        return nullptr;
+    }
+
+    ELogTarget* target = new (std::nothrow) ELogShmTarget(ringName.c_str(), ringSize, unlinkOnStop);
+    if (target == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate shared memory log target, out of memory");
+    }
+    return target;
+}
+
+}  // namespace elog
+
+#endif  // defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
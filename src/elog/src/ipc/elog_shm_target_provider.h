@@ -0,0 +1,35 @@
+#ifndef __ELOG_SHM_TARGET_PROVIDER_H__
+#define __ELOG_SHM_TARGET_PROVIDER_H__
+
+#include "elog_def.h"
+
+#if defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
+
+#include "elog_config.h"
+#include "elog_target_provider.h"
+#include "elog_target_spec.h"
+
+namespace elog {
+
+/** @brief Provider for shared memory ring log targets. */
+class ELOG_API ELogShmTargetProvider : public ELogTargetProvider {
+public:
+    ELogShmTargetProvider() {}
+    ELogShmTargetProvider(const ELogShmTargetProvider&) = delete;
+    ELogShmTargetProvider(ELogShmTargetProvider&&) = delete;
+    ELogShmTargetProvider& operator=(const ELogShmTargetProvider&) = delete;
+    ~ELogShmTargetProvider() final {}
+
+    /**
+     * @brief Loads a target from configuration.
+     * @param logTargetCfg The configuration string.
+     * @return ELogTarget* The resulting shared memory log target, or null of failed.
+     */
+    ELogTarget* loadTarget(const ELogConfigMapNode* logTargetCfg) final;
+};
+
+}  // namespace elog
+
+#endif  // defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
+
+#endif  // __ELOG_SHM_TARGET_PROVIDER_H__
@@ -5,6 +5,7 @@
 #include "elog_common.h"
 #include "elog_field_selector_internal.h"
 #include "elog_json_receptor.h"
+#include "elog_json_writer.h"
 #include "elog_logger.h"
 #include "elog_report.h"
 
@@ -29,7 +30,8 @@ ELogDatadogTarget::ELogDatadogTarget(const char* serverAddress, const char* apiK
       m_tags(tags),
       m_stackTrace(stackTrace),
       m_compress(compress),
-      m_tagsFormatter(nullptr) {
+      m_tagsFormatter(nullptr),
+      m_logItemCount(0) {
     ELOG_REPORT_TRACE("Creating HTTP client to Datadog at: %s", serverAddress);
     m_client.initialize(serverAddress, "Datadog", config, this);
 }
@@ -53,8 +55,8 @@ bool ELogDatadogTarget::startLogTarget() {
         return false;
     }
 
-    // make sure the json object is of array type
-    m_logItemArray = nlohmann::json::array();
+    // log items are written directly into the request body, which is a JSON array
+    resetLogItems();
 
     return m_client.start();
 }
@@ -70,39 +72,54 @@ bool ELogDatadogTarget::stopLogTarget() {
 
 bool ELogDatadogTarget::writeLogRecord(const ELogRecord& logRecord, uint64_t& bytesWritten) {
     ELOG_REPORT_TRACE("Preapring log message for Datadog");
-    size_t index = m_logItemArray.size();
+
+    // tags are prepared first, since on failure nothing should be written
+    ELogJsonReceptor receptor;
+    fillInTags(logRecord, &receptor);
+    if (!prepareTagsString(getTagNames(), receptor.getPropValues(), m_tagsStr)) {
+        ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to prepare datadog tags");
+        return false;
+    }
+
+    // write log item directly as JSON into the pending request body
+    if (m_logItemCount > 0) {
+        m_logItems.push_back(',');
+    }
+    ELogJsonWriter<std::string> writer(m_logItems);
+    writer.beginObject();
 
     // log line
-    std::string logMsg;
-    formatLogMsg(logRecord, logMsg);
-    m_logItemArray[index]["message"] = logMsg;
-    bytesWritten = logMsg.length();
+    m_logMsg.clear();
+    formatLogMsg(logRecord, m_logMsg);
+    writer.writeStringMember("message", m_logMsg.c_str(), m_logMsg.length());
+    bytesWritten = m_logMsg.length();
 
     // more metadata
     const char* logLevelStr = elogLevelToStr(logRecord.m_logLevel);
-    m_logItemArray[index]["status"] = logLevelStr;
+    writer.writeStringMember("status", logLevelStr);
     bytesWritten += strlen(logLevelStr);
 
-    m_logItemArray[index]["hostname"] = getHostNameField();
+    writer.writeStringMember("hostname", getHostNameField());
     bytesWritten += strlen(getHostNameField());
 
     // TODO: this is not working well, neither as int, nor as string
-    // m_logItemArray[index]["timestamp"] = elogTimeToUnixTimeSeconds(logRecord.m_logTime);
-    m_logItemArray[index]["logger.name"] = logRecord.m_logger->getLogSource()->getQualifiedName();
+    // writer.writeIntMember("timestamp", elogTimeToUnixTimeSeconds(logRecord.m_logTime));
+    writer.writeStringMember("logger.name", logRecord.m_logger->getLogSource()->getQualifiedName(),
+                             logRecord.m_logger->getLogSource()->getQualifiedNameLength());
     bytesWritten += logRecord.m_logger->getLogSource()->getQualifiedNameLength();
 
     const char* threadName = getThreadNameField(logRecord.m_threadId);
     if (threadName != nullptr && *threadName != 0) {
-        m_logItemArray[index]["logger.thread_name"] = threadName;
+        writer.writeStringMember("logger.thread_name", threadName);
         bytesWritten += strlen(threadName);
     }
 
     if (!m_source.empty()) {
-        m_logItemArray[index]["ddsource"] = m_source.c_str();
+        writer.writeStringMember("ddsource", m_source.c_str(), m_source.length());
         bytesWritten += m_source.length();
     }
     if (!m_service.empty()) {
-        m_logItemArray[index]["service"] = m_service.c_str();
+        writer.writeStringMember("service", m_service.c_str(), m_service.length());
         bytesWritten += m_service.length();
     }
 
@@ -110,41 +127,42 @@ bool ELogDatadogTarget::writeLogRecord(const ELogRecord& logRecord, uint64_t& by
 #ifdef ELOG_ENABLE_STACK_TRACE
         std::string stackTrace;
         if (getStackTraceString(stackTrace)) {
-            m_logItemArray[index]["error.stack"] = stackTrace;
+            writer.writeStringMember("error.stack", stackTrace.c_str(), stackTrace.length());
             bytesWritten += stackTrace.length();
         }
 #endif
     }
 
     // tags
-    ELogJsonReceptor receptor;
-    fillInTags(logRecord, &receptor);
-    std::string tags;
-    if (!prepareTagsString(getTagNames(), receptor.getPropValues(), tags)) {
-        ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to prepare datadog tags");
-        return false;
-    }
-    m_logItemArray[index]["ddtags"] = tags;
-    bytesWritten += tags.length();
-    /*if (!receptor.prepareJsonMap(m_logItemArray[index]["ddtags"], getTagNames())) {
-        return 0;
-    }*/
+    writer.writeStringMember("ddtags", m_tagsStr.c_str(), m_tagsStr.length());
+    bytesWritten += m_tagsStr.length();
+    writer.endObject();
+    ++m_logItemCount;
 
-    ELOG_REPORT_TRACE("Log message for Datadog is ready, body: %s", m_logItemArray.dump().c_str());
+    ELOG_REPORT_TRACE("Log message for Datadog is ready, body: %s", m_logItems.c_str());
     return true;
 }
 
 bool ELogDatadogTarget::flushLogTarget() {
-    std::string body =
-        m_logItemArray.size() == 1 ? m_logItemArray[0].dump() : m_logItemArray.dump();
-    ELOG_REPORT_TRACE("POST log message for Datadog: %s", body.c_str());
-    bool res =
-        m_client.post("/api/v2/logs", body.data(), body.size(), "application/json", m_compress)
-            .first;
+    if (m_logItemCount == 0) {
+        // silently ignore request
+        return true;
+    }
+
+    // a single log item is sent as is, without the enclosing array
+    const char* body = m_logItems.data() + 1;
+    size_t bodySize = m_logItems.size() - 1;
+    if (m_logItemCount > 1) {
+        m_logItems.push_back(']');
+        body = m_logItems.data();
+        bodySize = m_logItems.size();
+    }
+    ELOG_REPORT_TRACE("POST log message for Datadog: %s", body);
+    bool res = m_client.post("/api/v2/logs", body, bodySize, "application/json", m_compress).first;
 
     // clear the log entry for next round
     // NOTE: if resend needs to take place, then the body has already been copied tp the backlog)
-    m_logItemArray = nlohmann::json::array();
+    resetLogItems();
     return res;
 }
 
@@ -158,14 +176,15 @@ bool ELogDatadogTarget::prepareTagsString(const std::vector<std::string>& propNa
             "Cannot prepare Datadog log target tags, property name and value count mismatch");
         return false;
     }
-    std::stringstream s;
+    tags.clear();
     for (uint32_t i = 0; i < propNames.size(); ++i) {
-        s << propNames[i] << ":" << propValues[i];
-        if (i + 1 < propNames.size()) {
-            s << ",";
+        if (i > 0) {
+            tags.push_back(',');
         }
+        tags.append(propNames[i]);
+        tags.push_back(':');
+        tags.append(propValues[i]);
     }
-    tags = s.str();
     return true;
 }
 
@@ -4,6 +4,7 @@
 
 #include "elog_common.h"
 #include "elog_json_receptor.h"
+#include "elog_json_writer.h"
 #include "elog_report.h"
 
 namespace elog {
@@ -58,41 +59,67 @@ bool ELogGrafanaJsonTarget::stopLogTarget() {
 bool ELogGrafanaJsonTarget::writeLogRecord(const ELogRecord& logRecord, uint64_t& bytesWritten) {
     ELOG_REPORT_TRACE("Preapring log message for Grafana Loki");
     bytesWritten = 0;
-    if (m_logEntry.empty()) {
+
+    // the request body is written directly as JSON, in the form:
+    // {"streams":[{"stream":{labels},"values":[[time,msg,{metadata}],...]}]}
+    if (m_logLineCount == 0) {
         // apply labels (once per batch)
         ELogJsonReceptor receptor;
         fillInLabels(logRecord, &receptor);
-        if (!receptor.prepareJsonMap(m_logEntry["streams"][0]["stream"], getLabelNames())) {
+        m_logEntry.assign("{\"streams\":[{\"stream\":");
+        ELogJsonWriter<std::string> writer(m_logEntry);
+        writer.beginObject();
+        if (!receptor.writeJsonMap(writer, getLabelNames())) {
+            m_logEntry.clear();
             return false;
         }
+        writer.endObject();
+        m_logEntry.append(",\"values\":[");
         bytesWritten += receptor.getBytesPrepared();
     }
 
-    // log line time, common to all log lines until flush
-    auto& values = m_logEntry["streams"][0]["values"];
-    size_t logLineCount = values.size();
-    auto& logLine = values[logLineCount];
+    // prepare log line attributes first, since on failure nothing should be written
+    ELogJsonReceptor metadataReceptor;
+    if (m_metadataFormatter->getPropCount() > 0) {
+        fillInMetadata(logRecord, &metadataReceptor);
+        if (metadataReceptor.getPropValues().size() != getMetadataNames().size()) {
+            ELOG_REPORT_MODERATE_ERROR_DEFAULT(
+                "Mismatching Grafana Loki log line meta-data names and values");
+            return false;
+        }
+    }
+
+    if (m_logLineCount > 0) {
+        m_logEntry.push_back(',');
+    }
+    ELogJsonWriter<std::string> writer(m_logEntry);
+    writer.beginArray();
+
+    // log line time
     // need to send local time, other Loki complains that timestamp is too new
-    std::string unixTimeNanoStr = std::to_string(
-        std::chrono::nanoseconds(elogTimeToUnixTimeNanos(logRecord.m_logTime, false)).count());
-    logLine[0] = unixTimeNanoStr;
-    bytesWritten += unixTimeNanoStr.length();
+    char unixTimeNanoStr[32];
+    std::to_chars_result res =
+        std::to_chars(unixTimeNanoStr, unixTimeNanoStr + sizeof(unixTimeNanoStr),
+                      elogTimeToUnixTimeNanos(logRecord.m_logTime, false));
+    size_t unixTimeNanoLen = res.ptr - unixTimeNanoStr;
+    writer.writeString(unixTimeNanoStr, unixTimeNanoLen);
+    bytesWritten += unixTimeNanoLen;
 
     // log line
-    std::string logMsg;
-    formatLogMsg(logRecord, logMsg);
-    logLine[1] = logMsg;
-    bytesWritten += logMsg.length();
+    m_logMsg.clear();
+    formatLogMsg(logRecord, m_logMsg);
+    writer.writeString(m_logMsg.c_str(), m_logMsg.length());
+    bytesWritten += m_logMsg.length();
 
     // fill int log line attributes
     if (m_metadataFormatter->getPropCount() > 0) {
-        ELogJsonReceptor receptor;
-        fillInMetadata(logRecord, &receptor);
-        if (!receptor.prepareJsonMap(logLine[2], getMetadataNames())) {
-            return false;
-        }
-        bytesWritten += receptor.getBytesPrepared();
+        writer.beginObject();
+        metadataReceptor.writeJsonMap(writer, getMetadataNames());
+        writer.endObject();
+        bytesWritten += metadataReceptor.getBytesPrepared();
     }
+    writer.endArray();
+    ++m_logLineCount;
 
     // NOTE: log data is being aggregated until flush, which sends HTTP message to server
 
@@ -101,19 +128,20 @@ bool ELogGrafanaJsonTarget::writeLogRecord(const ELogRecord& logRecord, uint64_t
 }
 
 bool ELogGrafanaJsonTarget::flushLogTarget() {
-    if (m_logEntry.empty()) {
+    if (m_logLineCount == 0) {
         // silently ignore request
         return true;
     }
-    std::string jsonBody = m_logEntry.dump();
-    ELOG_REPORT_TRACE("POST log message for Grafana Loki: %s", jsonBody.c_str());
+    m_logEntry.append("]}]}");
+    ELOG_REPORT_TRACE("POST log message for Grafana Loki: %s", m_logEntry.c_str());
     bool res =
-        m_client.post("/loki/api/v1/push", jsonBody.data(), jsonBody.size(), "application/json")
+        m_client.post("/loki/api/v1/push", m_logEntry.data(), m_logEntry.size(), "application/json")
             .first;
 
     // clear the log entry for next round
     // NOTE: if resend needs to take place, then the body has already been copied tp the backlog)
     m_logEntry.clear();
+    m_logLineCount = 0;
     return res;
 }
 
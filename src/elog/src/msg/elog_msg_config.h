@@ -18,6 +18,11 @@
 #define ELOG_MSG_MAX_CONCURRENT_REQUESTS 4096
 #define ELOG_MSG_DEFAULT_CONCURRENT_REQUESTS 32
 
+/** @brief Min/Max/Default number of connections (shards) for message-based log targets. */
+#define ELOG_MSG_MIN_CONNECTIONS 1
+#define ELOG_MSG_MAX_CONNECTIONS 64
+#define ELOG_MSG_DEFAULT_CONNECTIONS 1
+
 /** @brief Default binary format for message-based log targets. */
 #define ELOG_MSG_DEFAULT_BINARY_FORMAT "protobuf"
 
@@ -60,6 +65,15 @@
 
 namespace elog {
 
+/** @brief Specifies how log records are assigned to connections (shards). */
+enum class ELogMsgShardMode : uint32_t {
+    /** @var Each logging thread is bound to a shard according to its thread slot. */
+    SM_THREAD,
+
+    /** @var Log records are distributed to shards in a round-robin manner. */
+    SM_ROUND_ROBIN
+};
+
 /** @brief Common configuration for all message-based log targets. */
 struct ELogMsgConfig {
     /** @var Specifies whether communication is synchronous (blocking) or not.  */
@@ -71,6 +85,12 @@ struct ELogMsgConfig {
     /** @var Specifies the maximum allowed number of outstanding pending requests. */
     uint32_t m_maxConcurrentRequests;
 
+    /** @var Specifies the number of connections (shards) used by the log target. */
+    uint32_t m_connectionCount;
+
+    /** @var Specifies how log records are assigned to shards. */
+    ELogMsgShardMode m_shardMode;
+
     /** @brief Specifies the binary format used in serializing log records. */
     ELogBinaryFormatProvider* m_binaryFormatProvider;
 
@@ -72,6 +72,38 @@ bool ELogMsgConfigLoader::loadMsgConfig(const ELogConfigMapNode* logTargetCfg,
         return false;
     }
 
+    // number of connections (shards)
+    msgConfig.m_connectionCount = ELOG_MSG_DEFAULT_CONNECTIONS;
+    if (!ELogConfigLoader::getOptionalLogTargetUInt32Property(
+            logTargetCfg, targetName, "connections", msgConfig.m_connectionCount)) {
+        return false;
+    }
+    if (!verifyUInt32PropRange(targetName, "connections", msgConfig.m_connectionCount,
+                               ELOG_MSG_MIN_CONNECTIONS, ELOG_MSG_MAX_CONNECTIONS, true,
+                               ELOG_MSG_DEFAULT_CONNECTIONS)) {
+        return false;
+    }
+
+    // shard assignment mode
+    std::string shardBy;
+    found = false;
+    if (!ELogConfigLoader::getOptionalLogTargetStringProperty(logTargetCfg, targetName, "shard_by",
+                                                              shardBy, &found)) {
+        return false;
+    }
+    msgConfig.m_shardMode = ELogMsgShardMode::SM_THREAD;
+    if (found) {
+        if (shardBy.compare("round_robin") == 0) {
+            msgConfig.m_shardMode = ELogMsgShardMode::SM_ROUND_ROBIN;
+        } else if (shardBy.compare("thread") != 0) {
+            ELOG_REPORT_ERROR(
+                "Invalid %s log target specification, unsupported property 'shard_by' value '%s' "
+                "(context: %s)",
+                targetName, shardBy.c_str(), logTargetCfg->getFullContext());
+            return false;
+        }
+    }
+
     // binary format
     std::string binaryFormat = ELOG_MSG_DEFAULT_BINARY_FORMAT;
     if (!ELogConfigLoader::getOptionalLogTargetStringProperty(logTargetCfg, targetName,
@@ -2,6 +2,7 @@
 
 #include <cinttypes>
 
+#include "elog_aligned_alloc.h"
 #include "elog_report.h"
 
 namespace elog {
@@ -12,15 +13,20 @@ bool ELogMsgStats::initialize(uint32_t maxThreads) {
     if (!ELogStats::initialize(maxThreads)) {
         return false;
     }
-    if (!m_sendCount.initialize(maxThreads) || !m_sendFailCount.initialize(maxThreads) ||
-        !m_sendByteCount.initialize(maxThreads) ||
-        !m_compressedSendByteCount.initialize(maxThreads) || !m_recvCount.initialize(maxThreads) ||
-        !m_recvFailCount.initialize(maxThreads) || !m_recvByteCount.initialize(maxThreads) ||
-        !m_processedMsgCount.initialize(maxThreads)) {
+    if (!bindStatVar(m_sendCount) || !bindStatVar(m_sendFailCount) ||
+        !bindStatVar(m_sendByteCount) || !bindStatVar(m_compressedSendByteCount) ||
+        !bindStatVar(m_recvCount) || !bindStatVar(m_recvFailCount) ||
+        !bindStatVar(m_recvByteCount) || !bindStatVar(m_processedMsgCount)) {
         ELOG_REPORT_ERROR("Failed to initialize message statistics variables");
         terminate();
         return false;
     }
+    m_shardStats = elogAlignedAllocObjectArray<ELogMsgShardStats>(ELOG_CACHE_LINE, m_shardCount);
+    if (m_shardStats == nullptr) {
+        ELOG_REPORT_ERROR("Failed to allocate per-shard message statistics, out of memory");
+        terminate();
+        return false;
+    }
     return true;
 }
 
@@ -34,24 +40,35 @@ void ELogMsgStats::terminate() {
     m_recvFailCount.terminate();
     m_recvByteCount.terminate();
     m_processedMsgCount.terminate();
+    if (m_shardStats != nullptr) {
+        elogAlignedFreeObjectArray(m_shardStats, m_shardCount);
+        m_shardStats = nullptr;
+    }
 }
 
-void ELogMsgStats::updateSendStats(uint64_t sendBytes, uint64_t compressedBytes, int status) {
+void ELogMsgStats::updateSendStats(uint64_t sendBytes, uint64_t compressedBytes, int status,
+                                   uint32_t shardId /* = 0 */) {
+    ELogMsgShardStats& shardStats = m_shardStats[shardId];
     if (status != 0) {
         incrementSendFailCount();
+        shardStats.m_sendFailCount.fetch_add(1, std::memory_order_relaxed);
     } else {
         incrementSendCount();
         addSendBytesCount(sendBytes);
         if (compressedBytes > 0) {
             addCompressedSendBytesCount(compressedBytes);
         }
+        shardStats.m_sendCount.fetch_add(1, std::memory_order_relaxed);
+        shardStats.m_sendByteCount.fetch_add(sendBytes, std::memory_order_relaxed);
     }
 }
 
-void ELogMsgStats::updateRecvStats(uint64_t recvBytes, uint64_t msgProcessed) {
+void ELogMsgStats::updateRecvStats(uint64_t recvBytes, uint64_t msgProcessed,
+                                   uint32_t shardId /* = 0 */) {
     incrementRecvCount();
     addRecvByteCount(recvBytes);
     addProcessedMsgCount(msgProcessed);
+    m_shardStats[shardId].m_processedMsgCount.fetch_add(msgProcessed, std::memory_order_relaxed);
 }
 
 void ELogMsgStats::toString(ELogBuffer& buffer, ELogTarget* logTarget, const char* msg /* = "" */) {
@@ -89,6 +106,24 @@ void ELogMsgStats::toString(ELogBuffer& buffer, ELogTarget* logTarget, const cha
         buffer.appendArgs("\tAverage recv buffer size: N/A\n");
     }
     buffer.appendArgs("\tProcessed message count: %" PRIu64 "\n", m_processedMsgCount.getSum());
+
+    // per-shard statistics (only when using more than one connection)
+    if (m_shardCount > 1 && m_shardStats != nullptr) {
+        for (uint32_t i = 0; i < m_shardCount; ++i) {
+            const ELogMsgShardStats& shardStats = m_shardStats[i];
+            uint64_t recordCount = shardStats.m_recordCount.load(std::memory_order_relaxed);
+            uint64_t processedCount =
+                shardStats.m_processedMsgCount.load(std::memory_order_relaxed);
+            uint64_t pendingCount = recordCount > processedCount ? recordCount - processedCount : 0;
+            buffer.appendArgs(
+                "\tShard %u: records=%" PRIu64 ", sends=%" PRIu64 ", send failures=%" PRIu64
+                ", bytes sent=%" PRIu64 ", processed=%" PRIu64 ", pending=%" PRIu64 "\n",
+                i, recordCount, shardStats.m_sendCount.load(std::memory_order_relaxed),
+                shardStats.m_sendFailCount.load(std::memory_order_relaxed),
+                shardStats.m_sendByteCount.load(std::memory_order_relaxed), processedCount,
+                pendingCount);
+        }
+    }
 }
 
 void ELogMsgStats::resetThreadCounters(uint64_t slotId) {
@@ -4,18 +4,49 @@
 
 #include <msg/msg_buffer_array_writer.h>
 
+#include <string>
+
 #include "elog_report.h"
 
 namespace elog {
 
 ELOG_DECLARE_REPORT_LOGGER(ELogMsgTarget)
 
+ELogMsgTarget::ELogMsgTarget(const char* name, const ELogMsgConfig& msgConfig,
+                             const std::vector<commutil::DataClient*>& dataClients)
+    : ELogTarget(name),
+      m_msgConfig(msgConfig.m_commConfig),
+      m_binaryFormatProvider(msgConfig.m_binaryFormatProvider),
+      m_msgStats(nullptr),
+      m_shardMode(msgConfig.m_shardMode),
+      m_nextShard(0),
+      m_syncMode(msgConfig.m_syncMode),
+      m_compress(msgConfig.m_compress),
+      m_maxConcurrentRequests(msgConfig.m_maxConcurrentRequests) {
+    m_shards.reserve(dataClients.size());
+    for (commutil::DataClient* dataClient : dataClients) {
+        m_shards.push_back(new (std::nothrow)
+                               ELogMsgShard(this, (uint32_t)m_shards.size(), dataClient));
+    }
+    // each shard has its own lock, so when there is more than one shard we avoid the log target's
+    // global lock, and let concurrent threads make progress on different shards
+    if (m_shards.size() > 1) {
+        setNativelyThreadSafe();
+    }
+}
+
 // special case: implement object self-destruction due to member destruction
 void ELogMsgTarget::destroy() {
-    if (m_dataClient != nullptr) {
-        delete m_dataClient;
-        m_dataClient = nullptr;
+    for (ELogMsgShard* shard : m_shards) {
+        if (shard != nullptr) {
+            if (shard->m_dataClient != nullptr) {
+                delete shard->m_dataClient;
+                shard->m_dataClient = nullptr;
+            }
+            delete shard;
+        }
     }
+    m_shards.clear();
     if (m_binaryFormatProvider != nullptr) {
         delete m_binaryFormatProvider;
         m_binaryFormatProvider = nullptr;
@@ -23,14 +54,16 @@ void ELogMsgTarget::destroy() {
     delete this;
 }
 
-void ELogMsgTarget::onSendMsgStats(uint32_t msgSizeBytes, uint32_t compressedMsgSizeBytes,
-                                   int status) {
-    if (m_enableStats && m_msgStats != nullptr) {
-        m_msgStats->updateSendStats(msgSizeBytes, compressedMsgSizeBytes, status);
+void ELogMsgTarget::ELogMsgShard::onSendMsgStats(uint32_t msgSizeBytes,
+                                                 uint32_t compressedMsgSizeBytes, int status) {
+    if (m_target->m_enableStats && m_target->m_msgStats != nullptr) {
+        m_target->m_msgStats->updateSendStats(msgSizeBytes, compressedMsgSizeBytes, status,
+                                              m_shardId);
     }
 }
 
-void ELogMsgTarget::onRecvMsgStats(uint32_t msgSizeBytes, uint32_t compressedMsgSizeBytes) {
+void ELogMsgTarget::ELogMsgShard::onRecvMsgStats(uint32_t msgSizeBytes,
+                                                 uint32_t compressedMsgSizeBytes) {
     // NOTE: since in ELog protocol the status response is not compressed, we ignore this
     // notification altogether and report statistics during handling of incoming response
 }
@@ -42,10 +75,9 @@ uint64_t ELogMsgTarget::getProcessedMsgCount() {
     return m_msgStats->getProcessedMsgCount().getSum();
 }
 
-commutil::ErrorCode ELogMsgTarget::handleMsg(const commutil::ConnectionDetails& connectionDetails,
-                                             const commutil::MsgHeader& msgHeader,
-                                             const char* msgBuffer, uint32_t bufferSize,
-                                             bool lastInBatch, uint32_t batchSize) {
+commutil::ErrorCode ELogMsgTarget::ELogMsgShard::handleMsg(
+    const commutil::ConnectionDetails& connectionDetails, const commutil::MsgHeader& msgHeader,
+    const char* msgBuffer, uint32_t bufferSize, bool lastInBatch, uint32_t batchSize) {
     // check message id expected according to protocol
     uint32_t msgId = msgHeader.getMsgId();
     if (msgId != ELOG_STATUS_MSG_ID) {
@@ -55,47 +87,60 @@ commutil::ErrorCode ELogMsgTarget::handleMsg(const commutil::ConnectionDetails&
 
     // deserialize status message
     ELogStatusMsg statusMsg;
-    if (!m_binaryFormatProvider->logStatusFromBuffer(statusMsg, msgBuffer, bufferSize)) {
+    if (!m_target->m_binaryFormatProvider->logStatusFromBuffer(statusMsg, msgBuffer,
+                                                               bufferSize)) {
         ELOG_REPORT_ERROR("Failed to deserialize status response message");
         return commutil::ErrorCode::E_DATA_CORRUPT;
     }
 
     // check status
+    bool enableStats = m_target->m_enableStats && m_target->m_msgStats != nullptr;
     if (statusMsg.getStatus() != 0) {
         ELOG_REPORT_ERROR("Received status %d from server", statusMsg.getStatus());
-        if (m_enableStats && m_msgStats != nullptr) {
-            m_msgStats->incrementRecvFailCount();
+        if (enableStats) {
+            m_target->m_msgStats->incrementRecvFailCount();
         }
         return commutil::ErrorCode::E_SERVER_ERROR;
     }
 
     // update statistics
-    m_msgStats->updateRecvStats(bufferSize, statusMsg.getRecordsProcessed());
+    if (enableStats) {
+        m_target->m_msgStats->updateRecvStats(bufferSize, statusMsg.getRecordsProcessed(),
+                                              m_shardId);
+    }
     return commutil::ErrorCode::E_OK;
 }
 
-void ELogMsgTarget::handleMsgError(const commutil::ConnectionDetails& connectionDetails,
-                                   const commutil::MsgHeader& msgHeader, int status) {
-    if (m_enableStats && m_msgStats != nullptr) {
-        m_msgStats->incrementRecvFailCount();
+void ELogMsgTarget::ELogMsgShard::handleMsgError(
+    const commutil::ConnectionDetails& connectionDetails, const commutil::MsgHeader& msgHeader,
+    int status) {
+    if (m_target->m_enableStats && m_target->m_msgStats != nullptr) {
+        m_target->m_msgStats->incrementRecvFailCount();
     }
 }
 
-bool ELogMsgTarget::startLogTarget() {
-    commutil::ErrorCode rc = m_msgClient.initialize(m_dataClient, m_maxConcurrentRequests);
+bool ELogMsgTarget::ELogMsgShard::start() {
+    commutil::ErrorCode rc =
+        m_msgClient.initialize(m_dataClient, m_target->m_maxConcurrentRequests);
     if (rc != commutil::ErrorCode::E_OK) {
         ELOG_REPORT_ERROR("Failed to initialize message client: %s",
                           commutil::errorCodeToString(rc));
         return false;
     }
-    rc = m_msgSender.initialize(&m_msgClient, m_msgConfig, this, m_enableStats ? this : nullptr);
+    rc = m_msgSender.initialize(&m_msgClient, m_target->m_msgConfig, this,
+                                m_target->m_enableStats ? this : nullptr);
     if (rc != commutil::ErrorCode::E_OK) {
         ELOG_REPORT_ERROR("Failed to initialize message sender: %s",
                           commutil::errorCodeToString(rc));
         (void)m_msgClient.terminate();
         return false;
     }
-    m_msgClient.setName(getName());
+    if (m_target->getShardCount() > 1) {
+        std::string clientName = std::string(m_target->getName()) + "." + std::to_string(m_shardId);
+        m_msgClient.setName(clientName.c_str());
+    } else {
+        m_msgClient.setName(m_target->getName());
+    }
     rc = m_msgSender.start();
     if (rc != commutil::ErrorCode::E_OK) {
         ELOG_REPORT_ERROR("Failed to start message sender: %s", commutil::errorCodeToString(rc));
@@ -106,7 +151,7 @@ bool ELogMsgTarget::startLogTarget() {
     return true;
 }
 
-bool ELogMsgTarget::stopLogTarget() {
+bool ELogMsgTarget::ELogMsgShard::stop() {
     commutil::ErrorCode rc = m_msgSender.stop();
     if (rc != commutil::ErrorCode::E_OK) {
         ELOG_REPORT_ERROR("Failed to stop message sender: %s", commutil::errorCodeToString(rc));
@@ -127,53 +172,118 @@ bool ELogMsgTarget::stopLogTarget() {
     return true;
 }
 
+bool ELogMsgTarget::ELogMsgShard::flush() {
+    // NOTE: caller is expected to hold the shard lock
+    if (m_msgBufferArray.empty()) {
+        return true;
+    }
+
+    // send message
+    bool res = true;
+    if (m_target->m_syncMode) {
+        commutil::ErrorCode rc = m_msgSender.transactMsgBatch(
+            ELOG_RECORD_MSG_ID, m_msgBufferArray, m_target->m_compress, COMMUTIL_MSG_FLAG_BATCH,
+            m_target->m_msgConfig.m_sendTimeoutMillis);
+        if (rc != commutil::ErrorCode::E_OK) {
+            ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to transact message batch: %s",
+                                               commutil::errorCodeToString(rc));
+            res = false;
+        }
+    } else {
+        commutil::ErrorCode rc =
+            m_msgSender.sendMsgBatch(ELOG_RECORD_MSG_ID, m_msgBufferArray, m_target->m_compress,
+                                     COMMUTIL_MSG_FLAG_BATCH);
+        if (rc != commutil::ErrorCode::E_OK) {
+            ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to send message batch: %s",
+                                               commutil::errorCodeToString(rc));
+            res = false;
+        }
+    }
+
+    // clear the buffer array for next round
+    m_msgBufferArray.clear();
+
+    // NOTE: if resend needs to take place, then the body has already been copied to the backlog
+    return res;
+}
+
+bool ELogMsgTarget::startLogTarget() {
+    for (uint32_t i = 0; i < m_shards.size(); ++i) {
+        if (m_shards[i] == nullptr) {
+            ELOG_REPORT_ERROR("Failed to allocate shard %u of message log target %s, out of memory",
+                              i, getName());
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < m_shards.size(); ++i) {
+        if (!m_shards[i]->start()) {
+            ELOG_REPORT_ERROR("Failed to start shard %u of message log target %s", i, getName());
+            for (uint32_t j = 0; j < i; ++j) {
+                (void)m_shards[j]->stop();
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ELogMsgTarget::stopLogTarget() {
+    bool res = true;
+    for (ELogMsgShard* shard : m_shards) {
+        if (!shard->stop()) {
+            res = false;
+        }
+    }
+    return res;
+}
+
+ELogMsgTarget::ELogMsgShard* ELogMsgTarget::selectShard() {
+    uint64_t shardCount = m_shards.size();
+    if (shardCount == 1) {
+        return m_shards[0];
+    }
+    if (m_shardMode == ELogMsgShardMode::SM_THREAD) {
+        // threads are bound to shards by their statistics slot, which is allocated once per thread
+        uint64_t slotId = ELogStats::getSlotId();
+        if (slotId != ELOG_INVALID_STAT_SLOT_ID) {
+            return m_shards[slotId % shardCount];
+        }
+    }
+    return m_shards[m_nextShard.fetch_add(1, std::memory_order_relaxed) % shardCount];
+}
+
 bool ELogMsgTarget::writeLogRecord(const ELogRecord& logRecord, uint64_t& bytesWritten) {
     ELOG_REPORT_DEBUG("Preapring log message");
 
     // use the binary format provider to convert the log record into a byte array
-    // and put it in the data buffer array
-    commutil::MsgBuffer& msgBuffer = m_msgBufferArray.emplace_back();
+    // and put it in the data buffer array of the selected shard
+    ELogMsgShard* shard = selectShard();
+    std::unique_lock<std::mutex> lock = lockShard(shard);
+    commutil::MsgBuffer& msgBuffer = shard->m_msgBufferArray.emplace_back();
     if (!m_binaryFormatProvider->logRecordToBuffer(logRecord, getLogFormatter(), msgBuffer)) {
         ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to serialize log record into buffer");
         return false;
     }
+    if (m_enableStats && m_msgStats != nullptr) {
+        m_msgStats->incrementShardRecordCount(shard->m_shardId);
+    }
     bytesWritten = msgBuffer.size();
     return true;
 }
 
 bool ELogMsgTarget::flushLogTarget() {
-    // send message
     bool res = true;
-    if (!m_msgBufferArray.empty()) {
-        if (m_syncMode) {
-            commutil::ErrorCode rc = m_msgSender.transactMsgBatch(
-                ELOG_RECORD_MSG_ID, m_msgBufferArray, m_compress, COMMUTIL_MSG_FLAG_BATCH,
-                m_msgConfig.m_sendTimeoutMillis);
-            if (rc != commutil::ErrorCode::E_OK) {
-                ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to transact message batch: %s",
-                                                   commutil::errorCodeToString(rc));
-                res = false;
-            }
-        } else {
-            commutil::ErrorCode rc = m_msgSender.sendMsgBatch(ELOG_RECORD_MSG_ID, m_msgBufferArray,
-                                                              m_compress, COMMUTIL_MSG_FLAG_BATCH);
-            if (rc != commutil::ErrorCode::E_OK) {
-                ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to send message batch: %s",
-                                                   commutil::errorCodeToString(rc));
-                res = false;
-            }
+    for (ELogMsgShard* shard : m_shards) {
+        std::unique_lock<std::mutex> lock = lockShard(shard);
+        if (!shard->flush()) {
+            res = false;
         }
-
-        // clear the buffer array for next round
-        m_msgBufferArray.clear();
     }
-
-    // NOTE: if resend needs to take place, then the body has already been copied to the backlog
     return res;
 }
 
 ELogStats* ELogMsgTarget::createStats() {
-    m_msgStats = new (std::nothrow) ELogMsgStats();
+    m_msgStats = new (std::nothrow) ELogMsgStats((uint32_t)m_shards.size());
     return m_msgStats;
 }
 
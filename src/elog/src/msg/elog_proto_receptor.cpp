@@ -9,6 +9,21 @@ void ELogProtoReceptor::receiveStaticText(uint32_t typeId, const std::string& te
     // static text is not used, just discard it
 }
 
+void ELogProtoReceptor::receiveRelativeTime(uint32_t typeId, uint64_t relativeTimeNanos,
+                                            const ELogFieldSpec& fieldSpec) {
+    m_logRecordMsg->set_relativetimenanos(relativeTimeNanos);
+}
+
+void ELogProtoReceptor::receiveSourceRelativeTime(uint32_t typeId, uint64_t relativeTimeNanos,
+                                                  const ELogFieldSpec& fieldSpec) {
+    m_logRecordMsg->set_sourcerelativetimenanos(relativeTimeNanos);
+}
+
+void ELogProtoReceptor::receiveThreadDelta(uint32_t typeId, uint64_t deltaNanos,
+                                           const ELogFieldSpec& fieldSpec) {
+    m_logRecordMsg->set_threaddeltananos(deltaNanos);
+}
+
 void ELogProtoReceptor::receiveRecordId(uint32_t typeId, uint64_t recordId,
                                         const ELogFieldSpec& fieldSpec) {
     m_logRecordMsg->set_recordid(recordId);
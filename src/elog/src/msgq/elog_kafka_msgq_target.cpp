@@ -6,7 +6,9 @@
 #include <sstream>
 
 #include "elog_field_selector_internal.h"
+#include "elog_logger.h"
 #include "elog_report.h"
+#include "elog_source.h"
 
 namespace elog {
 
@@ -113,11 +115,39 @@ bool ELogKafkaMsgQTarget::startLogTarget() {
         return false;
     }
 
+    // producer batching and compression
+    if (m_producerParams.m_lingerMillis != 0 &&
+        !setConfProperty("linger.ms", std::to_string(m_producerParams.m_lingerMillis).c_str())) {
+        cleanup();
+        return false;
+    }
+    if (m_producerParams.m_batchSizeBytes != 0 &&
+        !setConfProperty("batch.size", std::to_string(m_producerParams.m_batchSizeBytes).c_str())) {
+        cleanup();
+        return false;
+    }
+    if (!m_producerParams.m_compression.empty() &&
+        !setConfProperty("compression.codec", m_producerParams.m_compression.c_str())) {
+        cleanup();
+        return false;
+    }
+
+    // delivery reports are required for recycling payload buffers
+    if (!initBufferPool()) {
+        cleanup();
+        return false;
+    }
+    rd_kafka_conf_set_opaque(m_conf, this);
+    rd_kafka_conf_set_dr_msg_cb(m_conf, onDeliveryReport);
+
     // TODO: this should be configurable
     m_topicConf = rd_kafka_topic_conf_new();
-    if (rd_kafka_topic_conf_set(m_topicConf, "acks", "all", errstr, sizeof(errstr)) !=
-        RD_KAFKA_CONF_OK) {
-        ELOG_REPORT_ERROR("Failed to configure kafka topic acks=all: %s", errstr);
+    if (!setTopicConfProperty("acks", "all")) {
+        cleanup();
+        return false;
+    }
+    if (!m_producerParams.m_partitioner.empty() &&
+        !setTopicConfProperty("partitioner", m_producerParams.m_partitioner.c_str())) {
         cleanup();
         return false;
     }
@@ -180,61 +210,98 @@ bool ELogKafkaMsgQTarget::writeLogRecord(const ELogRecord& logRecord, uint64_t&
         fillInHeaders(logRecord, &receptor);
         if (!receptor.prepareHeaders(headers, getHeaderNames(), bytesWritten)) {
             ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to prepare kafka message headers");
+            rd_kafka_headers_destroy(headers);
             return false;
         }
     }
 
-    // prepare formatted log message
-    std::string logMsg;
+    // prepare formatted log message, directly into a pooled buffer if possible, so that it can be
+    // handed over to librdkafka without copying (the buffer is recycled by the delivery report
+    // callback), otherwise librdkafka is ordered to copy the payload
+    std::string* buffer = allocBuffer();
+    std::string localMsg;
+    std::string& logMsg = (buffer != nullptr) ? *buffer : localMsg;
+    int msgFlags = (buffer != nullptr) ? 0 : RD_KAFKA_MSG_F_COPY;
     formatLogMsg(logRecord, logMsg);
     bytesWritten += logMsg.length();
 
-    // unassigned partition, copy payload, no key specification, payload is formatted string
-    // headers include specific log record fields
+    // keyed partitioning (key is always copied by librdkafka)
+    char keyBuf[32];
+    const void* key = nullptr;
+    size_t keyLength = 0;
+    if (m_producerParams.m_partitionKey == ELogKafkaPartitionKey::KPK_SOURCE) {
+        if (logRecord.m_logger != nullptr && logRecord.m_logger->getLogSource() != nullptr) {
+            ELogSource* logSource = logRecord.m_logger->getLogSource();
+            key = logSource->getQualifiedName();
+            keyLength = logSource->getQualifiedNameLength();
+        }
+    } else if (m_producerParams.m_partitionKey == ELogKafkaPartitionKey::KPK_THREAD) {
+        int res = snprintf(keyBuf, sizeof(keyBuf), "%u", (unsigned)logRecord.m_threadId);
+        key = keyBuf;
+        keyLength = (size_t)res;
+    }
+
+    // unassigned partition, payload is formatted string, headers include specific log record
+    // fields
     int32_t partition = RD_KAFKA_PARTITION_UA;
     if (m_partition != -1) {
         partition = m_partition;
     }
+    bool result = true;
     if (headers != nullptr) {
-        const uint32_t VU_COUNT = 6;
+        const uint32_t VU_COUNT = 7;
         rd_kafka_vu_t vus[VU_COUNT];
         vus[0].vtype = RD_KAFKA_VTYPE_PARTITION;
         vus[0].u.i32 = partition;
 
         vus[1].vtype = RD_KAFKA_VTYPE_MSGFLAGS;
-        vus[1].u.i = RD_KAFKA_MSG_F_COPY;
+        vus[1].u.i = msgFlags;
 
         vus[2].vtype = RD_KAFKA_VTYPE_VALUE;
         vus[2].u.mem.ptr = (void*)logMsg.c_str();
         vus[2].u.mem.size = logMsg.length();
 
         vus[3].vtype = RD_KAFKA_VTYPE_KEY;
-        vus[3].u.mem.ptr = nullptr;
-        vus[3].u.mem.size = 0;
+        vus[3].u.mem.ptr = (void*)key;
+        vus[3].u.mem.size = keyLength;
 
         vus[4].vtype = RD_KAFKA_VTYPE_HEADERS;
         vus[4].u.headers = headers;
 
         vus[5].vtype = RD_KAFKA_VTYPE_TOPIC;
         vus[5].u.cstr = m_topicName.c_str();
+
+        vus[6].vtype = RD_KAFKA_VTYPE_OPAQUE;
+        vus[6].u.ptr = buffer;
         rd_kafka_error_t* res = rd_kafka_produceva(m_producer, vus, VU_COUNT);
         if (res != nullptr) {
             const char* errMsg = rd_kafka_err2name(rd_kafka_error_code(res));
             ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to produce message on kafka topic %s: %s",
                                                m_topicName.c_str(), errMsg);
             rd_kafka_error_destroy(res);
-            return false;
+            // NOTE: on failure, headers are not owned by librdkafka
+            rd_kafka_headers_destroy(headers);
+            result = false;
         }
     } else {
-        if (rd_kafka_produce(m_topic, partition, RD_KAFKA_MSG_F_COPY, (void*)logMsg.c_str(),
-                             logMsg.length(), nullptr, 0, nullptr) == -1) {
+        if (rd_kafka_produce(m_topic, partition, msgFlags, (void*)logMsg.c_str(), logMsg.length(),
+                             key, keyLength, buffer) == -1) {
             const char* errMsg = rd_kafka_err2name(rd_kafka_last_error());
             ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to produce message on kafka topic %s: %s",
                                                m_topicName.c_str(), errMsg);
-            return false;
+            result = false;
         }
     }
 
+    if (!result) {
+        if (buffer != nullptr) {
+            releaseBuffer(buffer);
+        }
+        return false;
+    }
+
+    // serve delivery reports (non-blocking), so that payload buffers are recycled
+    rd_kafka_poll(m_producer, 0);
     return true;
 }
 
@@ -263,6 +330,91 @@ void ELogKafkaMsgQTarget::formatClientId() {
     m_clientId = s.str();
 }
 
+bool ELogKafkaMsgQTarget::setConfProperty(const char* propName, const char* propValue) {
+    char errstr[512];
+    if (rd_kafka_conf_set(m_conf, propName, propValue, errstr, sizeof(errstr)) !=
+        RD_KAFKA_CONF_OK) {
+        ELOG_REPORT_ERROR("Failed to configure kafka producer %s=%s: %s", propName, propValue,
+                          errstr);
+        return false;
+    }
+    return true;
+}
+
+bool ELogKafkaMsgQTarget::setTopicConfProperty(const char* propName, const char* propValue) {
+    char errstr[512];
+    if (rd_kafka_topic_conf_set(m_topicConf, propName, propValue, errstr, sizeof(errstr)) !=
+        RD_KAFKA_CONF_OK) {
+        ELOG_REPORT_ERROR("Failed to configure kafka topic %s=%s: %s", propName, propValue,
+                          errstr);
+        return false;
+    }
+    return true;
+}
+
+bool ELogKafkaMsgQTarget::initBufferPool() {
+    m_bufferPool.reserve(m_producerParams.m_bufferPoolSize);
+    m_freeBuffers.reserve(m_producerParams.m_bufferPoolSize);
+    for (uint32_t i = 0; i < m_producerParams.m_bufferPoolSize; ++i) {
+        std::string* buffer = new (std::nothrow) std::string();
+        if (buffer == nullptr) {
+            ELOG_REPORT_ERROR("Failed to allocate kafka payload buffer pool, out of memory");
+            termBufferPool();
+            return false;
+        }
+        m_bufferPool.push_back(buffer);
+        m_freeBuffers.push_back(buffer);
+    }
+    return true;
+}
+
+void ELogKafkaMsgQTarget::termBufferPool() {
+    // NOTE: called only after the producer is destroyed, so no buffer is in use by librdkafka
+    for (std::string* buffer : m_bufferPool) {
+        delete buffer;
+    }
+    m_bufferPool.clear();
+    m_freeBuffers.clear();
+}
+
+std::string* ELogKafkaMsgQTarget::allocBuffer() {
+    if (m_bufferPool.empty()) {
+        return nullptr;
+    }
+    std::unique_lock<std::mutex> lock(m_bufferLock);
+    if (m_freeBuffers.empty()) {
+        // try to reclaim buffers of messages that were already delivered
+        lock.unlock();
+        rd_kafka_poll(m_producer, 0);
+        lock.lock();
+        if (m_freeBuffers.empty()) {
+            return nullptr;
+        }
+    }
+    std::string* buffer = m_freeBuffers.back();
+    m_freeBuffers.pop_back();
+    buffer->clear();
+    return buffer;
+}
+
+void ELogKafkaMsgQTarget::releaseBuffer(std::string* buffer) {
+    std::unique_lock<std::mutex> lock(m_bufferLock);
+    m_freeBuffers.push_back(buffer);
+}
+
+void ELogKafkaMsgQTarget::onDeliveryReport(rd_kafka_t* producer, const rd_kafka_message_t* msg,
+                                           void* opaque) {
+    ELogKafkaMsgQTarget* target = (ELogKafkaMsgQTarget*)opaque;
+    if (msg->err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        ELOG_REPORT_MODERATE_ERROR_DEFAULT("Failed to deliver message to kafka topic %s: %s",
+                                           target->m_topicName.c_str(),
+                                           rd_kafka_err2name(msg->err));
+    }
+    if (msg->_private != nullptr) {
+        target->releaseBuffer((std::string*)msg->_private);
+    }
+}
+
 void ELogKafkaMsgQTarget::cleanup() {
     if (m_topic != nullptr) {
         rd_kafka_topic_destroy(m_topic);
@@ -280,9 +432,10 @@ void ELogKafkaMsgQTarget::cleanup() {
         rd_kafka_conf_destroy(m_conf);
         m_conf = nullptr;
     }
+    termBufferPool();
     ELogMsgQTarget::stopLogTarget();
 }
 
 }  // namespace elog
 
-#endif  // ELOG_ENABLE_MYSQL_DB_CONNECTOR
\ No newline at end of file
+#endif  // ELOG_ENABLE_KAFKA_MSGQ_CONNECTOR
\ No newline at end of file
@@ -14,8 +14,8 @@ ELOG_DECLARE_REPORT_LOGGER(ELogKafkaMsgQTargetProvider)
 ELogTarget* ELogKafkaMsgQTargetProvider::loadMsgQTarget(const ELogConfigMapNode* logTargetCfg,
                                                         const std::string& topic,
                                                         const std::string& headers) {
-    // we expect 4 properties: kafka_bootstrap_servers, and optional partition,
-    // kafka_flush_timeout, kafka_shutdown_flush_timeout
+    // we expect 1 mandatory property: kafka_bootstrap_servers, and optional partition,
+    // kafka_flush_timeout, kafka_shutdown_flush_timeout, and producer tuning properties
     std::string bootstrapServers;
     if (!ELogConfigLoader::getLogTargetStringProperty(
             logTargetCfg, "Kafka", "kafka_bootstrap_servers", bootstrapServers)) {
@@ -42,9 +42,75 @@ ELogTarget* ELogKafkaMsgQTargetProvider::loadMsgQTarget(const ELogConfigMapNode*
         return nullptr;
     }
 
-    ELogMsgQTarget* target =
-        new (std::nothrow) ELogKafkaMsgQTarget(bootstrapServers, topic, headers, partition,
-                                               flushTimeoutMillis, shutdownFlushTimeoutMillis);
+    // producer batching, compression and partitioning
+    ELogKafkaProducerParams producerParams;
+    if (!ELogConfigLoader::getOptionalLogTargetTimeoutProperty(
+            logTargetCfg, "Kafka", "kafka_linger", producerParams.m_lingerMillis,
+            ELogTimeUnits::TU_MILLI_SECONDS)) {
+        return nullptr;
+    }
+    if (!ELogConfigLoader::getOptionalLogTargetSizeProperty(
+            logTargetCfg, "Kafka", "kafka_batch_size", producerParams.m_batchSizeBytes,
+            ELogSizeUnits::SU_BYTES)) {
+        return nullptr;
+    }
+
+    bool found = false;
+    if (!ELogConfigLoader::getOptionalLogTargetStringProperty(
+            logTargetCfg, "Kafka", "kafka_compression", producerParams.m_compression, &found)) {
+        return nullptr;
+    }
+    if (found && producerParams.m_compression.compare("none") != 0 &&
+        producerParams.m_compression.compare("gzip") != 0 &&
+        producerParams.m_compression.compare("snappy") != 0 &&
+        producerParams.m_compression.compare("lz4") != 0 &&
+        producerParams.m_compression.compare("zstd") != 0) {
+        ELOG_REPORT_ERROR(
+            "Invalid Kafka log target specification, invalid compression codec '%s', expecting "
+            "one of: none, gzip, snappy, lz4, zstd (context: %s)",
+            producerParams.m_compression.c_str(), logTargetCfg->getFullContext());
+        return nullptr;
+    }
+
+    // partitioner names are verified by librdkafka
+    if (!ELogConfigLoader::getOptionalLogTargetStringProperty(
+            logTargetCfg, "Kafka", "kafka_partitioner", producerParams.m_partitioner)) {
+        return nullptr;
+    }
+
+    std::string partitionKey;
+    if (!ELogConfigLoader::getOptionalLogTargetStringProperty(
+            logTargetCfg, "Kafka", "kafka_partition_key", partitionKey, &found)) {
+        return nullptr;
+    }
+    if (found) {
+        if (partitionKey.compare("none") == 0) {
+            producerParams.m_partitionKey = ELogKafkaPartitionKey::KPK_NONE;
+        } else if (partitionKey.compare("source") == 0) {
+            producerParams.m_partitionKey = ELogKafkaPartitionKey::KPK_SOURCE;
+        } else if (partitionKey.compare("thread") == 0) {
+            producerParams.m_partitionKey = ELogKafkaPartitionKey::KPK_THREAD;
+        } else {
+            ELOG_REPORT_ERROR(
+                "Invalid Kafka log target specification, invalid partition key '%s', expecting "
+                "one of: none, source, thread (context: %s)",
+                partitionKey.c_str(), logTargetCfg->getFullContext());
+            return nullptr;
+        }
+    }
+
+    if (!ELogConfigLoader::getOptionalLogTargetUInt32Property(
+            logTargetCfg, "Kafka", "kafka_buffer_pool_size", producerParams.m_bufferPoolSize)) {
+        return nullptr;
+    }
+    if (!verifyUInt32PropRange("Kafka", "kafka_buffer_pool_size", producerParams.m_bufferPoolSize,
+                               0, ELOG_KAFKA_MAX_BUFFER_POOL_SIZE)) {
+        return nullptr;
+    }
+
+    ELogMsgQTarget* target = new (std::nothrow)
+        ELogKafkaMsgQTarget(bootstrapServers, topic, headers, partition, flushTimeoutMillis,
+                            shutdownFlushTimeoutMillis, producerParams);
     if (target == nullptr) {
         ELOG_REPORT_ERROR("Failed to allocate Kafka message queue log target, out of memory");
     }
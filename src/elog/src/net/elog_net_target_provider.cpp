@@ -39,6 +39,8 @@ ELogTarget* ELogNetTargetProvider::loadTarget(const ELogConfigMapNode* logTarget
     //  binary_format={protobuf/thrift/avro}&
     //  compress=value&
     //  max_concurrent_requests=value&
+    //  connections=value&
+    //  shard_by=[thread/round_robin]&
     //  connect_timeout=value&
     //  send_timeout=value&
     //  resend_period=value&
@@ -79,30 +81,33 @@ ELogTarget* ELogNetTargetProvider::loadTarget(const ELogConfigMapNode* logTarget
         return nullptr;
     }
 
-    // create the data client
-    commutil::DataClient* dataClient = nullptr;
-    if (m_type.compare("tcp") == 0) {
-        dataClient = new (std::nothrow)
-            commutil::TcpClient(host.c_str(), port, msgConfig.m_commConfig.m_connectTimeoutMillis);
-    } else if (m_type.compare("udp") == 0) {
-        dataClient = new (std::nothrow) commutil::UdpClient(host.c_str(), port);
-    } else {
-        ELOG_REPORT_ERROR(
-            "Failed to load net log target, invalid transport type '%s' (internal error)",
-            m_type.c_str());
-        delete msgConfig.m_binaryFormatProvider;
-        return nullptr;
-    }
-    if (dataClient == nullptr) {
-        ELOG_REPORT_ERROR("Failed to allocate data client, out of memory");
-        delete msgConfig.m_binaryFormatProvider;
-        return nullptr;
+    // create the data clients (one per connection)
+    std::vector<commutil::DataClient*> dataClients;
+    for (uint32_t i = 0; i < msgConfig.m_connectionCount; ++i) {
+        commutil::DataClient* dataClient = nullptr;
+        if (m_type.compare("tcp") == 0) {
+            dataClient = new (std::nothrow) commutil::TcpClient(
+                host.c_str(), port, msgConfig.m_commConfig.m_connectTimeoutMillis);
+        } else {
+            dataClient = new (std::nothrow) commutil::UdpClient(host.c_str(), port);
+        }
+        if (dataClient == nullptr) {
+            ELOG_REPORT_ERROR("Failed to allocate data client, out of memory");
+            for (commutil::DataClient* client : dataClients) {
+                delete client;
+            }
+            delete msgConfig.m_binaryFormatProvider;
+            return nullptr;
+        }
+        dataClients.push_back(dataClient);
     }
 
-    ELogMsgTarget* target = new (std::nothrow) ELogMsgTarget("net", msgConfig, dataClient);
+    ELogMsgTarget* target = new (std::nothrow) ELogMsgTarget("net", msgConfig, dataClients);
     if (target == nullptr) {
         ELOG_REPORT_ERROR("Failed to allocate net log target, out of memory");
-        delete dataClient;
+        for (commutil::DataClient* client : dataClients) {
+            delete client;
+        }
         delete msgConfig.m_binaryFormatProvider;
     }
     return target;
@@ -80,7 +80,9 @@ static ELogRpcTarget* constructGRPCTarget(const char* name, const std::string& s
                                           const std::string& clientCA, const std::string& clientKey,
                                           ELogGRPCClientMode clientMode,
                                           uint64_t deadlineTimeoutMillis,
-                                          uint32_t maxInflightCalls) {
+                                          uint32_t maxInflightCalls,
+                                          grpc_compression_algorithm compression,
+                                          const ELogGRPCBatchParams& batchParams) {
     ELogGRPCTargetConstructorMap::iterator itr = sTargetConstructorMap.find(name);
     if (itr == sTargetConstructorMap.end()) {
         ELOG_REPORT_ERROR("Invalid gPRC target provider type name '%s': not found", name);
@@ -90,7 +92,7 @@ static ELogRpcTarget* constructGRPCTarget(const char* name, const std::string& s
     ELogGRPCBaseTargetConstructor* constructor = itr->second;
     ELogRpcTarget* logTarget = constructor->createLogTarget(
         ELogReport::getReportHandler(), server, params, serverCA, clientCA, clientKey, clientMode,
-        deadlineTimeoutMillis, maxInflightCalls);
+        deadlineTimeoutMillis, maxInflightCalls, compression, batchParams);
     if (logTarget == nullptr) {
         ELOG_REPORT_ERROR("Failed to create gRPC target by name '%s', out of memory", name);
     }
@@ -140,6 +142,8 @@ ELogTarget* ELogGRPCTargetProvider::loadRpcTarget(const ELogConfigMapNode* logTa
             clientMode = ELogGRPCClientMode::GRPC_CM_ASYNC_CALLBACK_UNARY;
         } else if (clientModeStr.compare("async_callback_stream") == 0) {
             clientMode = ELogGRPCClientMode::GRPC_CM_ASYNC_CALLBACK_STREAM;
+        } else if (clientModeStr.compare("stream_batch") == 0) {
+            clientMode = ELogGRPCClientMode::GRPC_CM_STREAM_BATCH;
         } else {
             ELOG_REPORT_ERROR(
                 "Invalid log target specification, invalid gRPC client mode value '%s' (context: "
@@ -156,6 +160,32 @@ ELogTarget* ELogGRPCTargetProvider::loadRpcTarget(const ELogConfigMapNode* logTa
         return nullptr;
     }
 
+    // for batch streaming, it is also possible to specify maximum batch size and target latency
+    ELogGRPCBatchParams batchParams;
+    if (!ELogConfigLoader::getOptionalLogTargetUInt32Property(
+            logTargetCfg, "gRPC", "grpc_max_batch_size", batchParams.m_maxBatchSize)) {
+        return nullptr;
+    }
+    if (batchParams.m_maxBatchSize < ELOG_GRPC_MIN_BATCH_SIZE) {
+        ELOG_REPORT_ERROR(
+            "Invalid log target specification, gRPC maximum batch size %u is too small, must be "
+            "at least %u (context: %s)",
+            batchParams.m_maxBatchSize, (unsigned)ELOG_GRPC_MIN_BATCH_SIZE,
+            logTargetCfg->getFullContext());
+        return nullptr;
+    }
+    if (!ELogConfigLoader::getOptionalLogTargetTimeoutProperty(
+            logTargetCfg, "gRPC", "grpc_batch_latency", batchParams.m_batchLatencyMicros,
+            ELogTimeUnits::TU_MICRO_SECONDS)) {
+        return nullptr;
+    }
+
+    // check for message compression: none, gzip, deflate
+    grpc_compression_algorithm compression = GRPC_COMPRESS_NONE;
+    if (!loadCompression(logTargetCfg, compression)) {
+        return nullptr;
+    }
+
     // check for security members
     std::string serverCA;
     if (!loadFileProp(logTargetCfg, "grpc_server_ca_path", "server certificate authority",
@@ -176,7 +206,31 @@ ELogTarget* ELogGRPCTargetProvider::loadRpcTarget(const ELogConfigMapNode* logTa
 
     // search for the provider type and construct the specialized log target
     return constructGRPCTarget(providerType.c_str(), server, params, serverCA, clientCA, clientKey,
-                               clientMode, deadlineTimeoutMillis, maxInflightCalls);
+                               clientMode, deadlineTimeoutMillis, maxInflightCalls, compression,
+                               batchParams);
+}
+
+bool ELogGRPCTargetProvider::loadCompression(const ELogConfigMapNode* logTargetCfg,
+                                             grpc_compression_algorithm& compression) {
+    std::string compressionStr;
+    bool found = false;
+    if (!ELogConfigLoader::getOptionalLogTargetStringProperty(
+            logTargetCfg, "gRPC", "grpc_compression", compressionStr, &found)) {
+        return false;
+    }
+    if (!found || compressionStr.compare("none") == 0) {
+        compression = GRPC_COMPRESS_NONE;
+    } else if (compressionStr.compare("gzip") == 0) {
+        compression = GRPC_COMPRESS_GZIP;
+    } else if (compressionStr.compare("deflate") == 0) {
+        compression = GRPC_COMPRESS_DEFLATE;
+    } else {
+        ELOG_REPORT_ERROR(
+            "Invalid log target specification, invalid gRPC compression value '%s' (context: %s)",
+            compressionStr.c_str(), logTargetCfg->getFullContext());
+        return false;
+    }
+    return true;
 }
 
 bool ELogGRPCTargetProvider::loadFileProp(const ELogConfigMapNode* logTargetCfg,
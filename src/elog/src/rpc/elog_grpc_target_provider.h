@@ -5,6 +5,8 @@
 
 #ifdef ELOG_ENABLE_GRPC_CONNECTOR
 
+#include <grpc/compression.h>
+
 #include "rpc/elog_rpc_target_provider.h"
 
 namespace elog {
@@ -35,6 +37,9 @@ protected:
 private:
     bool loadFileProp(const ELogConfigMapNode* logTargetCfg, const char* propName,
                       const char* description, std::string& fileContents);
+
+    bool loadCompression(const ELogConfigMapNode* logTargetCfg,
+                         grpc_compression_algorithm& compression);
 };
 
 }  // namespace elog
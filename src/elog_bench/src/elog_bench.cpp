@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cinttypes>
 #include <condition_variable>
@@ -6,6 +7,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <new>
 #include <thread>
 
 // #define DEFAULT_SERVER_ADDR "192.168.108.111"
@@ -13,6 +15,12 @@
 
 // include elog system first, then any possible connector
 #include "elog_api.h"
+#include "elog_json_writer.h"
+#include "elog_static_formatter.h"
+
+#ifdef ELOG_ENABLE_JSON
+#include <nlohmann/json.hpp>
+#endif
 
 #ifdef ELOG_WINDOWS
 #define WIN32_LEAN_AND_MEAN
@@ -100,6 +108,25 @@ inline void pinThread(uint32_t coreId) {
 
 // so we need to fix counters management for that
 
+// allocation counting, for benchmarks that report allocations per record
+static std::atomic<bool> sCountAllocs(false);
+static std::atomic<uint64_t> sAllocCount(0);
+
+void* operator new(size_t size) {
+    if (sCountAllocs.load(std::memory_order_relaxed)) {
+        sAllocCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* ptr = malloc(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+
 static const uint64_t MT_MSG_COUNT = 10000;
 static const uint64_t ST_MSG_COUNT = 1000000;
 static const uint32_t MIN_THREAD_COUNT = 1;
@@ -117,6 +144,9 @@ static bool sTestSelector = false;
 static bool sTestFilter = false;
 static bool sTestFlushPolicy = false;
 static bool sTestLogFormatter = false;
+static bool sTestJsonWriter = false;
+static bool sTestTimeCapture = false;
+static bool sTestRateLimit = false;
 static int sMsgCnt = -1;
 static int sMinThreadCnt = -1;
 static int sMaxThreadCnt = -1;
@@ -194,6 +224,7 @@ static int testGRPCStream();
 static int testGRPCAsync();
 static int testGRPCAsyncCallbackUnary();
 static int testGRPCAsyncCallbackStream();
+static int testGRPCStreamBatch();
 #endif
 #ifdef ELOG_ENABLE_NET
 static int testTcp();
@@ -277,6 +308,8 @@ static void writeCsvFile(const char* fileName, std::vector<double>& msgThroughpu
                          bool privateLogger);
 static void testPerfFileFlushPolicy();
 static void testPerfBufferedFile();
+static void testPerfStats();
+static void testPerfFlatCombining();
 static void testPerfSegmentedFile();
 static void testPerfRotatingFile();
 static void testPerfDeferredFile();
@@ -461,6 +494,19 @@ public:
         }
         return grpc::Status::OK;
     }
+
+    ::grpc::Status StreamLogRecordBatches(
+        ::grpc::ServerContext* context,
+        ::grpc::ServerReader< ::elog_grpc::ELogRecordBatchMsg>* reader,
+        ::elog_grpc::ELogStatusMsg* response) {
+        elog_grpc::ELogRecordBatchMsg batchMsg;
+        while (reader->Read(&batchMsg)) {
+            for (const elog_grpc::ELogRecordMsg& msg : batchMsg.records()) {
+                handleGrpcLogRecord(&msg);
+            }
+        }
+        return grpc::Status::OK;
+    }
 };
 
 class TestGRPCAsyncServer final : public elog_grpc::ELogService::AsyncService {
@@ -874,11 +920,16 @@ static int testSelector();
 static int testFilter();
 static int testFlushPolicy();
 static int testLogFormatter();
+static int testJsonWriter();
+static int testTimeCapture();
+static int testRateLimit();
 
 static bool sTestPerfAll = true;
 static bool sTestPerfIdleLog = false;
 static bool sTestPerfFileFlush = false;
 static bool sTestPerfBufferedFile = false;
+static bool sTestPerfStats = false;
+static bool sTestPerfFlatCombining = false;
 static bool sTestPerfSegmentedFile = false;
 static bool sTestPerfRotatingFile = false;
 static bool sTestPerfDeferredFile = false;
@@ -926,6 +977,10 @@ static bool sTestPerfBinaryAcceleration = false;
 
 static int sGroupSize = 0;
 static int sGroupTimeoutMicros = 0;
+#ifdef ELOG_ENABLE_DYNAMIC_CONFIG
+static bool sSetLogTargetGCMode = false;
+static elog::ELogGCMode sLogTargetGCMode = elog::ELogGCMode::GM_EPOCH_SET;
+#endif
 
 static bool getPerfParam(const char* param) {
     if (strcmp(param, "idle") == 0) {
@@ -934,6 +989,10 @@ static bool getPerfParam(const char* param) {
         sTestPerfFileFlush = true;
     } else if (strcmp(param, "buffered") == 0) {
         sTestPerfBufferedFile = true;
+    } else if (strcmp(param, "stats") == 0) {
+        sTestPerfStats = true;
+    } else if (strcmp(param, "combining") == 0) {
+        sTestPerfFlatCombining = true;
     } else if (strcmp(param, "segmented") == 0) {
         sTestPerfSegmentedFile = true;
     } else if (strcmp(param, "rotating") == 0) {
@@ -1239,6 +1298,15 @@ static bool parseArgs(int argc, char* argv[]) {
         } else if (strcmp(argv[1], "--test-log-formatter") == 0) {
             sTestLogFormatter = true;
             return true;
+        } else if (strcmp(argv[1], "--test-json-writer") == 0) {
+            sTestJsonWriter = true;
+            return true;
+        } else if (strcmp(argv[1], "--test-time-capture") == 0) {
+            sTestTimeCapture = true;
+            return true;
+        } else if (strcmp(argv[1], "--test-rate-limit") == 0) {
+            sTestRateLimit = true;
+            return true;
         }
     }
 
@@ -1338,6 +1406,23 @@ static bool parseArgs(int argc, char* argv[]) {
             if (!parseIntParam(argv[i], sGroupTimeoutMicros, "--group-timeout-micros")) {
                 return false;
             }
+#ifdef ELOG_ENABLE_DYNAMIC_CONFIG
+        } else if (strcmp(argv[i], "--gc-mode") == 0) {
+            ++i;
+            if (i == argc) {
+                fprintf(stderr, "ERROR: Missing argument for --gc-mode\n");
+                return false;
+            }
+            sSetLogTargetGCMode = true;
+            if (strcmp(argv[i], "epoch-set") == 0) {
+                sLogTargetGCMode = elog::ELogGCMode::GM_EPOCH_SET;
+            } else if (strcmp(argv[i], "thread-epoch") == 0) {
+                sLogTargetGCMode = elog::ELogGCMode::GM_THREAD_EPOCH;
+            } else {
+                fprintf(stderr, "ERROR: Invalid --gc-mode argument '%s'\n", argv[i]);
+                return false;
+            }
+#endif
         } else {
             fprintf(stderr, "ERROR: Invalid parameter '%s'\n", argv[i]);
             return false;
@@ -1605,6 +1690,11 @@ int main(int argc, char* argv[]) {
     }
 
     elog::ELogParams params;
+#ifdef ELOG_ENABLE_DYNAMIC_CONFIG
+    if (sSetLogTargetGCMode) {
+        params.m_logTargetGCMode = sLogTargetGCMode;
+    }
+#endif
 #ifdef ELOG_ENABLE_CONFIG_SERVICE
     struct Publisher : public elog::ELogConfigServicePublisher {
         Publisher() : elog::ELogConfigServicePublisher("elog_bench_test_publisher") {}
@@ -1664,6 +1754,12 @@ int main(int argc, char* argv[]) {
         res = testFlushPolicy();
     } else if (sTestLogFormatter) {
         res = testLogFormatter();
+    } else if (sTestJsonWriter) {
+        res = testJsonWriter();
+    } else if (sTestTimeCapture) {
+        res = testTimeCapture();
+    } else if (sTestRateLimit) {
+        res = testRateLimit();
     } else {
         fprintf(stderr, "STARTING ELOG BENCHMARK\n");
 
@@ -1677,6 +1773,12 @@ int main(int argc, char* argv[]) {
         if (sTestPerfAll || sTestPerfBufferedFile) {
             testPerfBufferedFile();
         }
+        if (sTestPerfAll || sTestPerfStats) {
+            testPerfStats();
+        }
+        if (sTestPerfAll || sTestPerfFlatCombining) {
+            testPerfFlatCombining();
+        }
         if (sTestPerfAll || sTestPerfSegmentedFile) {
             testPerfSegmentedFile();
         }
@@ -1809,7 +1911,11 @@ void termELog() {
 
 inline bool isCaughtUp(elog::ELogTarget* logTarget, uint64_t targetMsgCount) {
     bool caughtUp = false;
-    return logTarget->isCaughtUp(targetMsgCount, caughtUp) && caughtUp;
+    if (!logTarget->isCaughtUp(targetMsgCount, caughtUp)) {
+        // statistics disabled, so there is no way to tell (only used with synchronous log targets)
+        return true;
+    }
+    return caughtUp;
 }
 
 static int testAsyncThreadName() {
@@ -2429,6 +2535,13 @@ private:
 
 ELOG_IMPLEMENT_LOG_FORMATTER(TestFormatter)
 
+#define BENCH_FORMAT_SPEC \
+    "${time} ${level:6} [${tid:-5}] ${host} ${user} ${prog} ${pid} ${src} ${msg}"
+
+ELOG_DECLARE_STATIC_LOG_FORMATTER(BenchStaticFormatter, bench_static, BENCH_FORMAT_SPEC,
+                                  ELOG_NO_EXPORT)
+ELOG_IMPLEMENT_LOG_FORMATTER(BenchStaticFormatter)
+
 int testLogFormatter() {
     const char* cfg = "sys://stderr?log_format=test:${time} ${level:6} ${tid} ${src} ${msg}";
     elog::ELogTarget* logTarget = initElog(cfg);
@@ -2437,6 +2550,223 @@ int testLogFormatter() {
     }
     elog::ELogLogger* logger = elog::getPrivateLogger("elog_bench_logger");
     ELOG_INFO_EX(logger, "This is a test message");
+
+    // compare interpreted, compiled and static formatting throughput
+    elog::ELogFormatter* logFormatter = new (std::nothrow) elog::ELogFormatter();
+    if (logFormatter == nullptr || !logFormatter->initialize(BENCH_FORMAT_SPEC)) {
+        fprintf(stderr, "Failed to initialize log formatter\n");
+        if (logFormatter != nullptr) {
+            elog::destroyLogFormatter(logFormatter);
+        }
+        termELog();
+        return 2;
+    }
+    elog::ELogFormatter* staticFormatter =
+        elog::constructLogFormatter(BenchStaticFormatter::TYPE_NAME);
+    if (staticFormatter == nullptr) {
+        fprintf(stderr, "Failed to create static log formatter\n");
+        elog::destroyLogFormatter(logFormatter);
+        termELog();
+        return 3;
+    }
+    const char* logMsg = "This is a test message";
+    elog::ELogRecord logRecord;
+    logRecord.m_logMsg = logMsg;
+    logRecord.m_logMsgLen = (uint32_t)strlen(logMsg);
+    logRecord.m_logLevel = elog::ELEVEL_INFO;
+    logRecord.m_file = __FILE__;
+    logRecord.m_line = __LINE__;
+    logRecord.m_function = ELOG_FUNCTION;
+    logRecord.m_threadId = getCurrentThreadId();
+    logRecord.m_logger = logger;
+    elog::ELogBuffer logBuffer;
+    const char* modeNames[] = {"Interpreted", "Compiled", "Static"};
+    for (int mode = 0; mode < 3; ++mode) {
+        logFormatter->setCompiledMode(mode == 1);
+        elog::ELogFormatter* formatter = (mode == 2) ? staticFormatter : logFormatter;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint64_t i = 0; i < ST_MSG_COUNT; ++i) {
+            logBuffer.reset();
+            logRecord.m_logRecordId = i;
+            formatter->formatLogBuffer(logRecord, logBuffer);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::microseconds testTime =
+            std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        double throughput = ST_MSG_COUNT / (double)testTime.count() * 1000000.0f;
+        fprintf(stderr, "%s formatter: %u usec, %0.3f Msg/Sec\n", modeNames[mode],
+                (unsigned)testTime.count(), throughput);
+    }
+    elog::destroyLogFormatter(staticFormatter);
+    elog::destroyLogFormatter(logFormatter);
+    termELog();
+    return 0;
+}
+
+static void reportJsonWriterResult(const char* name, std::chrono::microseconds testTime,
+                                   uint64_t byteCount, uint64_t allocCount) {
+    double throughput = byteCount / (double)testTime.count() * 1000000.0f / 1024 / 1024;
+    fprintf(stderr, "%s: %u usec, %0.3f MB/Sec, %0.3f allocations per record\n", name,
+            (unsigned)testTime.count(), throughput, allocCount / (double)ST_MSG_COUNT);
+}
+
+int testJsonWriter() {
+    // compare composing a Datadog-like JSON batch body with the streaming JSON writer vs. nlohmann
+    const uint64_t BATCH_SIZE = 100;
+    const char* logMsgs[] = {
+        "This is a test message with some payload, that is long enough to be scanned in chunks",
+        "Connection to \"server-01\" failed:\tretrying in 5 seconds\n",
+        "C:\\Program Files\\elog\\bin\\elog_bench.exe exited with code 0"};
+    const size_t logMsgCount = sizeof(logMsgs) / sizeof(logMsgs[0]);
+
+    std::string body;
+    uint64_t byteCount = 0;
+    sAllocCount.store(0, std::memory_order_relaxed);
+    sCountAllocs.store(true, std::memory_order_relaxed);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < ST_MSG_COUNT; ++i) {
+        if (i % BATCH_SIZE == 0) {
+            body.assign(1, '[');
+        } else {
+            body.push_back(',');
+        }
+        elog::ELogJsonWriter<std::string> writer(body);
+        writer.beginObject();
+        writer.writeStringMember("message", logMsgs[i % logMsgCount]);
+        writer.writeStringMember("status", "INFO");
+        writer.writeStringMember("hostname", "bench-host");
+        writer.writeStringMember("logger.name", "elog_bench_logger");
+        writer.writeStringMember("ddtags", "env:bench,version:1");
+        writer.endObject();
+        if ((i + 1) % BATCH_SIZE == 0) {
+            body.push_back(']');
+            byteCount += body.length();
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    sCountAllocs.store(false, std::memory_order_relaxed);
+    reportJsonWriterResult("JSON writer",
+                           std::chrono::duration_cast<std::chrono::microseconds>(end - start),
+                           byteCount, sAllocCount.load(std::memory_order_relaxed));
+
+#ifdef ELOG_ENABLE_JSON
+    nlohmann::json logItemArray = nlohmann::json::array();
+    byteCount = 0;
+    sAllocCount.store(0, std::memory_order_relaxed);
+    sCountAllocs.store(true, std::memory_order_relaxed);
+    start = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < ST_MSG_COUNT; ++i) {
+        size_t index = logItemArray.size();
+        logItemArray[index]["message"] = logMsgs[i % logMsgCount];
+        logItemArray[index]["status"] = "INFO";
+        logItemArray[index]["hostname"] = "bench-host";
+        logItemArray[index]["logger.name"] = "elog_bench_logger";
+        logItemArray[index]["ddtags"] = "env:bench,version:1";
+        if ((i + 1) % BATCH_SIZE == 0) {
+            body = logItemArray.dump();
+            byteCount += body.length();
+            logItemArray = nlohmann::json::array();
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    sCountAllocs.store(false, std::memory_order_relaxed);
+    reportJsonWriterResult("nlohmann JSON",
+                           std::chrono::duration_cast<std::chrono::microseconds>(end - start),
+                           byteCount, sAllocCount.load(std::memory_order_relaxed));
+#else
+    fprintf(stderr, "nlohmann JSON comparison skipped, must compile with ELOG_ENABLE_JSON\n");
+#endif
+    return 0;
+}
+
+static void reportTimeCaptureResult(const char* name) {
+    // prevent the compiler from optimizing away the time capture
+    volatile uint32_t sink = 0;
+    elog::ELogTime logTime;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < ST_MSG_COUNT; ++i) {
+        elog::getCurrentLogTime(logTime);
+        sink = sink + (uint32_t)elog::elogTimeToInt64(logTime);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::nanoseconds testTime =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    elog::ELogTimeBuffer timeBuffer;
+    elog::elogTimeToString(logTime, timeBuffer);
+    fprintf(stderr, "%s: %0.2f nanos per record (last time: %s)\n", name,
+            testTime.count() / (double)ST_MSG_COUNT, timeBuffer.m_buffer);
+}
+
+int testTimeCapture() {
+    elog::ELogTarget* logTarget = initElog();
+    if (logTarget == nullptr) {
+        return 1;
+    }
+
+    // compare per-record time capture cost of all time capture modes and the lazy time source
+    elog::setTimeCaptureMode(elog::ELogTimeCaptureMode::TCM_REALTIME);
+    reportTimeCaptureResult("Real-time clock");
+    elog::setTimeCaptureMode(elog::ELogTimeCaptureMode::TCM_REALTIME_COARSE);
+    reportTimeCaptureResult("Coarse real-time clock");
+    elog::setTimeCaptureMode(elog::ELogTimeCaptureMode::TCM_TSC);
+    reportTimeCaptureResult("TSC clock");
+    elog::setTimeCaptureMode(elog::ELogTimeCaptureMode::TCM_REALTIME);
+    elog::enableLazyTimeSource();
+    reportTimeCaptureResult("Lazy time source");
+    elog::disableLazyTimeSource();
+
+    termELog();
+    return 0;
+}
+
+static void reportRateLimitResult(const char* name, uint64_t maxMsg, bool sharded) {
+    const uint32_t threadCounts[] = {1, 2, 4, 8, 16, 32};
+    const uint64_t callCount = ST_MSG_COUNT;
+    for (uint32_t threadCount : threadCounts) {
+        elog::ELogRateLimiter rateLimiter(
+            elog::ELogRateLimitParams(maxMsg, 1, elog::ELogTimeUnits::TU_SECONDS, sharded));
+        std::atomic<uint64_t> passCount(0);
+        std::vector<std::thread> threads;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back(std::thread([&rateLimiter, &passCount, callCount]() {
+                elog::ELogRecord logRecord;
+                uint64_t localPassCount = 0;
+                for (uint64_t j = 0; j < callCount; ++j) {
+                    if (rateLimiter.filterLogRecord(logRecord)) {
+                        ++localPassCount;
+                    }
+                }
+                passCount.fetch_add(localPassCount, std::memory_order_relaxed);
+            }));
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::nanoseconds testTime =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        // NOTE: cost is averaged over the calls of all threads, so that on a machine with fewer
+        // cores than threads the result is not inflated by time-slicing
+        fprintf(stderr, "%s, %u threads: %0.2f nanos per call, %" PRIu64 " passed\n", name,
+                threadCount, testTime.count() / (double)(callCount * threadCount),
+                passCount.load(std::memory_order_relaxed));
+    }
+}
+
+int testRateLimit() {
+    elog::ELogTarget* logTarget = initElog();
+    if (logTarget == nullptr) {
+        return 1;
+    }
+
+    // compare per-call cost of the shared and sharded rate limiters, both when most calls pass
+    // (token consumption) and when most calls are rejected (limit reached)
+    reportRateLimitResult("Shared rate limiter (pass)", 1000000000, false);
+    reportRateLimitResult("Sharded rate limiter (pass)", 1000000000, true);
+    reportRateLimitResult("Shared rate limiter (reject)", 1000, false);
+    reportRateLimitResult("Sharded rate limiter (reject)", 1000, true);
+
     termELog();
     return 0;
 }
@@ -2545,6 +2875,11 @@ int testGRPC() {
         return res;
     }
 
+    res = testGRPCStreamBatch();
+    if (res != 0) {
+        return res;
+    }
+
     return 0;
 }
 
@@ -2567,7 +2902,7 @@ std::thread startServiceWait<TestGRPCAsyncServer>(
 
 template <typename ServerType>
 int testGRPCClient(const char* clientType, int opts = 0, uint32_t stMsgCount = 1000,
-                   uint32_t mtMsgCount = 1000) {
+                   uint32_t mtMsgCount = 1000, const char* extraParams = "") {
     // setup up server
     std::string serverAddress = "0.0.0.0:5051";
     ServerType service;
@@ -2590,6 +2925,7 @@ int testGRPCClient(const char* clientType, int opts = 0, uint32_t stMsgCount = 1
         "${msg})&grpc_max_inflight_calls=20000&flush_policy=count&flush_count=1024&"
         "grpc_client_mode=";
     cfg += clientType;
+    cfg += extraParams;
     std::string testName = std::string("gRPC (") + clientType + ")";
     std::string mtResultFileName = std::string("elog_bench_grpc_") + clientType;
 
@@ -2605,6 +2941,10 @@ int testGRPCClient(const char* clientType, int opts = 0, uint32_t stMsgCount = 1
     }
 
     runSingleThreadedTest(testName.c_str(), cfg.c_str(), msgPerf, ioPerf, statData, stMsgCount);
+#ifdef MEASURE_PERCENTILE
+    fprintf(stderr, "%s latency: p50=%0.3f usec, p95=%0.3f usec, p99=%0.3f usec\n", testName.c_str(),
+            statData.p50, statData.p95, statData.p99);
+#endif
     uint32_t receivedMsgCount = (uint32_t)sGrpcMsgCount.load(std::memory_order_relaxed);
     // total: 2 pre-init + stMsgCount single-thread messages
     uint32_t totalMsg = stMsgCount;
@@ -2672,6 +3012,14 @@ int testGRPCAsyncCallbackUnary() {
 int testGRPCAsyncCallbackStream() {
     return testGRPCClient<TestGRPCAsyncCallbackServer>("async_callback_stream");
 }
+
+int testGRPCStreamBatch() {
+    int res = testGRPCClient<TestGRPCServer>("stream_batch");
+    if (res != 0) {
+        return res;
+    }
+    return testGRPCClient<TestGRPCServer>("stream_batch", 0, 1000, 1000, "&grpc_compression=gzip");
+}
 #endif
 
 #if defined(ELOG_ENABLE_NET) || defined(ELOG_ENABLE_IPC)
@@ -3015,6 +3363,19 @@ void testKafka() {
     double ioPerf = 0.0f;
     StatData statData;
     runSingleThreadedTest("Kafka", cfg.c_str(), msgPerf, ioPerf, statData, 10);
+
+    // batched producer with zero-copy payload, compression and per-thread keyed partitioning
+    std::string batchCfg =
+        std::string("msgq://kafka?kafka_bootstrap_servers=") + sServerAddr +
+        ":9092&"
+        "msgq_topic=log_records&"
+        "kafka_linger=5millis&"
+        "kafka_batch_size=1mb&"
+        "kafka_compression=lz4&"
+        "kafka_partition_key=thread&"
+        "kafka_flush_timeout=50millis&"
+        "flush_policy=count&flush_count=4096";
+    runSingleThreadedTest("Kafka (batched)", batchCfg.c_str(), msgPerf, ioPerf, statData);
 }
 #endif
 
@@ -3675,6 +4036,9 @@ void runMultiThreadTest(const char* title, const char* fileName, const char* cfg
         uint64_t bytesStart = logTarget->getBytesWritten();
         uint64_t initMsgCount = logTarget->getProcessedMsgCount();
         // fprintf(stderr, "Init msg count = %" PRIu64 "\n", initMsgCount);
+        threads.reserve(threadCount);
+        sAllocCount.store(0, std::memory_order_relaxed);
+        sCountAllocs.store(true, std::memory_order_relaxed);
         for (uint32_t i = 0; i < threadCount; ++i) {
             elog::ELogLogger* logger = loggers[i];
             threads.emplace_back(std::thread([i, &resVec, logger, msgCount]() {
@@ -3708,6 +4072,7 @@ void runMultiThreadTest(const char* title, const char* fileName, const char* cfg
         }
 
         auto end = std::chrono::high_resolution_clock::now();
+        sCountAllocs.store(false, std::memory_order_relaxed);
         ELOG_INFO("%u Thread Test ended", threadCount);
         uint64_t bytesEnd = logTarget->getBytesWritten();
         double throughput = 0;
@@ -3739,12 +4104,14 @@ void runMultiThreadTest(const char* title, const char* fileName, const char* cfg
         msgThroughput.push_back(throughput);
         throughput = (bytesEnd - bytesStart) / (double)testTime.count() * 1000000.0f / 1024;
 #ifdef ELOG_MSVC
-        fprintf(stderr, "%u thread Throughput: %s KB/Sec\n\n", threadCount,
+        fprintf(stderr, "%u thread Throughput: %s KB/Sec\n", threadCount,
                 win32FormatNumber(throughput).c_str());
 #else
-        fprintf(stderr, "%u thread Throughput: %'.3f KB/Sec\n\n", threadCount, throughput);
+        fprintf(stderr, "%u thread Throughput: %'.3f KB/Sec\n", threadCount, throughput);
 #endif
         byteThroughput.push_back(throughput);
+        fprintf(stderr, "%u thread allocations per record: %0.3f\n\n", threadCount,
+                sAllocCount.load(std::memory_order_relaxed) / (double)(threadCount * msgCount));
     }
 
     // std::this_thread::sleep_for(std::chrono::milliseconds(5000));
@@ -4316,6 +4683,49 @@ void testPerfBufferedFile() {
     runMultiThreadTest("Buffered File (4mb)", "elog_bench_buffered4mb", cfg);
 }
 
+void testPerfStats() {
+    // measure statistics overhead: all logging threads update the same log target's counters
+    const char* cfg =
+        "file:///./bench_data/elog_bench_stats_on.log?"
+        "file_buffer_size=1mb&file_lock=yes&flush_policy=none&enable_stats=yes";
+    runMultiThreadTest("Buffered File (1mb, statistics enabled)", "elog_bench_stats_on", cfg);
+
+    // latency histograms are disabled by default, measure them when sampling every 64th record
+    cfg =
+        "file:///./bench_data/elog_bench_stats_sampled.log?"
+        "file_buffer_size=1mb&file_lock=yes&flush_policy=none&enable_stats=yes";
+    elog::setStatsLatencySampleRate(64);
+    runMultiThreadTest("Buffered File (1mb, statistics enabled, latency sampled 1/64)",
+                       "elog_bench_stats_sampled", cfg);
+    elog::setStatsLatencySampleRate(0);
+
+    cfg =
+        "file:///./bench_data/elog_bench_stats_off.log?"
+        "file_buffer_size=1mb&file_lock=yes&flush_policy=none&enable_stats=no";
+    runMultiThreadTest("Buffered File (1mb, statistics disabled)", "elog_bench_stats_off", cfg);
+}
+
+void testPerfFlatCombining() {
+    // compare try-lock/backlog with flat-combining under heavy lock contention (8-32 threads)
+    const char* cfg =
+        "file:///./bench_data/elog_bench_backlog.log?"
+        "file_buffer_size=1mb&file_lock=yes&flush_policy=none";
+    runMultiThreadTest("Buffered File (1mb, try-lock/backlog)", "elog_bench_backlog", cfg, true, 8,
+                       32);
+
+    cfg =
+        "file:///./bench_data/elog_bench_combining.log?"
+        "file_buffer_size=1mb&file_lock=yes&flush_policy=none&flat_combining=yes";
+    runMultiThreadTest("Buffered File (1mb, flat-combining)", "elog_bench_combining", cfg, true, 8,
+                       32);
+
+    // the plain file log target is natively thread-safe (it takes no log target lock), so flat
+    // combining does not apply to it, and it serves as the lock-free reference
+    cfg = "file:///./bench_data/elog_bench_combining_plain.log?flush_policy=none&flat_combining=yes";
+    runMultiThreadTest("File (plain, no log target lock)", "elog_bench_combining_plain", cfg, true,
+                       8, 32);
+}
+
 void testPerfSegmentedFile() {
     const char* cfg =
         "file:///./bench_data/elog_bench_segmented_1mb.log?"
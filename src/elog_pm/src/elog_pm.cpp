@@ -3,6 +3,11 @@
 #include "elog_api.h"
 #include "life_sign_manager.h"
 
+#if defined(ELOG_ENABLE_IPC) && defined(ELOG_LINUX)
+#include "ipc/elog_shm_ring.h"
+#define ELOG_PM_HAS_SHM_RING
+#endif
+
 #ifdef ELOG_WINDOWS
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
@@ -38,9 +43,16 @@
 #define CMD_DUMP_SHM "dump-shm"
 #define CMD_DEL_SHM "del-shm"
 #define CMD_DEL_ALL_SHM "del-all-shm"
+#define CMD_LS_RING "ls-ring"
+#define CMD_DUMP_RING "dump-ring"
+#define CMD_DEL_RING "del-ring"
 
 static const char* sCommands[] = {CMD_EXIT,    CMD_HELP,        CMD_LS_SHM, CMD_DUMP_SHM,
-                                  CMD_DEL_SHM, CMD_DEL_ALL_SHM, nullptr};
+                                  CMD_DEL_SHM, CMD_DEL_ALL_SHM,
+#ifdef ELOG_PM_HAS_SHM_RING
+                                  CMD_LS_RING, CMD_DUMP_RING,   CMD_DEL_RING,
+#endif
+                                  nullptr};
 
 // error codes
 #define ERR_INIT 1
@@ -105,6 +117,11 @@ static int printLifeSignRecords(const dbgutil::LifeSignHeader* hdr, const AppDat
 static int printThreadLifeSignRecords(uint32_t threadSlotId, const dbgutil::LifeSignHeader* hdr,
                                       const AppData& appData);
 static void printTime(const char* title, int64_t epochTimeMilliSeconds, uint32_t padding = 0);
+#ifdef ELOG_PM_HAS_SHM_RING
+static int listAllRings();
+static int execDumpRing(const std::string& ringName);
+static int execDelRing(const std::string& ringName);
+#endif
 
 // Windows Shared Memory Guardian Stuff
 //
@@ -254,6 +271,24 @@ static int execArgs(int argc, char* argv[]) {
         }
         return execDelShm(argv[2]);
     }
+#ifdef ELOG_PM_HAS_SHM_RING
+    if (strcmp(argv[1], CMD_LS_RING) == 0) {
+        return listAllRings();
+    }
+    if (strcmp(argv[1], CMD_DUMP_RING) == 0 || strcmp(argv[1], CMD_DEL_RING) == 0) {
+        if (argc < 3) {
+            ELOG_ERROR_EX(sLogger, "Missing argument for command %s", argv[1]);
+            return ERR_MISSING_ARG;
+        }
+        if (argc > 3) {
+            ELOG_WARN_EX(sLogger, "Ignoring excess arguments passed to command %s", argv[1]);
+        }
+        if (strcmp(argv[1], CMD_DUMP_RING) == 0) {
+            return execDumpRing(argv[2]);
+        }
+        return execDelRing(argv[2]);
+    }
+#endif
     ELOG_ERROR_EX(sLogger, "Invalid command: %s", argv[2]);
     return ERR_INVALID_ARG;
 }
@@ -358,6 +393,11 @@ static void printHelp() {
     printf("del-all-shm: deletes all shared memory segments\n");
     printf("del-shm <name>: delete a shared memory segment\n");
     printf("dump-shm <name>: dumps the contents of a shared memory segment\n");
+#ifdef ELOG_PM_HAS_SHM_RING
+    printf("ls-ring: list all shared memory log record rings\n");
+    printf("dump-ring <name>: dumps the header and pending records of a shared memory ring\n");
+    printf("del-ring <name>: delete a shared memory ring\n");
+#endif
     printf("help: prints this help screen\n");
 }
 
@@ -417,6 +457,16 @@ static bool execCommand(const std::string& cmd) {
     } else if (cmd.starts_with(CMD_DEL_SHM)) {
         std::string shmName = trim(cmd.substr(strlen(CMD_DEL_SHM)));
         execDelShm(shmName);
+#ifdef ELOG_PM_HAS_SHM_RING
+    } else if (cmd.compare(CMD_LS_RING) == 0) {
+        listAllRings();
+    } else if (cmd.starts_with(CMD_DUMP_RING)) {
+        std::string ringName = trim(cmd.substr(strlen(CMD_DUMP_RING)));
+        execDumpRing(ringName);
+    } else if (cmd.starts_with(CMD_DEL_RING)) {
+        std::string ringName = trim(cmd.substr(strlen(CMD_DEL_RING)));
+        execDelRing(ringName);
+#endif
     } else {
         fprintf(stderr, "ERROR: Unrecognized command\n");
     }
@@ -1268,4 +1318,80 @@ bool syncSegment(const std::string& segName, ShmSegmentData& segData) {
     return true;
 }
 
-#endif
\ No newline at end of file
+#endif
+
+#ifdef ELOG_PM_HAS_SHM_RING
+int listAllRings() {
+    elog::ELogShmRingList ringList;
+    if (!elog::ELogShmRing::listRings(ringList)) {
+        ELOG_ERROR_EX(sLogger, "Failed to list shared memory rings");
+        return ERR_LIST_SHM;
+    }
+    if (ringList.empty()) {
+        ELOG_INFO_EX(sLogger, "No shared memory rings found");
+        return 0;
+    }
+    size_t maxNameSize = 0;
+    for (const auto& entry : ringList) {
+        maxNameSize = std::max(maxNameSize, entry.first.length());
+    }
+    printf("Shared memory ring list:\n");
+    printf("Name%*sSize\n", (int)(maxNameSize - 2), "");
+    for (const auto& entry : ringList) {
+        printf("%s  %" PRIu64 " bytes\n", entry.first.c_str(), entry.second);
+    }
+    flushAllStream();
+    return 0;
+}
+
+int execDumpRing(const std::string& ringName) {
+    elog::ELogShmRing ring;
+    if (!ring.open(ringName.c_str())) {
+        ELOG_ERROR_EX(sLogger, "Failed to open shared memory ring %s", ringName.c_str());
+        return ERR_OPEN_SHM;
+    }
+
+    // print header
+    const elog::ELogShmRingHeader* hdr = ring.getHeader();
+    uint64_t readPos = hdr->m_readPos.load(std::memory_order_acquire);
+    uint64_t reservePos = hdr->m_reservePos.load(std::memory_order_acquire);
+    printf("Ring name:        %s\n", ringName.c_str());
+    printf("Ring version:     %u\n", hdr->m_version);
+    printf("Writer pid:       %" PRIu64 "\n", hdr->m_writerPid);
+    printTime("Create time", hdr->m_createTimeEpochMillis, 5);
+    printf("Capacity:         %" PRIu64 " bytes\n", hdr->m_capacity);
+    printf("Used:             %" PRIu64 " bytes\n", reservePos - readPos);
+    printf("Records written:  %" PRIu64 "\n",
+           hdr->m_recordCount.load(std::memory_order_relaxed));
+    printf("Records dropped:  %" PRIu64 "\n", hdr->m_dropCount.load(std::memory_order_relaxed));
+    printf("Abandoned:        %" PRIu64 "\n",
+           hdr->m_abandonCount.load(std::memory_order_relaxed));
+    printf("Waiting readers:  %u\n", hdr->m_waiterCount.load(std::memory_order_relaxed));
+
+    // print pending records without consuming them
+    printf("Pending records:\n");
+    uint64_t pos = readPos;
+    const char* data = nullptr;
+    uint32_t length = 0;
+    uint32_t i = 1;
+    while (ring.inspect(pos, data, length)) {
+        // formatted records usually end with new line
+        int printLen = (int)length;
+        if (printLen > 0 && data[printLen - 1] == '\n') {
+            --printLen;
+        }
+        printf("[%u] %.*s\n", i++, printLen, data);
+    }
+    flushAllStream();
+    (void)ring.close();
+    return 0;
+}
+
+int execDelRing(const std::string& ringName) {
+    if (!elog::ELogShmRing::unlinkRing(ringName.c_str())) {
+        ELOG_ERROR_EX(sLogger, "Failed to delete shared memory ring %s", ringName.c_str());
+        return ERR_DEL_SHM;
+    }
+    return 0;
+}
+#endif
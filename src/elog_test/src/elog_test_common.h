@@ -130,8 +130,16 @@ public:
 
     inline uint64_t getFlushCount() const { return m_flushCount.load(std::memory_order_relaxed); }
 
+    std::string getLastFlushThreadName() {
+        std::unique_lock<std::mutex> lock(m_lock);
+        return m_lastFlushThreadName;
+    }
+
     std::mutex& getLock() { return m_lock; };
 
+    /** @brief Allows flush moderation (the log target synchronizes access by itself). */
+    void enableFlushModeration() { setNativelyThreadSafe(); }
+
 protected:
     /** @brief Order the log target to start (required for threaded targets). */
     bool startLogTarget() override { return true; }
@@ -163,6 +171,9 @@ protected:
     /** @brief Orders a buffered log target to flush it log messages. */
     bool flushLogTarget() override {
         m_flushCount.fetch_add(1, std::memory_order_relaxed);
+        const char* threadName = elog::getCurrentThreadName();
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_lastFlushThreadName = (threadName != nullptr) ? threadName : "";
         return true;
     }
 
@@ -172,6 +183,7 @@ private:
     std::vector<std::string> m_logMessages;
     std::vector<std::string> m_infoLogMessages;
     std::atomic<uint64_t> m_flushCount;
+    std::string m_lastFlushThreadName;
 };
 
 #endif  // __ELOG_TEST_COMMON_H__
\ No newline at end of file
@@ -1,5 +1,16 @@
 #include <regex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
 
+#include "async/elog_deferred_target.h"
+#include "async/elog_quantum_target.h"
+#include "async/elog_queued_target.h"
+#include "elog_gc.h"
+#include "elog_histogram.h"
+#include "elog_msg_blob.h"
+#include "elog_render_cache.h"
+#include "file/elog_buffered_file_writer.h"
 #include "elog_test_common.h"
 
 #ifdef ELOG_WINDOWS
@@ -451,4 +462,1314 @@ TEST(ELogCore, TimeFormat) {
     ELOG_INFO("Test message");
     EXPECT_EQ(logMessages.size(), 1);
     fprintf(stderr, "Time: %s\n", logMessages[0].c_str());
-}
\ No newline at end of file
+}
+
+TEST(ELogCore, CompiledFormat) {
+    TestLogTarget* logTarget = new (std::nothrow) TestLogTarget();
+    ASSERT_NE(logTarget, nullptr);
+    const auto& logMessages = logTarget->getLogMessages();
+
+    // compiled and interpreted formatting should yield the exact same result (record id, time and
+    // line are excluded, since they differ between log messages)
+    // NOTE: caller script is required to set env var TEST_ENV_VAR=TEST_ENV_VALUE, otherwise the
+    // log format cannot be parsed
+    bool res = logTarget->setLogFormat(
+        "${host}@${user} ${prog:-12}|${pid:10}| ${level:6:fg-color=green} [${tid:-8}] "
+        "${if: (log_level == INFO): ${fmt:begin-fg-color=green}: ${fmt:begin-fg-color=red}}"
+        "${src:font=underline}${fmt:default} ${mod} ${file} ${func} ${tname} "
+        "${env:name=TEST_ENV_VAR} ${msg:20}");
+    if (!res) {
+        logTarget->destroy();
+    }
+    ASSERT_TRUE(res);
+    elog::ELogFormatter* logFormatter = logTarget->getLogFormatter();
+    ASSERT_NE(logFormatter, nullptr);
+    EXPECT_EQ(logFormatter->isCompiledMode(), true);
+    ASSERT_NE(elog::addLogTarget(logTarget), ELOG_INVALID_TARGET_ID);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getPrivateLogger("elog.test.core.compiled");
+
+    logTarget->clearLogMessages();
+    ELOG_INFO_EX(logger, "Test message");
+    logFormatter->setCompiledMode(false);
+    ELOG_INFO_EX(logger, "Test message");
+    logFormatter->setCompiledMode(true);
+    ELOG_WARN_EX(logger, "Test message");
+    logFormatter->setCompiledMode(false);
+    ELOG_WARN_EX(logger, "Test message");
+    logFormatter->setCompiledMode(true);
+    EXPECT_EQ(logMessages.size(), 4);
+    if (logMessages.size() == 4) {
+        EXPECT_EQ(logMessages[0], logMessages[1]);
+        EXPECT_EQ(logMessages[2], logMessages[3]);
+        EXPECT_NE(logMessages[0], logMessages[2]);
+    }
+    elog::removeLogTarget(logTarget);
+}
+
+TEST(ELogCore, CachedNames) {
+    TestLogTarget* logTarget = new (std::nothrow) TestLogTarget();
+    elog::addLogTarget(logTarget);
+    const auto& logMessages = logTarget->getLogMessages();
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    bool res = logTarget->setLogFormat("${tname:16}|${src:-26}|${mod:12}|${msg}");
+    EXPECT_EQ(res, true);
+    elog::ELogFormatter* logFormatter = logTarget->getLogFormatter();
+    elog::ELogLogger* logger = elog::getPrivateLogger("elog.test.core.cached");
+
+    // names are cached per formatting thread, and renaming should invalidate the cache, in both
+    // compiled and interpreted mode
+    logTarget->clearLogMessages();
+    std::thread t([logger, logFormatter]() {
+        for (int i = 0; i < 2; ++i) {
+            logFormatter->setCompiledMode(i == 0);
+            elog::setCurrentThreadName(i == 0 ? "cache-test-1" : "cache-test-22");
+            logger->getLogSource()->setModuleName(i == 0 ? "mod_a" : "mod_bb");
+            ELOG_INFO_EX(logger, "Test message");
+            ELOG_INFO_EX(logger, "Test message");
+        }
+        logFormatter->setCompiledMode(true);
+    });
+    t.join();
+    EXPECT_EQ(logMessages.size(), 4);
+    if (logMessages.size() == 4) {
+        EXPECT_EQ(logMessages[0],
+                  "cache-test-1    |     elog.test.core.cached|mod_a       |Test message");
+        EXPECT_EQ(logMessages[1], logMessages[0]);
+        EXPECT_EQ(logMessages[2],
+                  "cache-test-22   |     elog.test.core.cached|mod_bb      |Test message");
+        EXPECT_EQ(logMessages[3], logMessages[2]);
+    }
+    elog::removeLogTarget(logTarget);
+}
+
+TEST(ELogCore, TimeCaptureMode) {
+    // all time capture modes should be close to the real-time clock
+    elog::ELogTimeCaptureMode modes[] = {elog::ELogTimeCaptureMode::TCM_REALTIME,
+                                         elog::ELogTimeCaptureMode::TCM_REALTIME_COARSE,
+                                         elog::ELogTimeCaptureMode::TCM_TSC};
+    for (elog::ELogTimeCaptureMode mode : modes) {
+        elog::setTimeCaptureMode(mode);
+        EXPECT_EQ(elog::getTimeCaptureMode(), mode);
+        for (uint32_t i = 0; i < 3; ++i) {
+            elog::ELogTime refTime;
+            elog::ELogTime logTime;
+            elog::elogGetCurrentTime(refTime);
+            elog::getCurrentLogTime(logTime);
+            int64_t diffNanos = (int64_t)elog::elogTimeToUnixTimeNanos(logTime) -
+                                (int64_t)elog::elogTimeToUnixTimeNanos(refTime);
+            EXPECT_LT(std::abs(diffNanos), 50000000ll);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    elog::setTimeCaptureMode(elog::ELogTimeCaptureMode::TCM_REALTIME);
+}
+
+TEST(ELogCore, RelativeTime) {
+    TestLogTarget* logTarget = new (std::nothrow) TestLogTarget();
+    elog::addLogTarget(logTarget);
+    const auto& logMessages = logTarget->getLogMessages();
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getPrivateLogger("elog.test.core.rel_time");
+
+    // check in both compiled and interpreted mode
+    for (int mode = 0; mode < 2; ++mode) {
+        EXPECT_EQ(logTarget->setLogFormat("${rel_time} ${src_rel_time} ${thread_delta}"), true);
+        logTarget->getLogFormatter()->setCompiledMode(mode == 0);
+        logTarget->clearLogMessages();
+        for (int i = 0; i < 3; ++i) {
+            ELOG_INFO_EX(logger, "Test message");
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        ASSERT_EQ(logMessages.size(), 3);
+        uint64_t prevRelTime = 0;
+        for (int i = 0; i < 3; ++i) {
+            uint64_t relTime = 0;
+            uint64_t srcRelTime = 0;
+            uint64_t threadDelta = 0;
+            std::stringstream s(logMessages[i]);
+            s >> relTime >> srcRelTime >> threadDelta;
+            EXPECT_GT(relTime, prevRelTime);
+            EXPECT_LE(srcRelTime, relTime);
+            // NOTE: delta of first record depends on records previously issued by this thread
+            if (i > 0) {
+                EXPECT_GE(threadDelta, 1000000ull);
+                EXPECT_EQ(threadDelta, relTime - prevRelTime);
+            }
+            prevRelTime = relTime;
+        }
+    }
+    elog::removeLogTarget(logTarget);
+}
+
+TEST(ELogCore, ThreadDeltaAsync) {
+    // records are formatted by the log thread of the deferred target, but the delta should still
+    // be computed relative to the previous record of each logging thread
+    const uint32_t threadCount = 3;
+    const uint32_t msgCount = 20;
+    TestLogTarget* subTarget = new (std::nothrow) TestLogTarget();
+    ASSERT_NE(subTarget, nullptr);
+    ASSERT_TRUE(subTarget->setLogFormat("${tid} ${rel_time} ${thread_delta} ${msg}"));
+    elog::ELogDeferredTarget* logTarget = new (std::nothrow) elog::ELogDeferredTarget(subTarget);
+    ASSERT_NE(logTarget, nullptr);
+    ASSERT_NE(elog::addLogTarget(logTarget), ELOG_INVALID_TARGET_ID);
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getSharedLogger("elog.test.core.thread_delta");
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(std::thread([logger, i, msgCount]() {
+            for (uint32_t j = 0; j < msgCount; ++j) {
+                ELOG_INFO_EX(logger, "Delta message %u %u", i, j);
+                std::this_thread::sleep_for(std::chrono::microseconds(100 * (i + 1)));
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    logTarget->flush();
+
+    // group records by logging thread, and verify each delta against the thread's previous record
+    std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, uint64_t>>> threadRecords;
+    for (const std::string& logMsg : subTarget->getLogMessages()) {
+        uint64_t threadId = 0;
+        uint64_t relTime = 0;
+        uint64_t threadDelta = 0;
+        std::string msg;
+        std::stringstream s(logMsg);
+        s >> threadId >> relTime >> threadDelta >> msg;
+        if (msg.compare("Delta") == 0) {
+            threadRecords[threadId].push_back({relTime, threadDelta});
+        }
+    }
+    EXPECT_EQ(threadRecords.size(), threadCount);
+    for (const auto& entry : threadRecords) {
+        const auto& records = entry.second;
+        ASSERT_EQ(records.size(), msgCount);
+        // first record of a new thread has no predecessor
+        EXPECT_EQ(records[0].second, 0);
+        for (uint32_t i = 1; i < records.size(); ++i) {
+            EXPECT_GT(records[i].second, 0);
+            EXPECT_EQ(records[i].second, records[i].first - records[i - 1].first);
+        }
+    }
+    elog::removeLogTarget(logTarget);
+}
+
+TEST(ELogCore, RenderCache) {
+    // the render cache reuses time strings of the same time specification, even if the time
+    // specification objects are distinct
+    elog::ELogRecord logRecord = {};
+    elog::elogGetCurrentTime(logRecord.m_logTime);
+    logRecord.m_logMsg = "Test message";
+    EXPECT_EQ(elog::getRenderCache(logRecord), nullptr);
+    {
+        elog::ELogRenderCache renderCache(logRecord);
+        elog::ELogScopedRenderCache scopedRenderCache(&renderCache);
+        EXPECT_EQ(elog::getRenderCache(logRecord), &renderCache);
+        elog::ELogRecord otherRecord = logRecord;
+        EXPECT_EQ(elog::getRenderCache(otherRecord), nullptr);
+
+        size_t len1 = 0;
+        size_t len2 = 0;
+        const char* timeStr1 = renderCache.getTimeString(nullptr, len1);
+        const char* timeStr2 = renderCache.getTimeString(nullptr, len2);
+        EXPECT_EQ(timeStr1, timeStr2);
+        EXPECT_EQ(len1, len2);
+
+        elog::ELogTimeSpec timeSpec1;
+        timeSpec1.m_timeUnits = elog::ELogTimeUnits::TU_MICRO_SECONDS;
+        elog::ELogTimeSpec timeSpec2 = timeSpec1;
+        const char* timeStr3 = renderCache.getTimeString(&timeSpec1, len1);
+        const char* timeStr4 = renderCache.getTimeString(&timeSpec2, len2);
+        EXPECT_NE(timeStr1, timeStr3);
+        EXPECT_EQ(timeStr3, timeStr4);
+        EXPECT_EQ(len1, len2);
+
+        // cached result should be the same as uncached
+        elog::ELogTimeBuffer timeBuffer;
+        size_t len = elog::elogTimeToString(logRecord.m_logTime, timeBuffer);
+        EXPECT_EQ(std::string(timeStr1), std::string(timeBuffer.m_buffer, len));
+    }
+    EXPECT_EQ(elog::getRenderCache(logRecord), nullptr);
+
+    // all targets receiving the same record, in either compiled or interpreted mode, should see
+    // the same time string
+    TestLogTarget* logTarget1 = new (std::nothrow) TestLogTarget();
+    TestLogTarget* logTarget2 = new (std::nothrow) TestLogTarget();
+    TestLogTarget* logTarget3 = new (std::nothrow) TestLogTarget();
+    elog::addLogTarget(logTarget1);
+    elog::addLogTarget(logTarget2);
+    elog::addLogTarget(logTarget3);
+    EXPECT_EQ(logTarget1->setLogFormat("${time} ${msg}"), true);
+    EXPECT_EQ(logTarget2->setLogFormat("[${time}] ${level}: ${msg}"), true);
+    EXPECT_EQ(logTarget3->setLogFormat("${msg} @ ${time}"), true);
+    logTarget3->getLogFormatter()->setCompiledMode(false);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getPrivateLogger("elog.test.core.render_cache");
+    logTarget1->clearLogMessages();
+    logTarget2->clearLogMessages();
+    logTarget3->clearLogMessages();
+    ELOG_INFO_EX(logger, "Test message");
+    ASSERT_EQ(logTarget1->getLogMessages().size(), 1);
+    ASSERT_EQ(logTarget2->getLogMessages().size(), 1);
+    ASSERT_EQ(logTarget3->getLogMessages().size(), 1);
+    const std::string& msg1 = logTarget1->getLogMessages()[0];
+    const std::string& msg2 = logTarget2->getLogMessages()[0];
+    const std::string& msg3 = logTarget3->getLogMessages()[0];
+    std::string timeStr = msg1.substr(0, msg1.size() - strlen(" Test message"));
+    EXPECT_EQ(msg2, "[" + timeStr + "] INFO: Test message");
+    EXPECT_EQ(msg3, "Test message @ " + timeStr);
+
+    elog::removeLogTarget(logTarget1);
+    elog::removeLogTarget(logTarget2);
+    elog::removeLogTarget(logTarget3);
+}
+
+TEST(ELogCore, MsgBlob) {
+    // message blobs keep binary messages intact, and are null terminated
+    const char binaryMsg[] = {'a', 0, 'b', 0, 'c'};
+    elog::ELogMsgRef binaryRef(elog::ELogMsgBlob::create(binaryMsg, sizeof(binaryMsg)));
+    ASSERT_NE(binaryRef.getMsgBlob(), nullptr);
+    EXPECT_EQ(binaryRef.getLength(), sizeof(binaryMsg));
+    EXPECT_EQ(memcmp(binaryRef.getData(), binaryMsg, sizeof(binaryMsg)), 0);
+    EXPECT_EQ(binaryRef.getData()[sizeof(binaryMsg)], 0);
+
+    // references share the same blob, which stays valid as long as there is a reference to it
+    elog::ELogMsgRef copyRef = binaryRef;
+    EXPECT_EQ(copyRef.getMsgBlob(), binaryRef.getMsgBlob());
+    binaryRef = elog::ELogMsgRef();
+    EXPECT_EQ(binaryRef.getMsgBlob(), nullptr);
+    EXPECT_STREQ(binaryRef.getData(), "");
+    EXPECT_EQ(copyRef.getData()[2], 'b');
+
+    // released blobs are reused by the pool
+    elog::ELogMsgBlob* msgBlob = copyRef.getMsgBlob();
+    copyRef = elog::ELogMsgRef();
+    elog::ELogMsgRef reusedRef(elog::ELogMsgBlob::create("reused", 6));
+    EXPECT_EQ(reusedRef.getMsgBlob(), msgBlob);
+    EXPECT_STREQ(reusedRef.getData(), "reused");
+
+    // messages too large for the pool are still supported
+    std::string largeMsg(64 * 1024, 'x');
+    elog::ELogMsgRef largeRef(elog::ELogMsgBlob::create(largeMsg.c_str(), largeMsg.length()));
+    ASSERT_NE(largeRef.getMsgBlob(), nullptr);
+    EXPECT_EQ(std::string(largeRef.getData()), largeMsg);
+
+    // all queues of a record being dispatched share the same message copy
+    elog::ELogRecord logRecord = {};
+    logRecord.m_logMsg = "Shared message";
+    {
+        elog::ELogRenderCache renderCache(logRecord);
+        elog::ELogScopedRenderCache scopedRenderCache(&renderCache);
+        elog::ELogMsgRef msgRef1 = elog::acquireLogRecordMsg(logRecord);
+        elog::ELogMsgRef msgRef2 = elog::acquireLogRecordMsg(logRecord);
+        ASSERT_NE(msgRef1.getMsgBlob(), nullptr);
+        EXPECT_EQ(msgRef1.getMsgBlob(), msgRef2.getMsgBlob());
+        EXPECT_STREQ(msgRef1.getData(), "Shared message");
+    }
+    elog::ELogMsgRef msgRef1 = elog::acquireLogRecordMsg(logRecord);
+    elog::ELogMsgRef msgRef2 = elog::acquireLogRecordMsg(logRecord);
+    EXPECT_NE(msgRef1.getMsgBlob(), msgRef2.getMsgBlob());
+    EXPECT_STREQ(msgRef2.getData(), "Shared message");
+}
+
+static size_t getDeferredTestMsgs(TestLogTarget* logTarget, std::vector<std::string>& logMsgs) {
+    std::unique_lock<std::mutex> lock(logTarget->getLock());
+    logMsgs.clear();
+    for (const std::string& logMsg : logTarget->getLogMessages()) {
+        if (logMsg.find("Deferred message") == 0) {
+            logMsgs.push_back(logMsg);
+        }
+    }
+    return logMsgs.size();
+}
+
+TEST(ELogCore, DeferredSharedMsg) {
+    // two deferred log targets receiving the same records share the queued message copies, and
+    // each delivers the exact messages to its sub-target
+    const uint32_t msgCount = 1000;
+    TestLogTarget* subTarget1 = new (std::nothrow) TestLogTarget();
+    TestLogTarget* subTarget2 = new (std::nothrow) TestLogTarget();
+    EXPECT_EQ(subTarget1->setLogFormat("${msg}"), true);
+    EXPECT_EQ(subTarget2->setLogFormat("${msg}"), true);
+    elog::ELogDeferredTarget* logTarget1 = new (std::nothrow) elog::ELogDeferredTarget(subTarget1);
+    elog::ELogDeferredTarget* logTarget2 = new (std::nothrow) elog::ELogDeferredTarget(subTarget2);
+    elog::ELogTargetId logTargetId1 = elog::addLogTarget(logTarget1);
+    elog::ELogTargetId logTargetId2 = elog::addLogTarget(logTarget2);
+    ASSERT_NE(logTargetId1, ELOG_INVALID_TARGET_ID);
+    ASSERT_NE(logTargetId2, ELOG_INVALID_TARGET_ID);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getPrivateLogger("elog.test.core.deferred");
+    for (uint32_t i = 0; i < msgCount; ++i) {
+        ELOG_INFO_EX(logger, "Deferred message %u with some payload to avoid short strings", i);
+    }
+
+    std::vector<std::string> logMsgs1;
+    std::vector<std::string> logMsgs2;
+    for (uint32_t i = 0; i < 500; ++i) {
+        if (getDeferredTestMsgs(subTarget1, logMsgs1) == msgCount &&
+            getDeferredTestMsgs(subTarget2, logMsgs2) == msgCount) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(logMsgs1.size(), msgCount);
+    ASSERT_EQ(logMsgs2.size(), msgCount);
+    for (uint32_t i = 0; i < msgCount; ++i) {
+        std::string expected = "Deferred message " + std::to_string(i) +
+                               " with some payload to avoid short strings";
+        EXPECT_EQ(logMsgs1[i], expected);
+        EXPECT_EQ(logMsgs2[i], expected);
+    }
+
+    elog::removeLogTarget(logTargetId1);
+    elog::removeLogTarget(logTargetId2);
+}
+
+TEST(ELogCore, DeferredMultiProducer) {
+    // records pushed concurrently by several threads to deferred and queued log targets are all
+    // delivered, and records of each thread retain their order
+    const uint32_t threadCount = 8;
+    const uint32_t msgCount = 2000;
+    TestLogTarget* subTarget1 = new (std::nothrow) TestLogTarget();
+    TestLogTarget* subTarget2 = new (std::nothrow) TestLogTarget();
+    EXPECT_EQ(subTarget1->setLogFormat("${msg}"), true);
+    EXPECT_EQ(subTarget2->setLogFormat("${msg}"), true);
+    elog::ELogDeferredTarget* logTarget1 = new (std::nothrow) elog::ELogDeferredTarget(subTarget1);
+    elog::ELogQueuedTarget* logTarget2 =
+        new (std::nothrow) elog::ELogQueuedTarget(subTarget2, 64, 10);
+    elog::ELogTargetId logTargetId1 = elog::addLogTarget(logTarget1);
+    elog::ELogTargetId logTargetId2 = elog::addLogTarget(logTarget2);
+    ASSERT_NE(logTargetId1, ELOG_INVALID_TARGET_ID);
+    ASSERT_NE(logTargetId2, ELOG_INVALID_TARGET_ID);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getSharedLogger("elog.test.core.deferred.mp");
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(std::thread([logger, i, msgCount]() {
+            for (uint32_t j = 0; j < msgCount; ++j) {
+                ELOG_INFO_EX(logger, "Deferred message %u %u", i, j);
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<std::string> logMsgs1;
+    std::vector<std::string> logMsgs2;
+    for (uint32_t i = 0; i < 500; ++i) {
+        if (getDeferredTestMsgs(subTarget1, logMsgs1) == threadCount * msgCount &&
+            getDeferredTestMsgs(subTarget2, logMsgs2) == threadCount * msgCount) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(logMsgs1.size(), threadCount * msgCount);
+    ASSERT_EQ(logMsgs2.size(), threadCount * msgCount);
+    for (const std::vector<std::string>* logMsgs : {&logMsgs1, &logMsgs2}) {
+        std::vector<uint32_t> nextMsgId(threadCount, 0);
+        for (const std::string& logMsg : *logMsgs) {
+            unsigned threadId = 0;
+            unsigned msgId = 0;
+            ASSERT_EQ(sscanf(logMsg.c_str(), "Deferred message %u %u", &threadId, &msgId), 2);
+            ASSERT_LT(threadId, threadCount);
+            EXPECT_EQ(msgId, nextMsgId[threadId]);
+            nextMsgId[threadId] = msgId + 1;
+        }
+    }
+
+    elog::removeLogTarget(logTargetId1);
+    elog::removeLogTarget(logTargetId2);
+}
+
+static uint64_t getQuantumNodeMsgCount(elog::ELogQuantumTarget* logTarget) {
+    uint64_t msgCount = 0;
+    for (uint32_t i = 0; i < logTarget->getNodeCount(); ++i) {
+        msgCount += logTarget->getNodeMsgCount(i);
+    }
+    return msgCount;
+}
+
+static void getQuantumTestMsgs(TestLogTarget* logTarget, size_t& quantumMsgCount,
+                               size_t& deliveredMsgCount) {
+    std::unique_lock<std::mutex> lock(logTarget->getLock());
+    quantumMsgCount = 0;
+    for (const std::string& logMsg : logTarget->getLogMessages()) {
+        if (logMsg.find("Quantum message") == 0) {
+            ++quantumMsgCount;
+        }
+    }
+    deliveredMsgCount = logTarget->getLogMessages().size();
+}
+
+TEST(ELogCore, NumaQuantum) {
+    // all records pushed by several threads to a NUMA-aware quantum log target are delivered, and
+    // are accounted for by the per-node statistics (regardless of the actual number of nodes)
+    const uint32_t threadCount = 4;
+    const uint32_t msgCount = 2000;
+    TestLogTarget* subTarget = new (std::nothrow) TestLogTarget();
+    EXPECT_EQ(subTarget->setLogFormat("${msg}"), true);
+    elog::ELogQuantumTarget* logTarget =
+        new (std::nothrow) elog::ELogQuantumTarget(subTarget, 1024);
+    logTarget->setNumaAware(true);
+    elog::ELogTargetId logTargetId = elog::addLogTarget(logTarget);
+    ASSERT_NE(logTargetId, ELOG_INVALID_TARGET_ID);
+    EXPECT_GE(logTarget->getNodeCount(), 1u);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getSharedLogger("elog.test.core.quantum.numa");
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(std::thread([logger, i, msgCount]() {
+            for (uint32_t j = 0; j < msgCount; ++j) {
+                ELOG_INFO_EX(logger, "Quantum message %u %u", i, j);
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // flush is posted to the log threads of all nodes, and is executed after all records
+    uint64_t flushCount = subTarget->getFlushCount();
+    logTarget->flush();
+    size_t quantumMsgCount = 0;
+    size_t deliveredMsgCount = 0;
+    for (uint32_t i = 0; i < 500; ++i) {
+        if (subTarget->getFlushCount() >= flushCount + logTarget->getNodeCount()) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GE(subTarget->getFlushCount(), flushCount + logTarget->getNodeCount());
+    getQuantumTestMsgs(subTarget, quantumMsgCount, deliveredMsgCount);
+    EXPECT_EQ(quantumMsgCount, threadCount * msgCount);
+
+    // NOTE: records accumulated before elog was initialized are replayed into each new log target,
+    // so the per-node statistics are compared against all records delivered to the sub-target
+    for (uint32_t i = 0; i < 500; ++i) {
+        getQuantumTestMsgs(subTarget, quantumMsgCount, deliveredMsgCount);
+        if (getQuantumNodeMsgCount(logTarget) == deliveredMsgCount) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(getQuantumNodeMsgCount(logTarget), deliveredMsgCount);
+
+    elog::removeLogTarget(logTargetId);
+}
+
+TEST(ELogCore, NumaQuantumMultiRing) {
+    // with several ring buffers (forced, regardless of the actual number of nodes), each thread is
+    // bound to a single ring buffer, so its records are delivered exactly once and in order
+    const uint32_t nodeCount = 4;
+    const uint32_t threadCount = 8;
+    const uint32_t msgCount = 2000;
+    TestLogTarget* subTarget = new (std::nothrow) TestLogTarget();
+    ASSERT_NE(subTarget, nullptr);
+    EXPECT_EQ(subTarget->setLogFormat("${msg}"), true);
+    elog::ELogQuantumTarget* logTarget =
+        new (std::nothrow) elog::ELogQuantumTarget(subTarget, 1024);
+    ASSERT_NE(logTarget, nullptr);
+    logTarget->setNumaAware(true);
+    logTarget->setNodeCount(nodeCount);
+    elog::ELogTargetId logTargetId = elog::addLogTarget(logTarget);
+    ASSERT_NE(logTargetId, ELOG_INVALID_TARGET_ID);
+    EXPECT_EQ(logTarget->getNodeCount(), nodeCount);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getSharedLogger("elog.test.core.quantum.rings");
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(std::thread([logger, i, msgCount]() {
+            for (uint32_t j = 0; j < msgCount; ++j) {
+                ELOG_INFO_EX(logger, "Quantum message %u %u", i, j);
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    size_t quantumMsgCount = 0;
+    size_t deliveredMsgCount = 0;
+    for (uint32_t i = 0; i < 500; ++i) {
+        getQuantumTestMsgs(subTarget, quantumMsgCount, deliveredMsgCount);
+        if (quantumMsgCount == threadCount * msgCount) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(quantumMsgCount, threadCount * msgCount);
+
+    // threads are spread among all ring buffers
+    for (uint32_t i = 0; i < nodeCount; ++i) {
+        EXPECT_GT(logTarget->getNodeMsgCount(i), 0u);
+    }
+
+    // each thread's records are delivered in the order in which they were logged
+    std::vector<uint32_t> nextMsgId(threadCount, 0);
+    uint32_t outOfOrderCount = 0;
+    {
+        std::unique_lock<std::mutex> lock(subTarget->getLock());
+        for (const std::string& logMsg : subTarget->getLogMessages()) {
+            unsigned threadId = 0;
+            unsigned msgId = 0;
+            if (sscanf(logMsg.c_str(), "Quantum message %u %u", &threadId, &msgId) != 2) {
+                continue;
+            }
+            ASSERT_LT(threadId, threadCount);
+            if (msgId != nextMsgId[threadId]) {
+                ++outOfOrderCount;
+            }
+            nextMsgId[threadId] = msgId + 1;
+        }
+    }
+    EXPECT_EQ(outOfOrderCount, 0u);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        EXPECT_EQ(nextMsgId[i], msgCount);
+    }
+
+    elog::removeLogTarget(logTargetId);
+}
+
+TEST(ELogCore, FlatCombining) {
+    // records logged concurrently by several threads to a log target that requires a lock are all
+    // written exactly once in flat-combining mode
+    const uint32_t threadCount = 8;
+    const uint32_t msgCount = 2000;
+    TestLogTarget* logTarget = new (std::nothrow) TestLogTarget();
+    ASSERT_NE(logTarget, nullptr);
+    EXPECT_EQ(logTarget->setLogFormat("${msg}"), true);
+    logTarget->setFlatCombining(true);
+    EXPECT_EQ(logTarget->isFlatCombining(), true);
+    elog::ELogTargetId logTargetId = elog::addLogTarget(logTarget);
+    ASSERT_NE(logTargetId, ELOG_INVALID_TARGET_ID);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getSharedLogger("elog.test.core.combining");
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(std::thread([logger, i, msgCount]() {
+            for (uint32_t j = 0; j < msgCount; ++j) {
+                ELOG_INFO_EX(logger, "Combined message %u %u", i, j);
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // records pushed to the backlog (due to bounded waiting) are drained by the next lock holder
+    ELOG_INFO_EX(logger, "Final message");
+
+    // each thread's records are written exactly once, and in the order in which they were logged
+    std::vector<uint32_t> nextMsgId(threadCount, 0);
+    uint32_t outOfOrderCount = 0;
+    for (const std::string& logMsg : logTarget->getLogMessages()) {
+        unsigned threadId = 0;
+        unsigned msgId = 0;
+        if (sscanf(logMsg.c_str(), "Combined message %u %u", &threadId, &msgId) != 2) {
+            continue;
+        }
+        ASSERT_LT(threadId, threadCount);
+        ASSERT_LT(msgId, msgCount);
+        if (msgId != nextMsgId[threadId]) {
+            ++outOfOrderCount;
+        }
+        nextMsgId[threadId] = msgId + 1;
+    }
+    EXPECT_EQ(outOfOrderCount, 0u);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        EXPECT_EQ(nextMsgId[i], msgCount);
+    }
+    elog::removeLogTarget(logTargetId);
+}
+
+// log target that holds its lock while writing the leader log record, until the follower thread
+// starts logging, so that the follower log record is published and written by the leader thread
+class CombineTestLogTarget : public elog::ELogTarget {
+public:
+    CombineTestLogTarget()
+        : ELogTarget("combine_test"), m_leaderWriting(false), m_followerLogging(false) {}
+    CombineTestLogTarget(const CombineTestLogTarget&) = delete;
+    CombineTestLogTarget(CombineTestLogTarget&&) = delete;
+    CombineTestLogTarget& operator=(const CombineTestLogTarget&) = delete;
+
+    ELOG_DECLARE_LOG_TARGET(CombineTestLogTarget)
+
+    inline bool isLeaderWriting() const { return m_leaderWriting.load(); }
+    inline void setFollowerLogging() { m_followerLogging.store(true); }
+
+protected:
+    bool startLogTarget() override { return true; }
+    bool stopLogTarget() override { return true; }
+
+    bool writeLogRecord(const elog::ELogRecord& logRecord, uint64_t& bytesWritten) override {
+        bytesWritten = logRecord.m_logMsgLen;
+        if (strcmp(logRecord.m_logMsg, "Combine leader") == 0) {
+            m_leaderWriting.store(true);
+            while (!m_followerLogging.load()) {
+                std::this_thread::yield();
+            }
+            // give the follower a chance to publish its log record (but not long enough for it to
+            // give up waiting and push its log record to the backlog)
+            for (uint32_t i = 0; i < 8; ++i) {
+                std::this_thread::yield();
+            }
+        }
+        return true;
+    }
+
+    bool flushLogTarget() override { return true; }
+
+private:
+    std::atomic<bool> m_leaderWriting;
+    std::atomic<bool> m_followerLogging;
+};
+
+ELOG_IMPLEMENT_LOG_TARGET(CombineTestLogTarget)
+
+TEST(ELogCore, FlatCombiningStats) {
+    // a log record written by the combining thread on behalf of another thread is charged to the
+    // statistics slot of the thread that logged it
+    CombineTestLogTarget* logTarget = new (std::nothrow) CombineTestLogTarget();
+    ASSERT_NE(logTarget, nullptr);
+    logTarget->setFlatCombining(true);
+    elog::ELogTargetId logTargetId = elog::addLogTarget(logTarget);
+    ASSERT_NE(logTargetId, ELOG_INVALID_TARGET_ID);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getSharedLogger("elog.test.core.combining");
+    elog::ELogStats* stats = logTarget->getStats();
+    uint64_t leaderMsgSubmitted = 0;
+    uint64_t followerMsgSubmitted = 0;
+
+    // statistics slots are reused by threads, so only the difference is counted
+    std::thread leader([logger, stats, &leaderMsgSubmitted]() {
+        uint64_t slotId = elog::ELogStats::getSlotId();
+        uint64_t initialMsgSubmitted = stats->getMsgSubmitted(slotId);
+        ELOG_INFO_EX(logger, "Combine leader");
+        leaderMsgSubmitted = stats->getMsgSubmitted(slotId) - initialMsgSubmitted;
+    });
+    while (!logTarget->isLeaderWriting()) {
+        std::this_thread::yield();
+    }
+    std::thread follower([logger, logTarget, stats, &followerMsgSubmitted]() {
+        uint64_t slotId = elog::ELogStats::getSlotId();
+        uint64_t initialMsgSubmitted = stats->getMsgSubmitted(slotId);
+        logTarget->setFollowerLogging();
+        ELOG_INFO_EX(logger, "Combine follower");
+        followerMsgSubmitted = stats->getMsgSubmitted(slotId) - initialMsgSubmitted;
+    });
+    leader.join();
+    follower.join();
+
+    // NOTE: with several CPUs the follower may publish its log record only after the leader
+    // released the lock, in which case it writes its own log record, so combining is not verified
+    EXPECT_EQ(leaderMsgSubmitted, 1u);
+    EXPECT_EQ(followerMsgSubmitted, 1u);
+    elog::removeLogTarget(logTargetId);
+}
+
+#define TEST_GC_MAGIC 0x12345678u
+
+static std::atomic<uint32_t> sTestGCObjectCount(0);
+
+class TestGCObject : public elog::ELogManagedObject {
+public:
+    TestGCObject() : m_magic(TEST_GC_MAGIC) { sTestGCObjectCount.fetch_add(1); }
+    ~TestGCObject() final {
+        m_magic = 0;
+        sTestGCObjectCount.fetch_sub(1);
+    }
+
+    volatile uint32_t m_magic;
+};
+
+TEST(ELogCore, GCThreadEpoch) {
+    elog::ELogGC gc;
+    ASSERT_EQ(gc.initialize("test_gc", 64, 1, 0, 0, 0, elog::ELogGCMode::GM_THREAD_EPOCH), true);
+    std::atomic<uint64_t> epoch(0);
+
+    // an object retired while a (nested) critical section is active, is recycled only after the
+    // outermost critical section ends
+    uint64_t outerEpoch = gc.enterEpoch(epoch);
+    uint64_t innerEpoch = gc.enterEpoch(epoch);
+    EXPECT_EQ(innerEpoch, outerEpoch);
+    gc.retire(new TestGCObject(), 0);
+    gc.leaveEpoch(innerEpoch);
+    gc.recycleRetiredObjects();
+    EXPECT_EQ(sTestGCObjectCount.load(), 1u);
+    gc.leaveEpoch(outerEpoch);
+    EXPECT_EQ(sTestGCObjectCount.load(), 0u);
+
+    // concurrent readers never observe a recycled object while objects are being replaced
+    const uint32_t readerCount = 8;
+    const uint32_t replaceCount = 2000;
+    std::atomic<TestGCObject*> current(new TestGCObject());
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> errorCount(0);
+    std::vector<std::thread> readers;
+    for (uint32_t i = 0; i < readerCount; ++i) {
+        readers.emplace_back(std::thread([&gc, &epoch, &current, &done, &errorCount]() {
+            while (!done.load(std::memory_order_relaxed)) {
+                elog::ELogScopedEpoch scopedEpoch(gc, epoch);
+                TestGCObject* object = current.load(std::memory_order_acquire);
+                if (object->m_magic != TEST_GC_MAGIC) {
+                    errorCount.fetch_add(1);
+                }
+            }
+        }));
+    }
+    for (uint32_t i = 0; i < replaceCount; ++i) {
+        elog::ELogScopedEpoch scopedEpoch(gc, epoch);
+        TestGCObject* prev = current.exchange(new TestGCObject(), std::memory_order_acq_rel);
+        gc.retire(prev, ELOG_CURRENT_EPOCH);
+    }
+    done.store(true);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(errorCount.load(), 0u);
+
+    // no reader is active, so everything retired can be recycled
+    gc.recycleRetiredObjects();
+    EXPECT_EQ(sTestGCObjectCount.load(), 1u);
+    delete current.load();
+    EXPECT_EQ(gc.destroy(), true);
+}
+
+TEST(ELogCore, GCReuseId) {
+    // the reader slot cached by a thread for a destroyed GC must not be used by a new GC that is
+    // given the same id, otherwise two threads may share a reader slot
+    std::atomic<uint64_t> epoch(0);
+    elog::ELogGC oldGC;
+    ASSERT_EQ(oldGC.initialize("test_gc_old", 64, 1, 0, 0, 0, elog::ELogGCMode::GM_THREAD_EPOCH),
+              true);
+    oldGC.leaveEpoch(oldGC.enterEpoch(epoch));
+    EXPECT_EQ(oldGC.destroy(), true);
+
+    elog::ELogGC gc;
+    ASSERT_EQ(gc.initialize("test_gc", 64, 1, 0, 0, 0, elog::ELogGCMode::GM_THREAD_EPOCH), true);
+    std::atomic<uint32_t> readerState(0);
+    std::thread reader;
+    {
+        // the reader enters while this thread is still inside, so that a stale reader slot cached
+        // by this thread would be handed out to the reader as well
+        elog::ELogScopedEpoch scopedEpoch(gc, epoch);
+        reader = std::thread([&gc, &epoch, &readerState]() {
+            uint64_t readerEpoch = gc.enterEpoch(epoch);
+            readerState.store(1);
+            while (readerState.load() != 2) {
+                std::this_thread::yield();
+            }
+            gc.leaveEpoch(readerEpoch);
+        });
+        while (readerState.load() != 1) {
+            std::this_thread::yield();
+        }
+    }
+
+    // the reader is still inside, so a newly retired object cannot be recycled yet
+    {
+        elog::ELogScopedEpoch scopedEpoch(gc, epoch);
+        gc.retire(new TestGCObject(), ELOG_CURRENT_EPOCH);
+    }
+    gc.recycleRetiredObjects();
+    EXPECT_EQ(sTestGCObjectCount.load(), 1u);
+    readerState.store(2);
+    reader.join();
+    gc.recycleRetiredObjects();
+    EXPECT_EQ(sTestGCObjectCount.load(), 0u);
+    EXPECT_EQ(gc.destroy(), true);
+}
+
+TEST(ELogCore, StatsThreadBlocks) {
+    // base and derived statistics variables share per-thread counter blocks, and are aggregated
+    // correctly across threads
+    const uint32_t threadCount = 4;
+    const uint32_t incCount = 10000;
+    elog::ELogBufferedStats stats;
+    ASSERT_EQ(stats.initialize(ELOG_DEFAULT_MAX_THREADS), true);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(std::thread([&stats]() {
+            for (uint32_t j = 0; j < incCount; ++j) {
+                stats.incrementMsgWritten();
+                stats.addBytesWritten(3);
+                stats.incrementBufferWriteCount();
+                stats.addBufferBytesCount(5);
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(stats.getMsgWritten(), threadCount * incCount);
+    EXPECT_EQ(stats.getBytesWritten(), threadCount * incCount * 3);
+    EXPECT_EQ(stats.getBufferWriteCount().getSum(), threadCount * incCount);
+    EXPECT_EQ(stats.getBufferByteCount().getSum(), threadCount * incCount * 5);
+    EXPECT_EQ(stats.getMsgFailWrite(), 0u);
+    stats.terminate();
+}
+
+// log target that buffers log records, and sends them as a batch during flush
+class BatchTestLogTarget : public elog::ELogTarget {
+public:
+    BatchTestLogTarget()
+        : ELogTarget("batch_test"), m_failSend(false), m_batchCount(0), m_batchBytes(0) {
+        setDeferredWriteStats();
+    }
+    BatchTestLogTarget(const BatchTestLogTarget&) = delete;
+    BatchTestLogTarget(BatchTestLogTarget&&) = delete;
+    BatchTestLogTarget& operator=(const BatchTestLogTarget&) = delete;
+
+    ELOG_DECLARE_LOG_TARGET(BatchTestLogTarget)
+
+    inline void setFailSend(bool failSend) { m_failSend = failSend; }
+
+protected:
+    bool startLogTarget() override { return true; }
+    bool stopLogTarget() override { return true; }
+
+    bool writeLogRecord(const elog::ELogRecord& logRecord, uint64_t& bytesWritten) override {
+        bytesWritten = logRecord.m_logMsgLen;
+        ++m_batchCount;
+        m_batchBytes += bytesWritten;
+        return true;
+    }
+
+    bool flushLogTarget() override {
+        reportBatchWrite(!m_failSend, m_batchCount, m_batchBytes);
+        m_batchCount = 0;
+        m_batchBytes = 0;
+        return !m_failSend;
+    }
+
+private:
+    bool m_failSend;
+    uint64_t m_batchCount;
+    uint64_t m_batchBytes;
+};
+
+ELOG_IMPLEMENT_LOG_TARGET(BatchTestLogTarget)
+
+TEST(ELogCore, BatchWriteStats) {
+    // log records buffered by a batching log target are counted as written only after their batch
+    // is sent, and as discarded if sending the batch fails
+    BatchTestLogTarget* logTarget = new (std::nothrow) BatchTestLogTarget();
+    ASSERT_NE(logTarget, nullptr);
+    elog::ELogTargetId logTargetId = elog::addLogTarget(logTarget);
+    ASSERT_NE(logTargetId, ELOG_INVALID_TARGET_ID);
+    elog::ELogStats* stats = logTarget->getStats();
+    ASSERT_NE(stats, nullptr);
+
+    // send records replayed from before initialization
+    logTarget->flush();
+    uint64_t msgWritten = stats->getMsgWritten();
+    uint64_t msgDiscarded = stats->getMsgDiscarded();
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getPrivateLogger("elog.test.core.batch");
+    for (uint32_t i = 0; i < 10; ++i) {
+        ELOG_INFO_EX(logger, "Batch message %u", i);
+    }
+    EXPECT_EQ(stats->getMsgWritten(), msgWritten);
+    logTarget->flush();
+    EXPECT_EQ(stats->getMsgWritten(), msgWritten + 10);
+    EXPECT_EQ(stats->getMsgDiscarded(), msgDiscarded);
+
+    logTarget->setFailSend(true);
+    for (uint32_t i = 0; i < 5; ++i) {
+        ELOG_INFO_EX(logger, "Batch message %u", i);
+    }
+    logTarget->flush();
+    EXPECT_EQ(stats->getMsgWritten(), msgWritten + 10);
+    EXPECT_EQ(stats->getMsgDiscarded(), msgDiscarded + 5);
+    logTarget->setFailSend(false);
+
+    elog::removeLogTarget(logTargetId);
+}
+
+TEST(ELogCore, LatencyHistogram) {
+    // bucket boundaries: exact below sub-bucket count, then 8 linear sub-buckets per power of two
+    EXPECT_EQ(elog::ELogHistogram::getBucketIndex(0), 0u);
+    EXPECT_EQ(elog::ELogHistogram::getBucketIndex(7), 7u);
+    EXPECT_EQ(elog::ELogHistogram::getBucketIndex(8), 8u);
+    EXPECT_EQ(elog::ELogHistogram::getBucketIndex(15), 15u);
+    EXPECT_EQ(elog::ELogHistogram::getBucketIndex(16), 16u);
+    EXPECT_EQ(elog::ELogHistogram::getBucketIndex(17), 16u);
+    EXPECT_EQ(elog::ELogHistogram::getBucketIndex(UINT64_MAX), ELOG_HISTOGRAM_BUCKET_COUNT - 1);
+    for (uint64_t value = 1; value < (1ull << 30); value = value * 3 + 1) {
+        uint32_t bucketIndex = elog::ELogHistogram::getBucketIndex(value);
+        EXPECT_GE(elog::ELogHistogram::getBucketUpperBound(bucketIndex), value);
+        EXPECT_LT(elog::ELogHistogram::getBucketUpperBound(bucketIndex - 1), value);
+        // relative error is bounded by the sub-bucket resolution
+        EXPECT_LE(elog::ELogHistogram::getBucketUpperBound(bucketIndex) - value, value / 8);
+    }
+
+    // per-thread histograms are merged into a single snapshot
+    const uint32_t threadCount = 4;
+    const uint32_t valueCount = 1000;
+    elog::ELogHistogram histogram;
+    ASSERT_EQ(histogram.initialize(ELOG_DEFAULT_MAX_THREADS), true);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(std::thread([&histogram]() {
+            uint64_t slotId = elog::ELogStats::getSlotId();
+            for (uint32_t j = 1; j <= valueCount; ++j) {
+                histogram.record(slotId, j);
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    elog::ELogHistogramSnapshot snapshot;
+    histogram.getSnapshot(snapshot);
+    EXPECT_EQ(snapshot.m_count, threadCount * valueCount);
+    EXPECT_EQ(snapshot.m_sum, threadCount * (uint64_t)valueCount * (valueCount + 1) / 2);
+    EXPECT_EQ(snapshot.m_min, 1u);
+    EXPECT_EQ(snapshot.m_max, valueCount);
+    EXPECT_EQ(snapshot.getMean(), (valueCount + 1) / 2);
+    uint64_t p50 = snapshot.getPercentile(50.0);
+    EXPECT_GE(p50, 500u);
+    EXPECT_LE(p50, 500u + 500u / 8);
+    uint64_t p99 = snapshot.getPercentile(99.0);
+    EXPECT_GE(p99, 990u);
+    EXPECT_LE(p99, valueCount);
+    EXPECT_EQ(snapshot.getPercentile(100.0), valueCount);
+    histogram.terminate();
+
+    // log targets record write latency and queue residence (when latency sampling is enabled),
+    // and asynchronous log targets record batch sizes
+    EXPECT_EQ(elog::getStatsLatencySampleRate(), 0u);
+    elog::setStatsLatencySampleRate(1);
+    const uint32_t msgCount = 100;
+    TestLogTarget* subTarget = new (std::nothrow) TestLogTarget();
+    EXPECT_EQ(subTarget->setLogFormat("${msg}"), true);
+    elog::ELogDeferredTarget* logTarget = new (std::nothrow) elog::ELogDeferredTarget(subTarget);
+    elog::ELogTargetId logTargetId = elog::addLogTarget(logTarget);
+    ASSERT_NE(logTargetId, ELOG_INVALID_TARGET_ID);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getPrivateLogger("elog.test.core.histogram");
+    for (uint32_t i = 0; i < msgCount; ++i) {
+        ELOG_INFO_EX(logger, "Deferred message %u for latency histogram", i);
+    }
+    std::vector<std::string> logMsgs;
+    for (uint32_t i = 0; i < 500; ++i) {
+        if (getDeferredTestMsgs(subTarget, logMsgs) == msgCount) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(logMsgs.size(), msgCount);
+
+    elog::ELogHistogramSnapshot writeLatency;
+    elog::ELogHistogramSnapshot queueResidence;
+    elog::ELogHistogramSnapshot batchSize;
+    subTarget->getStats()->getWriteLatency(writeLatency);
+    subTarget->getStats()->getQueueResidence(queueResidence);
+    logTarget->getStats()->getBatchSize(batchSize);
+    EXPECT_GE(writeLatency.m_count, msgCount);
+    EXPECT_GE(queueResidence.m_count, msgCount);
+    EXPECT_GE(batchSize.m_sum, msgCount);
+    // residence time of each record includes its write time
+    EXPECT_GE(queueResidence.m_max, writeLatency.m_max);
+
+    elog::ELogBuffer buffer;
+    subTarget->statsToString(buffer);
+    EXPECT_NE(std::string(buffer.getRef(), buffer.getOffset()).find("Write latency (ns): count="),
+              std::string::npos);
+
+    // with sampling only about one in every 10 records is measured (flush requests of the deferred
+    // thread share the same sampling counter), and with sampling disabled none is
+    const uint32_t sampleRate = 10;
+    uint32_t expectedMsgCount = msgCount;
+    for (uint32_t rate : {sampleRate, 0u}) {
+        elog::setStatsLatencySampleRate(rate);
+        uint64_t prevCount = writeLatency.m_count;
+        for (uint32_t i = 0; i < msgCount; ++i) {
+            ELOG_INFO_EX(logger, "Deferred message %u for sampled latency histogram", i);
+        }
+        expectedMsgCount += msgCount;
+        for (uint32_t i = 0; i < 500; ++i) {
+            if (getDeferredTestMsgs(subTarget, logMsgs) == expectedMsgCount) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_EQ(logMsgs.size(), expectedMsgCount);
+        subTarget->getStats()->getWriteLatency(writeLatency);
+        if (rate == 0) {
+            EXPECT_EQ(writeLatency.m_count, prevCount);
+        } else {
+            EXPECT_GE(writeLatency.m_count, prevCount + msgCount / rate / 2);
+            EXPECT_LE(writeLatency.m_count, prevCount + msgCount / rate + 1);
+        }
+    }
+    elog::removeLogTarget(logTargetId);
+}
+
+TEST(ELogCore, SelfProfile) {
+    // when self-profiling is compiled in, each logged message is accounted for in the pipeline
+    // stages it passes through, otherwise all counters remain zero
+    const uint32_t msgCount = 100;
+    TestLogTarget* logTarget = new (std::nothrow) TestLogTarget();
+    EXPECT_EQ(logTarget->setLogFormat("${msg}"), true);
+    elog::ELogTargetId logTargetId = elog::addLogTarget(logTarget);
+    ASSERT_NE(logTargetId, ELOG_INVALID_TARGET_ID);
+
+    elog::resetSelfProfileStats();
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getPrivateLogger("elog.test.core.profile");
+    for (uint32_t i = 0; i < msgCount; ++i) {
+        ELOG_INFO_EX(logger, "Profiled message %u", i);
+    }
+    logTarget->flush();
+
+    elog::ELogProfileStats stats;
+    elog::getSelfProfileStats(stats);
+    const uint32_t finishLog = (uint32_t)elog::ELogProfileStage::PS_FINISH_LOG;
+    const uint32_t targetLog = (uint32_t)elog::ELogProfileStage::PS_TARGET_LOG;
+    const uint32_t targetFlush = (uint32_t)elog::ELogProfileStage::PS_TARGET_FLUSH;
+    const uint32_t format = (uint32_t)elog::ELogProfileStage::PS_FORMAT;
+    if (elog::isSelfProfileEnabled()) {
+        EXPECT_GE(stats.m_callCount[finishLog], msgCount);
+        EXPECT_GE(stats.m_callCount[targetLog], msgCount);
+        EXPECT_GE(stats.m_callCount[targetFlush], 1u);
+        EXPECT_GE(stats.m_callCount[format], msgCount);
+        EXPECT_GE(stats.m_ticks[finishLog], stats.m_ticks[format]);
+    } else {
+        for (uint32_t i = 0; i < ELOG_PROFILE_STAGE_COUNT; ++i) {
+            EXPECT_EQ(stats.m_callCount[i], 0u);
+            EXPECT_EQ(stats.m_ticks[i], 0u);
+        }
+    }
+    elog::reportSelfProfileStats(elog::ELEVEL_TRACE);
+
+    elog::resetSelfProfileStats();
+    elog::getSelfProfileStats(stats);
+    EXPECT_EQ(stats.m_callCount[finishLog], 0u);
+    elog::removeLogTarget(logTargetId);
+}
+
+TEST(ELogCore, ShardedRateLimit) {
+    // tokens are drawn in chunks of 10, so the main thread takes the first chunk and keeps 9
+    // unused tokens, and the remaining 90 tokens are all consumed by the worker threads (unless the
+    // one hour interval happens to end during the test)
+    const uint64_t maxMsg = 100;
+    const uint32_t threadCount = 4;
+    const uint32_t callCount = 1000;
+    elog::ELogRateLimiter rateLimiter(
+        elog::ELogRateLimitParams(maxMsg, 1, elog::ELogTimeUnits::TU_HOURS, true, 10));
+    elog::ELogRecord logRecord;
+    EXPECT_EQ(rateLimiter.filterLogRecord(logRecord), true);
+
+    std::atomic<uint64_t> passCount(0);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(std::thread([&rateLimiter, &passCount, callCount]() {
+            elog::ELogRecord threadLogRecord;
+            for (uint32_t j = 0; j < callCount; ++j) {
+                if (rateLimiter.filterLogRecord(threadLogRecord)) {
+                    passCount.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }));
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    EXPECT_LE(passCount.load(), maxMsg);
+    EXPECT_GE(passCount.load(), maxMsg - 10 - threadCount * 10);
+}
+
+TEST(ELogCore, CallSiteRateLimit) {
+    // the storming call site is limited to 10 messages within the one hour window, while the quiet
+    // call site is not affected
+    TestLogTarget* logTarget = new (std::nothrow) TestLogTarget();
+    EXPECT_EQ(logTarget->setLogFormat("${msg}"), true);
+    elog::ELogTargetId logTargetId = elog::addLogTarget(logTarget);
+    ASSERT_NE(logTargetId, ELOG_INVALID_TARGET_ID);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getPrivateLogger("elog.test.core.call_site");
+    EXPECT_EQ(elog::configureCallSiteRateLimit("10:1:hour"), true);
+    for (uint32_t i = 0; i < 50; ++i) {
+        ELOG_INFO_EX(logger, "Storming message %u", i);
+    }
+    for (uint32_t i = 0; i < 5; ++i) {
+        ELOG_INFO_EX(logger, "Quiet message %u", i);
+    }
+    elog::clearCallSiteRateLimit();
+    ELOG_INFO_EX(logger, "Storming message after clear");
+
+    uint32_t stormCount = 0;
+    uint32_t quietCount = 0;
+    for (const std::string& logMsg : logTarget->getLogMessages()) {
+        if (logMsg.find("Storming message") == 0) {
+            ++stormCount;
+        } else if (logMsg.find("Quiet message") == 0) {
+            ++quietCount;
+        }
+    }
+    EXPECT_EQ(stormCount, 11u);
+    EXPECT_EQ(quietCount, 5u);
+    elog::removeLogTarget(logTargetId);
+}
+
+TEST(ELogCore, CallSiteRateLimitMultiThread) {
+    // threads reserve message chunks of the storming call site, so the limit is never exceeded,
+    // and tokens left unused by other threads cause it to be applied only slightly early
+    const uint32_t threadCount = 4;
+    const uint32_t maxMsg = 1000;
+    TestLogTarget* logTarget = new (std::nothrow) TestLogTarget();
+    EXPECT_EQ(logTarget->setLogFormat("${msg}"), true);
+    elog::ELogTargetId logTargetId = elog::addLogTarget(logTarget);
+    ASSERT_NE(logTargetId, ELOG_INVALID_TARGET_ID);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getSharedLogger("elog.test.core.call_site_mt");
+    EXPECT_EQ(elog::setCallSiteRateLimit(maxMsg, 1, elog::ELogTimeUnits::TU_HOURS), true);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([logger, maxMsg]() {
+            for (uint32_t j = 0; j < maxMsg; ++j) {
+                ELOG_INFO_EX(logger, "Storming message %u", j);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    // a new time window is started by the timer service
+    elog::clearCallSiteRateLimit();
+    EXPECT_EQ(elog::setCallSiteRateLimit(10, 20, elog::ELogTimeUnits::TU_MILLI_SECONDS), true);
+    for (uint32_t i = 0; i < 2; ++i) {
+        for (uint32_t j = 0; j < 20; ++j) {
+            ELOG_INFO_EX(logger, "Windowed message %u", j);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    elog::clearCallSiteRateLimit();
+
+    uint32_t stormCount = 0;
+    uint32_t windowedCount = 0;
+    for (const std::string& logMsg : logTarget->getLogMessages()) {
+        if (logMsg.find("Storming message") == 0) {
+            ++stormCount;
+        } else if (logMsg.find("Windowed message") == 0) {
+            ++windowedCount;
+        }
+    }
+    EXPECT_LE(stormCount, maxMsg);
+    // each thread reserves at most 1/16 of the remaining messages at once
+    EXPECT_GE(stormCount, maxMsg - threadCount * maxMsg / 16);
+    EXPECT_EQ(windowedCount, 20u);
+    elog::removeLogTarget(logTargetId);
+}
+
+TEST(ELogCore, TimedFlushTimerService) {
+    // timed flush policies of several log targets share the same timer thread, each one flushing
+    // its log target at its own rate
+    const uint32_t targetCount = 3;
+    const uint64_t flushPeriodMillis[targetCount] = {10, 25, 500};
+    TestLogTarget* logTargets[targetCount] = {};
+    elog::ELogTargetId logTargetIds[targetCount] = {};
+    for (uint32_t i = 0; i < targetCount; ++i) {
+        logTargets[i] = new (std::nothrow) TestLogTarget();
+        ASSERT_NE(logTargets[i], nullptr);
+        logTargets[i]->setFlushPolicy(
+            new (std::nothrow) elog::ELogTimedFlushPolicy(flushPeriodMillis[i], logTargets[i]));
+        logTargetIds[i] = elog::addLogTarget(logTargets[i]);
+        ASSERT_NE(logTargetIds[i], ELOG_INVALID_TARGET_ID);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // the timed flush policy flushes only if no other flush took place during the last period, so
+    // the expected flush count is only roughly estimated
+    EXPECT_GE(logTargets[0]->getFlushCount(), 5u);
+    EXPECT_GE(logTargets[1]->getFlushCount(), 2u);
+    EXPECT_LE(logTargets[1]->getFlushCount(), logTargets[0]->getFlushCount());
+    EXPECT_EQ(logTargets[2]->getFlushCount(), 0u);
+
+    // log target I/O is never executed on the timer service thread
+    EXPECT_EQ(logTargets[0]->getLastFlushThreadName(), "flush-executor");
+
+    // removing log targets cancels their flush timers
+    for (uint32_t i = 0; i < targetCount; ++i) {
+        elog::removeLogTarget(logTargetIds[i]);
+    }
+}
+
+static void testGroupFlush(uint32_t groupTimeoutMicros, uint32_t threadCount, uint32_t msgCount) {
+    TestLogTarget* logTarget = new (std::nothrow) TestLogTarget();
+    ASSERT_NE(logTarget, nullptr);
+    logTarget->enableFlushModeration();
+    EXPECT_EQ(logTarget->setLogFormat("${msg}"), true);
+    logTarget->setFlushPolicy(new (std::nothrow) elog::ELogChainedFlushPolicy(
+        new (std::nothrow) elog::ELogImmediateFlushPolicy(),
+        new (std::nothrow) elog::ELogGroupFlushPolicy(4, groupTimeoutMicros)));
+    elog::ELogTargetId logTargetId = elog::addLogTarget(logTarget);
+    ASSERT_NE(logTargetId, ELOG_INVALID_TARGET_ID);
+
+    elog::getRootLogSource()->setLogLevel(elog::ELEVEL_INFO, elog::ELogPropagateMode::PM_NONE);
+    elog::ELogLogger* logger = elog::getSharedLogger("elog.test.core.group_flush");
+    uint64_t initialFlushCount = logTarget->getFlushCount();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(std::thread([logger, i, msgCount]() {
+            for (uint32_t j = 0; j < msgCount; ++j) {
+                ELOG_INFO_EX(logger, "Group flush message %u %u", i, j);
+            }
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    uint64_t elapsedMicros = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+
+    // every record is written, and each flush request is served by some group flush
+    uint32_t groupMsgCount = 0;
+    for (const std::string& logMsg : logTarget->getLogMessages()) {
+        if (logMsg.starts_with("Group flush message")) {
+            ++groupMsgCount;
+        }
+    }
+    EXPECT_EQ(groupMsgCount, threadCount * msgCount);
+    uint64_t flushCount = logTarget->getFlushCount() - initialFlushCount;
+    EXPECT_GE(flushCount, 1u);
+    EXPECT_LE(flushCount, (uint64_t)threadCount * msgCount);
+
+    // a single thread never fills a group, so each of its flushes waits for the group deadline
+    if (threadCount == 1) {
+        EXPECT_GE(elapsedMicros, (uint64_t)groupTimeoutMicros * msgCount);
+    }
+    elog::removeLogTarget(logTargetId);
+}
+
+TEST(ELogCore, GroupFlushDeadline) {
+    // group timeouts of at least one timer tick are waited for on the timer service, with a single
+    // deadline timer task re-armed by each group leader, and shorter timeouts are waited for with a
+    // timed condition variable wait
+    testGroupFlush(2000, 1, 10);
+    testGroupFlush(2000, 8, 200);
+    testGroupFlush(200, 1, 10);
+    testGroupFlush(200, 8, 200);
+}
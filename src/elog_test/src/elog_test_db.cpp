@@ -1,5 +1,9 @@
 #include "elog_test_common.h"
 
+#ifdef ELOG_ENABLE_DB
+#include "db/elog_columnar_batch.h"
+#endif
+
 #ifdef ELOG_ENABLE_MYSQL_DB_CONNECTOR
 bool testMySQL() {
     ELOG_BEGIN_TEST();
@@ -88,3 +92,76 @@ TEST(ELogDb, Redis) {
     EXPECT_EQ(res, true);
 }
 #endif
+
+#ifdef ELOG_ENABLE_DB
+TEST(ELogDb, ColumnarBatch) {
+    elog::ELogDbFormatter* formatter = new (std::nothrow) elog::ELogDbFormatter();
+    ASSERT_NE(formatter, nullptr);
+    ASSERT_EQ(formatter->initialize("INSERT INTO log_records VALUES(${rid}, ${time}, ${level}, "
+                                   "${tid}, ${msg}, ${line}, ${file})"),
+              true);
+    EXPECT_EQ(formatter->getProcessedStatement(),
+              "INSERT INTO log_records VALUES(?, ?, ?, ?, ?, ?, ?)");
+
+    // log time has 100 nanos resolution
+    const uint64_t baseNanos = elog::getCurrentTimeEpoch<std::chrono::nanoseconds>() / 100 * 100;
+    const size_t recordCount = 16;
+    std::vector<std::string> msgs(recordCount);
+    std::vector<elog::ELogRecord> logRecords(recordCount);
+    for (size_t i = 0; i < recordCount; ++i) {
+        msgs[i] = "Test message " + std::to_string(i);
+        elog::ELogRecord& logRecord = logRecords[i];
+        logRecord.m_logRecordId = i + 1;
+        elog::elogTimeFromUnixTimeNanos(baseNanos + i * 1000, logRecord.m_logTime);
+        logRecord.m_threadId = 100 + (uint32_t)(i % 3);
+        logRecord.m_logLevel = (i % 2 == 0) ? elog::ELEVEL_INFO : elog::ELEVEL_ERROR;
+        logRecord.m_file = "test_file.cpp";
+        logRecord.m_function = "testFunc";
+        logRecord.m_logMsg = msgs[i].c_str();
+        logRecord.m_logMsgLen = (uint32_t)msgs[i].length();
+        logRecord.m_line = (uint16_t)(10 + i);
+    }
+
+    // fill in two steps to check appending
+    elog::ELogColumnarBatch batch;
+    EXPECT_EQ(formatter->fillColumnarBatch(logRecords.data(), recordCount / 2, batch),
+              recordCount / 2);
+    EXPECT_EQ(
+        formatter->fillColumnarBatch(logRecords.data() + recordCount / 2, recordCount / 2, batch),
+        recordCount / 2);
+    ASSERT_EQ(batch.getColumnCount(), 7);
+    ASSERT_EQ(batch.getRowCount(), recordCount);
+
+    const elog::ELogColumnarBatch::Column& ridColumn = batch.getColumn(0);
+    const elog::ELogColumnarBatch::Column& timeColumn = batch.getColumn(1);
+    const elog::ELogColumnarBatch::Column& levelColumn = batch.getColumn(2);
+    const elog::ELogColumnarBatch::Column& tidColumn = batch.getColumn(3);
+    const elog::ELogColumnarBatch::Column& lineColumn = batch.getColumn(5);
+    EXPECT_EQ(ridColumn.getName(), "rid");
+    EXPECT_EQ(timeColumn.getParamType(), elog::ELogDbFormatter::ParamType::PT_DATETIME);
+    EXPECT_EQ(levelColumn.getParamType(), elog::ELogDbFormatter::ParamType::PT_LOG_LEVEL);
+    EXPECT_EQ(batch.getColumn(4).getParamType(), elog::ELogDbFormatter::ParamType::PT_TEXT);
+    for (size_t i = 0; i < recordCount; ++i) {
+        EXPECT_EQ(ridColumn.getIntValues()[i], i + 1);
+        EXPECT_EQ(timeColumn.getIntValues()[i], baseNanos + i * 1000);
+        EXPECT_EQ(levelColumn.getLogLevelValues()[i], logRecords[i].m_logLevel);
+        EXPECT_EQ(tidColumn.getIntValues()[i], logRecords[i].m_threadId);
+        EXPECT_EQ(lineColumn.getIntValues()[i], 10 + i);
+        size_t length = 0;
+        const char* msg = batch.getString(4, i, length);
+        EXPECT_EQ(std::string(msg, length), msgs[i]);
+        const char* file = batch.getString(6, i, length);
+        EXPECT_EQ(std::string(file, length), "test_file.cpp");
+    }
+
+    // cleared batch keeps its columns
+    batch.clear();
+    EXPECT_EQ(batch.getRowCount(), 0);
+    EXPECT_EQ(batch.getColumnCount(), 7);
+    EXPECT_EQ(batch.getStringHeap().empty(), true);
+    EXPECT_EQ(formatter->fillColumnarBatch(logRecords.data(), 1, batch), 1);
+    EXPECT_EQ(batch.getRowCount(), 1);
+    EXPECT_EQ(batch.getColumn(0).getIntValues().size(), 1);
+    elog::destroyLogFormatter(formatter);
+}
+#endif
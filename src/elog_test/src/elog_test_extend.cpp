@@ -1,3 +1,4 @@
+#include "elog_static_formatter.h"
 #include "elog_test_common.h"
 
 class TestSelector : public elog::ELogFieldSelector {
@@ -199,4 +200,39 @@ int testLogFormatter() {
 TEST(ELogExtend, ELogFormatter) {
     int res = testLogFormatter();
     EXPECT_EQ(res, 0);
-}
\ No newline at end of file
+}
+
+#define TEST_STATIC_FORMAT                                                                    \
+    "${time} ${level:6} [${tid:-8}] ${host}@${user} ${pid} ${prog:10} ${src:font=underline} " \
+    "${mod} ${file}:${line} ${func} "                                                         \
+    "${if: (log_level == INFO): ${fmt:begin-fg-color=green}: ${fmt:begin-fg-color=red}}"      \
+    "${msg}${fmt:default} ${env:name=TEST_ENV_VAR}"
+
+ELOG_DECLARE_STATIC_LOG_FORMATTER(TestStaticFormatter, test_static, TEST_STATIC_FORMAT,
+                                  ELOG_NO_EXPORT)
+ELOG_IMPLEMENT_LOG_FORMATTER(TestStaticFormatter)
+
+TEST(ELogExtend, ELogStaticFormatter) {
+    // format each record with both a static formatter and a regular formatter, and compare
+    elog::ELogFormatter* logFormatter = elog::constructLogFormatter("test_static");
+    ASSERT_NE(logFormatter, nullptr);
+    TestLogTarget* staticTarget = new (std::nothrow) TestLogTarget();
+    staticTarget->setLogFormatter(logFormatter);
+    TestLogTarget* logTarget = new (std::nothrow) TestLogTarget();
+    logTarget->setLogFormat(TEST_STATIC_FORMAT);
+    elog::addLogTarget(staticTarget);
+    elog::addLogTarget(logTarget);
+    staticTarget->clearLogMessages();
+    logTarget->clearLogMessages();
+
+    elog::ELogLogger* logger = elog::getPrivateLogger("elog.test.static");
+    ELOG_INFO_EX(logger, "Test message");
+    ELOG_WARN_EX(logger, "Test message");
+    const auto& staticMessages = staticTarget->getLogMessages();
+    const auto& logMessages = logTarget->getLogMessages();
+    EXPECT_EQ(staticMessages.size(), 2);
+    EXPECT_EQ(staticMessages, logMessages);
+
+    elog::removeLogTarget(logTarget);
+    elog::removeLogTarget(staticTarget);
+}
@@ -27,6 +27,7 @@ static int testGRPCStream();
 static int testGRPCAsync();
 static int testGRPCAsyncCallbackUnary();
 static int testGRPCAsyncCallbackStream();
+static int testGRPCStreamBatch();
 #endif
 
 #ifdef ELOG_ENABLE_GRPC_CONNECTOR
@@ -143,6 +144,19 @@ public:
         }
         return grpc::Status::OK;
     }
+
+    ::grpc::Status StreamLogRecordBatches(
+        ::grpc::ServerContext* context,
+        ::grpc::ServerReader< ::elog_grpc::ELogRecordBatchMsg>* reader,
+        ::elog_grpc::ELogStatusMsg* response) {
+        elog_grpc::ELogRecordBatchMsg batchMsg;
+        while (reader->Read(&batchMsg)) {
+            for (const elog_grpc::ELogRecordMsg& msg : batchMsg.records()) {
+                handleGrpcLogRecord(&msg);
+            }
+        }
+        return grpc::Status::OK;
+    }
 };
 
 class TestGRPCAsyncServer final : public elog_grpc::ELogService::AsyncService {
@@ -326,6 +340,10 @@ TEST(ELogGRPC, AsyncCallbackStream) {
     int res = testGRPCAsyncCallbackStream();
     EXPECT_EQ(res, 0);
 }
+TEST(ELogGRPC, StreamBatch) {
+    int res = testGRPCStreamBatch();
+    EXPECT_EQ(res, 0);
+}
 
 template <typename ServerType>
 std::thread startServiceWait(std::unique_ptr<grpc::Server>& server, ServerType& service,
@@ -348,7 +366,7 @@ static int sMsgCnt = -1;
 
 template <typename ServerType>
 int testGRPCClient(const char* clientType, int opts = 0, uint32_t stMsgCount = 10,
-                   uint32_t mtMsgCount = 100) {
+                   uint32_t mtMsgCount = 100, const char* extraParams = "") {
     // setup up server
     std::string serverAddress = "0.0.0.0:5051";
     ServerType service;
@@ -371,6 +389,7 @@ int testGRPCClient(const char* clientType, int opts = 0, uint32_t stMsgCount = 1
         "${msg})&grpc_max_inflight_calls=20000&flush_policy=count&flush_count=1024&"
         "grpc_client_mode=";
     cfg += clientType;
+    cfg += extraParams;
     std::string testName = std::string("gRPC (") + clientType + ")";
     std::string mtResultFileName = std::string("elog_test_grpc_") + clientType;
 
@@ -449,4 +468,9 @@ int testGRPCAsyncCallbackUnary() {
 int testGRPCAsyncCallbackStream() {
     return testGRPCClient<TestGRPCAsyncCallbackServer>("async_callback_stream");
 }
+
+int testGRPCStreamBatch() {
+    return testGRPCClient<TestGRPCServer>("stream_batch", 0, 10, 100,
+                                          "&grpc_max_batch_size=64&grpc_compression=gzip");
+}
 #endif
\ No newline at end of file
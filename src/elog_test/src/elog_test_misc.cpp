@@ -1,9 +1,14 @@
+#include <cstring>
+#include <fstream>
 #include <sstream>
 
+#include "elog_json_writer.h"
 #include "elog_test_common.h"
 
 #ifdef ELOG_ENABLE_JSON
 #include <nlohmann/json.hpp>
+
+#include "elog_json_formatter.h"
 #endif
 
 TEST(ELogMisc, ThreadName) {
@@ -32,6 +37,62 @@ TEST(ELogMisc, ThreadName) {
     elog::removeLogTarget(logTarget);
 }
 
+TEST(ELogMisc, JsonWriter) {
+    // escaping should be correct regardless of the position of special characters relative to the
+    // SIMD scan width
+    std::string plain(70, 'x');
+    for (size_t pos : {0, 5, 15, 16, 31, 32, 33, 63, 69}) {
+        std::string str = plain;
+        str[pos] = '"';
+        str[(pos + 7) % str.length()] = '\n';
+        std::string expected;
+        for (char c : str) {
+            if (c == '"') {
+                expected += "\\\"";
+            } else if (c == '\n') {
+                expected += "\\n";
+            } else {
+                expected += c;
+            }
+        }
+        std::string escaped;
+        elog::elogJsonAppendEscaped(escaped, str.c_str(), str.length());
+        EXPECT_EQ(escaped, expected);
+    }
+
+    // writing into a string and into a log buffer should yield the same result
+    std::string jsonStr;
+    elog::ELogBuffer jsonBuffer;
+    elog::ELogJsonWriter<std::string> strWriter(jsonStr);
+    elog::ELogJsonWriter<elog::ELogBuffer> bufferWriter(jsonBuffer);
+    for (int i = 0; i < 2; ++i) {
+        auto writeJson = [](auto& writer) {
+            writer.beginObject();
+            writer.writeStringMember("msg", "say \"hi\"\t\\ \x01");
+            writer.writeIntMember("count", 42);
+            writer.writeKey("list");
+            writer.beginArray();
+            writer.writeInt(1);
+            writer.writeString("two");
+            writer.beginObject();
+            writer.endObject();
+            writer.endArray();
+            writer.endObject();
+            writer.finish();
+        };
+        if (i == 0) {
+            writeJson(strWriter);
+        } else {
+            writeJson(bufferWriter);
+        }
+    }
+    const char* expected =
+        "{\"msg\":\"say \\\"hi\\\"\\t\\\\ \\u0001\",\"count\":42,\"list\":[1,\"two\",{}]}";
+    EXPECT_EQ(jsonStr, expected);
+    EXPECT_EQ(std::string(jsonBuffer.getRef(), jsonBuffer.getOffset()), expected);
+    EXPECT_EQ(strlen(jsonBuffer.getRef()), jsonBuffer.getOffset());
+}
+
 TEST(ELogMisc, LogMacros) {
     TestLogTarget* logTarget = new (std::nothrow) TestLogTarget();
     logTarget->setLogFormat("${msg}");
@@ -126,4 +187,373 @@ TEST(ELogMisc, StructuredLogging) {
 
     elog::removeLogTarget(logTarget);
 }
-#endif
\ No newline at end of file
+
+TEST(ELogMisc, JsonFormatter) {
+    // JSON template mode: field values are escaped
+    TestLogTarget* logTarget = new (std::nothrow) TestLogTarget();
+    elog::ELogFormatter* logFormatter = elog::constructLogFormatter("json");
+    EXPECT_NE(logFormatter, nullptr);
+    if (logFormatter == nullptr) {
+        return;
+    }
+    EXPECT_EQ(logFormatter->initialize("{\"level\": \"${level}\", \"log_msg\": \"${msg}\"}"), true);
+    logTarget->setLogFormatter(logFormatter);
+    elog::addLogTarget(logTarget);
+    const auto& logMessages = logTarget->getLogMessages();
+
+    logTarget->clearLogMessages();
+    ELOG_INFO("This is a \"quoted\"\ttest message\\");
+    EXPECT_EQ(logMessages.size(), 1);
+    nlohmann::json jsonLog = nlohmann::json::parse(logMessages[0]);
+    EXPECT_EQ(jsonLog["level"].get<std::string>().compare("INFO"), 0);
+    EXPECT_EQ(jsonLog["log_msg"].get<std::string>().compare("This is a \"quoted\"\ttest message\\"),
+              0);
+
+    // property map mode: each record is formatted as a JSON object
+    elog::ELogJsonFormatter* jsonFormatter = elog::ELogJsonFormatter::create();
+    EXPECT_NE(jsonFormatter, nullptr);
+    if (jsonFormatter == nullptr) {
+        elog::removeLogTarget(logTarget);
+        return;
+    }
+    EXPECT_EQ(jsonFormatter->parseJson("{\"tid\": \"${tid}\", \"log_msg\": \"${msg}\"}"), true);
+    logTarget->setLogFormatter(jsonFormatter);
+    logTarget->clearLogMessages();
+    ELOG_INFO("Line 1\nLine 2");
+    EXPECT_EQ(logMessages.size(), 1);
+    jsonLog = nlohmann::json::parse(logMessages[0]);
+    EXPECT_EQ(jsonLog["tid"].get<uint32_t>(), getCurrentThreadId());
+    EXPECT_EQ(jsonLog["log_msg"].get<std::string>().compare("Line 1\nLine 2"), 0);
+
+    elog::removeLogTarget(logTarget);
+}
+#endif
+
+static bool readArrowFile(const char* path, std::string& content) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f.good()) {
+        return false;
+    }
+    content.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// minimal bounds-checked flatbuffers reader, enough for decoding Arrow IPC message metadata
+class ArrowFbReader {
+public:
+    ArrowFbReader(const char* data, size_t size) : m_data(data), m_size(size), m_valid(true) {}
+
+    inline bool isValid() const { return m_valid; }
+
+    template <typename T>
+    T read(size_t pos) {
+        T value = 0;
+        if (pos + sizeof(T) > m_size) {
+            m_valid = false;
+        } else {
+            memcpy(&value, m_data + pos, sizeof(T));
+        }
+        return value;
+    }
+
+    inline size_t getRoot() { return read<uint32_t>(0); }
+
+    bool getField(size_t table, uint32_t fieldId, size_t& fieldPos) {
+        size_t vtable = table - (size_t)(int64_t)read<int32_t>(table);
+        uint16_t vtableSize = read<uint16_t>(vtable);
+        if (4 + 2 * fieldId >= vtableSize) {
+            return false;
+        }
+        uint16_t fieldOffset = read<uint16_t>(vtable + 4 + 2 * fieldId);
+        fieldPos = table + fieldOffset;
+        return fieldOffset != 0;
+    }
+
+    template <typename T>
+    T getScalar(size_t table, uint32_t fieldId) {
+        size_t fieldPos = 0;
+        return getField(table, fieldId, fieldPos) ? read<T>(fieldPos) : 0;
+    }
+
+    bool getObject(size_t table, uint32_t fieldId, size_t& objectPos) {
+        size_t fieldPos = 0;
+        if (!getField(table, fieldId, fieldPos)) {
+            return false;
+        }
+        objectPos = fieldPos + read<uint32_t>(fieldPos);
+        return m_valid;
+    }
+
+    bool getVector(size_t table, uint32_t fieldId, size_t& elementPos, uint32_t& count) {
+        size_t vectorPos = 0;
+        if (!getObject(table, fieldId, vectorPos)) {
+            return false;
+        }
+        count = read<uint32_t>(vectorPos);
+        elementPos = vectorPos + 4;
+        return m_valid;
+    }
+
+    inline size_t getVectorTable(size_t elementPos, uint32_t index) {
+        size_t offsetPos = elementPos + 4 * index;
+        return offsetPos + read<uint32_t>(offsetPos);
+    }
+
+    std::string getString(size_t table, uint32_t fieldId) {
+        size_t stringPos = 0;
+        if (!getObject(table, fieldId, stringPos)) {
+            return "";
+        }
+        uint32_t length = read<uint32_t>(stringPos);
+        if (stringPos + 4 + length > m_size) {
+            m_valid = false;
+            return "";
+        }
+        return std::string(m_data + stringPos + 4, length);
+    }
+
+private:
+    const char* m_data;
+    size_t m_size;
+    bool m_valid;
+};
+
+struct ArrowStreamInfo {
+    uint32_t m_schemaFieldCount = 0;
+    std::vector<std::pair<std::string, std::string>> m_metadata;
+    uint32_t m_dictionaryBatchCount = 0;
+    uint32_t m_recordBatchCount = 0;
+    uint64_t m_rowCount = 0;
+    std::vector<std::string> m_msgs;
+};
+
+#define ARROW_TEST_FIELD_COUNT 11
+#define ARROW_TEST_BUFFER_COUNT (2 * ARROW_TEST_FIELD_COUNT + 1)
+
+// verifies batch field nodes and buffers against the message body, and returns the buffer specs
+static bool decodeArrowBatch(ArrowFbReader& fb, size_t batch, uint64_t bodyLength,
+                             uint32_t nodeCount, uint32_t bufferCount, uint64_t& rowCount,
+                             std::vector<std::pair<uint64_t, uint64_t>>& buffers) {
+    rowCount = fb.getScalar<uint64_t>(batch, 0);
+    size_t nodePos = 0;
+    uint32_t count = 0;
+    if (!fb.getVector(batch, 1, nodePos, count) || count != nodeCount) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        // each node is a struct of length and null count
+        if (fb.read<uint64_t>(nodePos + 16 * i) != rowCount ||
+            fb.read<uint64_t>(nodePos + 16 * i + 8) != 0) {
+            return false;
+        }
+    }
+    size_t bufferPos = 0;
+    if (!fb.getVector(batch, 2, bufferPos, count) || count != bufferCount) {
+        return false;
+    }
+    buffers.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t offset = fb.read<uint64_t>(bufferPos + 16 * i);
+        uint64_t length = fb.read<uint64_t>(bufferPos + 16 * i + 8);
+        if (offset % 8 != 0 || offset + length > bodyLength) {
+            return false;
+        }
+        buffers.push_back({offset, length});
+    }
+    return fb.isValid();
+}
+
+// decodes the message framing of an Arrow IPC stream, and the message column of all record batches
+static bool decodeArrowStream(const std::string& content, ArrowStreamInfo& info) {
+    const uint8_t headerSchema = 1;
+    const uint8_t headerDictionaryBatch = 2;
+    const uint8_t headerRecordBatch = 3;
+    size_t pos = 0;
+    for (;;) {
+        ArrowFbReader frame(content.data(), content.size());
+        if (frame.read<uint32_t>(pos) != 0xFFFFFFFF) {
+            return false;
+        }
+        uint32_t metadataLength = frame.read<uint32_t>(pos + 4);
+        pos += 8;
+        if (!frame.isValid() || metadataLength % 8 != 0 ||
+            pos + metadataLength > content.size()) {
+            return false;
+        }
+        if (metadataLength == 0) {
+            // end of stream marker must be last
+            return pos == content.size();
+        }
+        ArrowFbReader fb(content.data() + pos, metadataLength);
+        pos += metadataLength;
+        size_t message = fb.getRoot();
+        uint8_t headerType = fb.getScalar<uint8_t>(message, 1);
+        uint64_t bodyLength = fb.getScalar<uint64_t>(message, 3);
+        size_t header = 0;
+        if (!fb.getObject(message, 2, header) || pos + bodyLength > content.size()) {
+            return false;
+        }
+        const char* body = content.data() + pos;
+        pos += bodyLength;
+
+        uint64_t rowCount = 0;
+        std::vector<std::pair<uint64_t, uint64_t>> buffers;
+        if (headerType == headerSchema) {
+            size_t elementPos = 0;
+            uint32_t count = 0;
+            if (!fb.getVector(header, 1, elementPos, count)) {
+                return false;
+            }
+            info.m_schemaFieldCount = count;
+            if (fb.getVector(header, 2, elementPos, count)) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    size_t keyValue = fb.getVectorTable(elementPos, i);
+                    info.m_metadata.push_back(
+                        {fb.getString(keyValue, 0), fb.getString(keyValue, 1)});
+                }
+            }
+        } else if (headerType == headerDictionaryBatch) {
+            // single string column: validity, offsets and data buffers
+            size_t batch = 0;
+            if (!fb.getObject(header, 1, batch) ||
+                !decodeArrowBatch(fb, batch, bodyLength, 1, 3, rowCount, buffers)) {
+                return false;
+            }
+            ++info.m_dictionaryBatchCount;
+        } else if (headerType == headerRecordBatch) {
+            if (!decodeArrowBatch(fb, header, bodyLength, ARROW_TEST_FIELD_COUNT,
+                                  ARROW_TEST_BUFFER_COUNT, rowCount, buffers)) {
+                return false;
+            }
+            // message column is last, and is not dictionary encoded
+            const auto& offsetBuffer = buffers[ARROW_TEST_BUFFER_COUNT - 2];
+            const auto& dataBuffer = buffers[ARROW_TEST_BUFFER_COUNT - 1];
+            if (offsetBuffer.second != (rowCount + 1) * sizeof(int32_t)) {
+                return false;
+            }
+            const char* offsets = body + offsetBuffer.first;
+            for (uint64_t i = 0; i < rowCount; ++i) {
+                int32_t start = 0;
+                int32_t end = 0;
+                memcpy(&start, offsets + i * sizeof(int32_t), sizeof(int32_t));
+                memcpy(&end, offsets + (i + 1) * sizeof(int32_t), sizeof(int32_t));
+                if (start < 0 || end < start || (uint64_t)end > dataBuffer.second) {
+                    return false;
+                }
+                info.m_msgs.push_back(std::string(body + dataBuffer.first + start, end - start));
+            }
+            ++info.m_recordBatchCount;
+            info.m_rowCount += rowCount;
+        } else {
+            return false;
+        }
+        if (!fb.isValid()) {
+            return false;
+        }
+    }
+}
+
+static const std::string* findArrowMetadata(const ArrowStreamInfo& info, const char* key) {
+    for (const auto& entry : info.m_metadata) {
+        if (entry.first.compare(key) == 0) {
+            return &entry.second;
+        }
+    }
+    return nullptr;
+}
+
+TEST(ELogMisc, ArrowFileTarget) {
+    const char* arrowPath = "./elog_test_arrow.arrows";
+    std::remove(arrowPath);
+    elog::ELogTargetId targetId =
+        elog::configureLogTarget("file://./elog_test_arrow.arrows?file_format=arrow&"
+                                 "arrow_batch_size=4&log_level=INFO");
+    ASSERT_NE(targetId, ELOG_INVALID_TARGET_ID);
+    elog::ELogLogger* logger = elog::getPrivateLogger("elog.test.misc.arrow");
+
+    // 10 records with batch size 4 result in several batches, the last one written on stop
+    for (int i = 0; i < 10; ++i) {
+        ELOG_INFO_EX(logger, "Arrow test message %d", i);
+    }
+    elog::removeLogTarget(targetId);
+
+    std::string content;
+    ASSERT_EQ(readArrowFile(arrowPath, content), true);
+    std::remove(arrowPath);
+
+    // stream starts with a continuation marker and ends with end-of-stream marker
+    ASSERT_GE(content.size(), 16);
+    EXPECT_EQ(content.substr(0, 4), std::string(4, '\xFF'));
+    EXPECT_EQ(content.substr(content.size() - 8), std::string(4, '\xFF') + std::string(4, '\0'));
+    for (int i = 0; i < 10; ++i) {
+        std::string msg = "Arrow test message " + std::to_string(i);
+        EXPECT_NE(content.find(msg), std::string::npos);
+    }
+
+    // decode the stream: schema, dictionaries, and record batches with all records in order
+    // NOTE: records accumulated before elog was initialized are replayed into each new log target
+    ArrowStreamInfo info;
+    ASSERT_TRUE(decodeArrowStream(content, info));
+    EXPECT_EQ(info.m_schemaFieldCount, ARROW_TEST_FIELD_COUNT);
+    EXPECT_GT(info.m_dictionaryBatchCount, 0u);
+    EXPECT_EQ(info.m_msgs.size(), info.m_rowCount);
+    EXPECT_EQ(info.m_recordBatchCount, (info.m_rowCount + 3) / 4);
+    std::vector<std::string> testMsgs;
+    for (const std::string& msg : info.m_msgs) {
+        if (msg.starts_with("Arrow test message")) {
+            testMsgs.push_back(msg);
+        }
+    }
+    ASSERT_EQ(testMsgs.size(), 10u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(testMsgs[i], "Arrow test message " + std::to_string(i));
+    }
+    const std::string* osName = findArrowMetadata(info, "os_name");
+    ASSERT_NE(osName, nullptr);
+    EXPECT_EQ(osName->find_first_of("\r\n"), std::string::npos);
+    EXPECT_NE(findArrowMetadata(info, "pid"), nullptr);
+
+    // a stream missing its end-of-stream marker is rejected
+    ArrowStreamInfo truncatedInfo;
+    EXPECT_FALSE(decodeArrowStream(content.substr(0, content.size() - 8), truncatedInfo));
+    // file name is dictionary encoded, so it appears once in the stream
+    size_t pos = content.find("elog_test_misc.cpp");
+    ASSERT_NE(pos, std::string::npos);
+    EXPECT_EQ(content.find("elog_test_misc.cpp", pos + 1), std::string::npos);
+
+    // with tiny segment size, each batch goes to a new segment, which is a complete stream
+    const char* segmentPaths[] = {"./elog_test_arrow_seg.arrows", "./elog_test_arrow_seg.1.arrows",
+                                  "./elog_test_arrow_seg.2.arrows"};
+    for (const char* segmentPath : segmentPaths) {
+        std::remove(segmentPath);
+    }
+    targetId = elog::configureLogTarget(
+        "file://./elog_test_arrow_seg.arrows?file_format=arrow&arrow_batch_size=4&"
+        "file_segment_size=1b&log_level=INFO");
+    ASSERT_NE(targetId, ELOG_INVALID_TARGET_ID);
+    for (int i = 0; i < 8; ++i) {
+        ELOG_INFO_EX(logger, "Arrow segment message %d", i);
+    }
+    elog::removeLogTarget(targetId);
+    std::string allSegments;
+    uint64_t segmentRowCount = 0;
+    for (const char* segmentPath : segmentPaths) {
+        ASSERT_EQ(readArrowFile(segmentPath, content), true);
+        std::remove(segmentPath);
+        EXPECT_EQ(content.substr(content.size() - 8),
+                  std::string(4, '\xFF') + std::string(4, '\0'));
+        // each segment has its own schema and dictionaries
+        EXPECT_NE(content.find("elog_test_misc.cpp"), std::string::npos);
+        ArrowStreamInfo segmentInfo;
+        EXPECT_TRUE(decodeArrowStream(content, segmentInfo));
+        EXPECT_EQ(segmentInfo.m_schemaFieldCount, ARROW_TEST_FIELD_COUNT);
+        EXPECT_GT(segmentInfo.m_dictionaryBatchCount, 0u);
+        segmentRowCount += segmentInfo.m_rowCount;
+        allSegments += content;
+    }
+    for (int i = 0; i < 8; ++i) {
+        std::string msg = "Arrow segment message " + std::to_string(i);
+        EXPECT_NE(allSegments.find(msg), std::string::npos);
+    }
+    EXPECT_GE(segmentRowCount, 8u);
+}
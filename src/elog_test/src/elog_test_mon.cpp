@@ -130,4 +130,104 @@ TEST(ELogMon, Otel) {
     bool res = testOtel();
     EXPECT_EQ(res, true);
 }
-#endif
\ No newline at end of file
+#endif
+#ifdef ELOG_ENABLE_HTTP
+#include <httplib.h>
+
+#include <filesystem>
+
+#include "elog_http_client.h"
+
+class TestHttpAssistant : public elog::ELogHttpClientAssistant {
+public:
+    TestHttpAssistant() : elog::ELogHttpClientAssistant("TestHttp") {}
+};
+
+bool testHttpBacklogSpill() {
+    // stub HTTP server, which may be toggled between available and unavailable (503) state
+    const uint32_t MSG_COUNT = 200;
+    std::atomic<bool> available(false);
+    std::mutex lock;
+    std::vector<std::string> received;
+    httplib::Server server;
+    server.Post("/logs", [&](const httplib::Request& req, httplib::Response& res) {
+        if (!available.load(std::memory_order_relaxed)) {
+            res.status = 503;
+            return;
+        }
+        std::unique_lock<std::mutex> guard(lock);
+        received.push_back(req.body);
+        res.status = ELOG_HTTP_STATUS_OK;
+    });
+    int port = server.bind_to_any_port("127.0.0.1");
+    if (port <= 0) {
+        fprintf(stderr, "Failed to bind stub HTTP server\n");
+        return false;
+    }
+    std::thread serverThread([&server]() { server.listen_after_bind(); });
+    server.wait_until_ready();
+
+    // small in-memory backlog, so that most of the backlog is spilled to disk
+    std::string spillDir = (std::filesystem::temp_directory_path() / "elog_test_spill").string();
+    std::filesystem::remove_all(spillDir);
+    elog::ELogHttpConfig httpConfig;
+    httpConfig.m_resendPeriodMillis = 50;
+    httpConfig.m_backlogLimitBytes = 256;
+    httpConfig.m_spillDir = spillDir;
+    httpConfig.m_spillSegmentSizeBytes = 1024;
+    TestHttpAssistant assistant;
+    elog::ELogHttpClient client;
+    std::string serverAddr = "http://127.0.0.1:" + std::to_string(port);
+    client.initialize(serverAddr.c_str(), "TestHttp", httpConfig, &assistant);
+    if (!client.start()) {
+        fprintf(stderr, "Failed to start HTTP client\n");
+        server.stop();
+        serverThread.join();
+        return false;
+    }
+
+    // all messages fail while server is unavailable, and are moved to backlog
+    for (uint32_t i = 0; i < MSG_COUNT; ++i) {
+        std::string body = "log message " + std::to_string(i);
+        client.post("/logs", body.c_str(), body.length(), "text/plain");
+    }
+
+    // let the resend thread fail a few times, then make the server available
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    available.store(true, std::memory_order_relaxed);
+
+    // wait until backlog is fully replayed
+    bool done = false;
+    for (uint32_t i = 0; i < 100 && !done; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::unique_lock<std::mutex> guard(lock);
+        done = (received.size() >= MSG_COUNT);
+    }
+    client.stop();
+    server.stop();
+    serverThread.join();
+
+    // verify no message was lost, and that order was preserved
+    if (received.size() != MSG_COUNT) {
+        fprintf(stderr, "Expecting %u messages, received %zu\n", MSG_COUNT, received.size());
+        return false;
+    }
+    for (uint32_t i = 0; i < MSG_COUNT; ++i) {
+        std::string expected = "log message " + std::to_string(i);
+        if (received[i] != expected) {
+            fprintf(stderr, "Message %u out of order: %s\n", i, received[i].c_str());
+            return false;
+        }
+    }
+
+    // all spill segments should be removed after replay
+    bool spillEmpty = std::filesystem::is_empty(spillDir);
+    std::filesystem::remove_all(spillDir);
+    return spillEmpty;
+}
+
+TEST(ELogMon, HttpBacklogSpill) {
+    bool res = testHttpBacklogSpill();
+    EXPECT_EQ(res, true);
+}
+#endif
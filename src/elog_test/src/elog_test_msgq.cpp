@@ -23,4 +23,30 @@ TEST(ELogMsgQ, Kafka) {
     bool res = testKafka();
     EXPECT_EQ(res, true);
 }
-#endif
\ No newline at end of file
+#endif
+#ifdef ELOG_ENABLE_KAFKA_MSGQ_CONNECTOR
+bool testKafkaBatched() {
+    ELOG_BEGIN_TEST();
+    std::string serverAddr;
+    getEnvVar("ELOG_KAFKA_SERVER", serverAddr);
+    std::string cfg =
+        std::string("msgq://kafka?kafka_bootstrap_servers=") + serverAddr +
+        ":9092&"
+        "msgq_topic=log_records&"
+        "kafka_linger=5millis&"
+        "kafka_batch_size=64kb&"
+        "kafka_compression=lz4&"
+        "kafka_partition_key=source&"
+        "kafka_buffer_pool_size=16&"
+        "kafka_flush_timeout=5000millis&"
+        "flush_policy=count&flush_count=64";
+    double msgPerf = 0.0f;
+    double ioPerf = 0.0f;
+    runSingleThreadedTest("Kafka (batched)", cfg.c_str(), msgPerf, ioPerf, TT_NORMAL, 100);
+    ELOG_END_TEST();
+}
+TEST(ELogMsgQ, KafkaBatched) {
+    bool res = testKafkaBatched();
+    EXPECT_EQ(res, true);
+}
+#endif
@@ -6,6 +6,9 @@ static int testUdp();
 #endif
 #ifdef ELOG_ENABLE_IPC
 static int testPipe();
+#ifdef ELOG_LINUX
+#include "ipc/elog_shm_ring.h"
+#endif
 #endif
 
 #if defined(ELOG_ENABLE_NET) || defined(ELOG_ENABLE_IPC)
@@ -190,7 +193,8 @@ static int sMsgCnt = -1;
 
 int testMsgClient(TestServer& server, const char* schema, const char* serverType, const char* mode,
                   const char* address, bool compress = false, int opts = 0,
-                  uint32_t stMsgCount = 1000, uint32_t mtMsgCount = 1000) {
+                  uint32_t stMsgCount = 1000, uint32_t mtMsgCount = 1000,
+                  const char* extraParams = "") {
     if (!server.initTestServer()) {
         ELOG_ERROR_EX(sTestLogger, "Failed to initialize test server");
         return 1;
@@ -208,7 +212,7 @@ int testMsgClient(TestServer& server, const char* schema, const char* serverType
                       "binary_format=protobuf&compress=" +
                       (compress ? "yes" : "no") +
                       "&max_concurrent_requests=1024&"
-                      "flush_policy=count&flush_count=1024";
+                      "flush_policy=count&flush_count=1024" + extraParams;
     std::string testName = std::string(mode) + " " + serverType;
     std::string mtResultFileName = std::string("elog_test_") + mode + "_" + serverType;
 
@@ -294,6 +298,8 @@ static int testTcpSync(bool compress);
 static int testUdpSync(bool compress);
 static int testTcpAsync(bool compress);
 static int testUdpAsync(bool compress);
+static int testTcpShard(const char* mode, const char* shardBy);
+static int testUdpShard(const char* mode, const char* shardBy);
 
 TEST(ELogNet, TcpSync) {
     int res = testTcpSync(false);
@@ -328,6 +334,18 @@ TEST(ELogNet, UdpAsyncCompress) {
     int res = testUdpAsync(true);
     EXPECT_EQ(res, 0);
 }
+TEST(ELogNet, TcpSyncShard) {
+    int res = testTcpShard("sync", "thread");
+    EXPECT_EQ(res, 0);
+}
+TEST(ELogNet, TcpAsyncShardRoundRobin) {
+    int res = testTcpShard("async", "round_robin");
+    EXPECT_EQ(res, 0);
+}
+TEST(ELogNet, UdpAsyncShard) {
+    int res = testUdpShard("async", "thread");
+    EXPECT_EQ(res, 0);
+}
 
 int testTcpSync(bool compress) {
     TestTcpServer server("0.0.0.0", 5051);
@@ -351,12 +369,27 @@ int testUdpAsync(bool compress) {
     TestUdpServer server("0.0.0.0", 5051);
     return testMsgClient(server, "net", "udp", "async", "127.0.0.1:5051", compress);
 }
+
+int testTcpShard(const char* mode, const char* shardBy) {
+    TestTcpServer server("0.0.0.0", 5051);
+    std::string extraParams = std::string("&connections=4&shard_by=") + shardBy;
+    return testMsgClient(server, "net", "tcp", mode, "127.0.0.1:5051", false, 0, 1000, 1000,
+                         extraParams.c_str());
+}
+
+int testUdpShard(const char* mode, const char* shardBy) {
+    TestUdpServer server("0.0.0.0", 5051);
+    std::string extraParams = std::string("&connections=4&shard_by=") + shardBy;
+    return testMsgClient(server, "net", "udp", mode, "127.0.0.1:5051", false, 0, 1000, 1000,
+                         extraParams.c_str());
+}
 #endif
 
 #ifdef ELOG_ENABLE_IPC
 
 static int testPipeSync(bool compress);
 static int testPipeAsync(bool compress);
+static int testPipeShard(const char* mode, const char* shardBy);
 
 TEST(ELogIpc, PipeSync) {
     int res = testPipeSync(false);
@@ -376,6 +409,10 @@ TEST(ELogIpc, PipeAsyncCompress) {
     int res = testPipeAsync(true);
     EXPECT_EQ(res, 0);
 }
+TEST(ELogIpc, PipeAsyncShard) {
+    int res = testPipeShard("async", "thread");
+    EXPECT_EQ(res, 0);
+}
 
 int testPipeSync(bool compress) {
     TestPipeServer server("elog_test_pipe");
@@ -388,4 +425,149 @@ int testPipeAsync(bool compress) {
     ELOG_DEBUG_EX(sTestLogger, "Server listening on pipe elog_test_pipe");
     return testMsgClient(server, "ipc", "pipe", "async", "elog_test_pipe", compress);
 }
-#endif
\ No newline at end of file
+
+int testPipeShard(const char* mode, const char* shardBy) {
+    TestPipeServer server("elog_test_pipe");
+    std::string extraParams = std::string("&connections=4&shard_by=") + shardBy;
+    return testMsgClient(server, "ipc", "pipe", mode, "elog_test_pipe", false, 0, 1000, 1000,
+                         extraParams.c_str());
+}
+
+#ifdef ELOG_LINUX
+TEST(ELogIpc, ShmRing) {
+    const char* cfg =
+        "ipc://shm?address=elog_test_ring&size=64KB&unlink_on_stop=yes&log_format=${msg}";
+    elog::ELogTargetId targetId = elog::configureLogTarget(cfg);
+    ASSERT_NE(targetId, ELOG_INVALID_TARGET_ID);
+
+    // collector side: consume records in place until all test records arrive
+    const uint32_t threadCount = 4;
+    const uint32_t msgCount = 10000;
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> recvCount(0);
+    elog::ELogShmRing ring;
+    ASSERT_TRUE(ring.open("elog_test_ring"));
+    std::thread collector([&ring, &done, &recvCount]() {
+        const char* data = nullptr;
+        uint32_t length = 0;
+        for (;;) {
+            if (!ring.wait(100)) {
+                if (done.load(std::memory_order_relaxed)) {
+                    break;
+                }
+                continue;
+            }
+            while (ring.peek(data, length)) {
+                if (std::string(data, length).starts_with("shm-test-")) {
+                    recvCount.fetch_add(1, std::memory_order_relaxed);
+                }
+                ring.consume();
+            }
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([i]() {
+            for (uint32_t j = 0; j < msgCount; ++j) {
+                ELOG_INFO_EX(sTestLogger, "shm-test-%u-%u", i, j);
+                // ring is small, so we let the collector catch up to reduce dropped records
+                if (j % 64 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    elog::ELogShmRingList ringList;
+    EXPECT_TRUE(elog::ELogShmRing::listRings(ringList));
+    EXPECT_TRUE(std::find_if(ringList.begin(), ringList.end(), [](const auto& entry) {
+                    return entry.first.compare("elog_test_ring") == 0;
+                }) != ringList.end());
+
+    done.store(true, std::memory_order_relaxed);
+    collector.join();
+    uint64_t dropCount = ring.getHeader()->m_dropCount.load(std::memory_order_relaxed);
+    // records are either received or dropped due to full ring, but never lost
+    EXPECT_GE(recvCount.load() + dropCount, threadCount * msgCount);
+    EXPECT_GT(recvCount.load(), 0u);
+    ring.close();
+    elog::removeLogTarget(targetId);
+}
+
+// simulates a producer that reserved a record and crashed before committing it
+static void abandonShmRecord(elog::ELogShmRing& ring, uint32_t length, bool publishSize) {
+    elog::ELogShmRingHeader* hdr = const_cast<elog::ELogShmRingHeader*>(ring.getHeader());
+    uint64_t recordSize = (sizeof(elog::ELogShmRecordHeader) + length +
+                           ELOG_SHM_RING_RECORD_ALIGN - 1) &
+                          ~(uint64_t)(ELOG_SHM_RING_RECORD_ALIGN - 1);
+    uint64_t pos = hdr->m_reservePos.fetch_add(recordSize, std::memory_order_acq_rel);
+    if (publishSize) {
+        char* data = (char*)hdr + hdr->m_dataOffset;
+        elog::ELogShmRecordHeader* recordHeader =
+            (elog::ELogShmRecordHeader*)(data + (pos & (hdr->m_capacity - 1)));
+        recordHeader->m_payloadSize = length;
+        recordHeader->m_commitWord.store(elog::ELOG_SHM_RECORD_RESERVED,
+                                         std::memory_order_release);
+    }
+}
+
+static bool peekShmRecord(elog::ELogShmRing& ring, std::string& record, uint64_t timeoutMillis) {
+    const char* data = nullptr;
+    uint32_t length = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (!ring.peek(data, length)) {
+        if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(timeoutMillis)) {
+            return false;
+        }
+        (void)ring.wait(10);
+    }
+    record.assign(data, length);
+    ring.consume();
+    return true;
+}
+
+TEST(ELogIpc, ShmRingAbandonedRecord) {
+    const char* ringName = "elog_test_ring_abandon";
+    elog::ELogShmRing writer;
+    ASSERT_TRUE(writer.create(ringName, ELOG_SHM_RING_MIN_SIZE));
+    elog::ELogShmRing reader;
+    ASSERT_TRUE(reader.open(ringName));
+    const elog::ELogShmRingHeader* hdr = reader.getHeader();
+
+    // writer crashes with one record of known size and one of unknown size left uncommitted
+    std::string record;
+    ASSERT_TRUE(writer.write("rec-1", 5));
+    abandonShmRecord(writer, 32, true);
+    ASSERT_TRUE(writer.write("rec-2", 5));
+    abandonShmRecord(writer, 32, false);
+    EXPECT_TRUE(peekShmRecord(reader, record, 1000));
+    EXPECT_EQ(record, "rec-1");
+    writer.close();
+
+    // a new writer re-attaches, so abandoned records are skipped immediately
+    ASSERT_TRUE(writer.create(ringName, ELOG_SHM_RING_MIN_SIZE));
+    ASSERT_TRUE(writer.write("rec-3", 5));
+    EXPECT_TRUE(peekShmRecord(reader, record, 0));
+    EXPECT_EQ(record, "rec-2");
+    EXPECT_TRUE(peekShmRecord(reader, record, 0));
+    EXPECT_EQ(record, "rec-3");
+    EXPECT_EQ(hdr->m_abandonCount.load(), 2u);
+
+    // a live writer with a pending record blocks the consumer
+    abandonShmRecord(writer, 16, true);
+    ASSERT_TRUE(writer.write("rec-4", 5));
+    EXPECT_FALSE(peekShmRecord(reader, record, 3 * ELOG_SHM_RING_LIVENESS_CHECK_MILLIS));
+
+    // once the writer is gone the consumer skips the abandoned record
+    writer.close();
+    EXPECT_TRUE(peekShmRecord(reader, record, 10 * ELOG_SHM_RING_LIVENESS_CHECK_MILLIS));
+    EXPECT_EQ(record, "rec-4");
+    EXPECT_EQ(hdr->m_abandonCount.load(), 3u);
+    EXPECT_EQ(reader.getReadPos(), hdr->m_reservePos.load());
+    reader.close(true);
+}
+#endif
+#endif